@@ -156,3 +156,38 @@ if float(Modulemd._version) >= 2:
 
     ServiceLevel = override(ServiceLevel)
     __all__.append(ServiceLevel)
+
+    class Reader(Modulemd.Reader):
+        def __iter__(self):
+            return self
+
+        def __next__(self):
+            # A subdocument that cannot be read must not end a for loop, so
+            # it is skipped and its error is kept in failures instead. Errors
+            # that end the whole stream are still raised.
+            while True:
+                try:
+                    doc = super(Reader, self).next_document()
+                except GLib.Error as error:
+                    if self.is_finished():
+                        raise
+                    self.failures.append(error)
+                    continue
+
+                if doc is None:
+                    raise StopIteration
+                return doc
+
+        @property
+        def failures(self):
+            """ The errors of the subdocuments skipped while iterating
+            """
+            if not hasattr(self, "_failures"):
+                self._failures = []
+            return self._failures
+
+        # Python 2 iterator protocol
+        next = __next__
+
+    Reader = override(Reader)
+    __all__.append(Reader)
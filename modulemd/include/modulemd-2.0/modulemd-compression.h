@@ -34,6 +34,8 @@ G_BEGIN_DECLS
  * @MODULEMD_COMPRESSION_TYPE_BZ2_COMPRESSION: bzip2 compression
  * @MODULEMD_COMPRESSION_TYPE_XZ_COMPRESSION: LZMA compression
  * @MODULEMD_COMPRESSION_TYPE_ZCK_COMPRESSION: zchunk compression
+ * @MODULEMD_COMPRESSION_TYPE_ZSTD_COMPRESSION: Zstandard compression
+ * (Since: 2.9)
  * @MODULEMD_COMPRESSION_TYPE_SENTINEL: Enum list terminator
  *
  * Since: 2.8
@@ -47,6 +49,7 @@ typedef enum
   MODULEMD_COMPRESSION_TYPE_BZ2_COMPRESSION,
   MODULEMD_COMPRESSION_TYPE_XZ_COMPRESSION,
   MODULEMD_COMPRESSION_TYPE_ZCK_COMPRESSION,
+  MODULEMD_COMPRESSION_TYPE_ZSTD_COMPRESSION,
   MODULEMD_COMPRESSION_TYPE_SENTINEL,
 } ModulemdCompressionTypeEnum;
 
@@ -54,7 +57,7 @@ typedef enum
 /**
  * modulemd_compression_type:
  * @name: (in): The name of the compression type. Valid options are:
- * "gz", "gzip", "bz2", "bzip2", "xz" and "zck".
+ * "gz", "gzip", "bz2", "bzip2", "xz", "zck", "zst" and "zstd".
  *
  * Returns: The #ModulemdCompressionTypeEnum value corresponding to the
  * provided string if available or
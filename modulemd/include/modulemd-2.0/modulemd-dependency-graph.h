@@ -0,0 +1,190 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2020 Red Hat, Inc.
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#pragma once
+
+#include "modulemd-module-index.h"
+#include "modulemd-module-stream.h"
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/**
+ * SECTION: modulemd-dependency-graph
+ * @title: Modulemd.DependencyGraph
+ * @stability: stable
+ * @short_description: The dependencies between the module streams of an
+ * index.
+ *
+ * #ModulemdDependencyGraph records which module streams of a
+ * #ModulemdModuleIndex require or build-require which other streams of the
+ * same index. A stream requires every stream of the index for which
+ * modulemd_module_stream_depends_on_stream() would return TRUE, so an empty
+ * set of streams in its dependencies stands for all streams of that module
+ * and a negated set for all streams not listed.
+ *
+ * When a stream has more than one #ModulemdDependencies object, they are
+ * alternatives. The graph includes the requirements of all of them.
+ *
+ * The graph is a snapshot of the index at the time it was created. Streams
+ * added to or removed from the index afterwards are not reflected in it.
+ */
+
+/**
+ * ModulemdDependencyTypeEnum:
+ * @MODULEMD_DEPENDENCY_TYPE_RUNTIME: Only the run-time requirements of the
+ * streams.
+ * @MODULEMD_DEPENDENCY_TYPE_BUILDTIME: Only the build-time requirements of the
+ * streams.
+ * @MODULEMD_DEPENDENCY_TYPE_ALL: Both the run-time and build-time
+ * requirements of the streams.
+ *
+ * Selects the requirements taken into account by a #ModulemdDependencyGraph
+ * query.
+ *
+ * Since: 2.9
+ */
+typedef enum
+{
+  MODULEMD_DEPENDENCY_TYPE_RUNTIME = 1,
+  MODULEMD_DEPENDENCY_TYPE_BUILDTIME = 2,
+  MODULEMD_DEPENDENCY_TYPE_ALL = 3,
+} ModulemdDependencyTypeEnum;
+
+#define MODULEMD_TYPE_DEPENDENCY_GRAPH (modulemd_dependency_graph_get_type ())
+
+G_DECLARE_FINAL_TYPE (ModulemdDependencyGraph,
+                      modulemd_dependency_graph,
+                      MODULEMD,
+                      DEPENDENCY_GRAPH,
+                      GObject)
+
+
+/**
+ * modulemd_dependency_graph_new:
+ * @index: (in): The #ModulemdModuleIndex whose streams make up the graph.
+ *
+ * Returns: (transfer full): A newly-allocated #ModulemdDependencyGraph of
+ * the module streams in @index. It holds a reference to every stream, so it
+ * remains valid if @index is modified or freed.
+ *
+ * Since: 2.9
+ */
+ModulemdDependencyGraph *
+modulemd_dependency_graph_new (ModulemdModuleIndex *index);
+
+
+/**
+ * modulemd_dependency_graph_get_streams:
+ * @self: (in): This #ModulemdDependencyGraph object.
+ *
+ * Returns: (transfer none) (element-type ModulemdModuleStream): All of the
+ * streams in the graph, sorted by module name and then as by
+ * modulemd_module_search_streams(). The other functions of
+ * #ModulemdDependencyGraph return streams in this order where possible.
+ *
+ * Since: 2.9
+ */
+GPtrArray *
+modulemd_dependency_graph_get_streams (ModulemdDependencyGraph *self);
+
+
+/**
+ * modulemd_dependency_graph_get_requirements:
+ * @self: (in): This #ModulemdDependencyGraph object.
+ * @stream: (in): A #ModulemdModuleStream in the graph.
+ * @type: (in): The requirements to include.
+ *
+ * Returns: (transfer container) (element-type ModulemdModuleStream): The
+ * streams that @stream requires directly. This is a zero-length list if
+ * @stream has no requirements in the graph or is not part of it.
+ *
+ * Since: 2.9
+ */
+GPtrArray *
+modulemd_dependency_graph_get_requirements (ModulemdDependencyGraph *self,
+                                            ModulemdModuleStream *stream,
+                                            ModulemdDependencyTypeEnum type);
+
+
+/**
+ * modulemd_dependency_graph_get_transitive_requirements:
+ * @self: (in): This #ModulemdDependencyGraph object.
+ * @stream: (in): A #ModulemdModuleStream in the graph.
+ * @type: (in): The requirements to include.
+ *
+ * Collects the streams that @stream needs, directly or indirectly.
+ *
+ * For %MODULEMD_DEPENDENCY_TYPE_RUNTIME, these are the streams that must be
+ * installed alongside @stream. For %MODULEMD_DEPENDENCY_TYPE_BUILDTIME, these
+ * are the streams that must be present in the buildroot of @stream: its
+ * build-time requirements together with their run-time requirements. For
+ * %MODULEMD_DEPENDENCY_TYPE_ALL, both kinds of requirements of every stream
+ * reached are followed.
+ *
+ * Returns: (transfer container) (element-type ModulemdModuleStream): The
+ * streams needed by @stream, not including @stream itself.
+ *
+ * Since: 2.9
+ */
+GPtrArray *
+modulemd_dependency_graph_get_transitive_requirements (
+  ModulemdDependencyGraph *self,
+  ModulemdModuleStream *stream,
+  ModulemdDependencyTypeEnum type);
+
+
+/**
+ * modulemd_dependency_graph_get_topological_order:
+ * @self: (in): This #ModulemdDependencyGraph object.
+ * @type: (in): The requirements to include.
+ * @error: (out): A #GError that will return the reason for a failure.
+ *
+ * Orders the streams of the graph so that every stream comes after all of
+ * the streams it requires. Of the streams whose requirements are already
+ * satisfied, those earlier in modulemd_dependency_graph_get_streams() come
+ * first.
+ *
+ * Returns: (transfer container) (element-type ModulemdModuleStream): All of
+ * the streams in the graph in dependency order. NULL and sets @error to
+ * %MODULEMD_ERROR_VALIDATE if the requirements contain a cycle. See
+ * modulemd_dependency_graph_get_cycles().
+ *
+ * Since: 2.9
+ */
+GPtrArray *
+modulemd_dependency_graph_get_topological_order (
+  ModulemdDependencyGraph *self,
+  ModulemdDependencyTypeEnum type,
+  GError **error);
+
+
+/**
+ * modulemd_dependency_graph_get_cycles:
+ * @self: (in): This #ModulemdDependencyGraph object.
+ * @type: (in): The requirements to include.
+ *
+ * Finds the groups of streams that require each other, directly or
+ * indirectly. Every stream appears in at most one group.
+ *
+ * Returns: (transfer full) (element-type GPtrArray): A list of the groups of
+ * streams that form cycles, each itself a list of #ModulemdModuleStream
+ * objects. This is a zero-length list if there are no cycles.
+ *
+ * Since: 2.9
+ */
+GPtrArray *
+modulemd_dependency_graph_get_cycles (ModulemdDependencyGraph *self,
+                                      ModulemdDependencyTypeEnum type);
+
+G_END_DECLS
@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include "modulemd-compression.h"
 #include "modulemd-module.h"
 #include "modulemd-subdocument-info.h"
 #include "modulemd-translation.h"
@@ -337,6 +338,143 @@ modulemd_module_index_dump_to_custom (ModulemdModuleIndex *self,
                                       GError **error);
 
 
+/**
+ * modulemd_module_index_dump_to_file:
+ * @self: This #ModulemdModuleIndex object.
+ * @path: (in): The path of the file to write the module metadata and other
+ * related information to. If @comtype has a usual file suffix, such as ".gz"
+ * for gzip, and @path does not already end with it, it is appended.
+ * @comtype: (in): The #ModulemdCompressionTypeEnum to compress the file with.
+ * Only %MODULEMD_COMPRESSION_TYPE_NO_COMPRESSION is available if libmodulemd
+ * was built without rpmio, and zchunk cannot be written.
+ * @level: (in): The compression level from 1 to 9, or 0 to use the default
+ * level of the compressor. Ignored if the file is not compressed.
+ * @error: (out): A #GError containing the reason the function failed, NULL if
+ * the function succeeded.
+ *
+ * Writes the index to a file, compressing it on a separate thread while the
+ * YAML is still being generated. The file is removed again if it could not be
+ * written completely.
+ *
+ * Returns: (transfer full): The name of the file that was written. In the
+ * event of an error, sets @error appropriately and returns NULL.
+ *
+ * Since: 2.9
+ */
+gchar *
+modulemd_module_index_dump_to_file (ModulemdModuleIndex *self,
+                                    const gchar *path,
+                                    ModulemdCompressionTypeEnum comtype,
+                                    gint level,
+                                    GError **error);
+
+
+/**
+ * modulemd_module_index_dump_to_binary:
+ * @self: This #ModulemdModuleIndex object.
+ * @error: (out): A #GError containing the reason the function failed, NULL if
+ * the function succeeded.
+ *
+ * Serializes the index into a versioned binary form that
+ * modulemd_module_index_update_from_binary() can load much faster than YAML.
+ * The binary form is only meant to be read back by libmodulemd. Streams that
+ * have not been parsed yet, as described for
+ * modulemd_module_index_set_lazy_streams(), are written without parsing them
+ * and are validated when they are loaded and parsed.
+ *
+ * Returns: (transfer full): The binary representation of the index. In the
+ * event of an error, sets @error appropriately and returns NULL.
+ *
+ * Since: 2.9
+ */
+GBytes *
+modulemd_module_index_dump_to_binary (ModulemdModuleIndex *self,
+                                      GError **error);
+
+
+/**
+ * modulemd_module_index_dump_to_binary_file:
+ * @self: This #ModulemdModuleIndex object.
+ * @path: (in): The path of the file to write the binary index to.
+ * @error: (out): A #GError containing the reason the function failed, NULL if
+ * the function succeeded.
+ *
+ * Writes the output of modulemd_module_index_dump_to_binary() to @path. The
+ * file is replaced atomically, so processes loading it at the same time see
+ * either the old or the new index.
+ *
+ * Returns: TRUE if written successfully, FALSE and sets @error appropriately
+ * in the event of an error.
+ *
+ * Since: 2.9
+ */
+gboolean
+modulemd_module_index_dump_to_binary_file (ModulemdModuleIndex *self,
+                                           const gchar *path,
+                                           GError **error);
+
+
+/**
+ * modulemd_module_index_update_from_binary:
+ * @self: This #ModulemdModuleIndex object.
+ * @bytes: (in): A binary index created by
+ * modulemd_module_index_dump_to_binary().
+ * @failures: (out) (element-type ModulemdSubdocumentInfo) (transfer container):
+ * An array containing any subdocuments from the index that could not be
+ * added. See #ModulemdSubdocumentInfo for more details.
+ * @error: (out): A #GError containing additional information if this function
+ * fails in a way that prevents program continuation.
+ *
+ * Adds the contents of a binary index to @self, as
+ * modulemd_module_index_update_from_string() does for YAML. The module
+ * streams are loaded as lazy streams, whether or not they are enabled with
+ * modulemd_module_index_set_lazy_streams(), so that each is only parsed the
+ * first time it is used. Their YAML is read from @bytes, which is kept for as
+ * long as any of them need it. Streams that were validated when the index was
+ * written are not validated again. Call
+ * modulemd_module_index_load_lazy_streams() to parse all of them and get any
+ * that could not be parsed.
+ *
+ * Returns: TRUE if the update was successful. Returns FALSE and sets
+ * @failures approriately if any of the subdocuments were invalid or sets
+ * @error if @bytes is not a binary index written by this version of
+ * libmodulemd.
+ *
+ * Since: 2.9
+ */
+gboolean
+modulemd_module_index_update_from_binary (ModulemdModuleIndex *self,
+                                          GBytes *bytes,
+                                          GPtrArray **failures,
+                                          GError **error);
+
+
+/**
+ * modulemd_module_index_update_from_binary_file:
+ * @self: This #ModulemdModuleIndex object.
+ * @path: (in): A file written by modulemd_module_index_dump_to_binary_file().
+ * @failures: (out) (element-type ModulemdSubdocumentInfo) (transfer container):
+ * An array containing any subdocuments from the index that could not be
+ * added. See #ModulemdSubdocumentInfo for more details.
+ * @error: (out): A #GError containing additional information if this function
+ * fails in a way that prevents program continuation.
+ *
+ * Maps @path into memory and loads it with
+ * modulemd_module_index_update_from_binary().
+ *
+ * Returns: TRUE if the update was successful. Returns FALSE and sets
+ * @failures approriately if any of the subdocuments were invalid or sets
+ * @error if there was a fatal error.
+ *
+ * Since: 2.9
+ */
+gboolean
+modulemd_module_index_update_from_binary_file (ModulemdModuleIndex *self,
+                                               const gchar *path,
+                                               GPtrArray **failures,
+                                               GError **error);
+
+
 /**
  * modulemd_module_index_get_module_names_as_strv: (rename-to modulemd_module_index_get_module_names)
  * @self: This #ModulemdModuleIndex object.
@@ -382,6 +520,237 @@ gboolean
 modulemd_module_index_remove_module (ModulemdModuleIndex *self,
                                      const gchar *module_name);
 
+
+/**
+ * modulemd_module_index_search_streams:
+ * @self: This #ModulemdModuleIndex object.
+ * @module_name: (nullable): A pattern for the module name of the streams to
+ * retrieve. If NULL, the module name is not included in the search.
+ * @stream_name: (nullable): A pattern for the stream name. If NULL, the
+ * stream name is not included in the search.
+ * @version: (nullable): A pattern for the version, matched against its
+ * decimal representation. If NULL, the version is not included in the
+ * search.
+ * @context: (nullable): A pattern for the context. If NULL, the context is
+ * not included in the search.
+ * @arch: (nullable): A pattern for the processor architecture. If NULL, the
+ * architecture is not included in the search.
+ *
+ * Searches every module in the index for streams matching all of the given
+ * patterns, which may use the `*` and `?` wildcards supported by
+ * g_pattern_match_simple(). See modulemd_module_search_streams_by_glob() for
+ * how each module is searched.
+ *
+ * Returns: (transfer container) (element-type ModulemdModuleStream): The list
+ * of matching stream objects, sorted by module name and then as by
+ * modulemd_module_search_streams(). This function cannot fail, but it may
+ * return a zero-length list if no matches were found.
+ *
+ * Since: 2.9
+ */
+GPtrArray *
+modulemd_module_index_search_streams (ModulemdModuleIndex *self,
+                                      const gchar *module_name,
+                                      const gchar *stream_name,
+                                      const gchar *version,
+                                      const gchar *context,
+                                      const gchar *arch);
+
+
+/**
+ * modulemd_module_index_get_streams_by_rpm_artifact:
+ * @self: This #ModulemdModuleIndex object.
+ * @nevra: The binary RPM to look up, in the name-[epoch:]version-release.arch
+ * form used by the `artifacts` section of module streams. A missing epoch is
+ * treated as a zero epoch.
+ *
+ * Finds the module streams that list @nevra among their RPM artifacts.
+ *
+ * The reverse lookup tables used by this, the other
+ * `modulemd_module_index_get_streams_by_*` functions and
+ * modulemd_module_index_get_streams_requiring_stream() are built the first
+ * time one of them is called. Afterwards, only the modules that had streams
+ * added, removed or renamed since the previous call are looked at again.
+ * Changes to the artifacts, components or dependencies of a stream that is
+ * already in the index are not noticed until its module is looked at again.
+ *
+ * Returns: (transfer container) (element-type ModulemdModuleStream): The list
+ * of streams shipping @nevra, sorted by module name and then as by
+ * modulemd_module_search_streams(). This function cannot
+ * fail, but it may return a zero-length list if no streams ship @nevra.
+ *
+ * Since: 2.9
+ */
+GPtrArray *
+modulemd_module_index_get_streams_by_rpm_artifact (ModulemdModuleIndex *self,
+                                                   const gchar *nevra);
+
+
+/**
+ * modulemd_module_index_get_streams_by_rpm_artifacts:
+ * @self: This #ModulemdModuleIndex object.
+ * @nevras: (array zero-terminated=1) (nullable): The binary RPMs to look up.
+ *
+ * Looks up each of @nevras as by
+ * modulemd_module_index_get_streams_by_rpm_artifact().
+ *
+ * Returns: (transfer full) (element-type utf8 GPtrArray): A table mapping
+ * each of @nevras that is shipped by at least one module stream to the list
+ * of those #ModulemdModuleStream objects.
+ *
+ * Since: 2.9
+ */
+GHashTable *
+modulemd_module_index_get_streams_by_rpm_artifacts (
+  ModulemdModuleIndex *self, const gchar *const *nevras);
+
+
+/**
+ * modulemd_module_index_get_streams_by_rpm_name:
+ * @self: This #ModulemdModuleIndex object.
+ * @name: The name of a binary RPM.
+ * @arch: (nullable): The processor architecture of the binary RPM. If NULL,
+ * artifacts for any architecture are included.
+ *
+ * Finds the module streams that list any version of the binary RPM @name
+ * among their RPM artifacts. See
+ * modulemd_module_index_get_streams_by_rpm_artifact() for when the lookup
+ * tables are updated.
+ *
+ * Returns: (transfer container) (element-type ModulemdModuleStream): The list
+ * of streams shipping @name, sorted as by
+ * modulemd_module_index_get_streams_by_rpm_artifact(). This function cannot
+ * fail, but it may return a zero-length list if no streams ship @name.
+ *
+ * Since: 2.9
+ */
+GPtrArray *
+modulemd_module_index_get_streams_by_rpm_name (ModulemdModuleIndex *self,
+                                               const gchar *name,
+                                               const gchar *arch);
+
+
+/**
+ * modulemd_module_index_get_streams_by_rpm_component:
+ * @self: This #ModulemdModuleIndex object.
+ * @name: The name of a source RPM package.
+ *
+ * Finds the module streams that build @name as one of their RPM components.
+ * See modulemd_module_index_get_streams_by_rpm_artifact() for when the lookup
+ * tables are updated.
+ *
+ * Returns: (transfer container) (element-type ModulemdModuleStream): The list
+ * of streams building @name, sorted as by
+ * modulemd_module_index_get_streams_by_rpm_artifact(). This function cannot
+ * fail, but it may return a zero-length list if no streams build @name.
+ *
+ * Since: 2.9
+ */
+GPtrArray *
+modulemd_module_index_get_streams_by_rpm_component (ModulemdModuleIndex *self,
+                                                    const gchar *name);
+
+
+/**
+ * modulemd_module_index_get_streams_by_rpm_components:
+ * @self: This #ModulemdModuleIndex object.
+ * @names: (array zero-terminated=1) (nullable): The names of source RPM
+ * packages.
+ *
+ * Looks up each of @names as by
+ * modulemd_module_index_get_streams_by_rpm_component().
+ *
+ * Returns: (transfer full) (element-type utf8 GPtrArray): A table mapping
+ * each of @names that is built by at least one module stream to the list of
+ * those #ModulemdModuleStream objects.
+ *
+ * Since: 2.9
+ */
+GHashTable *
+modulemd_module_index_get_streams_by_rpm_components (
+  ModulemdModuleIndex *self, const gchar *const *names);
+
+
+/**
+ * modulemd_module_index_get_streams_by_rpm_component_source:
+ * @self: This #ModulemdModuleIndex object.
+ * @repository: The repository URI of RPM components, as returned by
+ * modulemd_component_rpm_get_repository().
+ * @ref: (nullable): The commit ID or branch of RPM components, as returned by
+ * modulemd_component_rpm_get_ref(). If NULL, components built from any ref
+ * of @repository are included.
+ *
+ * Finds the module streams that have an RPM component built from @repository
+ * at @ref. Components that do not set an explicit repository are not
+ * included. See modulemd_module_index_get_streams_by_rpm_artifact() for when
+ * the lookup tables are updated.
+ *
+ * Returns: (transfer container) (element-type ModulemdModuleStream): The list
+ * of streams with matching components, sorted as by
+ * modulemd_module_index_get_streams_by_rpm_artifact(). This function cannot
+ * fail, but it may return a zero-length list if there are none.
+ *
+ * Since: 2.9
+ */
+GPtrArray *
+modulemd_module_index_get_streams_by_rpm_component_source (
+  ModulemdModuleIndex *self, const gchar *repository, const gchar *ref);
+
+
+/**
+ * modulemd_module_index_get_streams_requiring_stream:
+ * @self: This #ModulemdModuleIndex object.
+ * @module_name: The name of a module.
+ * @stream_name: The name of a stream of @module_name.
+ * @buildtime: Whether to look at build-time instead of run-time requirements.
+ *
+ * Finds the module streams in the index that would lose a requirement if
+ * @module_name:@stream_name went away: those for which
+ * modulemd_module_stream_depends_on_stream() or, if @buildtime is TRUE,
+ * modulemd_module_stream_build_depends_on_stream() returns TRUE. This
+ * includes streams that require all streams of @module_name and streams that
+ * require all streams except some that do not include @stream_name.
+ *
+ * See modulemd_module_index_get_streams_by_rpm_artifact() for when the lookup
+ * tables are updated.
+ *
+ * Returns: (transfer container) (element-type ModulemdModuleStream): The list
+ * of requiring streams, sorted as by
+ * modulemd_module_index_get_streams_by_rpm_artifact(). This function cannot
+ * fail, but it may return a zero-length list if no streams require
+ * @module_name:@stream_name.
+ *
+ * Since: 2.9
+ */
+GPtrArray *
+modulemd_module_index_get_streams_requiring_stream (ModulemdModuleIndex *self,
+                                                    const gchar *module_name,
+                                                    const gchar *stream_name,
+                                                    gboolean buildtime);
+
+
+/**
+ * modulemd_module_index_get_streams_requiring_streams:
+ * @self: This #ModulemdModuleIndex object.
+ * @module_streams: (array zero-terminated=1) (nullable): The module streams
+ * to look up, each in the "module:stream" form.
+ * @buildtime: Whether to look at build-time instead of run-time requirements.
+ *
+ * Looks up each of @module_streams as by
+ * modulemd_module_index_get_streams_requiring_stream().
+ *
+ * Returns: (transfer full) (element-type utf8 GPtrArray): A table mapping
+ * each of @module_streams that is required by at least one module stream to
+ * the list of those #ModulemdModuleStream objects.
+ *
+ * Since: 2.9
+ */
+GHashTable *
+modulemd_module_index_get_streams_requiring_streams (
+  ModulemdModuleIndex *self,
+  const gchar *const *module_streams,
+  gboolean buildtime);
+
 /**
  * modulemd_module_index_add_module_stream:
  * @self: This #ModulemdModuleIndex object.
@@ -408,6 +777,35 @@ modulemd_module_index_add_module_stream (ModulemdModuleIndex *self,
                                          GError **error);
 
 
+/**
+ * modulemd_module_index_adopt_module_stream:
+ * @self: This #ModulemdModuleIndex object.
+ * @stream: The #ModulemdModuleStream to add to the index. The stream added
+ * must have a module name and stream name set on it or it will be rejected.
+ * @error: (out): A #GError containing the reason the #ModulemdModuleStream
+ * object could not be added or NULL if the function succeeded.
+ *
+ * Like modulemd_module_index_add_module_stream(), but the index stores a
+ * reference to @stream itself instead of a deep copy of it, unless it has to
+ * be upgraded to a newer mdversion first. This is much cheaper for streams
+ * with many components, profiles or artifacts.
+ *
+ * The index and the caller then share @stream, so the caller must treat it as
+ * immutable from now on: any change made to it would also change the
+ * contents of the index.
+ *
+ * Returns: TRUE if the #ModulemdModuleStream was added successfully. If the
+ * stream already existed in the index, it will be replaced by the new one. On
+ * failure, returns FALSE and sets @error appropriately.
+ *
+ * Since: 2.9
+ */
+gboolean
+modulemd_module_index_adopt_module_stream (ModulemdModuleIndex *self,
+                                           ModulemdModuleStream *stream,
+                                           GError **error);
+
+
 /**
  * modulemd_module_index_add_defaults:
  * @self: This #ModulemdModuleIndex object.
@@ -493,6 +891,185 @@ ModulemdModuleStreamVersionEnum
 modulemd_module_index_get_stream_mdversion (ModulemdModuleIndex *self);
 
 
+/**
+ * modulemd_module_index_set_parse_threads:
+ * @self: This #ModulemdModuleIndex object.
+ * @threads: The maximum number of threads to parse YAML with, or 0 to use one
+ * per available processor.
+ *
+ * When @threads is not 1, YAML read with
+ * modulemd_module_index_update_from_file() or
+ * modulemd_module_index_update_from_string() is split into its subdocuments,
+ * which are parsed and validated concurrently on up to @threads threads.
+ * They are still added to the index in the order in which they appear, so the
+ * resulting index and any failures are the same as when parsing serially.
+ * Compressed files and YAML read from streams or custom handlers are always
+ * parsed serially.
+ *
+ * The default is 1.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_module_index_set_parse_threads (ModulemdModuleIndex *self,
+                                         guint threads);
+
+
+/**
+ * modulemd_module_index_get_parse_threads:
+ * @self: This #ModulemdModuleIndex object.
+ *
+ * Returns: The maximum number of threads that this index parses YAML with, as
+ * set by modulemd_module_index_set_parse_threads().
+ *
+ * Since: 2.9
+ */
+guint
+modulemd_module_index_get_parse_threads (ModulemdModuleIndex *self);
+
+
+/**
+ * modulemd_module_index_set_emit_threads:
+ * @self: This #ModulemdModuleIndex object.
+ * @threads: The maximum number of threads to emit YAML with, or 0 to use one
+ * per available processor.
+ *
+ * When @threads is not 1, the modulemd_module_index_dump_to_*() functions
+ * validate and emit the documents of each module concurrently on up to
+ * @threads threads, then write them out in the usual order. The output is
+ * identical to that of emitting serially, but it is only written once every
+ * module has been emitted.
+ *
+ * The default is 1.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_module_index_set_emit_threads (ModulemdModuleIndex *self,
+                                        guint threads);
+
+
+/**
+ * modulemd_module_index_get_emit_threads:
+ * @self: This #ModulemdModuleIndex object.
+ *
+ * Returns: The maximum number of threads that this index emits YAML with, as
+ * set by modulemd_module_index_set_emit_threads().
+ *
+ * Since: 2.9
+ */
+guint
+modulemd_module_index_get_emit_threads (ModulemdModuleIndex *self);
+
+
+/**
+ * modulemd_module_index_set_lazy_streams:
+ * @self: This #ModulemdModuleIndex object.
+ * @lazy: Whether to defer parsing module streams until they are needed.
+ *
+ * When @lazy is TRUE, module stream subdocuments read into the index
+ * afterwards are not parsed right away. Only their name, stream, version,
+ * context and arch are read, and the rest of their YAML is kept as text. Each
+ * stream is parsed and validated the first time it is requested, for example
+ * with modulemd_module_get_all_streams() or
+ * modulemd_module_search_streams(), or when the index is dumped or merged.
+ * This makes loading large repositories faster and uses less memory when
+ * only a few modules are looked at.
+ *
+ * As a consequence, errors in the body of a stream are not reported in the
+ * failures of the update_from_*() functions. Such a stream is left out of
+ * the index when it is first parsed and is reported by
+ * modulemd_module_index_load_lazy_streams(), which callers that need to know
+ * about invalid streams should call after loading. Parsing a stream does not
+ * change the order of the streams returned by
+ * modulemd_module_get_all_streams(). Defaults and translations are always
+ * parsed right away, as is YAML that is not encoded as UTF-8.
+ *
+ * The default is FALSE.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_module_index_set_lazy_streams (ModulemdModuleIndex *self,
+                                        gboolean lazy);
+
+
+/**
+ * modulemd_module_index_get_lazy_streams:
+ * @self: This #ModulemdModuleIndex object.
+ *
+ * Returns: Whether this index defers parsing module streams until they are
+ * needed, as set by modulemd_module_index_set_lazy_streams().
+ *
+ * Since: 2.9
+ */
+gboolean
+modulemd_module_index_get_lazy_streams (ModulemdModuleIndex *self);
+
+
+/**
+ * modulemd_module_index_load_lazy_streams:
+ * @self: This #ModulemdModuleIndex object.
+ * @failures: (out) (element-type ModulemdSubdocumentInfo) (transfer container):
+ * An array containing the subdocuments of the module streams that could not
+ * be parsed. See #ModulemdSubdocumentInfo for more details.
+ *
+ * Parses all of the module streams of @self whose parsing was deferred by
+ * modulemd_module_index_set_lazy_streams(). This reports the streams that
+ * could not be parsed, both now and when they were first needed earlier,
+ * which the other functions of the index cannot do.
+ *
+ * Returns: TRUE if every deferred module stream was parsed successfully.
+ * Returns FALSE and sets @failures appropriately otherwise.
+ *
+ * Since: 2.9
+ */
+gboolean
+modulemd_module_index_load_lazy_streams (ModulemdModuleIndex *self,
+                                         GPtrArray **failures);
+
+
+/**
+ * modulemd_module_index_set_cache_dir:
+ * @self: This #ModulemdModuleIndex object.
+ * @cache_dir: (in) (nullable): The path of a directory to keep pre-parsed
+ * copies of files in, or NULL to stop using a cache. It is created when
+ * needed.
+ *
+ * When a cache directory is set, modulemd_module_index_update_from_file() and
+ * modulemd_module_index_update_from_defaults_directory() first look for an
+ * entry for each file in @cache_dir. An entry is only used if the device,
+ * inode, size and modification time of the file, the @strict argument and
+ * the versions of libmodulemd and of its binary format all match those it
+ * was created with. It is then loaded as with
+ * modulemd_module_index_update_from_binary() instead of parsing the YAML, so
+ * its streams are only parsed when they are first used.
+ * Otherwise, the file is parsed and the entry is replaced.
+ *
+ * An entry is only written when a file is read without failures into an
+ * index that was empty. Problems with the cache itself are never reported as
+ * errors; the file is just parsed instead.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_module_index_set_cache_dir (ModulemdModuleIndex *self,
+                                     const gchar *cache_dir);
+
+
+/**
+ * modulemd_module_index_get_cache_dir:
+ * @self: This #ModulemdModuleIndex object.
+ *
+ * Returns: (transfer none) (nullable): The cache directory set by
+ * modulemd_module_index_set_cache_dir(), or NULL if there is none.
+ *
+ * Since: 2.9
+ */
+const gchar *
+modulemd_module_index_get_cache_dir (ModulemdModuleIndex *self);
+
+
 /**
  * modulemd_module_index_upgrade_streams:
  * @self: This #ModulemdModuleIndex object.
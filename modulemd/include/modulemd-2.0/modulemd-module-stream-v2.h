@@ -384,6 +384,58 @@ modulemd_module_stream_v2_get_rpm_component (ModulemdModuleStreamV2 *self,
                                              const gchar *component_name);
 
 
+/**
+ * modulemd_module_stream_v2_get_rpm_component_build_batches:
+ * @self: (in): This #ModulemdModuleStreamV2 object.
+ * @error: (out): A #GError that will return the reason for a failure.
+ *
+ * Plans the build of the RPM components of this stream as a sequence of
+ * batches. The components of a batch do not depend on each other and can be
+ * built in parallel once all of the previous batches have been built.
+ *
+ * If the components have buildorder values, each distinct value makes up a
+ * batch, in increasing order. If they have buildafter values, each component
+ * is placed in the batch right after the last of the components it must be
+ * built after, so that every batch is started as early as possible. Without
+ * either, all of the components make up a single batch.
+ *
+ * The number of batches is the length of the critical path of the build. See
+ * modulemd_module_stream_v2_get_rpm_component_critical_path().
+ *
+ * Returns: (transfer full) (element-type GStrv): An ordered list of batches,
+ * each an ordered #GStrv list of RPM component names. NULL and sets @error to
+ * %MODULEMD_ERROR_VALIDATE if the components do not validate or if their
+ * buildafter values form a cycle. The error message names the components of
+ * the cycle.
+ *
+ * Since: 2.9
+ */
+GPtrArray *
+modulemd_module_stream_v2_get_rpm_component_build_batches (
+  ModulemdModuleStreamV2 *self, GError **error);
+
+
+/**
+ * modulemd_module_stream_v2_get_rpm_component_critical_path:
+ * @self: (in): This #ModulemdModuleStreamV2 object.
+ * @error: (out): A #GError that will return the reason for a failure.
+ *
+ * Finds a longest chain of RPM components of this stream that must be built
+ * one after the other, as planned by
+ * modulemd_module_stream_v2_get_rpm_component_build_batches(). No build of
+ * the stream can take fewer sequential steps than this.
+ *
+ * Returns: (transfer full): The names of the components of the critical path
+ * in build order, with one component from each batch. NULL and sets @error
+ * as modulemd_module_stream_v2_get_rpm_component_build_batches() does.
+ *
+ * Since: 2.9
+ */
+GStrv
+modulemd_module_stream_v2_get_rpm_component_critical_path (
+  ModulemdModuleStreamV2 *self, GError **error);
+
+
 /**
  * modulemd_module_stream_v2_add_content_license:
  * @self: (in): This #ModulemdModuleStreamV2 object.
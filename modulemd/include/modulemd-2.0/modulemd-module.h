@@ -163,6 +163,39 @@ modulemd_module_search_streams (ModulemdModule *self,
                                 const gchar *arch);
 
 
+/**
+ * modulemd_module_search_streams_by_glob:
+ * @self: This #ModulemdModule object.
+ * @stream_name: (nullable): A pattern for the name of the streams to
+ * retrieve. If NULL, the stream name is not included in the search.
+ * @version: (nullable): A pattern for the version of the streams to retrieve,
+ * matched against its decimal representation. If NULL, the version is not
+ * included in the search.
+ * @context: (nullable): A pattern for the context of the streams to retrieve.
+ * If NULL, the context is not included in the search.
+ * @arch: (nullable): A pattern for the processor architecture of the streams
+ * to retrieve. If NULL, the architecture is not included in the search.
+ *
+ * Searches the streams of this module with glob patterns, which may use the
+ * `*` and `?` wildcards supported by g_pattern_match_simple(). A pattern
+ * without wildcards must match exactly, and a literal stream name, context or
+ * architecture is looked up directly rather than compared with every stream.
+ *
+ * Returns: (transfer container) (element-type ModulemdModuleStream): The list
+ * of stream objects matching all of the patterns, in the same order as
+ * modulemd_module_search_streams() returns them. This function cannot fail,
+ * but it may return a zero-length list if no matches were found.
+ *
+ * Since: 2.9
+ */
+GPtrArray *
+modulemd_module_search_streams_by_glob (ModulemdModule *self,
+                                        const gchar *stream_name,
+                                        const gchar *version,
+                                        const gchar *context,
+                                        const gchar *arch);
+
+
 /**
  * modulemd_module_get_stream_by_NSVCA:
  * @self: This #ModulemdModule object.
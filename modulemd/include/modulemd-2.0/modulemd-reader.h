@@ -0,0 +1,130 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2020 Red Hat, Inc.
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+/**
+ * SECTION: modulemd-reader
+ * @title: Modulemd.Reader
+ * @stability: stable
+ * @short_description: Reads module metadata one subdocument at a time.
+ *
+ * #ModulemdReader reads a YAML stream of module metadata and returns each
+ * #ModulemdModuleStream, #ModulemdDefaults and #ModulemdTranslation in it as
+ * soon as it has been parsed and validated, without collecting them into a
+ * #ModulemdModuleIndex. Only the subdocument currently being read is held in
+ * memory, so it is suited to single-pass tools that inspect very large
+ * repositories.
+ *
+ * In Python, a #ModulemdReader is an iterator:
+ *
+ * |[<!-- language="Python" -->
+ * reader = Modulemd.Reader.new_for_file("modules.yaml.gz", False)
+ *
+ * for doc in reader:
+ *     if isinstance(doc, Modulemd.ModuleStream):
+ *         print(doc.get_nsvc())
+ * ]|
+ *
+ * Iteration skips the subdocuments that fail to parse or validate and keeps
+ * their #GError in the `failures` list of the reader. An error that ends the
+ * whole stream, such as invalid YAML or a truncated compressed file, is
+ * raised instead. Call modulemd_reader_next_document() directly to get the
+ * error of each subdocument as it is read.
+ */
+
+#define MODULEMD_TYPE_READER (modulemd_reader_get_type ())
+
+G_DECLARE_FINAL_TYPE (
+  ModulemdReader, modulemd_reader, MODULEMD, READER, GObject)
+
+
+/**
+ * modulemd_reader_new_for_file:
+ * @yaml_file: (in): A path to a YAML file containing module metadata and
+ * other related information such as default streams. The file may be
+ * compressed with any of the formats supported by
+ * modulemd_module_index_update_from_file().
+ * @strict: (in): Whether the parser should return failure if it encounters an
+ * unknown mapping key or if it should ignore it.
+ * @error: (out): A #GError that will return the reason for a failure to open
+ * @yaml_file.
+ *
+ * Returns: (transfer full): A newly-allocated #ModulemdReader for
+ * @yaml_file. NULL and sets @error if the file could not be opened.
+ *
+ * Since: 2.9
+ */
+ModulemdReader *
+modulemd_reader_new_for_file (const gchar *yaml_file,
+                              gboolean strict,
+                              GError **error);
+
+
+/**
+ * modulemd_reader_new_for_string:
+ * @yaml_string: (in): A YAML string containing module metadata and other
+ * related information such as default streams.
+ * @strict: (in): Whether the parser should return failure if it encounters an
+ * unknown mapping key or if it should ignore it.
+ *
+ * Returns: (transfer full): A newly-allocated #ModulemdReader for a copy of
+ * @yaml_string.
+ *
+ * Since: 2.9
+ */
+ModulemdReader *
+modulemd_reader_new_for_string (const gchar *yaml_string, gboolean strict);
+
+
+/**
+ * modulemd_reader_next_document:
+ * @self: (in): This #ModulemdReader object.
+ * @error: (out): A #GError that will return the reason for a parsing or
+ * validation error.
+ *
+ * Reads and validates the next subdocument in the stream. A subdocument that
+ * fails to parse or validate is reported through @error and skipped, so the
+ * following call continues with the next one. Errors in the YAML itself end
+ * the stream.
+ *
+ * Returns: (transfer full) (nullable): The next #ModulemdModuleStream,
+ * #ModulemdDefaults or #ModulemdTranslation in the stream. NULL without
+ * setting @error once the stream has been read completely. NULL and sets
+ * @error if the subdocument could not be read.
+ *
+ * Since: 2.9
+ */
+GObject *
+modulemd_reader_next_document (ModulemdReader *self, GError **error);
+
+
+/**
+ * modulemd_reader_is_finished:
+ * @self: (in): This #ModulemdReader object.
+ *
+ * Returns: TRUE if modulemd_reader_next_document() has reached the end of the
+ * stream or an error that ended it, so that it will not return any more
+ * subdocuments. FALSE if the error it last returned, if any, was only for a
+ * single subdocument.
+ *
+ * Since: 2.9
+ */
+gboolean
+modulemd_reader_is_finished (ModulemdReader *self);
+
+G_END_DECLS
@@ -21,6 +21,7 @@
 #include "modulemd-defaults-v1.h"
 #include "modulemd-defaults.h"
 #include "modulemd-dependencies.h"
+#include "modulemd-dependency-graph.h"
 #include "modulemd-deprecated.h"
 #include "modulemd-errors.h"
 #include "modulemd-module-index-merger.h"
@@ -30,6 +31,7 @@
 #include "modulemd-module-stream.h"
 #include "modulemd-module.h"
 #include "modulemd-profile.h"
+#include "modulemd-reader.h"
 #include "modulemd-rpm-map-entry.h"
 #include "modulemd-service-level.h"
 #include "modulemd-subdocument-info.h"
@@ -63,3 +63,14 @@ gboolean
 modulemd_buildopts_emit_yaml (ModulemdBuildopts *self,
                               yaml_emitter_t *emitter,
                               GError **error);
+
+/**
+ * modulemd_buildopts_get_generation:
+ * @self: This #ModulemdBuildopts object.
+ *
+ * Returns: A counter that is increased every time @self is modified.
+ *
+ * Since: 2.9
+ */
+guint64
+modulemd_buildopts_get_generation (ModulemdBuildopts *self);
@@ -132,3 +132,27 @@ modulemd_component_emit_yaml_build_common (ModulemdComponent *self,
  */
 gboolean
 modulemd_component_equals_wrapper (const void *a, const void *b);
+
+/**
+ * modulemd_component_invalidate:
+ * @self: This #ModulemdComponent object.
+ *
+ * Records that @self has changed, so that any #ModulemdModuleStream containing
+ * it will be validated again by modulemd_module_stream_validate(). Called by
+ * every method that modifies a #ModulemdComponent.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_component_invalidate (ModulemdComponent *self);
+
+/**
+ * modulemd_component_get_generation:
+ * @self: This #ModulemdComponent object.
+ *
+ * Returns: A counter that is increased every time @self is modified.
+ *
+ * Since: 2.9
+ */
+guint64
+modulemd_component_get_generation (ModulemdComponent *self);
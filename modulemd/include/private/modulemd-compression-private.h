@@ -111,3 +111,157 @@ compressed_stream_read_fn (void *data,
                            unsigned char *buffer,
                            size_t size,
                            size_t *size_read);
+
+
+/**
+ * modulemd_compressed_writer:
+ *
+ * An opaque writer that compresses everything written to it into a file on a
+ * separate thread, so that producing the output and compressing it overlap.
+ *
+ * Since: 2.9
+ */
+typedef struct _modulemd_compressed_writer modulemd_compressed_writer;
+
+
+/**
+ * modulemd_compressed_writer_new:
+ * @path: (in): The path of the file to create or truncate.
+ * @comtype: (in): The #ModulemdCompressionTypeEnum to compress the file with.
+ * This must be a type that rpmio can write.
+ * @level: (in): The compression level from 1 to 9, or 0 to use the default
+ * level of the compressor.
+ * @error: (out): A #GError containing the reason this function failed.
+ *
+ * Returns: (transfer full): A newly-allocated #modulemd_compressed_writer that
+ * must be finished with modulemd_compressed_writer_close(). NULL and sets
+ * @error if the file could not be opened or libmodulemd was built without
+ * rpmio.
+ *
+ * Since: 2.9
+ */
+modulemd_compressed_writer *
+modulemd_compressed_writer_new (const gchar *path,
+                                ModulemdCompressionTypeEnum comtype,
+                                gint level,
+                                GError **error);
+
+
+/**
+ * modulemd_compressed_writer_write_fn:
+ * @data: (inout): A #modulemd_compressed_writer.
+ * @buffer: (in): The data to write.
+ * @size: (in): The size of @buffer.
+ *
+ * A #ModulemdWriteHandler that hands @buffer to the compression thread of a
+ * #modulemd_compressed_writer. It only blocks while all of the writer's
+ * buffers are waiting to be compressed.
+ *
+ * Returns: 1 on success or 0 if the compression thread failed.
+ *
+ * Since: 2.9
+ */
+gint
+modulemd_compressed_writer_write_fn (void *data,
+                                     unsigned char *buffer,
+                                     size_t size);
+
+
+/**
+ * modulemd_compressed_writer_close:
+ * @writer: (transfer full): A #modulemd_compressed_writer.
+ * @error: (out): A #GError containing the reason this function failed.
+ *
+ * Compresses anything still buffered, waits for the compression thread to
+ * finish, closes the file and frees @writer.
+ *
+ * Returns: TRUE if everything written to @writer was compressed and written
+ * to the file. FALSE and sets @error otherwise.
+ *
+ * Since: 2.9
+ */
+gboolean
+modulemd_compressed_writer_close (modulemd_compressed_writer *writer,
+                                  GError **error);
+
+
+/**
+ * modulemd_decompressor:
+ *
+ * An opaque reader that decompresses a file with a decompression library
+ * built into libmodulemd, without going through rpmio.
+ *
+ * Since: 2.9
+ */
+typedef struct _modulemd_decompressor modulemd_decompressor;
+
+
+/**
+ * modulemd_decompressor_new:
+ * @comtype: (in): The #ModulemdCompressionTypeEnum of the file open at @fd.
+ * @fd: (in): An open file descriptor positioned at the start of the
+ * compressed data. It is not closed by the decompressor.
+ * @error: (out): A #GError containing the reason this function failed.
+ *
+ * Returns: (transfer full): A newly-allocated #modulemd_decompressor. NULL and
+ * sets @error to #MODULEMD_ERROR_NOT_IMPLEMENTED if libmodulemd was built
+ * without a decompressor for @comtype, or to another error if the
+ * decompressor could not be initialized.
+ *
+ * Since: 2.9
+ */
+modulemd_decompressor *
+modulemd_decompressor_new (ModulemdCompressionTypeEnum comtype,
+                           int fd,
+                           GError **error);
+
+
+/**
+ * modulemd_decompressor_free:
+ * @self: (in): A #modulemd_decompressor.
+ *
+ * Frees @self. The file descriptor it was reading from is left open.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_decompressor_free (modulemd_decompressor *self);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (modulemd_decompressor,
+                               modulemd_decompressor_free);
+
+
+/**
+ * modulemd_decompressor_read_fn:
+ * @data: (inout): A #modulemd_decompressor.
+ * @buffer: (out): The buffer to write the decompressed data to.
+ * @size: (in): The size of the buffer.
+ * @size_read: (out): The number of bytes written to @buffer. Zero once all
+ * of the data has been decompressed.
+ *
+ * A #ModulemdReadHandler that decompresses the data as libyaml asks for it.
+ * Concatenated compressed streams are read one after another.
+ *
+ * Returns: 1 on success or 0 if the data could not be read or decompressed,
+ * in which case modulemd_decompressor_get_error() returns the reason.
+ *
+ * Since: 2.9
+ */
+gint
+modulemd_decompressor_read_fn (void *data,
+                               unsigned char *buffer,
+                               size_t size,
+                               size_t *size_read);
+
+
+/**
+ * modulemd_decompressor_get_error:
+ * @self: (in): A #modulemd_decompressor.
+ *
+ * Returns: (transfer none): The reason that modulemd_decompressor_read_fn()
+ * last failed, or NULL if it has not failed.
+ *
+ * Since: 2.9
+ */
+const GError *
+modulemd_decompressor_get_error (modulemd_decompressor *self);
@@ -66,4 +66,18 @@ modulemd_defaults_merge (ModulemdDefaults *from,
                          gboolean strict_default_streams,
                          GError **error);
 
+/**
+ * modulemd_defaults_invalidate:
+ * @self: (in): This #ModulemdDefaults object.
+ *
+ * Records that @self has changed since it was last validated, so that the
+ * next call to modulemd_defaults_validate() checks it again. Called by every
+ * method that modifies a #ModulemdDefaults.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_defaults_invalidate (ModulemdDefaults *self);
+
+
 G_END_DECLS
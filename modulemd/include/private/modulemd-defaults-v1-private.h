@@ -51,6 +51,28 @@ modulemd_defaults_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                  GError **error);
 
 
+/**
+ * modulemd_defaults_v1_parse_yaml_data:
+ * @parser: (inout): A libyaml parser object positioned just before the
+ * `YAML_MAPPING_START_EVENT` of the `data` section of a defaults document of
+ * metadata version 1.
+ * @strict: (in): Whether the parser should return failure if it encounters an
+ * unknown mapping key or if it should ignore it.
+ * @error: (out): A #GError that will return the reason for a parsing or
+ * validation error.
+ *
+ * Returns: (transfer full): A newly-allocated #ModulemdDefaultsV1 object read
+ * from the YAML. NULL if a parse or validation error occurred and sets @error
+ * appropriately.
+ *
+ * Since: 2.9
+ */
+ModulemdDefaultsV1 *
+modulemd_defaults_v1_parse_yaml_data (yaml_parser_t *parser,
+                                      gboolean strict,
+                                      GError **error);
+
+
 /**
  * modulemd_defaults_v1_emit_yaml:
  * @self: This #ModulemdDefaultsV1 object.
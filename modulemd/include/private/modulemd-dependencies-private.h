@@ -120,3 +120,14 @@ modulemd_dependencies_buildrequires_module_and_stream (
   ModulemdDependencies *self,
   const gchar *module_name,
   const gchar *stream_name);
+
+/**
+ * modulemd_dependencies_get_generation:
+ * @self: This #ModulemdDependencies object.
+ *
+ * Returns: A counter that is increased every time @self is modified.
+ *
+ * Since: 2.9
+ */
+guint64
+modulemd_dependencies_get_generation (ModulemdDependencies *self);
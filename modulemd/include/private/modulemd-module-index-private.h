@@ -14,6 +14,7 @@
 #pragma once
 
 #include "modulemd-module-index.h"
+#include "private/modulemd-yaml.h"
 #include <glib-object.h>
 #include <yaml.h>
 
@@ -33,6 +34,10 @@ G_BEGIN_DECLS
  * @self: (in): This #ModulemdModuleIndex object.
  * @parser: (inout): An initialized YAML parser that has not yet processed any
  * events.
+ * @capture: (in) (nullable): The #modulemd_yaml_capture that the input of
+ * @parser was set through, or NULL. When provided, subdocuments are parsed in
+ * a single pass and their text is only recovered from @capture for
+ * subdocuments that fail.
  * @strict: (in): Whether the parser should return failure if it encounters an
  * unknown mapping key or if it should ignore it.
  * @autogen_module_name: (in): When parsing a module stream that contains no
@@ -56,12 +61,45 @@ G_BEGIN_DECLS
 gboolean
 modulemd_module_index_update_from_parser (ModulemdModuleIndex *self,
                                           yaml_parser_t *parser,
+                                          modulemd_yaml_capture *capture,
                                           gboolean strict,
                                           gboolean autogen_module_name,
                                           GPtrArray **failures,
                                           GError **error);
 
 
+/**
+ * modulemd_module_index_read_subdoc:
+ * @parser: (inout): A libyaml parser that has just consumed the
+ * `YAML_DOCUMENT_START_EVENT` of a subdocument.
+ * @capture: (in) (nullable): The #modulemd_yaml_capture attached to @parser,
+ * or NULL if the subdocument text cannot be recovered from its marks.
+ * @strict: (in): Whether the parser should return failure if it encounters an
+ * unknown mapping key or if it should ignore it.
+ * @start_mark: (in): The start mark of the `YAML_DOCUMENT_START_EVENT`.
+ * @failure: (out) (transfer full): A #ModulemdSubdocumentInfo describing the
+ * subdocument if it could not be read.
+ *
+ * Reads and validates a single subdocument the same way as
+ * modulemd_module_index_update_from_parser() does, without adding it to an
+ * index. On return, @parser is positioned just after the
+ * `YAML_DOCUMENT_END_EVENT` of the subdocument, unless a fatal parse error
+ * occurred.
+ *
+ * Returns: (transfer full): The #ModulemdModuleStream, #ModulemdDefaults or
+ * #ModulemdTranslation that was read, or NULL and sets @failure if the
+ * subdocument was invalid.
+ *
+ * Since: 2.9
+ */
+GObject *
+modulemd_module_index_read_subdoc (yaml_parser_t *parser,
+                                   modulemd_yaml_capture *capture,
+                                   gboolean strict,
+                                   const yaml_mark_t *start_mark,
+                                   ModulemdSubdocumentInfo **failure);
+
+
 /**
  * modulemd_module_index_merge:
  * @from: (in) (transfer none): The #ModulemdModuleIndex whose contents are
@@ -90,4 +128,31 @@ modulemd_module_index_merge (ModulemdModuleIndex *from,
                              gboolean strict_default_streams,
                              GError **error);
 
+
+/**
+ * modulemd_module_index_merge_adopting_streams:
+ * @from: (in): The #ModulemdModuleIndex whose contents are being merged in.
+ * @into: (inout): The #ModulemdModuleIndex into which @from is being merged.
+ * @override: (in): As for modulemd_module_index_merge().
+ * @strict_default_streams: (in): As for modulemd_module_index_merge().
+ * @error: (out): If the merge fails, this will return a #GError explaining the
+ * reason for it.
+ *
+ * Like modulemd_module_index_merge(), but the streams of @from are shared
+ * with @into as by modulemd_module_index_adopt_module_stream() rather than
+ * copied. Use this only when @from is an intermediate result that nothing
+ * else will modify.
+ *
+ * Returns: The same as modulemd_module_index_merge().
+ *
+ * Since: 2.9
+ */
+gboolean
+modulemd_module_index_merge_adopting_streams (
+  ModulemdModuleIndex *from,
+  ModulemdModuleIndex *into,
+  gboolean override,
+  gboolean strict_default_streams,
+  GError **error);
+
 G_END_DECLS
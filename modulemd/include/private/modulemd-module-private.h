@@ -17,7 +17,9 @@
 #include <yaml.h>
 
 #include "modulemd-module.h"
+#include "modulemd-subdocument-info.h"
 #include "modulemd-translation.h"
+#include "private/modulemd-util.h"
 
 
 G_BEGIN_DECLS
@@ -136,6 +138,31 @@ modulemd_module_add_stream (ModulemdModule *self,
                             GError **error);
 
 
+/**
+ * modulemd_module_adopt_stream:
+ * @self: This #ModulemdModule object.
+ * @stream: A #ModulemdModuleStream object to associate with this
+ * #ModulemdModule.
+ * @index_mdversion: (in): The #ModulemdModuleStreamVersionEnum of the highest
+ * stream version added so far in the #ModulemdModuleIndex.
+ * @error: (out): A #GError containing information about why this function
+ * failed.
+ *
+ * Like modulemd_module_add_stream(), but unless @stream has to be upgraded,
+ * @self takes a reference to @stream itself rather than a copy of it. The
+ * caller must not modify @stream afterwards.
+ *
+ * Returns: The same as modulemd_module_add_stream().
+ *
+ * Since: 2.9
+ */
+ModulemdModuleStreamVersionEnum
+modulemd_module_adopt_stream (ModulemdModule *self,
+                              ModulemdModuleStream *stream,
+                              ModulemdModuleStreamVersionEnum index_mdversion,
+                              GError **error);
+
+
 /**
  * modulemd_module_upgrade_streams:
  * @self: This #ModulemdModule object.
@@ -152,4 +179,254 @@ modulemd_module_upgrade_streams (ModulemdModule *self,
                                  ModulemdModuleStreamVersionEnum mdversion,
                                  GError **error);
 
+
+/**
+ * modulemd_module_set_string_pool:
+ * @self: This #ModulemdModule object.
+ * @pool: (in) (nullable): The #modulemd_string_pool of the
+ * #ModulemdModuleIndex that holds @self, or NULL.
+ *
+ * Sets the pool that @self makes current while it parses lazy streams and
+ * files streams in its lookup tables, so that they share strings with the
+ * rest of the index even when they are parsed after reading has finished.
+ *
+ * Lazy streams whose strings were allocated in the previous pool take their
+ * own copies of them first. The index calls this with NULL when @self is
+ * still referenced elsewhere as it lets go of it, so that freeing the index
+ * frees its pool and the strings allocated in it.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_module_set_string_pool (ModulemdModule *self,
+                                 modulemd_string_pool *pool);
+
+
+/**
+ * modulemd_lazy_stream:
+ * @module_name: The module name read from the stream's data section.
+ * @stream_name: The stream name read from the stream's data section.
+ * @version: The version read from the stream's data section or zero.
+ * @context: The context read from the stream's data section or NULL.
+ * @arch: The architecture read from the stream's data section or NULL.
+ * @subdoc: A #ModulemdSubdocumentInfo holding the whole YAML subdocument of
+ * the stream along with its mdversion.
+ * @strict: Whether the stream should be parsed strictly once it is needed.
+ * @validated: Whether the stream was validated before its YAML was stored,
+ * as it is when it is written to a binary index, so that it does not need to
+ * be validated again once it is parsed.
+ * @position: The position of the stream in the order in which streams were
+ * added to its #ModulemdModule, set by modulemd_module_add_lazy_stream().
+ * @index: Where the stream is kept among the lazy streams of its
+ * #ModulemdModule.
+ * @pooled: Whether @module_name, @stream_name, @context and @arch were
+ * allocated with modulemd_string_pool_insert() rather than owned by the
+ * stream. The pool must then outlive the stream, which is why the
+ * #ModulemdModule that holds it keeps a reference to the pool.
+ *
+ * A module stream that has been indexed by its NSVCA but whose subdocument
+ * has not been parsed yet.
+ *
+ * Since: 2.9
+ */
+typedef struct _modulemd_lazy_stream
+{
+  gchar *module_name;
+  gchar *stream_name;
+  guint64 version;
+  gchar *context;
+  gchar *arch;
+
+  ModulemdSubdocumentInfo *subdoc;
+  gboolean strict;
+  gboolean validated;
+  guint64 position;
+  guint index;
+  gboolean pooled;
+} modulemd_lazy_stream;
+
+
+/**
+ * modulemd_lazy_stream_free:
+ * @lazy: (transfer full): A #modulemd_lazy_stream.
+ *
+ * Frees @lazy and everything it holds, apart from any strings it borrows from
+ * a #modulemd_string_pool.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_lazy_stream_free (modulemd_lazy_stream *lazy);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (modulemd_lazy_stream,
+                               modulemd_lazy_stream_free);
+
+
+/**
+ * modulemd_lazy_stream_parse_yaml_header:
+ * @parser: (inout): A libyaml parser object positioned just before the
+ * `YAML_MAPPING_START_EVENT` of the `data` section of a stream document.
+ * @error: (out): A #GError that will return the reason for a parsing error.
+ *
+ * Reads only the name, stream, version, context and arch of a stream from its
+ * `data` section and skips everything else in it. The same keys are used by
+ * every stream mdversion. On success, @parser is left positioned just after
+ * the `YAML_MAPPING_END_EVENT` of that section. If a #modulemd_string_pool is
+ * current, the strings read are allocated in it.
+ *
+ * Returns: (transfer full): A newly-allocated #modulemd_lazy_stream with no
+ * @subdoc set, or NULL and sets @error if the section could not be read.
+ *
+ * Since: 2.9
+ */
+modulemd_lazy_stream *
+modulemd_lazy_stream_parse_yaml_header (yaml_parser_t *parser, GError **error);
+
+
+/**
+ * modulemd_lazy_stream_parse:
+ * @lazy: (in): A #modulemd_lazy_stream with its @subdoc set.
+ * @error: (out): A #GError that will return the reason for a parsing or
+ * validation error.
+ *
+ * Parses the YAML of @subdoc as a stream of its mdversion and validates it,
+ * unless @validated is set.
+ *
+ * Returns: (transfer full): The parsed stream, or NULL and sets @error if it
+ * could not be parsed or is not valid.
+ *
+ * Since: 2.9
+ */
+ModulemdModuleStream *
+modulemd_lazy_stream_parse (modulemd_lazy_stream *lazy, GError **error);
+
+
+/**
+ * modulemd_module_add_lazy_stream:
+ * @self: This #ModulemdModule object.
+ * @lazy: (transfer full): A #modulemd_lazy_stream whose module name matches
+ * this #ModulemdModule and whose @subdoc is set.
+ * @index_mdversion: (in): The #ModulemdModuleStreamVersionEnum of the highest
+ * stream version added so far in the #ModulemdModuleIndex.
+ * @error: (out): A #GError containing information about why this function
+ * failed.
+ *
+ * Adds a stream to @self without parsing it. The stream is parsed, validated
+ * and upgraded to the highest mdversion seen by the #ModulemdModuleIndex the
+ * first time an accessor such as modulemd_module_get_all_streams() or
+ * modulemd_module_search_streams() could return it. It then takes the place
+ * among the other streams of @self at which it was added. A stream that fails
+ * at that point is dropped and reported by
+ * modulemd_module_load_lazy_streams().
+ *
+ * If the NSVCA of @lazy matches a stream that was already added, it is parsed
+ * immediately and added with modulemd_module_add_stream() instead, so that
+ * duplicates are handled the same way in both cases.
+ *
+ * Returns: The mdversion that the stream will have once it is parsed, with the
+ * same meaning as the return value of modulemd_module_add_stream().
+ *
+ * Since: 2.9
+ */
+ModulemdModuleStreamVersionEnum
+modulemd_module_add_lazy_stream (
+  ModulemdModule *self,
+  modulemd_lazy_stream *lazy,
+  ModulemdModuleStreamVersionEnum index_mdversion,
+  GError **error);
+
+
+/**
+ * modulemd_module_load_lazy_streams:
+ * @self: This #ModulemdModule object.
+ * @failures: (in) (element-type ModulemdSubdocumentInfo): An array to which
+ * the subdocuments of the lazy streams that could not be parsed are added.
+ *
+ * Parses all of the streams of @self that were added with
+ * modulemd_module_add_lazy_stream() and not parsed yet. The streams that
+ * could not be parsed, now or when an accessor needed them earlier, are added
+ * to @failures with the reason set in their #GError.
+ *
+ * Returns: TRUE if every lazy stream of @self was parsed successfully.
+ *
+ * Since: 2.9
+ */
+gboolean
+modulemd_module_load_lazy_streams (ModulemdModule *self, GPtrArray *failures);
+
+
+/**
+ * ModulemdModuleStreamVisitor:
+ * @stream: (in) (nullable): A stream that has been parsed, or NULL.
+ * @lazy: (in) (nullable): A stream that has not been parsed yet, if @stream
+ * is NULL.
+ * @user_data: (in): The data passed to modulemd_module_foreach_stream().
+ * @error: (out): A #GError to set if the visitor fails.
+ *
+ * Returns: TRUE to carry on with the next stream, FALSE and sets @error to
+ * stop.
+ *
+ * Since: 2.9
+ */
+typedef gboolean (*ModulemdModuleStreamVisitor) (ModulemdModuleStream *stream,
+                                                 modulemd_lazy_stream *lazy,
+                                                 gpointer user_data,
+                                                 GError **error);
+
+
+/**
+ * modulemd_module_foreach_stream:
+ * @self: This #ModulemdModule object.
+ * @visitor: (in) (scope call): The function to call for each stream.
+ * @user_data: (in): Data to pass to @visitor.
+ * @error: (out): A #GError set by @visitor.
+ *
+ * Calls @visitor for each stream of @self in the order in which they were
+ * added, without parsing any lazy streams. @visitor must not change the
+ * streams of @self.
+ *
+ * Returns: TRUE if @visitor returned TRUE for every stream. FALSE and sets
+ * @error as soon as it returns FALSE.
+ *
+ * Since: 2.9
+ */
+gboolean
+modulemd_module_foreach_stream (ModulemdModule *self,
+                                ModulemdModuleStreamVisitor visitor,
+                                gpointer user_data,
+                                GError **error);
+
+
+/**
+ * modulemd_module_get_streams_serial:
+ * @self: This #ModulemdModule object.
+ *
+ * Returns: A number that changes whenever a stream of @self is added, removed
+ * or has its NSVCA changed, so that lookup tables built from the streams can
+ * tell when they are out of date. Changes to other attributes of the streams
+ * are not counted.
+ *
+ * Since: 2.9
+ */
+guint64
+modulemd_module_get_streams_serial (ModulemdModule *self);
+
+
+/**
+ * modulemd_module_compare_streams:
+ * @a: (in): A pointer to a #ModulemdModuleStream pointer.
+ * @b: (in): A pointer to a #ModulemdModuleStream pointer.
+ *
+ * A #GCompareFunc for g_ptr_array_sort() that orders streams of the same
+ * module by stream name, then by version with the highest first, then by
+ * context and then by architecture.
+ *
+ * Returns: A negative value if @a sorts before @b, zero if they have the same
+ * NSVCA and a positive value if @a sorts after @b.
+ *
+ * Since: 2.9
+ */
+gint
+modulemd_module_compare_streams (gconstpointer a, gconstpointer b);
+
 G_END_DECLS
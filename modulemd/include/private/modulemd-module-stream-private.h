@@ -112,6 +112,33 @@ modulemd_module_stream_validate_components (GHashTable *components,
                                             GError **error);
 
 
+/**
+ * modulemd_module_stream_plan_component_builds:
+ * @components: (in): A #GHashTable of #ModulemdComponent objects.
+ * @critical_path: (out) (optional) (transfer full): The longest chain of
+ * components in @components that must be built one after the other, in build
+ * order. It has one component from each batch.
+ * @error: (out): A #GError that will return the reason for a failure.
+ *
+ * Groups the components in @components into batches that can be built in
+ * parallel, following their buildorder or buildafter values. With buildorder,
+ * each distinct value makes up a batch. With buildafter, each component is
+ * placed in the batch right after the last of the components it must be
+ * built after.
+ *
+ * Returns: (transfer full): An ordered #GPtrArray of #GStrv batches of
+ * component names. NULL and sets @error appropriately if @components does not
+ * pass modulemd_module_stream_validate_components() or if its buildafter
+ * values form a cycle.
+ *
+ * Since: 2.9
+ */
+GPtrArray *
+modulemd_module_stream_plan_component_builds (GHashTable *components,
+                                              GStrv *critical_path,
+                                              GError **error);
+
+
 /**
  * modulemd_module_stream_validate_component_rpm_arches:
  * @components: (in): A #GHashTable of #ModulemdComponent objects.
@@ -349,4 +376,41 @@ modulemd_module_stream_emit_yaml_base (ModulemdModuleStream *self,
                                        yaml_emitter_t *emitter,
                                        GError **error);
 
+/**
+ * modulemd_module_stream_invalidate:
+ * @self: (in): This #ModulemdModuleStream object.
+ *
+ * Records that @self has changed since it was last validated, so that the
+ * next call to modulemd_module_stream_validate() checks it again. Called by
+ * every method that modifies a #ModulemdModuleStream. Changes made to the
+ * components, buildopts and dependencies of @self are tracked separately by
+ * those objects.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_module_stream_invalidate (ModulemdModuleStream *self);
+
+
+/**
+ * modulemd_module_stream_get_generation:
+ * @self: (in): This #ModulemdModuleStream object.
+ * @generation: (out): The number of changes made to @self itself, including
+ * adding and removing components, buildopts and dependencies.
+ * @child_generation: (out): The sum of the numbers of changes made to the
+ * components, buildopts and dependencies of @self.
+ *
+ * Gets the pair of counters that identifies the state of @self, as used to
+ * skip validating it again. The pair changes whenever @self or any of its
+ * children is modified, but its sum may not, since removing a child takes
+ * its changes out of @child_generation.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_module_stream_get_generation (ModulemdModuleStream *self,
+                                       guint64 *generation,
+                                       guint64 *child_generation);
+
+
 G_END_DECLS
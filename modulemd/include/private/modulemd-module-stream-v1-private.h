@@ -87,6 +87,29 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                       gboolean strict,
                                       GError **error);
 
+/**
+ * modulemd_module_stream_v1_parse_yaml_data:
+ * @parser: (inout): A libyaml parser object positioned just before the
+ * `YAML_MAPPING_START_EVENT` of the `data` section of a stream v1 document.
+ * @strict: (in): Whether the parser should return failure if it encounters an
+ * unknown mapping key or if it should ignore it.
+ * @error: (out): A #GError that will return the reason for a parsing or
+ * validation error.
+ *
+ * Reads the `data` section directly from @parser. On success, @parser is left
+ * positioned just after the `YAML_MAPPING_END_EVENT` of that section.
+ *
+ * Returns: (transfer full): A newly-allocated #ModulemdModuleStreamV1 object
+ * read from the YAML. NULL if a parse or validation error occurred and sets
+ * @error appropriately.
+ *
+ * Since: 2.9
+ */
+ModulemdModuleStreamV1 *
+modulemd_module_stream_v1_parse_yaml_data (yaml_parser_t *parser,
+                                           gboolean strict,
+                                           GError **error);
+
 /**
  * modulemd_module_stream_v1_emit_yaml:
  * @self: This #ModulemdModuleStreamV1 object.
@@ -105,5 +128,18 @@ modulemd_module_stream_v1_emit_yaml (ModulemdModuleStreamV1 *self,
                                      yaml_emitter_t *emitter,
                                      GError **error);
 
+/**
+ * modulemd_module_stream_v1_get_child_generation:
+ * @self: (in): This #ModulemdModuleStreamV1 object.
+ *
+ * Returns: The sum of the modification counters of the child objects of @self
+ * that take part in validation. It increases whenever one of them is
+ * modified.
+ *
+ * Since: 2.9
+ */
+guint64
+modulemd_module_stream_v1_get_child_generation (ModulemdModuleStreamV1 *self);
+
 
 G_END_DECLS
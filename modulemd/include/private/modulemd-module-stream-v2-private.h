@@ -89,6 +89,29 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                       gboolean strict,
                                       GError **error);
 
+/**
+ * modulemd_module_stream_v2_parse_yaml_data:
+ * @parser: (inout): A libyaml parser object positioned just before the
+ * `YAML_MAPPING_START_EVENT` of the `data` section of a stream v2 document.
+ * @strict: (in): Whether the parser should return failure if it encounters an
+ * unknown mapping key or if it should ignore it.
+ * @error: (out): A #GError that will return the reason for a parsing or
+ * validation error.
+ *
+ * Reads the `data` section directly from @parser. On success, @parser is left
+ * positioned just after the `YAML_MAPPING_END_EVENT` of that section.
+ *
+ * Returns: (transfer full): A newly-allocated #ModulemdModuleStreamV2 object
+ * read from the YAML. NULL if a parse or validation error occurred and sets
+ * @error appropriately.
+ *
+ * Since: 2.9
+ */
+ModulemdModuleStreamV2 *
+modulemd_module_stream_v2_parse_yaml_data (yaml_parser_t *parser,
+                                           gboolean strict,
+                                           GError **error);
+
 /**
  * modulemd_module_stream_v2_emit_yaml:
  * @self: This #ModulemdModuleStreamV2 object.
@@ -197,5 +220,18 @@ void
 modulemd_module_stream_v2_replace_dependencies (ModulemdModuleStreamV2 *self,
                                                 GPtrArray *array);
 
+/**
+ * modulemd_module_stream_v2_get_child_generation:
+ * @self: (in): This #ModulemdModuleStreamV2 object.
+ *
+ * Returns: The sum of the modification counters of the child objects of @self
+ * that take part in validation. It increases whenever one of them is
+ * modified.
+ *
+ * Since: 2.9
+ */
+guint64
+modulemd_module_stream_v2_get_child_generation (ModulemdModuleStreamV2 *self);
+
 
 G_END_DECLS
@@ -112,6 +112,38 @@ modulemd_subdocument_info_set_yaml (ModulemdSubdocumentInfo *self,
                                     const gchar *contents);
 
 
+/**
+ * modulemd_subdocument_info_take_yaml:
+ * @self: This #ModulemdSubdocumentInfo object.
+ * @contents: (transfer full): The contents of the document.
+ *
+ * Like modulemd_subdocument_info_set_yaml(), but takes ownership of @contents
+ * instead of copying it.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_subdocument_info_take_yaml (ModulemdSubdocumentInfo *self,
+                                     gchar *contents);
+
+
+/**
+ * modulemd_subdocument_info_set_yaml_variant:
+ * @self: This #ModulemdSubdocumentInfo object.
+ * @contents: (transfer none): A #GVariant string holding the contents of the
+ * document.
+ *
+ * Like modulemd_subdocument_info_set_yaml(), but keeps a reference to
+ * @contents and reads the document from it instead of copying it. The string
+ * of a #GVariant loaded from a memory mapping is read from the mapping.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_subdocument_info_set_yaml_variant (ModulemdSubdocumentInfo *self,
+                                            GVariant *contents);
+
+
 /**
  * modulemd_subdocument_info_set_gerror:
  * @self: This #ModulemdSubdocumentInfo object.
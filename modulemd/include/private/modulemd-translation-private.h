@@ -94,6 +94,28 @@ modulemd_translation_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                  gboolean strict,
                                  GError **error);
 
+/**
+ * modulemd_translation_parse_yaml_data:
+ * @parser: (inout): A libyaml parser object positioned just before the
+ * `YAML_MAPPING_START_EVENT` of the `data` section of a translation document.
+ * @version: (in): The metadata version of the translation document.
+ * @strict: (in): Whether the parser should return failure if it encounters an
+ * unknown mapping key or if it should ignore it.
+ * @error: (out): A #GError that will return the reason for a parsing or
+ * validation error.
+ *
+ * Returns: (transfer full): A newly-allocated #ModulemdTranslation object
+ * read from the YAML. NULL if a parse or validation error occurred and sets
+ * @error appropriately.
+ *
+ * Since: 2.9
+ */
+ModulemdTranslation *
+modulemd_translation_parse_yaml_data (yaml_parser_t *parser,
+                                      guint64 version,
+                                      gboolean strict,
+                                      GError **error);
+
 /**
  * modulemd_translation_emit_yaml:
  * @self: This #ModulemdTranslation object.
@@ -141,6 +141,342 @@ modulemd_hash_table_deep_str_copy (GHashTable *orig);
 GHashTable *
 modulemd_hash_table_deep_set_copy (GHashTable *orig);
 
+/**
+ * modulemd_string_pool:
+ *
+ * A reference-counted pool of the strings returned by
+ * modulemd_intern_string(). Each #ModulemdModuleIndex owns one and makes it
+ * the current pool of the calling thread while it reads or merges documents,
+ * so that all of the objects it holds share one copy of each string and
+ * those copies can be compared by pointer. A pool is not thread-safe: it must
+ * only be current on one thread at a time.
+ *
+ * A pool is also an arena for strings that are only needed while the index
+ * holds the objects that refer to them, such as the headers of lazy streams.
+ * They are allocated with modulemd_string_pool_insert() and freed all at once
+ * with the pool.
+ *
+ * Since: 2.9
+ */
+typedef struct _modulemd_string_pool modulemd_string_pool;
+
+/**
+ * modulemd_string_pool_new:
+ *
+ * Returns: (transfer full): A newly-allocated, empty #modulemd_string_pool.
+ *
+ * Since: 2.9
+ */
+modulemd_string_pool *
+modulemd_string_pool_new (void);
+
+/**
+ * modulemd_string_pool_ref:
+ * @pool: (in): A #modulemd_string_pool.
+ *
+ * Returns: (transfer full): @pool, with its reference count increased.
+ *
+ * Since: 2.9
+ */
+modulemd_string_pool *
+modulemd_string_pool_ref (modulemd_string_pool *pool);
+
+/**
+ * modulemd_string_pool_unref:
+ * @pool: (in) (transfer full): A #modulemd_string_pool.
+ *
+ * Releases a reference to @pool and frees it once there are none left. The
+ * strings it interned stay valid for as long as anything else refers to
+ * them, but those from modulemd_string_pool_insert() are freed along with
+ * @pool unless another pool absorbed them.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_string_pool_unref (modulemd_string_pool *pool);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (modulemd_string_pool,
+                               modulemd_string_pool_unref);
+
+/**
+ * modulemd_string_pool_absorb:
+ * @pool: (inout): The #modulemd_string_pool to add to.
+ * @other: (in): Another #modulemd_string_pool, which is left unchanged.
+ *
+ * Adds the strings of @other that @pool does not have yet to @pool. This is
+ * used to combine the pools that worker threads interned strings into while
+ * parsing into the pool of the index that keeps their results. Strings that
+ * both pools already had remain separate copies. The strings inserted in
+ * @other stay valid for as long as either pool exists.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_string_pool_absorb (modulemd_string_pool *pool,
+                             modulemd_string_pool *other);
+
+/**
+ * modulemd_string_pool_insert:
+ * @pool: (inout): A #modulemd_string_pool.
+ * @str: (in) (nullable): A string.
+ *
+ * Copies @str into the arena of @pool, or returns the copy already there.
+ * Unlike modulemd_intern_string(), this takes no reference: the copy is only
+ * valid for as long as @pool or a pool that absorbed it is, and it must not
+ * be freed.
+ *
+ * Returns: (transfer none) (nullable): The copy of @str in @pool, or NULL if
+ * @str is NULL.
+ *
+ * Since: 2.9
+ */
+gchar *
+modulemd_string_pool_insert (modulemd_string_pool *pool, const gchar *str);
+
+/**
+ * modulemd_string_pool_get_current:
+ *
+ * Returns: (transfer none) (nullable): The #modulemd_string_pool that is
+ * current on the calling thread, or NULL if there is none.
+ *
+ * Since: 2.9
+ */
+modulemd_string_pool *
+modulemd_string_pool_get_current (void);
+
+/**
+ * modulemd_string_pool_scope:
+ * @previous: The pool that was current before this scope was entered.
+ * @entered: Whether this scope has been entered and not yet left.
+ *
+ * Records the current #modulemd_string_pool of a thread while another one
+ * replaces it. Use %MMD_INIT_STRING_POOL_SCOPE rather than the fields.
+ *
+ * Since: 2.9
+ */
+typedef struct
+{
+  modulemd_string_pool *previous;
+  gboolean entered;
+} modulemd_string_pool_scope;
+
+/**
+ * modulemd_string_pool_scope_enter:
+ * @scope: (out caller-allocates): The #modulemd_string_pool_scope to record
+ * the current pool in.
+ * @pool: (in) (nullable): The #modulemd_string_pool to make current on the
+ * calling thread. If NULL, the current pool stays current.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_string_pool_scope_enter (modulemd_string_pool_scope *scope,
+                                  modulemd_string_pool *pool);
+
+/**
+ * modulemd_string_pool_scope_leave:
+ * @scope: (inout): A #modulemd_string_pool_scope.
+ *
+ * Makes the pool that was current when @scope was entered current again. It
+ * does nothing if @scope was already left.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_string_pool_scope_leave (modulemd_string_pool_scope *scope);
+
+G_DEFINE_AUTO_CLEANUP_CLEAR_FUNC (modulemd_string_pool_scope,
+                                  modulemd_string_pool_scope_leave);
+
+/**
+ * MMD_INIT_STRING_POOL_SCOPE:
+ * @_scope: (out): The name of the #modulemd_string_pool_scope to declare.
+ * @_pool: (in) (nullable): The #modulemd_string_pool to make current.
+ *
+ * Makes @_pool the current pool of the calling thread until @_scope goes out
+ * of scope.
+ *
+ * Since: 2.9
+ */
+#define MMD_INIT_STRING_POOL_SCOPE(_scope, _pool)                             \
+  g_auto (modulemd_string_pool_scope) _scope;                                 \
+  modulemd_string_pool_scope_enter (&(_scope), (_pool))
+
+/**
+ * modulemd_intern_string:
+ * @str: (nullable): A string.
+ *
+ * Objects that hold many copies of the same strings, such as arch names,
+ * licenses and rpm names, store the result of this function instead of a
+ * g_strdup() copy. While a #modulemd_string_pool is current on the calling
+ * thread, identical strings are kept in memory only once for as long as the
+ * pool or any object refers to them.
+ *
+ * Returns: (transfer full) (nullable): A reference to the copy of @str in the
+ * current #modulemd_string_pool, or to a new copy if there is none, or NULL
+ * if @str is NULL. It must be released with g_ref_string_release() rather
+ * than g_free().
+ *
+ * Since: 2.9
+ */
+gchar *
+modulemd_intern_string (const gchar *str);
+
+/**
+ * modulemd_interned_str_equal:
+ * @a: (in) (nullable): A string.
+ * @b: (in) (nullable): Another string.
+ *
+ * A #GEqualFunc for strings returned by modulemd_intern_string(), which
+ * compares them by pointer before comparing their contents. Strings interned
+ * in the same #modulemd_string_pool are equal exactly when their pointers
+ * are.
+ *
+ * Returns: TRUE if @a and @b are equal or both NULL.
+ *
+ * Since: 2.9
+ */
+gboolean
+modulemd_interned_str_equal (gconstpointer a, gconstpointer b);
+
+/**
+ * modulemd_interned_set_new:
+ *
+ * Returns: (transfer full): A newly-allocated, empty #GHashTable for use as a
+ * set of strings returned by modulemd_intern_string(). Add entries to it only
+ * with modulemd_interned_set_add().
+ *
+ * Since: 2.9
+ */
+GHashTable *
+modulemd_interned_set_new (void);
+
+/**
+ * modulemd_interned_set_add:
+ * @set: (inout): A #GHashTable created by modulemd_interned_set_new().
+ * @str: (in): The string to add to @set.
+ *
+ * Adds the interned copy of @str to @set.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_interned_set_add (GHashTable *set, const gchar *str);
+
+/**
+ * modulemd_interned_set_copy:
+ * @orig: A #GHashTable to copy, containing string keys.
+ *
+ * Returns: (transfer full): A newly-allocated #GHashTable like the one from
+ * modulemd_interned_set_new(), containing the interned copies of the keys
+ * from @orig. The values from @orig are ignored.
+ *
+ * Since: 2.9
+ */
+GHashTable *
+modulemd_interned_set_copy (GHashTable *orig);
+
+/**
+ * modulemd_interned_set_take:
+ * @dest: (inout): A reference to a #GHashTable created by
+ * modulemd_interned_set_new() that will be replaced.
+ * @set: (in) (transfer full) (nullable): A #GHashTable created by
+ * modulemd_interned_set_new(), as returned by
+ * modulemd_yaml_parse_interned_string_set().
+ *
+ * Replaces the set at @dest with @set without copying it. This is used while
+ * parsing, where the set has just been built and nothing else refers to it.
+ * If @set is NULL, @dest is emptied instead.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_interned_set_take (GHashTable **dest, GHashTable *set);
+
+/**
+ * modulemd_multimap_new:
+ *
+ * Returns: (transfer full): A newly-allocated #GHashTable that maps interned
+ * strings to #GPtrArray lists of borrowed pointers, for use with
+ * modulemd_multimap_add(), modulemd_multimap_remove() and
+ * modulemd_multimap_lookup().
+ *
+ * Since: 2.9
+ */
+GHashTable *
+modulemd_multimap_new (void);
+
+/**
+ * modulemd_multimap_add:
+ * @multimap: (inout): A #GHashTable created by modulemd_multimap_new().
+ * @key: (nullable): The key under which to file @value. If NULL, nothing is
+ * added.
+ * @value: (in): The pointer to add to the list for @key. It is not
+ * referenced.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_multimap_add (GHashTable *multimap,
+                       const gchar *key,
+                       gpointer value);
+
+/**
+ * modulemd_multimap_remove:
+ * @multimap: (inout): A #GHashTable created by modulemd_multimap_new().
+ * @key: (nullable): The key under which @value was filed.
+ * @value: (in): The pointer to remove from the list for @key.
+ *
+ * Removes one occurrence of @value from the list for @key, and the list
+ * itself once it is empty. The order of the list is not preserved.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_multimap_remove (GHashTable *multimap,
+                          const gchar *key,
+                          gpointer value);
+
+/**
+ * modulemd_multimap_lookup:
+ * @multimap: (in): A #GHashTable created by modulemd_multimap_new().
+ * @key: (nullable): The key to look up.
+ *
+ * Returns: (transfer none) (nullable): The list of pointers filed under
+ * @key, or NULL if there are none.
+ *
+ * Since: 2.9
+ */
+GPtrArray *
+modulemd_multimap_lookup (GHashTable *multimap, const gchar *key);
+
+/**
+ * modulemd_is_glob:
+ * @pattern: (nullable): A search pattern.
+ *
+ * Returns: TRUE if @pattern contains any of the `*` and `?` wildcards
+ * supported by g_pattern_match_simple().
+ *
+ * Since: 2.9
+ */
+gboolean
+modulemd_is_glob (const gchar *pattern);
+
+/**
+ * modulemd_glob_matches:
+ * @pattern: (nullable): A search pattern, which may use the wildcards
+ * supported by g_pattern_match_simple().
+ * @value: (nullable): The string to match against @pattern.
+ *
+ * Returns: TRUE if @value matches @pattern. A NULL @pattern matches anything
+ * and a NULL @value is matched as an empty string. A @pattern without any
+ * wildcards is compared directly.
+ *
+ * Since: 2.9
+ */
+gboolean
+modulemd_glob_matches (const gchar *pattern, const gchar *value);
+
 /**
  * modulemd_hash_table_deep_str_set_copy:
  * @orig: A #GHashTable to copy, containing string keys and #GHashTable values.
@@ -339,6 +675,33 @@ modulemd_boolean_equals (gboolean a, gboolean b);
   while (0)
 
 
+/**
+ * MODULEMD_REPLACE_INTERNED_SET:
+ * @_dest: (inout): A reference to a #GHashTable created by
+ * modulemd_interned_set_new() that will be replaced.
+ * @_set: (in): A #GHashTable set of strings to copy.
+ *
+ * Like MODULEMD_REPLACE_SET(), but @_dest receives a copy made with
+ * modulemd_interned_set_copy().
+ *
+ * Since: 2.9
+ */
+#define MODULEMD_REPLACE_INTERNED_SET(_dest, _set)                            \
+  do                                                                          \
+    {                                                                         \
+      if (_set)                                                               \
+        {                                                                     \
+          g_clear_pointer (&_dest, g_hash_table_unref);                       \
+          _dest = modulemd_interned_set_copy (_set);                          \
+        }                                                                     \
+      else                                                                    \
+        {                                                                     \
+          g_hash_table_remove_all (_dest);                                    \
+        }                                                                     \
+    }                                                                         \
+  while (0)
+
+
 /**
  * MODULEMD_SETTER_GETTER_STRING_EXT:
  * @is_static: static for private methods, or empty comment for public.
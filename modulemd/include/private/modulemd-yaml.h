@@ -75,6 +75,7 @@ typedef enum
  * modulemd_yaml_string:
  * @str: A pointer to a block of memory containing YAML.
  * @len: The number of bytes currently in use in @str.
+ * @alloc: The number of bytes allocated for @str. Since 2.9.
  *
  * #modulemd_yaml_string is an internal representation of an arbitrary length
  * YAML string.
@@ -85,15 +86,30 @@ typedef struct _modulemd_yaml_string
 {
   char *str;
   size_t len;
+  size_t alloc;
 } modulemd_yaml_string;
 
+/**
+ * modulemd_yaml_string_new:
+ * @size_hint: (in): The number of bytes of YAML expected to be written, or 0
+ * if it is not known.
+ *
+ * Returns: (transfer full): A newly-allocated, empty #modulemd_yaml_string
+ * that can hold @size_hint bytes before it has to grow.
+ *
+ * Since: 2.9
+ */
+modulemd_yaml_string *
+modulemd_yaml_string_new (gsize size_hint);
+
 /**
  * write_yaml_string:
  * @data: (inout): A void pointer to a #modulemd_yaml_string object.
  * @buffer: (in): YAML text to append to @data.
  * @size: (in): The number of bytes from @buffer to append to @data.
  *
- * Additionally memory for @data is automatically allocated if necessary.
+ * Additionally memory for @data is automatically allocated if necessary. It
+ * grows geometrically, so writing a string of any length takes linear time.
  *
  * Since: 2.0
  */
@@ -109,6 +125,161 @@ write_yaml_string (void *data, unsigned char *buffer, size_t size);
 void
 modulemd_yaml_string_free (modulemd_yaml_string *yaml_string);
 
+/**
+ * modulemd_yaml_string_free_to_bytes:
+ * @yaml_string: (in) (transfer full): A #modulemd_yaml_string.
+ *
+ * Frees @yaml_string and hands its contents over to a #GBytes without copying
+ * them. The data of the #GBytes is always followed by a NUL byte that is not
+ * counted in its size, so it may also be read as a string.
+ *
+ * Returns: (transfer full): The contents of @yaml_string.
+ *
+ * Since: 2.9
+ */
+GBytes *
+modulemd_yaml_string_free_to_bytes (modulemd_yaml_string *yaml_string);
+
+/**
+ * modulemd_yaml_capture:
+ * @string: The input string, if the parser is reading from one.
+ * @string_len: The length of @string in bytes.
+ * @buffer: A copy of the bytes read from @file or @read_fn that have not yet
+ * been forgotten.
+ * @file: The input file, if the parser is reading from one.
+ * @read_fn: The input handler, if the parser is reading from one.
+ * @read_data: The private data for @read_fn.
+ * @offset: The byte offset in the input of the oldest byte still retained.
+ * @index: The character index in the input of the oldest byte still retained.
+ *
+ * #modulemd_yaml_capture keeps hold of the raw input of a libyaml parser so
+ * that the text of a subdocument can be recovered from the marks of its
+ * events without re-emitting it. It is only valid for UTF-8 input.
+ *
+ * Since: 2.9
+ */
+typedef struct _modulemd_yaml_capture
+{
+  const guint8 *string;
+  gsize string_len;
+  GByteArray *buffer;
+  FILE *file;
+  yaml_read_handler_t *read_fn;
+  void *read_data;
+  gsize offset;
+  gsize index;
+} modulemd_yaml_capture;
+
+/**
+ * modulemd_yaml_capture_set_input_string:
+ * @capture: (inout): An initialized #modulemd_yaml_capture.
+ * @parser: (inout): A libyaml parser with no input set.
+ * @string: (in): The YAML string to read.
+ * @length: (in): The length of @string in bytes.
+ *
+ * Sets @string as the input of @parser and tracks it in @capture. @string
+ * must outlive both.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_yaml_capture_set_input_string (modulemd_yaml_capture *capture,
+                                        yaml_parser_t *parser,
+                                        const gchar *string,
+                                        gsize length);
+
+/**
+ * modulemd_yaml_capture_set_input_file:
+ * @capture: (inout): An initialized #modulemd_yaml_capture.
+ * @parser: (inout): A libyaml parser with no input set.
+ * @file: (in): An open file to read YAML from.
+ *
+ * Sets @file as the input of @parser, keeping a copy in @capture of
+ * everything read from it until it is forgotten.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_yaml_capture_set_input_file (modulemd_yaml_capture *capture,
+                                      yaml_parser_t *parser,
+                                      FILE *file);
+
+/**
+ * modulemd_yaml_capture_set_input:
+ * @capture: (inout): An initialized #modulemd_yaml_capture.
+ * @parser: (inout): A libyaml parser with no input set.
+ * @handler: (in): A libyaml read handler.
+ * @data: (in): The private data for @handler.
+ *
+ * Sets @handler as the input of @parser, keeping a copy in @capture of
+ * everything read through it until it is forgotten.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_yaml_capture_set_input (modulemd_yaml_capture *capture,
+                                 yaml_parser_t *parser,
+                                 yaml_read_handler_t *handler,
+                                 void *data);
+
+/**
+ * modulemd_yaml_capture_forget:
+ * @capture: (inout): A #modulemd_yaml_capture.
+ * @mark: (in): A mark from the parser that @capture is attached to.
+ *
+ * Releases everything in the input before @mark. Marks earlier than the most
+ * recently forgotten one may no longer be passed to @capture.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_yaml_capture_forget (modulemd_yaml_capture *capture,
+                              const yaml_mark_t *mark);
+
+/**
+ * modulemd_yaml_capture_dup:
+ * @capture: (in): A #modulemd_yaml_capture.
+ * @start_mark: (in): The mark at which to start copying.
+ * @end_mark: (in): The mark at which to stop copying.
+ *
+ * Returns: (transfer full): A copy of the raw input between @start_mark and
+ * @end_mark.
+ *
+ * Since: 2.9
+ */
+gchar *
+modulemd_yaml_capture_dup (modulemd_yaml_capture *capture,
+                           const yaml_mark_t *start_mark,
+                           const yaml_mark_t *end_mark);
+
+/**
+ * modulemd_yaml_capture_clear:
+ * @capture: (inout): A #modulemd_yaml_capture to clear.
+ *
+ * Frees any input retained by @capture.
+ *
+ * Since: 2.9
+ */
+void
+modulemd_yaml_capture_clear (modulemd_yaml_capture *capture);
+
+/**
+ * modulemd_yaml_map_file:
+ * @fd: (in): A file descriptor open for reading on an uncompressed YAML file.
+ *
+ * Maps the whole of the file behind @fd into memory so that it can be handed
+ * to a libyaml parser as an input string instead of being read through stdio.
+ * The kernel is advised that the mapping will be read sequentially.
+ *
+ * Returns: (transfer full): A #GMappedFile for @fd, or NULL if @fd is not a
+ * non-empty regular file or could not be mapped. Callers should fall back to
+ * reading @fd as a stream in that case.
+ *
+ * Since: 2.9
+ */
+GMappedFile *
+modulemd_yaml_map_file (int fd);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (FILE, fclose);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (modulemd_yaml_string,
@@ -120,6 +291,9 @@ G_DEFINE_AUTO_CLEANUP_CLEAR_FUNC (yaml_parser_t, yaml_parser_delete);
 
 G_DEFINE_AUTO_CLEANUP_CLEAR_FUNC (yaml_emitter_t, yaml_emitter_delete);
 
+G_DEFINE_AUTO_CLEANUP_CLEAR_FUNC (modulemd_yaml_capture,
+                                  modulemd_yaml_capture_clear);
+
 /**
  * mmd_yaml_get_event_name:
  * @type: (in): A libyaml event type.
@@ -170,6 +344,19 @@ mmd_yaml_get_event_name (yaml_event_type_t type);
   g_auto (yaml_event_t) _event;                                               \
   memset (&(_event), 0, sizeof (yaml_event_t))
 
+/**
+ * MMD_INIT_YAML_CAPTURE:
+ * @_capture: (out): A variable name to use for the new capture object.
+ *
+ * This convenience macro allocates and initializes a new
+ * #modulemd_yaml_capture object named @_capture.
+ *
+ * Since: 2.9
+ */
+#define MMD_INIT_YAML_CAPTURE(_capture)                                       \
+  g_auto (modulemd_yaml_capture) _capture;                                    \
+  memset (&(_capture), 0, sizeof (modulemd_yaml_capture))
+
 /**
  * MMD_INIT_YAML_STRING:
  * @_emitter: (inout): A libyaml emitter object.
@@ -182,8 +369,23 @@ mmd_yaml_get_event_name (yaml_event_type_t type);
  * Since: 2.0
  */
 #define MMD_INIT_YAML_STRING(_emitter, _string)                               \
+  MMD_INIT_YAML_STRING_SIZED (_emitter, _string, 0)
+
+/**
+ * MMD_INIT_YAML_STRING_SIZED:
+ * @_emitter: (inout): A libyaml emitter object.
+ * @_string: (out): A variable name to use for the new yaml string object.
+ * @_size_hint: (in): The number of bytes of YAML expected to be emitted, or 0
+ * if it is not known.
+ *
+ * Like %MMD_INIT_YAML_STRING, but allocates room for @_size_hint bytes up
+ * front.
+ *
+ * Since: 2.9
+ */
+#define MMD_INIT_YAML_STRING_SIZED(_emitter, _string, _size_hint)             \
   g_autoptr (modulemd_yaml_string) yaml_string =                              \
-    g_malloc0_n (1, sizeof (modulemd_yaml_string));                           \
+    modulemd_yaml_string_new (_size_hint);                                    \
   yaml_emitter_set_output (_emitter, write_yaml_string, (void *)yaml_string)
 
 /**
@@ -202,7 +404,7 @@ mmd_yaml_get_event_name (yaml_event_type_t type);
   yaml_emitter_delete (_emitter);                                             \
   yaml_emitter_initialize (_emitter);                                         \
   g_clear_pointer (&_string, modulemd_yaml_string_free);                      \
-  yaml_string = g_malloc0_n (1, sizeof (modulemd_yaml_string));               \
+  yaml_string = modulemd_yaml_string_new (0);                                 \
   yaml_emitter_set_output (_emitter, write_yaml_string, (void *)yaml_string)
 
 /**
@@ -731,6 +933,43 @@ guint64
 modulemd_yaml_parse_uint64 (yaml_parser_t *parser, GError **error);
 
 
+/**
+ * modulemd_yaml_key:
+ * @name: A mapping key as it appears in the YAML document.
+ * @id: The identifier that modulemd_yaml_lookup_key() returns for @name.
+ *
+ * An entry in a table of the mapping keys that a parser recognizes. Parsers
+ * look up each key in their table once and dispatch on the identifier with a
+ * `switch` statement, instead of comparing it against every known key in
+ * turn.
+ *
+ * Since: 2.9
+ */
+typedef struct
+{
+  const gchar *name;
+  gint id;
+} modulemd_yaml_key;
+
+
+/**
+ * modulemd_yaml_lookup_key:
+ * @keys: (array length=n_keys): A table of #modulemd_yaml_key entries, sorted
+ * by name in strcmp() order.
+ * @n_keys: The number of entries in @keys.
+ * @name: (in): The mapping key to look up.
+ *
+ * Returns: The identifier of @name in @keys, or -1 if @name is not in the
+ * table.
+ *
+ * Since: 2.9
+ */
+gint
+modulemd_yaml_lookup_key (const modulemd_yaml_key *keys,
+                          gsize n_keys,
+                          const gchar *name);
+
+
 /**
  * modulemd_yaml_parse_string_set:
  * @parser: (inout): A libyaml parser object positioned at the beginning of a
@@ -748,6 +987,27 @@ GHashTable *
 modulemd_yaml_parse_string_set (yaml_parser_t *parser, GError **error);
 
 
+/**
+ * modulemd_yaml_parse_interned_string_set:
+ * @parser: (inout): A libyaml parser object positioned at the beginning of a
+ * sequence with string scalars.
+ * @error: (out): A #GError that will return the reason for a parsing or
+ * validation error.
+ *
+ * Like modulemd_yaml_parse_string_set(), but the set is built with
+ * modulemd_interned_set_new() so that it can be taken over by an object that
+ * stores an interned set without copying it.
+ *
+ * Returns: (transfer full): A newly-allocated #GHashTable * of interned
+ * strings. NULL if a parse error occurred and sets @error appropriately.
+ *
+ * Since: 2.9
+ */
+GHashTable *
+modulemd_yaml_parse_interned_string_set (yaml_parser_t *parser,
+                                         GError **error);
+
+
 /**
  * modulemd_yaml_parse_string_set_from_map:
  * @parser: (inout): A libyaml parser object positioned at the beginning of a
@@ -775,6 +1035,32 @@ modulemd_yaml_parse_string_set_from_map (yaml_parser_t *parser,
                                          GError **error);
 
 
+/**
+ * modulemd_yaml_parse_interned_string_set_from_map:
+ * @parser: (inout): A libyaml parser object positioned at the beginning of a
+ * map containing a single key which is a sequence with string scalars.
+ * @key: (in): The key in a single-key mapping whose contents should be
+ * returned as a string set.
+ * @strict: (in): Whether the parser should return failure if it encounters an
+ * unknown mapping key or if it should ignore it.
+ * @error: (out): A #GError that will return the reason for a parsing or
+ * validation error.
+ *
+ * Like modulemd_yaml_parse_string_set_from_map(), but returns a set of
+ * interned strings as modulemd_yaml_parse_interned_string_set() does.
+ *
+ * Returns: (transfer full): A newly-allocated #GHashTable * of interned
+ * strings. NULL if a parse error occurred and sets @error appropriately.
+ *
+ * Since: 2.9
+ */
+GHashTable *
+modulemd_yaml_parse_interned_string_set_from_map (yaml_parser_t *parser,
+                                                  const gchar *key,
+                                                  gboolean strict,
+                                                  GError **error);
+
+
 /**
  * modulemd_yaml_parse_string_string_map:
  * @parser: (inout): A libyaml parser object positioned at the beginning of a
@@ -811,6 +1097,58 @@ ModulemdSubdocumentInfo *
 modulemd_yaml_parse_document_type (yaml_parser_t *parser);
 
 
+/**
+ * modulemd_yaml_capture_get_subdocument:
+ * @capture: (in): A #modulemd_yaml_capture.
+ * @start_mark: (in): The start mark of the `YAML_DOCUMENT_START_EVENT` of a
+ * subdocument.
+ * @end_mark: (in): The end mark of the `YAML_DOCUMENT_END_EVENT` of the same
+ * subdocument.
+ *
+ * Reads the raw text of a subdocument back out of @capture and runs it through
+ * modulemd_yaml_parse_document_type().
+ *
+ * Returns: (transfer full): A #ModulemdSubdocumentInfo with information on
+ * the parse results.
+ *
+ * Since: 2.9
+ */
+ModulemdSubdocumentInfo *
+modulemd_yaml_capture_get_subdocument (modulemd_yaml_capture *capture,
+                                       const yaml_mark_t *start_mark,
+                                       const yaml_mark_t *end_mark);
+
+
+/**
+ * modulemd_yaml_parse_document_keys:
+ * @parser: (inout): A libyaml parser object positioned inside the top-level
+ * mapping of a subdocument, just before a key.
+ * @doctype: (inout): The document type seen so far. Updated if a `document`
+ * key is read.
+ * @mdversion: (inout): The metadata version seen so far. Updated if a
+ * `version` key is read.
+ * @at_data: (out): Set to TRUE if @parser stopped at a `data` key.
+ * @error: (out): A #GError that will return the reason for failing to parse.
+ *
+ * Reads the top-level keys of a subdocument until either the `data` key, in
+ * which case @parser is left positioned just before its value, or the end of
+ * the top-level mapping. Unknown keys are skipped, even when parsing strictly,
+ * as modulemd_yaml_parse_document_type() does.
+ *
+ * Returns: TRUE if the keys were read successfully. FALSE and sets @error
+ * appropriately if a key was repeated, the document type was unknown or the
+ * YAML was malformed.
+ *
+ * Since: 2.9
+ */
+gboolean
+modulemd_yaml_parse_document_keys (yaml_parser_t *parser,
+                                   ModulemdYamlDocumentTypeEnum *doctype,
+                                   guint64 *mdversion,
+                                   gboolean *at_data,
+                                   GError **error);
+
+
 /**
  * modulemd_yaml_emit_document_headers:
  * @emitter: (inout): A libyaml emitter object that is positioned where the
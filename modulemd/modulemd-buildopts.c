@@ -30,6 +30,9 @@ struct _ModulemdBuildopts
 
   GHashTable *whitelist;
   GHashTable *arches;
+
+  /* Increased by every method that modifies this object */
+  guint64 generation;
 };
 
 G_DEFINE_TYPE (ModulemdBuildopts, modulemd_buildopts, G_TYPE_OBJECT)
@@ -126,6 +129,7 @@ modulemd_buildopts_set_rpm_macros (ModulemdBuildopts *self,
                                    const gchar *rpm_macros)
 {
   g_return_if_fail (MODULEMD_IS_BUILDOPTS (self));
+  self->generation++;
 
   g_clear_pointer (&self->rpm_macros, g_free);
   self->rpm_macros = g_strdup (rpm_macros);
@@ -134,6 +138,15 @@ modulemd_buildopts_set_rpm_macros (ModulemdBuildopts *self,
 }
 
 
+guint64
+modulemd_buildopts_get_generation (ModulemdBuildopts *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_BUILDOPTS (self), 0);
+
+  return self->generation;
+}
+
+
 const gchar *
 modulemd_buildopts_get_rpm_macros (ModulemdBuildopts *self)
 {
@@ -148,6 +161,7 @@ modulemd_buildopts_add_rpm_to_whitelist (ModulemdBuildopts *self,
                                          const gchar *rpm)
 {
   g_return_if_fail (MODULEMD_IS_BUILDOPTS (self));
+  self->generation++;
   g_hash_table_add (self->whitelist, g_strdup (rpm));
 }
 
@@ -157,6 +171,7 @@ modulemd_buildopts_remove_rpm_from_whitelist (ModulemdBuildopts *self,
                                               const gchar *rpm)
 {
   g_return_if_fail (MODULEMD_IS_BUILDOPTS (self));
+  self->generation++;
   g_hash_table_remove (self->whitelist, rpm);
 }
 
@@ -164,6 +179,7 @@ void
 modulemd_buildopts_clear_rpm_whitelist (ModulemdBuildopts *self)
 {
   g_return_if_fail (MODULEMD_IS_BUILDOPTS (self));
+  self->generation++;
   g_hash_table_remove_all (self->whitelist);
 }
 
@@ -181,6 +197,7 @@ void
 modulemd_buildopts_add_arch (ModulemdBuildopts *self, const gchar *arch)
 {
   g_return_if_fail (MODULEMD_IS_BUILDOPTS (self));
+  self->generation++;
   g_hash_table_add (self->arches, g_strdup (arch));
 }
 
@@ -189,6 +206,7 @@ void
 modulemd_buildopts_remove_arch (ModulemdBuildopts *self, const gchar *arch)
 {
   g_return_if_fail (MODULEMD_IS_BUILDOPTS (self));
+  self->generation++;
   g_hash_table_remove (self->arches, arch);
 }
 
@@ -197,6 +215,7 @@ void
 modulemd_buildopts_clear_arches (ModulemdBuildopts *self)
 {
   g_return_if_fail (MODULEMD_IS_BUILDOPTS (self));
+  self->generation++;
   g_hash_table_remove_all (self->arches);
 }
 
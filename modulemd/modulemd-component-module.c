@@ -121,6 +121,7 @@ modulemd_component_module_set_ref (ModulemdComponentModule *self,
                                    const gchar *ref)
 {
   g_return_if_fail (MODULEMD_IS_COMPONENT_MODULE (self));
+  modulemd_component_invalidate (MODULEMD_COMPONENT (self));
 
   g_clear_pointer (&self->ref, g_free);
   self->ref = g_strdup (ref);
@@ -143,6 +144,7 @@ modulemd_component_module_set_repository (ModulemdComponentModule *self,
                                           const gchar *repository)
 {
   g_return_if_fail (MODULEMD_IS_COMPONENT_MODULE (self));
+  modulemd_component_invalidate (MODULEMD_COMPONENT (self));
 
   g_clear_pointer (&self->repository, g_free);
   self->repository = g_strdup (repository);
@@ -303,6 +305,24 @@ modulemd_component_module_emit_yaml (ModulemdComponentModule *self,
 }
 
 
+enum
+{
+  MODULE_KEY_BUILDONLY,
+  MODULE_KEY_BUILDORDER,
+  MODULE_KEY_RATIONALE,
+  MODULE_KEY_REF,
+  MODULE_KEY_REPOSITORY
+};
+
+/* The keys of a module component mapping, in strcmp() order */
+static const modulemd_yaml_key module_component_keys[] = {
+  { "buildonly", MODULE_KEY_BUILDONLY },
+  { "buildorder", MODULE_KEY_BUILDORDER },
+  { "rationale", MODULE_KEY_RATIONALE },
+  { "ref", MODULE_KEY_REF },
+  { "repository", MODULE_KEY_REPOSITORY },
+};
+
 ModulemdComponentModule *
 modulemd_component_module_parse_yaml (yaml_parser_t *parser,
                                       const gchar *name,
@@ -343,9 +363,12 @@ modulemd_component_module_parse_yaml (yaml_parser_t *parser,
                 error, event, "Missing mapping in module component entry");
               break;
             }
-          if (g_str_equal ((const gchar *)event.data.scalar.value,
-                           "rationale"))
+          switch (modulemd_yaml_lookup_key (
+            module_component_keys,
+            G_N_ELEMENTS (module_component_keys),
+            (const gchar *)event.data.scalar.value))
             {
+            case MODULE_KEY_RATIONALE:
               value = modulemd_yaml_parse_string (parser, &nested_error);
               if (!value)
                 {
@@ -358,10 +381,9 @@ modulemd_component_module_parse_yaml (yaml_parser_t *parser,
 
               modulemd_component_set_rationale (MODULEMD_COMPONENT (m), value);
               g_clear_pointer (&value, g_free);
-            }
-          else if (g_str_equal ((const gchar *)event.data.scalar.value,
-                                "repository"))
-            {
+              break;
+
+            case MODULE_KEY_REPOSITORY:
               value = modulemd_yaml_parse_string (parser, &nested_error);
               if (!value)
                 {
@@ -374,9 +396,9 @@ modulemd_component_module_parse_yaml (yaml_parser_t *parser,
 
               modulemd_component_module_set_repository (m, value);
               g_clear_pointer (&value, g_free);
-            }
-          else if (g_str_equal ((const gchar *)event.data.scalar.value, "ref"))
-            {
+              break;
+
+            case MODULE_KEY_REF:
               value = modulemd_yaml_parse_string (parser, &nested_error);
               if (!value)
                 {
@@ -389,10 +411,9 @@ modulemd_component_module_parse_yaml (yaml_parser_t *parser,
 
               modulemd_component_module_set_ref (m, value);
               g_clear_pointer (&value, g_free);
-            }
-          else if (g_str_equal ((const gchar *)event.data.scalar.value,
-                                "buildonly"))
-            {
+              break;
+
+            case MODULE_KEY_BUILDONLY:
               if (!modulemd_component_parse_buildonly (
                     MODULEMD_COMPONENT (m), parser, &nested_error))
                 {
@@ -402,10 +423,9 @@ modulemd_component_module_parse_yaml (yaml_parser_t *parser,
                     "Failed to parse buildonly in component: %s",
                     nested_error->message);
                 }
-            }
-          else if (g_str_equal ((const gchar *)event.data.scalar.value,
-                                "buildorder"))
-            {
+              break;
+
+            case MODULE_KEY_BUILDORDER:
               buildorder = modulemd_yaml_parse_int64 (parser, &nested_error);
               if (buildorder == 0 && nested_error != NULL)
                 {
@@ -418,9 +438,9 @@ modulemd_component_module_parse_yaml (yaml_parser_t *parser,
 
               modulemd_component_set_buildorder (MODULEMD_COMPONENT (m),
                                                  buildorder);
-            }
-          else
-            {
+              break;
+
+            default:
               SKIP_UNKNOWN (parser,
                             NULL,
                             "Unexpected key in module component body: %s",
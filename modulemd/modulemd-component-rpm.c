@@ -207,6 +207,7 @@ modulemd_component_rpm_set_name (ModulemdComponent *self, const gchar *name)
   ModulemdComponentRpm *rpm_self = NULL;
 
   g_return_if_fail (MODULEMD_IS_COMPONENT_RPM (self));
+  modulemd_component_invalidate (self);
   rpm_self = MODULEMD_COMPONENT_RPM (self);
 
   if (g_strcmp0 (rpm_self->override_name, name) == 0)
@@ -256,6 +257,7 @@ void
 modulemd_component_rpm_set_ref (ModulemdComponentRpm *self, const gchar *ref)
 {
   g_return_if_fail (MODULEMD_IS_COMPONENT_RPM (self));
+  modulemd_component_invalidate (MODULEMD_COMPONENT (self));
 
   g_clear_pointer (&self->ref, g_free);
   self->ref = g_strdup (ref);
@@ -278,6 +280,7 @@ modulemd_component_rpm_set_cache (ModulemdComponentRpm *self,
                                   const gchar *cache)
 {
   g_return_if_fail (MODULEMD_IS_COMPONENT_RPM (self));
+  modulemd_component_invalidate (MODULEMD_COMPONENT (self));
 
   g_clear_pointer (&self->cache, g_free);
   self->cache = g_strdup (cache);
@@ -300,6 +303,7 @@ modulemd_component_rpm_set_repository (ModulemdComponentRpm *self,
                                        const gchar *repository)
 {
   g_return_if_fail (MODULEMD_IS_COMPONENT_RPM (self));
+  modulemd_component_invalidate (MODULEMD_COMPONENT (self));
 
   g_clear_pointer (&self->repository, g_free);
   self->repository = g_strdup (repository);
@@ -322,6 +326,7 @@ modulemd_component_rpm_set_buildroot (ModulemdComponentRpm *self,
                                       gboolean buildroot)
 {
   g_return_if_fail (MODULEMD_IS_COMPONENT_RPM (self));
+  modulemd_component_invalidate (MODULEMD_COMPONENT (self));
 
   self->buildroot = buildroot;
 
@@ -343,6 +348,7 @@ modulemd_component_rpm_set_srpm_buildroot (ModulemdComponentRpm *self,
                                            gboolean srpm_buildroot)
 {
   g_return_if_fail (MODULEMD_IS_COMPONENT_RPM (self));
+  modulemd_component_invalidate (MODULEMD_COMPONENT (self));
 
   self->srpm_buildroot = srpm_buildroot;
 
@@ -364,6 +370,7 @@ modulemd_component_rpm_add_restricted_arch (ModulemdComponentRpm *self,
                                             const gchar *arch)
 {
   g_return_if_fail (MODULEMD_IS_COMPONENT_RPM (self));
+  modulemd_component_invalidate (MODULEMD_COMPONENT (self));
 
   g_hash_table_add (self->arches, g_strdup (arch));
 }
@@ -373,6 +380,7 @@ void
 modulemd_component_rpm_reset_arches (ModulemdComponentRpm *self)
 {
   g_return_if_fail (MODULEMD_IS_COMPONENT_RPM (self));
+  modulemd_component_invalidate (MODULEMD_COMPONENT (self));
 
   g_hash_table_remove_all (self->arches);
 }
@@ -393,6 +401,7 @@ modulemd_component_rpm_add_multilib_arch (ModulemdComponentRpm *self,
                                           const gchar *arch)
 {
   g_return_if_fail (MODULEMD_IS_COMPONENT_RPM (self));
+  modulemd_component_invalidate (MODULEMD_COMPONENT (self));
 
   g_hash_table_add (self->multilib, g_strdup (arch));
 }
@@ -402,6 +411,7 @@ void
 modulemd_component_rpm_reset_multilib_arches (ModulemdComponentRpm *self)
 {
   g_return_if_fail (MODULEMD_IS_COMPONENT_RPM (self));
+  modulemd_component_invalidate (MODULEMD_COMPONENT (self));
 
   g_hash_table_remove_all (self->multilib);
 }
@@ -630,6 +640,38 @@ modulemd_component_rpm_emit_yaml (ModulemdComponentRpm *self,
 }
 
 
+enum
+{
+  RPM_KEY_ARCHES,
+  RPM_KEY_BUILDAFTER,
+  RPM_KEY_BUILDONLY,
+  RPM_KEY_BUILDORDER,
+  RPM_KEY_BUILDROOT,
+  RPM_KEY_CACHE,
+  RPM_KEY_MULTILIB,
+  RPM_KEY_NAME,
+  RPM_KEY_RATIONALE,
+  RPM_KEY_REF,
+  RPM_KEY_REPOSITORY,
+  RPM_KEY_SRPM_BUILDROOT
+};
+
+/* The keys of an rpm component mapping, in strcmp() order */
+static const modulemd_yaml_key rpm_component_keys[] = {
+  { "arches", RPM_KEY_ARCHES },
+  { "buildafter", RPM_KEY_BUILDAFTER },
+  { "buildonly", RPM_KEY_BUILDONLY },
+  { "buildorder", RPM_KEY_BUILDORDER },
+  { "buildroot", RPM_KEY_BUILDROOT },
+  { "cache", RPM_KEY_CACHE },
+  { "multilib", RPM_KEY_MULTILIB },
+  { "name", RPM_KEY_NAME },
+  { "rationale", RPM_KEY_RATIONALE },
+  { "ref", RPM_KEY_REF },
+  { "repository", RPM_KEY_REPOSITORY },
+  { "srpm-buildroot", RPM_KEY_SRPM_BUILDROOT },
+};
+
 ModulemdComponentRpm *
 modulemd_component_rpm_parse_yaml (yaml_parser_t *parser,
                                    const gchar *name,
@@ -672,9 +714,12 @@ modulemd_component_rpm_parse_yaml (yaml_parser_t *parser,
                 error, event, "Missing mapping in rpm component entry");
               break;
             }
-          if (g_str_equal ((const gchar *)event.data.scalar.value,
-                           "rationale"))
+          switch (modulemd_yaml_lookup_key (
+            rpm_component_keys,
+            G_N_ELEMENTS (rpm_component_keys),
+            (const gchar *)event.data.scalar.value))
             {
+            case RPM_KEY_RATIONALE:
               value = modulemd_yaml_parse_string (parser, &nested_error);
               if (!value)
                 {
@@ -687,10 +732,9 @@ modulemd_component_rpm_parse_yaml (yaml_parser_t *parser,
 
               modulemd_component_set_rationale (MODULEMD_COMPONENT (r), value);
               g_clear_pointer (&value, g_free);
-            }
-          else if (g_str_equal ((const gchar *)event.data.scalar.value,
-                                "name"))
-            {
+              break;
+
+            case RPM_KEY_NAME:
               value = modulemd_yaml_parse_string (parser, &nested_error);
               if (!value)
                 {
@@ -703,11 +747,9 @@ modulemd_component_rpm_parse_yaml (yaml_parser_t *parser,
 
               modulemd_component_set_name (MODULEMD_COMPONENT (r), value);
               g_clear_pointer (&value, g_free);
-            }
+              break;
 
-          else if (g_str_equal ((const gchar *)event.data.scalar.value,
-                                "repository"))
-            {
+            case RPM_KEY_REPOSITORY:
               value = modulemd_yaml_parse_string (parser, &nested_error);
               if (!value)
                 {
@@ -720,9 +762,9 @@ modulemd_component_rpm_parse_yaml (yaml_parser_t *parser,
 
               modulemd_component_rpm_set_repository (r, value);
               g_clear_pointer (&value, g_free);
-            }
-          else if (g_str_equal ((const gchar *)event.data.scalar.value, "ref"))
-            {
+              break;
+
+            case RPM_KEY_REF:
               value = modulemd_yaml_parse_string (parser, &nested_error);
               if (!value)
                 {
@@ -735,10 +777,9 @@ modulemd_component_rpm_parse_yaml (yaml_parser_t *parser,
 
               modulemd_component_rpm_set_ref (r, value);
               g_clear_pointer (&value, g_free);
-            }
-          else if (g_str_equal ((const gchar *)event.data.scalar.value,
-                                "cache"))
-            {
+              break;
+
+            case RPM_KEY_CACHE:
               value = modulemd_yaml_parse_string (parser, &nested_error);
               if (!value)
                 {
@@ -751,10 +792,9 @@ modulemd_component_rpm_parse_yaml (yaml_parser_t *parser,
 
               modulemd_component_rpm_set_cache (r, value);
               g_clear_pointer (&value, g_free);
-            }
-          else if (g_str_equal ((const gchar *)event.data.scalar.value,
-                                "arches"))
-            {
+              break;
+
+            case RPM_KEY_ARCHES:
               list = modulemd_yaml_parse_string_set (parser, &nested_error);
               if (!list)
                 {
@@ -767,10 +807,9 @@ modulemd_component_rpm_parse_yaml (yaml_parser_t *parser,
 
               g_clear_pointer (&r->arches, g_hash_table_unref);
               r->arches = g_steal_pointer (&list);
-            }
-          else if (g_str_equal ((const gchar *)event.data.scalar.value,
-                                "multilib"))
-            {
+              break;
+
+            case RPM_KEY_MULTILIB:
               list = modulemd_yaml_parse_string_set (parser, &nested_error);
               if (!list)
                 {
@@ -783,10 +822,9 @@ modulemd_component_rpm_parse_yaml (yaml_parser_t *parser,
 
               g_clear_pointer (&r->multilib, g_hash_table_unref);
               r->multilib = g_steal_pointer (&list);
-            }
-          else if (g_str_equal ((const gchar *)event.data.scalar.value,
-                                "buildroot"))
-            {
+              break;
+
+            case RPM_KEY_BUILDROOT:
               truth_value = modulemd_yaml_parse_bool (parser, &nested_error);
               if (nested_error)
                 {
@@ -798,10 +836,9 @@ modulemd_component_rpm_parse_yaml (yaml_parser_t *parser,
                 }
 
               modulemd_component_rpm_set_buildroot (r, truth_value);
-            }
-          else if (g_str_equal ((const gchar *)event.data.scalar.value,
-                                "srpm-buildroot"))
-            {
+              break;
+
+            case RPM_KEY_SRPM_BUILDROOT:
               truth_value = modulemd_yaml_parse_bool (parser, &nested_error);
               if (nested_error)
                 {
@@ -813,10 +850,9 @@ modulemd_component_rpm_parse_yaml (yaml_parser_t *parser,
                 }
 
               modulemd_component_rpm_set_srpm_buildroot (r, truth_value);
-            }
-          else if (g_str_equal ((const gchar *)event.data.scalar.value,
-                                "buildafter"))
-            {
+              break;
+
+            case RPM_KEY_BUILDAFTER:
               if (!modulemd_component_parse_buildafter (
                     MODULEMD_COMPONENT (r), parser, &nested_error))
                 {
@@ -826,10 +862,9 @@ modulemd_component_rpm_parse_yaml (yaml_parser_t *parser,
                     "Failed to parse buildafter in component: %s",
                     nested_error->message);
                 }
-            }
-          else if (g_str_equal ((const gchar *)event.data.scalar.value,
-                                "buildonly"))
-            {
+              break;
+
+            case RPM_KEY_BUILDONLY:
               if (!modulemd_component_parse_buildonly (
                     MODULEMD_COMPONENT (r), parser, &nested_error))
                 {
@@ -839,10 +874,9 @@ modulemd_component_rpm_parse_yaml (yaml_parser_t *parser,
                     "Failed to parse buildonly in component: %s",
                     nested_error->message);
                 }
-            }
-          else if (g_str_equal ((const gchar *)event.data.scalar.value,
-                                "buildorder"))
-            {
+              break;
+
+            case RPM_KEY_BUILDORDER:
               buildorder = modulemd_yaml_parse_int64 (parser, &nested_error);
               if (buildorder == 0 && nested_error != NULL)
                 {
@@ -855,9 +889,9 @@ modulemd_component_rpm_parse_yaml (yaml_parser_t *parser,
 
               modulemd_component_set_buildorder (MODULEMD_COMPONENT (r),
                                                  buildorder);
-            }
-          else
-            {
+              break;
+
+            default:
               SKIP_UNKNOWN (parser,
                             NULL,
                             "Unexpected key in rpm component body: %s",
@@ -28,6 +28,9 @@ typedef struct
   gboolean buildonly;
   gchar *name;
   gchar *rationale;
+
+  /* Increased by every method that modifies this component */
+  guint64 generation;
 } ModulemdComponentPrivate;
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (ModulemdComponent,
@@ -145,6 +148,30 @@ modulemd_component_default_validate (ModulemdComponent *self, GError **error)
 }
 
 
+void
+modulemd_component_invalidate (ModulemdComponent *self)
+{
+  g_return_if_fail (MODULEMD_IS_COMPONENT (self));
+
+  ModulemdComponentPrivate *priv =
+    modulemd_component_get_instance_private (self);
+
+  priv->generation++;
+}
+
+
+guint64
+modulemd_component_get_generation (ModulemdComponent *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_COMPONENT (self), 0);
+
+  ModulemdComponentPrivate *priv =
+    modulemd_component_get_instance_private (self);
+
+  return priv->generation;
+}
+
+
 gboolean
 modulemd_component_validate (ModulemdComponent *self, GError **error)
 {
@@ -237,6 +264,7 @@ void
 modulemd_component_add_buildafter (ModulemdComponent *self, const gchar *key)
 {
   g_return_if_fail (MODULEMD_IS_COMPONENT (self));
+  modulemd_component_invalidate (self);
 
   ModulemdComponentPrivate *priv =
     modulemd_component_get_instance_private (self);
@@ -248,6 +276,7 @@ void
 modulemd_component_clear_buildafter (ModulemdComponent *self)
 {
   g_return_if_fail (MODULEMD_IS_COMPONENT (self));
+  modulemd_component_invalidate (self);
 
   ModulemdComponentPrivate *priv =
     modulemd_component_get_instance_private (self);
@@ -296,6 +325,7 @@ void
 modulemd_component_set_buildonly (ModulemdComponent *self, gboolean buildonly)
 {
   g_return_if_fail (MODULEMD_IS_COMPONENT (self));
+  modulemd_component_invalidate (self);
 
   ModulemdComponentPrivate *priv =
     modulemd_component_get_instance_private (self);
@@ -322,6 +352,7 @@ void
 modulemd_component_set_buildorder (ModulemdComponent *self, gint64 buildorder)
 {
   g_return_if_fail (MODULEMD_IS_COMPONENT (self));
+  modulemd_component_invalidate (self);
 
   ModulemdComponentPrivate *priv =
     modulemd_component_get_instance_private (self);
@@ -350,6 +381,7 @@ modulemd_component_set_key (ModulemdComponent *self, const gchar *name)
   g_return_if_fail (MODULEMD_IS_COMPONENT (self));
   g_return_if_fail (name);
   g_return_if_fail (!g_str_equal (name, C_DEFAULT_STRING));
+  modulemd_component_invalidate (self);
 
   ModulemdComponentPrivate *priv =
     modulemd_component_get_instance_private (self);
@@ -404,6 +436,7 @@ modulemd_component_set_rationale (ModulemdComponent *self,
                                   const gchar *rationale)
 {
   g_return_if_fail (MODULEMD_IS_COMPONENT (self));
+  modulemd_component_invalidate (self);
 
   ModulemdComponentPrivate *priv =
     modulemd_component_get_instance_private (self);
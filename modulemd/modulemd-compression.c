@@ -15,6 +15,7 @@
 #include <fcntl.h>
 #include <glib.h>
 #include <inttypes.h>
+#include <string.h>
 #include <unistd.h>
 
 
@@ -22,6 +23,22 @@
 #include <rpm/rpmio.h>
 #endif
 
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HAVE_BZIP2
+#include <bzlib.h>
+#endif
+
+#ifdef HAVE_LZMA
+#include <lzma.h>
+#endif
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
 #include "modulemd-compression.h"
 #include "modulemd-errors.h"
 
@@ -34,6 +51,97 @@ G_DEFINE_AUTO_CLEANUP_FREE_FUNC (magic_t, magic_close, NULL)
 #endif
 
 
+/* How much of the start of a file to look at when sniffing its contents */
+#define MMD_SNIFF_SIZE 512
+
+/* The magic number at the start of each stream of a compression format */
+typedef struct
+{
+  ModulemdCompressionTypeEnum comtype;
+  const gchar *magic;
+  gsize magic_len;
+} mmd_compression_magic;
+
+static const mmd_compression_magic compression_magics[] = {
+  { MODULEMD_COMPRESSION_TYPE_GZ_COMPRESSION, "\x1f\x8b", 2 },
+  { MODULEMD_COMPRESSION_TYPE_BZ2_COMPRESSION, "BZh", 3 },
+  { MODULEMD_COMPRESSION_TYPE_XZ_COMPRESSION, "\xfd" "7zXZ\0", 6 },
+  { MODULEMD_COMPRESSION_TYPE_ZSTD_COMPRESSION, "\x28\xb5\x2f\xfd", 4 },
+  { MODULEMD_COMPRESSION_TYPE_SENTINEL, NULL, 0 }
+};
+
+
+static const mmd_compression_magic *
+get_compression_magic (ModulemdCompressionTypeEnum comtype)
+{
+  const mmd_compression_magic *magic;
+
+  for (magic = compression_magics;
+       magic->comtype != MODULEMD_COMPRESSION_TYPE_SENTINEL;
+       magic++)
+    {
+      if (magic->comtype == comtype)
+        {
+          return magic;
+        }
+    }
+
+  return NULL;
+}
+
+
+/*
+ * Identifies the compression of the file open at @fd from its first bytes,
+ * without moving its offset. Every supported compression format starts with
+ * a fixed magic number. Anything else that is valid UTF-8 without NUL bytes
+ * is taken to be uncompressed YAML.
+ */
+static ModulemdCompressionTypeEnum
+sniff_compression (int fd)
+{
+  guchar buf[MMD_SNIFF_SIZE];
+  const gchar *end = NULL;
+  const mmd_compression_magic *magic;
+  ssize_t len;
+
+  do
+    {
+      len = pread (fd, buf, sizeof (buf), 0);
+    }
+  while (len < 0 && errno == EINTR);
+
+  if (len <= 0)
+    {
+      return MODULEMD_COMPRESSION_TYPE_UNKNOWN_COMPRESSION;
+    }
+
+  for (magic = compression_magics;
+       magic->comtype != MODULEMD_COMPRESSION_TYPE_SENTINEL;
+       magic++)
+    {
+      if ((gsize)len >= magic->magic_len &&
+          memcmp (buf, magic->magic, magic->magic_len) == 0)
+        {
+          return magic->comtype;
+        }
+    }
+
+  if (memchr (buf, '\0', len) != NULL)
+    {
+      return MODULEMD_COMPRESSION_TYPE_UNKNOWN_COMPRESSION;
+    }
+
+  /* A full buffer may end in the middle of a multi-byte character */
+  if (g_utf8_validate ((const gchar *)buf, len, &end) ||
+      (len == sizeof (buf) && (const gchar *)buf + len - end < 4))
+    {
+      return MODULEMD_COMPRESSION_TYPE_NO_COMPRESSION;
+    }
+
+  return MODULEMD_COMPRESSION_TYPE_UNKNOWN_COMPRESSION;
+}
+
+
 ModulemdCompressionTypeEnum
 modulemd_detect_compression (const gchar *filename, int fd, GError **error)
 {
@@ -71,6 +179,11 @@ modulemd_detect_compression (const gchar *filename, int fd, GError **error)
     {
       return MODULEMD_COMPRESSION_TYPE_XZ_COMPRESSION;
     }
+  if (g_str_has_suffix (filename, ".zst") ||
+      g_str_has_suffix (filename, ".zstd"))
+    {
+      return MODULEMD_COMPRESSION_TYPE_ZSTD_COMPRESSION;
+    }
   if (g_str_has_suffix (filename, ".yaml") ||
       g_str_has_suffix (filename, ".yml") ||
       g_str_has_suffix (filename, ".txt"))
@@ -78,8 +191,15 @@ modulemd_detect_compression (const gchar *filename, int fd, GError **error)
       return MODULEMD_COMPRESSION_TYPE_NO_COMPRESSION;
     }
 
+  /* No known suffix? Look for the magic number of a supported format */
+  type = sniff_compression (fd);
+  if (type != MODULEMD_COMPRESSION_TYPE_UNKNOWN_COMPRESSION)
+    {
+      return type;
+    }
+
 #ifdef HAVE_LIBMAGIC
-  /* No known suffix? Try using libmagic from file-utils */
+  /* Still unknown? Try using libmagic from file-utils */
   const char *mime_type;
   g_auto (magic_t) magic = NULL;
   int magic_fd = fcntl (fd, F_DUPFD_CLOEXEC, 0);
@@ -152,6 +272,12 @@ modulemd_detect_compression (const gchar *filename, int fd, GError **error)
           type = MODULEMD_COMPRESSION_TYPE_XZ_COMPRESSION;
         }
 
+      else if (g_str_has_prefix (mime_type, "application/zstd") ||
+               g_str_has_prefix (mime_type, "application/x-zstd"))
+        {
+          type = MODULEMD_COMPRESSION_TYPE_ZSTD_COMPRESSION;
+        }
+
       else if (g_str_has_prefix (mime_type, "text/plain") ||
                g_str_has_prefix (mime_type, "text/x-yaml") ||
                g_str_has_prefix (mime_type, "application/x-yaml"))
@@ -202,6 +328,10 @@ modulemd_compression_type (const gchar *name)
     {
       type = MODULEMD_COMPRESSION_TYPE_ZCK_COMPRESSION;
     }
+  if (!g_strcmp0 (name, "zst") || !g_strcmp0 (name, "zstd"))
+    {
+      type = MODULEMD_COMPRESSION_TYPE_ZSTD_COMPRESSION;
+    }
 
   return type;
 }
@@ -214,6 +344,7 @@ modulemd_compression_suffix (ModulemdCompressionTypeEnum comtype)
     case MODULEMD_COMPRESSION_TYPE_GZ_COMPRESSION: return ".gz";
     case MODULEMD_COMPRESSION_TYPE_BZ2_COMPRESSION: return ".bz2";
     case MODULEMD_COMPRESSION_TYPE_XZ_COMPRESSION: return ".xz";
+    case MODULEMD_COMPRESSION_TYPE_ZSTD_COMPRESSION: return ".zst";
     default: return NULL;
     }
 }
@@ -235,6 +366,8 @@ get_comtype_string (ModulemdCompressionTypeEnum comtype)
 
     case MODULEMD_COMPRESSION_TYPE_XZ_COMPRESSION: return "xzdio"; break;
 
+    case MODULEMD_COMPRESSION_TYPE_ZSTD_COMPRESSION: return "zstdio"; break;
+
     default:
       g_info ("Unknown compression type: %d", comtype);
       return NULL;
@@ -306,3 +439,805 @@ mmd_Fclose (FD_t fd)
 }
 
 #endif
+
+
+/* The size and number of the buffers handed to the compression thread */
+#define MMD_COMPRESSED_WRITER_BLOCK_SIZE (64 * 1024)
+#define MMD_COMPRESSED_WRITER_BLOCKS 4
+
+struct _modulemd_compressed_writer
+{
+#ifdef HAVE_RPMIO
+  FD_t fd;
+#endif
+  GThread *thread;
+
+  /* Blocks of GByteArray cycle from @empty to @block to @full and back, so
+   * at most MMD_COMPRESSED_WRITER_BLOCKS of them are ever allocated. An empty
+   * block in @full tells the thread to stop.
+   */
+  GAsyncQueue *empty;
+  GAsyncQueue *full;
+  GByteArray *block;
+
+  /* Set by the compression thread */
+  gint failed;
+  GError *error;
+};
+
+
+static void
+modulemd_compressed_writer_free (modulemd_compressed_writer *writer)
+{
+#ifdef HAVE_RPMIO
+  g_clear_pointer (&writer->fd, mmd_Fclose);
+#endif
+  g_clear_pointer (&writer->block, g_byte_array_unref);
+  g_clear_pointer (&writer->empty, g_async_queue_unref);
+  g_clear_pointer (&writer->full, g_async_queue_unref);
+  g_clear_error (&writer->error);
+  g_free (writer);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (modulemd_compressed_writer,
+                               modulemd_compressed_writer_free);
+
+
+#ifdef HAVE_RPMIO
+static gpointer
+compressed_writer_thread (gpointer data)
+{
+  modulemd_compressed_writer *writer = (modulemd_compressed_writer *)data;
+  GByteArray *block = NULL;
+  gboolean done = FALSE;
+
+  while (!done)
+    {
+      block = g_async_queue_pop (writer->full);
+      done = block->len == 0;
+
+      /* Once a write has failed, keep returning blocks so that the emitter
+       * never waits forever.
+       */
+      if (!done && writer->error == NULL &&
+          Fwrite (block->data, 1, block->len, writer->fd) !=
+            (ssize_t)block->len)
+        {
+          g_set_error (&writer->error,
+                       MODULEMD_ERROR,
+                       MODULEMD_ERROR_FILE_ACCESS,
+                       "Error in rpmio::Fwrite(): %s",
+                       Fstrerror (writer->fd));
+          g_atomic_int_set (&writer->failed, TRUE);
+        }
+
+      g_byte_array_set_size (block, 0);
+      g_async_queue_push (writer->empty, block);
+    }
+
+  return NULL;
+}
+#endif
+
+
+modulemd_compressed_writer *
+modulemd_compressed_writer_new (const gchar *path,
+                                ModulemdCompressionTypeEnum comtype,
+                                gint level,
+                                GError **error)
+{
+#ifdef HAVE_RPMIO
+  g_autoptr (modulemd_compressed_writer) writer = NULL;
+  g_autofree gchar *mode = NULL;
+  g_autofree gchar *fmode = NULL;
+  guint i;
+
+  g_return_val_if_fail (path, NULL);
+  g_return_val_if_fail (level >= 0 && level <= 9, NULL);
+
+  mode = level ? g_strdup_printf ("w%d", level) : g_strdup ("w");
+  fmode = modulemd_get_rpmio_fmode (mode, comtype);
+  if (!fmode)
+    {
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_FILE_ACCESS,
+                   "Unable to construct rpmio fmode from comtype [%d]",
+                   comtype);
+      return NULL;
+    }
+
+  writer = g_new0 (modulemd_compressed_writer, 1);
+  writer->empty = g_async_queue_new_full ((GDestroyNotify)g_byte_array_unref);
+  writer->full = g_async_queue_new_full ((GDestroyNotify)g_byte_array_unref);
+  for (i = 0; i < MMD_COMPRESSED_WRITER_BLOCKS; i++)
+    {
+      g_async_queue_push (
+        writer->empty,
+        g_byte_array_sized_new (MMD_COMPRESSED_WRITER_BLOCK_SIZE));
+    }
+
+  g_debug ("Calling rpmio::Fopen (%s, %s)", path, fmode);
+  writer->fd = Fopen (path, fmode);
+  if (!writer->fd || Ferror (writer->fd))
+    {
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_FILE_ACCESS,
+                   "Cannot open %s for writing. Error in rpmio::Fopen(): %s",
+                   path,
+                   writer->fd ? Fstrerror (writer->fd) : g_strerror (errno));
+      return NULL;
+    }
+
+  writer->thread = g_thread_try_new (
+    "modulemd-compress", compressed_writer_thread, writer, error);
+  if (!writer->thread)
+    {
+      return NULL;
+    }
+
+  return g_steal_pointer (&writer);
+
+#else /* HAVE_RPMIO */
+  g_set_error_literal (error,
+                       MODULEMD_ERROR,
+                       MODULEMD_ERROR_NOT_IMPLEMENTED,
+                       "Cannot write compressed file. libmodulemd was not "
+                       "compiled with rpmio support.");
+  return NULL;
+#endif /* HAVE_RPMIO */
+}
+
+
+gint
+modulemd_compressed_writer_write_fn (void *data,
+                                     unsigned char *buffer,
+                                     size_t size)
+{
+  modulemd_compressed_writer *writer = (modulemd_compressed_writer *)data;
+  gsize chunk;
+
+  while (size > 0)
+    {
+      if (g_atomic_int_get (&writer->failed))
+        {
+          return 0;
+        }
+
+      if (writer->block == NULL)
+        {
+          writer->block = g_async_queue_pop (writer->empty);
+        }
+
+      chunk =
+        MIN (size, MMD_COMPRESSED_WRITER_BLOCK_SIZE - writer->block->len);
+      g_byte_array_append (writer->block, buffer, chunk);
+      buffer += chunk;
+      size -= chunk;
+
+      if (writer->block->len == MMD_COMPRESSED_WRITER_BLOCK_SIZE)
+        {
+          g_async_queue_push (writer->full, g_steal_pointer (&writer->block));
+        }
+    }
+
+  return 1;
+}
+
+
+gboolean
+modulemd_compressed_writer_close (modulemd_compressed_writer *writer,
+                                  GError **error)
+{
+  g_autoptr (modulemd_compressed_writer) owned = writer;
+
+#ifdef HAVE_RPMIO
+  if (writer->block != NULL && writer->block->len > 0)
+    {
+      g_async_queue_push (writer->full, g_steal_pointer (&writer->block));
+    }
+  if (writer->block == NULL)
+    {
+      writer->block = g_async_queue_pop (writer->empty);
+    }
+
+  /* Stop the thread with an empty block */
+  g_async_queue_push (writer->full, g_steal_pointer (&writer->block));
+  g_thread_join (g_steal_pointer (&writer->thread));
+
+  if (Fclose (g_steal_pointer (&writer->fd)) != 0 && writer->error == NULL)
+    {
+      g_set_error_literal (&writer->error,
+                           MODULEMD_ERROR,
+                           MODULEMD_ERROR_FILE_ACCESS,
+                           "Error in rpmio::Fclose()");
+    }
+#endif /* HAVE_RPMIO */
+
+  if (writer->error != NULL)
+    {
+      g_propagate_error (error, g_steal_pointer (&writer->error));
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+/* The amount of compressed data read from the file at a time */
+#define MMD_DECOMPRESSOR_BUFFER_SIZE (64 * 1024)
+
+typedef enum
+{
+  MMD_DECOMPRESS_OK,
+  MMD_DECOMPRESS_END,
+  MMD_DECOMPRESS_ERROR,
+} mmd_decompress_status;
+
+/*
+ * A decompression library wrapped for modulemd_decompressor. @step inflates
+ * as much of the pending input as fits into @out and returns
+ * MMD_DECOMPRESS_END once a complete compressed stream has been decoded.
+ */
+typedef struct
+{
+  ModulemdCompressionTypeEnum comtype;
+  gboolean (*init) (modulemd_decompressor *self, GError **error);
+  mmd_decompress_status (*step) (modulemd_decompressor *self,
+                                 guchar *out,
+                                 gsize out_len,
+                                 gsize *produced,
+                                 GError **error);
+  void (*end) (modulemd_decompressor *self);
+} mmd_decompressor_backend;
+
+struct _modulemd_decompressor
+{
+  const mmd_decompressor_backend *backend;
+  const mmd_compression_magic *magic;
+  int fd;
+
+  guchar buffer[MMD_DECOMPRESSOR_BUFFER_SIZE];
+  const guchar *in;
+  gsize in_len;
+
+  /* Whether the whole file has been read into @buffer */
+  gboolean eof;
+  /* Whether the backend is part of the way through a compressed stream */
+  gboolean in_stream;
+  /* Whether at least one compressed stream has been decoded completely */
+  gboolean after_stream;
+  gboolean finished;
+
+  union
+  {
+    gpointer unused;
+#ifdef HAVE_ZLIB
+    z_stream zlib;
+#endif
+#ifdef HAVE_BZIP2
+    bz_stream bzip2;
+#endif
+#ifdef HAVE_LZMA
+    lzma_stream lzma;
+#endif
+#ifdef HAVE_ZSTD
+    ZSTD_DStream *zstd;
+#endif
+  } state;
+
+  GError *error;
+};
+
+
+#ifdef HAVE_ZLIB
+static gboolean
+zlib_init (modulemd_decompressor *self, GError **error)
+{
+  memset (&self->state.zlib, 0, sizeof (self->state.zlib));
+
+  /* 32 enables gzip header detection */
+  if (inflateInit2 (&self->state.zlib, MAX_WBITS + 32) != Z_OK)
+    {
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_FILE_ACCESS,
+                   "Could not initialize zlib: %s",
+                   self->state.zlib.msg ? self->state.zlib.msg : "unknown");
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+static mmd_decompress_status
+zlib_step (modulemd_decompressor *self,
+           guchar *out,
+           gsize out_len,
+           gsize *produced,
+           GError **error)
+{
+  z_stream *stream = &self->state.zlib;
+  int ret;
+
+  stream->next_in = (Bytef *)self->in;
+  stream->avail_in = self->in_len;
+  stream->next_out = out;
+  stream->avail_out = MIN (out_len, G_MAXUINT);
+
+  ret = inflate (stream, Z_NO_FLUSH);
+
+  *produced = MIN (out_len, G_MAXUINT) - stream->avail_out;
+  self->in = stream->next_in;
+  self->in_len = stream->avail_in;
+
+  switch (ret)
+    {
+    case Z_OK:
+    case Z_BUF_ERROR: return MMD_DECOMPRESS_OK;
+    case Z_STREAM_END: return MMD_DECOMPRESS_END;
+    default:
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_FILE_ACCESS,
+                   "Could not decompress gzip data: %s",
+                   stream->msg ? stream->msg : "unknown error");
+      return MMD_DECOMPRESS_ERROR;
+    }
+}
+
+
+static void
+zlib_end (modulemd_decompressor *self)
+{
+  inflateEnd (&self->state.zlib);
+}
+#endif /* HAVE_ZLIB */
+
+
+#ifdef HAVE_BZIP2
+static gboolean
+bzip2_init (modulemd_decompressor *self, GError **error)
+{
+  int ret;
+
+  memset (&self->state.bzip2, 0, sizeof (self->state.bzip2));
+
+  ret = BZ2_bzDecompressInit (&self->state.bzip2, 0, 0);
+  if (ret != BZ_OK)
+    {
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_FILE_ACCESS,
+                   "Could not initialize bzip2: error %d",
+                   ret);
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+static mmd_decompress_status
+bzip2_step (modulemd_decompressor *self,
+            guchar *out,
+            gsize out_len,
+            gsize *produced,
+            GError **error)
+{
+  bz_stream *stream = &self->state.bzip2;
+  int ret;
+
+  stream->next_in = (char *)self->in;
+  stream->avail_in = self->in_len;
+  stream->next_out = (char *)out;
+  stream->avail_out = MIN (out_len, G_MAXUINT);
+
+  ret = BZ2_bzDecompress (stream);
+
+  *produced = MIN (out_len, G_MAXUINT) - stream->avail_out;
+  self->in = (const guchar *)stream->next_in;
+  self->in_len = stream->avail_in;
+
+  switch (ret)
+    {
+    case BZ_OK: return MMD_DECOMPRESS_OK;
+    case BZ_STREAM_END: return MMD_DECOMPRESS_END;
+    default:
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_FILE_ACCESS,
+                   "Could not decompress bzip2 data: error %d",
+                   ret);
+      return MMD_DECOMPRESS_ERROR;
+    }
+}
+
+
+static void
+bzip2_end (modulemd_decompressor *self)
+{
+  BZ2_bzDecompressEnd (&self->state.bzip2);
+}
+#endif /* HAVE_BZIP2 */
+
+
+#ifdef HAVE_LZMA
+static gboolean
+xz_init (modulemd_decompressor *self, GError **error)
+{
+  lzma_stream stream = LZMA_STREAM_INIT;
+  lzma_ret ret;
+
+  self->state.lzma = stream;
+
+  ret = lzma_stream_decoder (&self->state.lzma, UINT64_MAX, 0);
+  if (ret != LZMA_OK)
+    {
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_FILE_ACCESS,
+                   "Could not initialize liblzma: error %d",
+                   ret);
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+static mmd_decompress_status
+xz_step (modulemd_decompressor *self,
+         guchar *out,
+         gsize out_len,
+         gsize *produced,
+         GError **error)
+{
+  lzma_stream *stream = &self->state.lzma;
+  lzma_ret ret;
+
+  stream->next_in = self->in;
+  stream->avail_in = self->in_len;
+  stream->next_out = out;
+  stream->avail_out = out_len;
+
+  ret = lzma_code (stream, LZMA_RUN);
+
+  *produced = out_len - stream->avail_out;
+  self->in = stream->next_in;
+  self->in_len = stream->avail_in;
+
+  switch (ret)
+    {
+    case LZMA_OK:
+    case LZMA_BUF_ERROR: return MMD_DECOMPRESS_OK;
+    case LZMA_STREAM_END: return MMD_DECOMPRESS_END;
+    default:
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_FILE_ACCESS,
+                   "Could not decompress xz data: error %d",
+                   ret);
+      return MMD_DECOMPRESS_ERROR;
+    }
+}
+
+
+static void
+xz_end (modulemd_decompressor *self)
+{
+  lzma_end (&self->state.lzma);
+}
+#endif /* HAVE_LZMA */
+
+
+#ifdef HAVE_ZSTD
+static gboolean
+zstd_init (modulemd_decompressor *self, GError **error)
+{
+  self->state.zstd = ZSTD_createDStream ();
+  if (self->state.zstd == NULL ||
+      ZSTD_isError (ZSTD_initDStream (self->state.zstd)))
+    {
+      g_set_error_literal (error,
+                           MODULEMD_ERROR,
+                           MODULEMD_ERROR_FILE_ACCESS,
+                           "Could not initialize libzstd");
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+static mmd_decompress_status
+zstd_step (modulemd_decompressor *self,
+           guchar *out,
+           gsize out_len,
+           gsize *produced,
+           GError **error)
+{
+  ZSTD_inBuffer input = { self->in, self->in_len, 0 };
+  ZSTD_outBuffer output = { out, out_len, 0 };
+  size_t ret;
+
+  ret = ZSTD_decompressStream (self->state.zstd, &output, &input);
+
+  *produced = output.pos;
+  self->in += input.pos;
+  self->in_len -= input.pos;
+
+  if (ZSTD_isError (ret))
+    {
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_FILE_ACCESS,
+                   "Could not decompress zstd data: %s",
+                   ZSTD_getErrorName (ret));
+      return MMD_DECOMPRESS_ERROR;
+    }
+
+  /* Zero means that a complete frame has been decoded and flushed */
+  return ret == 0 ? MMD_DECOMPRESS_END : MMD_DECOMPRESS_OK;
+}
+
+
+static void
+zstd_end (modulemd_decompressor *self)
+{
+  g_clear_pointer (&self->state.zstd, ZSTD_freeDStream);
+}
+#endif /* HAVE_ZSTD */
+
+
+static const mmd_decompressor_backend decompressor_backends[] = {
+#ifdef HAVE_ZLIB
+  { MODULEMD_COMPRESSION_TYPE_GZ_COMPRESSION, zlib_init, zlib_step, zlib_end },
+#endif
+#ifdef HAVE_BZIP2
+  { MODULEMD_COMPRESSION_TYPE_BZ2_COMPRESSION,
+    bzip2_init,
+    bzip2_step,
+    bzip2_end },
+#endif
+#ifdef HAVE_LZMA
+  { MODULEMD_COMPRESSION_TYPE_XZ_COMPRESSION, xz_init, xz_step, xz_end },
+#endif
+#ifdef HAVE_ZSTD
+  { MODULEMD_COMPRESSION_TYPE_ZSTD_COMPRESSION,
+    zstd_init,
+    zstd_step,
+    zstd_end },
+#endif
+  { MODULEMD_COMPRESSION_TYPE_SENTINEL, NULL, NULL, NULL }
+};
+
+
+void
+modulemd_decompressor_free (modulemd_decompressor *self)
+{
+  if (self == NULL)
+    {
+      return;
+    }
+
+  if (self->backend != NULL)
+    {
+      self->backend->end (self);
+    }
+  g_clear_error (&self->error);
+  g_free (self);
+}
+
+
+modulemd_decompressor *
+modulemd_decompressor_new (ModulemdCompressionTypeEnum comtype,
+                           int fd,
+                           GError **error)
+{
+  g_autoptr (modulemd_decompressor) self = NULL;
+  const mmd_decompressor_backend *backend;
+
+  for (backend = decompressor_backends;
+       backend->comtype != MODULEMD_COMPRESSION_TYPE_SENTINEL;
+       backend++)
+    {
+      if (backend->comtype == comtype)
+        {
+          break;
+        }
+    }
+
+  if (backend->comtype == MODULEMD_COMPRESSION_TYPE_SENTINEL)
+    {
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_NOT_IMPLEMENTED,
+                   "No built-in decompressor for compression type [%d]",
+                   comtype);
+      return NULL;
+    }
+
+  self = g_new0 (modulemd_decompressor, 1);
+  self->magic = get_compression_magic (comtype);
+  self->fd = fd;
+  self->in = self->buffer;
+
+  if (!backend->init (self, error))
+    {
+      return NULL;
+    }
+  self->backend = backend;
+
+  return g_steal_pointer (&self);
+}
+
+
+/*
+ * Reads more of the file into @buffer after any input that has not been
+ * consumed yet.
+ */
+static gboolean
+decompressor_fill (modulemd_decompressor *self)
+{
+  ssize_t len;
+
+  memmove (self->buffer, self->in, self->in_len);
+  self->in = self->buffer;
+
+  do
+    {
+      len = read (self->fd,
+                  self->buffer + self->in_len,
+                  sizeof (self->buffer) - self->in_len);
+    }
+  while (len < 0 && errno == EINTR);
+
+  if (len < 0)
+    {
+      g_set_error (&self->error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_FILE_ACCESS,
+                   "Could not read compressed file: %s",
+                   g_strerror (errno));
+      return FALSE;
+    }
+
+  self->in_len += len;
+  self->eof = len == 0;
+
+  return TRUE;
+}
+
+
+/*
+ * Skips the zero bytes that may pad the end of a compressed stream and
+ * checks whether another stream follows. As with gzip and xz, anything else
+ * after the last stream is ignored.
+ *
+ * Returns: TRUE if another compressed stream follows. FALSE if the
+ * compressed data is over or sets @error if the file could not be read.
+ */
+static gboolean
+decompressor_next_stream_follows (modulemd_decompressor *self)
+{
+  while (TRUE)
+    {
+      while (self->in_len > 0 && self->in[0] == '\0')
+        {
+          self->in++;
+          self->in_len--;
+        }
+
+      if (self->in_len >= self->magic->magic_len || self->eof)
+        {
+          break;
+        }
+
+      if (!decompressor_fill (self))
+        {
+          return FALSE;
+        }
+    }
+
+  if (self->in_len == 0)
+    {
+      return FALSE;
+    }
+
+  if (self->in_len < self->magic->magic_len ||
+      memcmp (self->in, self->magic->magic, self->magic->magic_len) != 0)
+    {
+      g_debug ("Ignoring trailing data after the compressed data");
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+gint
+modulemd_decompressor_read_fn (void *data,
+                               unsigned char *buffer,
+                               size_t size,
+                               size_t *size_read)
+{
+  modulemd_decompressor *self = (modulemd_decompressor *)data;
+  mmd_decompress_status status;
+  gsize produced = 0;
+
+  if (self->error != NULL)
+    {
+      return 0;
+    }
+
+  while (produced == 0 && !self->finished)
+    {
+      if (self->in_len == 0 && !self->eof && !decompressor_fill (self))
+        {
+          return 0;
+        }
+
+      if (!self->in_stream && self->after_stream &&
+          !decompressor_next_stream_follows (self))
+        {
+          if (self->error != NULL)
+            {
+              return 0;
+            }
+          self->finished = TRUE;
+          break;
+        }
+
+      if (self->in_len == 0 && self->eof && !self->in_stream)
+        {
+          self->finished = TRUE;
+          break;
+        }
+
+      status =
+        self->backend->step (self, buffer, size, &produced, &self->error);
+      if (status == MMD_DECOMPRESS_ERROR)
+        {
+          return 0;
+        }
+
+      if (status == MMD_DECOMPRESS_END)
+        {
+          /* Start over in case another stream was concatenated to this one,
+           * as gzip and friends allow.
+           */
+          self->in_stream = FALSE;
+          self->after_stream = TRUE;
+          self->backend->end (self);
+          if (!self->backend->init (self, &self->error))
+            {
+              self->backend = NULL;
+              return 0;
+            }
+          continue;
+        }
+
+      self->in_stream = TRUE;
+      if (produced == 0 && self->in_len == 0 && self->eof)
+        {
+          g_set_error_literal (&self->error,
+                               MODULEMD_ERROR,
+                               MODULEMD_ERROR_FILE_ACCESS,
+                               "Compressed data ended unexpectedly");
+          return 0;
+        }
+    }
+
+  *size_read = produced;
+  return 1;
+}
+
+
+const GError *
+modulemd_decompressor_get_error (modulemd_decompressor *self)
+{
+  return self->error;
+}
@@ -190,6 +190,7 @@ modulemd_defaults_v1_set_default_stream (ModulemdDefaultsV1 *self,
                                          const gchar *intent)
 {
   g_return_if_fail (MODULEMD_IS_DEFAULTS_V1 (self));
+  modulemd_defaults_invalidate (MODULEMD_DEFAULTS (self));
 
   if (default_stream)
     {
@@ -332,6 +333,7 @@ modulemd_defaults_v1_add_or_clear_default_profile_for_stream (
   g_autoptr (GHashTable) profiles = NULL;
   g_return_if_fail (MODULEMD_IS_DEFAULTS_V1 (self));
   g_return_if_fail (stream_name);
+  modulemd_defaults_invalidate (MODULEMD_DEFAULTS (self));
 
 
   profile_table = g_hash_table_ref (
@@ -405,6 +407,7 @@ modulemd_defaults_v1_remove_default_profiles_for_stream (
 
   g_return_if_fail (MODULEMD_IS_DEFAULTS_V1 (self));
   g_return_if_fail (stream_name);
+  modulemd_defaults_invalidate (MODULEMD_DEFAULTS (self));
 
   profile_table = g_hash_table_ref (
     modulemd_defaults_v1_get_or_create_profile_table (self, intent));
@@ -537,14 +540,7 @@ modulemd_defaults_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                  gboolean strict,
                                  GError **error)
 {
-  MODULEMD_INIT_TRACE ();
   MMD_INIT_YAML_PARSER (parser);
-  MMD_INIT_YAML_EVENT (event);
-  g_autoptr (GError) nested_error = FALSE;
-  ModulemdDefaultsV1 *defaults = NULL;
-  gboolean done = FALSE;
-  g_autofree gchar *scalar = NULL;
-  guint64 modified;
 
   g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
@@ -555,6 +551,25 @@ modulemd_defaults_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
       return NULL;
     }
 
+  return modulemd_defaults_v1_parse_yaml_data (&parser, strict, error);
+}
+
+
+ModulemdDefaultsV1 *
+modulemd_defaults_v1_parse_yaml_data (yaml_parser_t *parser,
+                                      gboolean strict,
+                                      GError **error)
+{
+  MODULEMD_INIT_TRACE ();
+  MMD_INIT_YAML_EVENT (event);
+  g_autoptr (GError) nested_error = FALSE;
+  ModulemdDefaultsV1 *defaults = NULL;
+  gboolean done = FALSE;
+  g_autofree gchar *scalar = NULL;
+  guint64 modified;
+
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
   /* Create a module with a placeholder name. We'll verify that this has been
    * changed before we return it. This is because we can't guarantee that we
    * will get the module name from the YAML before reading any of the other
@@ -563,7 +578,7 @@ modulemd_defaults_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
    */
   defaults = modulemd_defaults_v1_new (DEFAULT_PLACEHOLDER);
 
-  YAML_PARSER_PARSE_WITH_EXIT (&parser, &event, error);
+  YAML_PARSER_PARSE_WITH_EXIT (parser, &event, error);
   if (event.type != YAML_MAPPING_START_EVENT)
     {
       MMD_YAML_ERROR_EVENT_EXIT (
@@ -572,7 +587,7 @@ modulemd_defaults_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
 
   while (!done)
     {
-      YAML_PARSER_PARSE_WITH_EXIT (&parser, &event, error);
+      YAML_PARSER_PARSE_WITH_EXIT (parser, &event, error);
       switch (event.type)
         {
         case YAML_MAPPING_END_EVENT: done = TRUE; break;
@@ -591,7 +606,7 @@ modulemd_defaults_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                     error, event, "Module name encountered twice.");
                 }
 
-              scalar = modulemd_yaml_parse_string (&parser, &nested_error);
+              scalar = modulemd_yaml_parse_string (parser, &nested_error);
               if (!scalar)
                 {
                   MMD_YAML_ERROR_EVENT_EXIT (
@@ -611,7 +626,7 @@ modulemd_defaults_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
             }
           else if (g_str_equal (event.data.scalar.value, "modified"))
             {
-              modified = modulemd_yaml_parse_uint64 (&parser, &nested_error);
+              modified = modulemd_yaml_parse_uint64 (parser, &nested_error);
               if (nested_error)
                 {
                   MMD_YAML_ERROR_EVENT_EXIT (
@@ -636,7 +651,7 @@ modulemd_defaults_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                     error, event, "Default stream encountered twice.");
                 }
 
-              scalar = modulemd_yaml_parse_string (&parser, &nested_error);
+              scalar = modulemd_yaml_parse_string (parser, &nested_error);
               if (!scalar)
                 {
                   MMD_YAML_ERROR_EVENT_EXIT (
@@ -651,7 +666,7 @@ modulemd_defaults_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
           else if (g_str_equal (event.data.scalar.value, "profiles"))
             {
               if (!modulemd_defaults_v1_parse_yaml_profiles (
-                    &parser, defaults->profile_defaults, &nested_error))
+                    parser, defaults->profile_defaults, &nested_error))
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return NULL;
@@ -660,7 +675,7 @@ modulemd_defaults_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
           else if (g_str_equal (event.data.scalar.value, "intents"))
             {
               if (!modulemd_defaults_v1_parse_intents (
-                    &parser, defaults, strict, &nested_error))
+                    parser, defaults, strict, &nested_error))
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return NULL;
@@ -668,7 +683,7 @@ modulemd_defaults_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
             }
           else
             {
-              SKIP_UNKNOWN (&parser,
+              SKIP_UNKNOWN (parser,
                             NULL,
                             "Unexpected key in defaults data: %s",
                             (const gchar *)event.data.scalar.value);
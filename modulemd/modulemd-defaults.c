@@ -26,6 +26,12 @@ typedef struct
 {
   gchar *module_name;
   guint64 modified;
+
+  /* Increased by every method that modifies these defaults. It starts at one
+   * so that a validated_generation of zero means "never validated".
+   */
+  guint64 generation;
+  guint64 validated_generation;
 } ModulemdDefaultsPrivate;
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (ModulemdDefaults,
@@ -129,6 +135,7 @@ ModulemdDefaults *
 modulemd_defaults_copy (ModulemdDefaults *self)
 {
   ModulemdDefaultsClass *klass;
+  ModulemdDefaults *copy = NULL;
 
   if (!self)
     {
@@ -140,7 +147,23 @@ modulemd_defaults_copy (ModulemdDefaults *self)
   klass = MODULEMD_DEFAULTS_GET_CLASS (self);
   g_return_val_if_fail (klass->copy, NULL);
 
-  return klass->copy (self);
+  copy = klass->copy (self);
+
+  /* A copy of defaults that are known to be valid is valid as well */
+  if (copy != NULL)
+    {
+      ModulemdDefaultsPrivate *priv =
+        modulemd_defaults_get_instance_private (self);
+      ModulemdDefaultsPrivate *copy_priv =
+        modulemd_defaults_get_instance_private (copy);
+
+      if (priv->validated_generation == priv->generation)
+        {
+          copy_priv->validated_generation = copy_priv->generation;
+        }
+    }
+
+  return copy;
 }
 
 
@@ -170,10 +193,37 @@ modulemd_defaults_validate (ModulemdDefaults *self, GError **error)
 
   g_return_val_if_fail (MODULEMD_IS_DEFAULTS (self), FALSE);
 
+  ModulemdDefaultsPrivate *priv =
+    modulemd_defaults_get_instance_private (self);
+
+  /* Nothing has changed since these defaults last passed validation */
+  if (priv->validated_generation == priv->generation)
+    {
+      return TRUE;
+    }
+
   klass = MODULEMD_DEFAULTS_GET_CLASS (self);
   g_return_val_if_fail (klass->validate, FALSE);
 
-  return klass->validate (self, error);
+  if (!klass->validate (self, error))
+    {
+      return FALSE;
+    }
+
+  priv->validated_generation = priv->generation;
+  return TRUE;
+}
+
+
+void
+modulemd_defaults_invalidate (ModulemdDefaults *self)
+{
+  g_return_if_fail (MODULEMD_IS_DEFAULTS (self));
+
+  ModulemdDefaultsPrivate *priv =
+    modulemd_defaults_get_instance_private (self);
+
+  priv->generation++;
 }
 
 
@@ -275,6 +325,7 @@ void
 modulemd_defaults_set_modified (ModulemdDefaults *self, guint64 modified)
 {
   g_return_if_fail (MODULEMD_IS_DEFAULTS (self));
+  modulemd_defaults_invalidate (self);
 
   ModulemdDefaultsPrivate *priv =
     modulemd_defaults_get_instance_private (self);
@@ -306,6 +357,8 @@ modulemd_defaults_set_module_name (ModulemdDefaults *self,
   /* It is a coding error if we ever get the default name here */
   g_return_if_fail (g_strcmp0 (module_name, DEF_DEFAULT_NAME_STRING));
 
+  modulemd_defaults_invalidate (self);
+
   ModulemdDefaultsPrivate *priv =
     modulemd_defaults_get_instance_private (self);
 
@@ -402,6 +455,10 @@ modulemd_defaults_class_init (ModulemdDefaultsClass *klass)
 static void
 modulemd_defaults_init (ModulemdDefaults *self)
 {
+  ModulemdDefaultsPrivate *priv =
+    modulemd_defaults_get_instance_private (self);
+
+  priv->generation = 1;
 }
 
 
@@ -452,5 +509,8 @@ modulemd_defaults_merge (ModulemdDefaults *from,
       return NULL;
     }
 
+  /* The merge fills in the tables of the copy directly */
+  modulemd_defaults_invalidate (merged_defaults);
+
   return g_steal_pointer (&merged_defaults);
 }
@@ -12,6 +12,7 @@
  */
 
 #include <glib.h>
+#include <string.h>
 #include <yaml.h>
 
 #include "modulemd-dependencies.h"
@@ -21,6 +22,40 @@
 #include "private/modulemd-util.h"
 #include "private/modulemd-yaml.h"
 
+/*
+ * The streams of one module required by a #ModulemdDependencies object.
+ */
+typedef struct
+{
+  const gchar *module_name;
+
+  /* The set of streams is empty, which means "all streams" */
+  gboolean all_streams;
+
+  /* The set of streams lists the streams that are *not* required */
+  gboolean negated;
+
+  /* The sorted stream names, as a range of modulemd_dependency_matcher's
+   * @streams.
+   */
+  guint first_stream;
+  guint n_streams;
+} modulemd_dependency_rule;
+
+
+/*
+ * A compiled, read-only form of a table of required module streams that
+ * can be matched against without allocating memory. The strings are
+ * borrowed from the table it was compiled from.
+ */
+typedef struct
+{
+  guint n_rules;
+  modulemd_dependency_rule *rules; /* Sorted by module name */
+  const gchar **streams;
+} modulemd_dependency_matcher;
+
+
 struct _ModulemdDependencies
 {
   GObject parent_instance;
@@ -34,6 +69,20 @@ struct _ModulemdDependencies
    * @value: #GHashTable set of compatible streams
    */
   GHashTable *runtime_deps;
+
+  /* Increased by every method that modifies this object */
+  guint64 generation;
+
+  /* Set by modulemd_dependencies_copy() on both objects, which then share
+   * the tables above until one of them is modified.
+   */
+  gboolean tables_shared;
+
+  /* Compiled forms of the tables above, created on first use by
+   * get_matcher() and dropped whenever the tables are modified.
+   */
+  modulemd_dependency_matcher *buildtime_matcher;
+  modulemd_dependency_matcher *runtime_matcher;
 };
 
 G_DEFINE_TYPE (ModulemdDependencies, modulemd_dependencies, G_TYPE_OBJECT)
@@ -92,16 +141,33 @@ modulemd_dependencies_copy (ModulemdDependencies *self)
   d->buildtime_deps = g_hash_table_ref (self->buildtime_deps);
   g_hash_table_unref (d->runtime_deps);
   d->runtime_deps = g_hash_table_ref (self->runtime_deps);
+  d->tables_shared = self->tables_shared = TRUE;
 
   return g_steal_pointer (&d);
 }
 
 
+static void
+modulemd_dependency_matcher_free (modulemd_dependency_matcher *matcher)
+{
+  if (matcher == NULL)
+    {
+      return;
+    }
+
+  g_free (matcher->rules);
+  g_free (matcher->streams);
+  g_free (matcher);
+}
+
+
 static void
 modulemd_dependencies_finalize (GObject *object)
 {
   ModulemdDependencies *self = (ModulemdDependencies *)object;
 
+  g_clear_pointer (&self->buildtime_matcher, modulemd_dependency_matcher_free);
+  g_clear_pointer (&self->runtime_matcher, modulemd_dependency_matcher_free);
   g_clear_pointer (&self->buildtime_deps, g_hash_table_unref);
   g_clear_pointer (&self->runtime_deps, g_hash_table_unref);
 
@@ -161,6 +227,64 @@ modulemd_dependencies_nested_table_values_as_strv (GHashTable *table,
 }
 
 
+static GHashTable *
+modulemd_dependencies_nested_table_copy (GHashTable *table)
+{
+  GHashTable *copy = NULL;
+  GHashTable *inner = NULL;
+  GHashTableIter iter;
+  GHashTableIter inner_iter;
+  gpointer key;
+  gpointer value;
+
+  copy = g_hash_table_new_full (
+    g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_hash_table_destroy);
+
+  g_hash_table_iter_init (&iter, table);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      inner = modulemd_dependencies_nested_table_get_or_create (copy, key);
+      g_hash_table_iter_init (&inner_iter, value);
+      while (g_hash_table_iter_next (&inner_iter, &key, NULL))
+        {
+          g_hash_table_add (inner, g_strdup (key));
+        }
+    }
+
+  return copy;
+}
+
+
+/*
+ * Must be called before any of the tables of @self is modified.
+ */
+static void
+modulemd_dependencies_prepare_modify (ModulemdDependencies *self)
+{
+  GHashTable *table = NULL;
+
+  self->generation++;
+  g_clear_pointer (&self->buildtime_matcher, modulemd_dependency_matcher_free);
+  g_clear_pointer (&self->runtime_matcher, modulemd_dependency_matcher_free);
+
+  if (!self->tables_shared)
+    {
+      return;
+    }
+
+  /* Stop sharing the tables with copies of @self */
+  table = modulemd_dependencies_nested_table_copy (self->buildtime_deps);
+  g_hash_table_unref (self->buildtime_deps);
+  self->buildtime_deps = table;
+
+  table = modulemd_dependencies_nested_table_copy (self->runtime_deps);
+  g_hash_table_unref (self->runtime_deps);
+  self->runtime_deps = table;
+
+  self->tables_shared = FALSE;
+}
+
+
 void
 modulemd_dependencies_add_buildtime_stream (ModulemdDependencies *self,
                                             const gchar *module_name,
@@ -169,6 +293,7 @@ modulemd_dependencies_add_buildtime_stream (ModulemdDependencies *self,
   g_return_if_fail (MODULEMD_IS_DEPENDENCIES (self));
   g_return_if_fail (module_name);
   g_return_if_fail (module_stream);
+  modulemd_dependencies_prepare_modify (self);
   modulemd_dependencies_nested_table_add (
     self->buildtime_deps, module_name, module_stream);
 }
@@ -180,6 +305,7 @@ modulemd_dependencies_set_empty_buildtime_dependencies_for_module (
 {
   g_return_if_fail (MODULEMD_IS_DEPENDENCIES (self));
   g_return_if_fail (module_name);
+  modulemd_dependencies_prepare_modify (self);
   modulemd_dependencies_nested_table_add (
     self->buildtime_deps, module_name, NULL);
 }
@@ -189,6 +315,7 @@ void
 modulemd_dependencies_clear_buildtime_dependencies (ModulemdDependencies *self)
 {
   g_return_if_fail (MODULEMD_IS_DEPENDENCIES (self));
+  modulemd_dependencies_prepare_modify (self);
   g_hash_table_remove_all (self->buildtime_deps);
 }
 
@@ -220,6 +347,7 @@ modulemd_dependencies_add_runtime_stream (ModulemdDependencies *self,
   g_return_if_fail (MODULEMD_IS_DEPENDENCIES (self));
   g_return_if_fail (module_name);
   g_return_if_fail (module_stream);
+  modulemd_dependencies_prepare_modify (self);
   modulemd_dependencies_nested_table_add (
     self->runtime_deps, module_name, module_stream);
 }
@@ -231,6 +359,7 @@ modulemd_dependencies_set_empty_runtime_dependencies_for_module (
 {
   g_return_if_fail (MODULEMD_IS_DEPENDENCIES (self));
   g_return_if_fail (module_name);
+  modulemd_dependencies_prepare_modify (self);
   modulemd_dependencies_nested_table_add (
     self->runtime_deps, module_name, NULL);
 }
@@ -240,6 +369,7 @@ void
 modulemd_dependencies_clear_runtime_dependencies (ModulemdDependencies *self)
 {
   g_return_if_fail (MODULEMD_IS_DEPENDENCIES (self));
+  modulemd_dependencies_prepare_modify (self);
   g_hash_table_remove_all (self->runtime_deps);
 }
 
@@ -322,6 +452,15 @@ modulemd_dependencies_validate_deps (GHashTable *deps, GError **error)
 }
 
 
+guint64
+modulemd_dependencies_get_generation (ModulemdDependencies *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_DEPENDENCIES (self), 0);
+
+  return self->generation;
+}
+
+
 gboolean
 modulemd_dependencies_validate (ModulemdDependencies *self, GError **error)
 {
@@ -678,67 +817,212 @@ modulemd_dependencies_emit_yaml (ModulemdDependencies *self,
 }
 
 
-static gboolean
-requires_module_and_stream (GHashTable *modules,
-                            const gchar *module_name,
-                            const gchar *stream_name)
+static modulemd_dependency_matcher *
+modulemd_dependency_matcher_new (GHashTable *table)
 {
+  g_autoptr (GPtrArray) module_names = NULL;
+  g_autoptr (GPtrArray) stream_names = NULL;
+  modulemd_dependency_matcher *matcher = NULL;
+  modulemd_dependency_rule *rule = NULL;
   GHashTable *streams = NULL;
   GHashTableIter iter;
   gpointer key;
-  gpointer value;
-  g_autofree gchar *negated = NULL;
+  guint n_streams = 0;
+  guint next_stream = 0;
 
-  streams = g_hash_table_lookup (modules, module_name);
-  /* If the module doesn't appear at all, return false */
-  if (!streams)
+  g_hash_table_iter_init (&iter, table);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&streams))
     {
-      return FALSE;
+      n_streams += g_hash_table_size (streams);
     }
 
-  /* Check whether this module is the empty set (which means "all streams") */
-  if (g_hash_table_size (streams) == 0)
+  module_names = modulemd_ordered_str_keys (table, modulemd_strcmp_sort);
+
+  matcher = g_new0 (modulemd_dependency_matcher, 1);
+  matcher->n_rules = module_names->len;
+  matcher->rules = g_new0 (modulemd_dependency_rule, module_names->len);
+  matcher->streams = g_new0 (const gchar *, n_streams);
+
+  for (guint i = 0; i < module_names->len; i++)
     {
-      return TRUE;
+      rule = &matcher->rules[i];
+
+      /* Borrow the strings owned by @table instead of the sorted copies */
+      g_hash_table_lookup_extended (table,
+                                    g_ptr_array_index (module_names, i),
+                                    &key,
+                                    (gpointer *)&streams);
+      rule->module_name = key;
+
+      rule->all_streams = g_hash_table_size (streams) == 0;
+      rule->first_stream = next_stream;
+      rule->n_streams = g_hash_table_size (streams);
+
+      stream_names = modulemd_ordered_str_keys (streams, modulemd_strcmp_sort);
+      for (guint j = 0; j < stream_names->len; j++)
+        {
+          key = g_ptr_array_index (stream_names, j);
+          g_hash_table_lookup_extended (streams, key, &key, NULL);
+          matcher->streams[next_stream++] = key;
+
+          /* Validation ensures that either all or none of the streams are
+           * negated.
+           */
+          if (((const gchar *)key)[0] == '-')
+            {
+              rule->negated = TRUE;
+            }
+        }
+      g_clear_pointer (&stream_names, g_ptr_array_unref);
     }
 
-  /* Check whether it includes the stream name explicitly */
-  if (g_hash_table_contains (streams, stream_name))
+  return matcher;
+}
+
+
+/*
+ * Returns: The compiled form of the build-time or run-time dependencies of
+ * @self, creating it if needed. It is safe to call from several threads at
+ * once as long as @self is not being modified.
+ */
+static modulemd_dependency_matcher *
+get_matcher (ModulemdDependencies *self, gboolean buildtime)
+{
+  modulemd_dependency_matcher **location =
+    buildtime ? &self->buildtime_matcher : &self->runtime_matcher;
+  modulemd_dependency_matcher *matcher = g_atomic_pointer_get (location);
+
+  if (matcher != NULL)
     {
-      return TRUE;
+      return matcher;
     }
 
+  matcher = modulemd_dependency_matcher_new (buildtime ? self->buildtime_deps
+                                                       : self->runtime_deps);
+  if (!g_atomic_pointer_compare_and_exchange (location, NULL, matcher))
+    {
+      /* Another thread got there first */
+      modulemd_dependency_matcher_free (matcher);
+      matcher = g_atomic_pointer_get (location);
+    }
 
-  /* Get the first item from the table and check if it's a negation */
-  negated = g_strdup_printf ("-%s", stream_name);
+  return matcher;
+}
 
-  g_hash_table_iter_init (&iter, streams);
 
-  /* We already checked that this hash table is not empty, so if iterating it
-   * fails, something has gone horribly wrong. Wrap this in a
-   * g_return_val_if_fail() to make static analysis happy.
-   */
-  g_return_val_if_fail (g_hash_table_iter_next (&iter, &key, &value), FALSE);
+/*
+ * Compares @name with @prefix followed by @suffix, as strcmp() would if they
+ * were concatenated.
+ */
+static gint
+compare_prefixed (const gchar *name, gchar prefix, const gchar *suffix)
+{
+  if (prefix != '\0')
+    {
+      if (name[0] != prefix)
+        {
+          return (guchar)name[0] - (guchar)prefix;
+        }
+      name++;
+    }
+
+  return strcmp (name, suffix);
+}
 
-  /* If we have a negative value for any entry, they all must be negative.
-   * Check whether we're explicitly excluding the requested stream */
-  if (((const gchar *)key)[0] == '-' &&
-      (!g_hash_table_contains (streams, negated)))
+
+static gboolean
+rule_has_stream (modulemd_dependency_matcher *matcher,
+                 modulemd_dependency_rule *rule,
+                 gchar prefix,
+                 const gchar *stream_name)
+{
+  guint low = rule->first_stream;
+  guint high = rule->first_stream + rule->n_streams;
+  guint middle;
+  gint cmp;
+
+  while (low < high)
     {
-      return TRUE;
+      middle = low + (high - low) / 2;
+      cmp = compare_prefixed (matcher->streams[middle], prefix, stream_name);
+      if (cmp == 0)
+        {
+          return TRUE;
+        }
+      if (cmp < 0)
+        {
+          low = middle + 1;
+        }
+      else
+        {
+          high = middle;
+        }
     }
 
   return FALSE;
 }
 
 
+static gboolean
+requires_module_and_stream (modulemd_dependency_matcher *matcher,
+                            const gchar *module_name,
+                            const gchar *stream_name)
+{
+  modulemd_dependency_rule *rule = NULL;
+  guint low = 0;
+  guint high = matcher->n_rules;
+  guint middle;
+  gint cmp;
+
+  while (low < high)
+    {
+      middle = low + (high - low) / 2;
+      cmp = strcmp (matcher->rules[middle].module_name, module_name);
+      if (cmp == 0)
+        {
+          rule = &matcher->rules[middle];
+          break;
+        }
+      if (cmp < 0)
+        {
+          low = middle + 1;
+        }
+      else
+        {
+          high = middle;
+        }
+    }
+
+  /* If the module doesn't appear at all, return false */
+  if (rule == NULL)
+    {
+      return FALSE;
+    }
+
+  /* An empty set means "all streams" */
+  if (rule->all_streams)
+    {
+      return TRUE;
+    }
+
+  /* Check whether it includes the stream name explicitly */
+  if (rule_has_stream (matcher, rule, '\0', stream_name))
+    {
+      return TRUE;
+    }
+
+  /* Otherwise, a negated set requires every stream it does not exclude */
+  return rule->negated && !rule_has_stream (matcher, rule, '-', stream_name);
+}
+
+
 gboolean
 modulemd_dependencies_requires_module_and_stream (ModulemdDependencies *self,
                                                   const gchar *module_name,
                                                   const gchar *stream_name)
 {
   return requires_module_and_stream (
-    self->runtime_deps, module_name, stream_name);
+    get_matcher (self, FALSE), module_name, stream_name);
 }
 
 
@@ -749,5 +1033,5 @@ modulemd_dependencies_buildrequires_module_and_stream (
   const gchar *stream_name)
 {
   return requires_module_and_stream (
-    self->buildtime_deps, module_name, stream_name);
+    get_matcher (self, TRUE), module_name, stream_name);
 }
@@ -0,0 +1,768 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2020 Red Hat, Inc.
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#include <glib.h>
+
+#include "modulemd-dependencies.h"
+#include "modulemd-dependency-graph.h"
+#include "modulemd-errors.h"
+#include "modulemd-module-stream-v1.h"
+#include "modulemd-module-stream-v2.h"
+#include "modulemd-module.h"
+#include "private/modulemd-module-private.h"
+#include "private/modulemd-util.h"
+
+
+struct _ModulemdDependencyGraph
+{
+  GObject parent_instance;
+
+  /* The nodes of the graph, holding a reference to each stream. Streams are
+   * referred to elsewhere by their position in this list.
+   */
+  GPtrArray *streams;
+
+  /* Stream to its position in @streams plus one */
+  GHashTable *positions;
+
+  /* For each position, a sorted #GArray of the positions of the streams
+   * required by that stream at run time and at build time.
+   */
+  GPtrArray *requires;
+  GPtrArray *buildrequires;
+};
+
+G_DEFINE_TYPE (ModulemdDependencyGraph,
+               modulemd_dependency_graph,
+               G_TYPE_OBJECT)
+
+
+/* The positions of the streams of one module in the graph */
+typedef struct
+{
+  guint first;
+  guint count;
+} modulemd_module_range;
+
+
+static void
+modulemd_dependency_graph_finalize (GObject *object)
+{
+  ModulemdDependencyGraph *self = (ModulemdDependencyGraph *)object;
+
+  g_clear_pointer (&self->streams, g_ptr_array_unref);
+  g_clear_pointer (&self->positions, g_hash_table_unref);
+  g_clear_pointer (&self->requires, g_ptr_array_unref);
+  g_clear_pointer (&self->buildrequires, g_ptr_array_unref);
+
+  G_OBJECT_CLASS (modulemd_dependency_graph_parent_class)->finalize (object);
+}
+
+
+static void
+modulemd_dependency_graph_class_init (ModulemdDependencyGraphClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = modulemd_dependency_graph_finalize;
+}
+
+
+static void
+modulemd_dependency_graph_init (ModulemdDependencyGraph *self)
+{
+  self->streams = g_ptr_array_new_with_free_func (g_object_unref);
+  self->positions = g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->requires =
+    g_ptr_array_new_with_free_func ((GDestroyNotify)g_array_unref);
+  self->buildrequires =
+    g_ptr_array_new_with_free_func ((GDestroyNotify)g_array_unref);
+}
+
+
+static gint
+compare_positions (gconstpointer a, gconstpointer b)
+{
+  guint a_ = *(const guint *)a;
+  guint b_ = *(const guint *)b;
+
+  return (a_ > b_) - (a_ < b_);
+}
+
+
+/*
+ * Returns: (transfer full): The sorted names of the modules that @stream
+ * requires at run time or, if @buildtime is TRUE, at build time in any of its
+ * dependencies.
+ */
+static GStrv
+get_required_modules (ModulemdModuleStream *stream, gboolean buildtime)
+{
+  g_autoptr (GHashTable) modules = NULL;
+  GPtrArray *deps = NULL;
+  ModulemdDependencies *dep = NULL;
+
+  switch (modulemd_module_stream_get_mdversion (stream))
+    {
+    case MD_MODULESTREAM_VERSION_ONE:
+      if (buildtime)
+        {
+          return modulemd_module_stream_v1_get_buildtime_modules_as_strv (
+            MODULEMD_MODULE_STREAM_V1 (stream));
+        }
+      return modulemd_module_stream_v1_get_runtime_modules_as_strv (
+        MODULEMD_MODULE_STREAM_V1 (stream));
+
+    case MD_MODULESTREAM_VERSION_TWO:
+      modules = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+      deps = modulemd_module_stream_v2_get_dependencies (
+        MODULEMD_MODULE_STREAM_V2 (stream));
+      for (guint i = 0; i < deps->len; i++)
+        {
+          g_auto (GStrv) names = NULL;
+
+          dep = g_ptr_array_index (deps, i);
+          if (buildtime)
+            {
+              names =
+                modulemd_dependencies_get_buildtime_modules_as_strv (dep);
+            }
+          else
+            {
+              names = modulemd_dependencies_get_runtime_modules_as_strv (dep);
+            }
+
+          for (guint j = 0; names[j]; j++)
+            {
+              g_hash_table_add (modules, g_strdup (names[j]));
+            }
+        }
+      return modulemd_ordered_str_keys_as_strv (modules);
+
+    default: return NULL;
+    }
+}
+
+
+/*
+ * Returns: (transfer full): The sorted positions of the streams required by
+ * the stream at @position, at run time or, if @buildtime is TRUE, at build
+ * time.
+ */
+static GArray *
+find_requirements (ModulemdDependencyGraph *self,
+                   GHashTable *ranges,
+                   guint position,
+                   gboolean buildtime)
+{
+  ModulemdModuleStream *stream = g_ptr_array_index (self->streams, position);
+  g_auto (GStrv) modules = get_required_modules (stream, buildtime);
+  GArray *edges = g_array_new (FALSE, FALSE, sizeof (guint));
+  modulemd_module_range *range = NULL;
+  const gchar *stream_name = NULL;
+  const gchar *last_name = NULL;
+  gboolean required = FALSE;
+
+  for (guint i = 0; modules && modules[i]; i++)
+    {
+      range = g_hash_table_lookup (ranges, modules[i]);
+      if (range == NULL)
+        {
+          continue;
+        }
+
+      /* The streams of a module are sorted by stream name and whether they
+       * are required depends on nothing else.
+       */
+      last_name = NULL;
+      for (guint j = range->first; j < range->first + range->count; j++)
+        {
+          stream_name = modulemd_module_stream_get_stream_name (
+            g_ptr_array_index (self->streams, j));
+          if (last_name == NULL || !g_str_equal (stream_name, last_name))
+            {
+              last_name = stream_name;
+              required =
+                buildtime ? modulemd_module_stream_build_depends_on_stream (
+                              stream, modules[i], stream_name)
+                          : modulemd_module_stream_depends_on_stream (
+                              stream, modules[i], stream_name);
+            }
+
+          if (required && j != position)
+            {
+              g_array_append_val (edges, j);
+            }
+        }
+    }
+
+  g_array_sort (edges, compare_positions);
+  return edges;
+}
+
+
+ModulemdDependencyGraph *
+modulemd_dependency_graph_new (ModulemdModuleIndex *index)
+{
+  g_autoptr (ModulemdDependencyGraph) self = NULL;
+  g_autoptr (GHashTable) ranges = NULL;
+  g_auto (GStrv) module_names = NULL;
+  g_autoptr (GPtrArray) sorted = NULL;
+  modulemd_module_range *range = NULL;
+  ModulemdModule *module = NULL;
+  GPtrArray *streams = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (index), NULL);
+
+  self = g_object_new (MODULEMD_TYPE_DEPENDENCY_GRAPH, NULL);
+  ranges = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+  module_names = modulemd_module_index_get_module_names_as_strv (index);
+  for (guint i = 0; module_names[i]; i++)
+    {
+      module = modulemd_module_index_get_module (index, module_names[i]);
+      streams = modulemd_module_get_all_streams (module);
+
+      sorted = g_ptr_array_sized_new (streams->len);
+      for (guint j = 0; j < streams->len; j++)
+        {
+          g_ptr_array_add (sorted, g_ptr_array_index (streams, j));
+        }
+      g_ptr_array_sort (sorted, modulemd_module_compare_streams);
+
+      range = g_new0 (modulemd_module_range, 1);
+      range->first = self->streams->len;
+      range->count = sorted->len;
+      g_hash_table_insert (ranges, g_strdup (module_names[i]), range);
+
+      for (guint j = 0; j < sorted->len; j++)
+        {
+          g_hash_table_insert (self->positions,
+                               g_ptr_array_index (sorted, j),
+                               GUINT_TO_POINTER (self->streams->len + 1));
+          g_ptr_array_add (self->streams,
+                           g_object_ref (g_ptr_array_index (sorted, j)));
+        }
+      g_clear_pointer (&sorted, g_ptr_array_unref);
+    }
+
+  for (guint i = 0; i < self->streams->len; i++)
+    {
+      g_ptr_array_add (self->requires,
+                       find_requirements (self, ranges, i, FALSE));
+      g_ptr_array_add (self->buildrequires,
+                       find_requirements (self, ranges, i, TRUE));
+    }
+
+  return g_steal_pointer (&self);
+}
+
+
+GPtrArray *
+modulemd_dependency_graph_get_streams (ModulemdDependencyGraph *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_DEPENDENCY_GRAPH (self), NULL);
+
+  return self->streams;
+}
+
+
+static gboolean
+get_position (ModulemdDependencyGraph *self,
+              ModulemdModuleStream *stream,
+              guint *position)
+{
+  guint stored =
+    GPOINTER_TO_UINT (g_hash_table_lookup (self->positions, stream));
+
+  if (stored == 0)
+    {
+      return FALSE;
+    }
+
+  *position = stored - 1;
+  return TRUE;
+}
+
+
+/*
+ * Returns: (transfer full): The sorted positions of the streams required by
+ * the stream at @position under @type, without duplicates.
+ */
+static GArray *
+get_edges (ModulemdDependencyGraph *self,
+           guint position,
+           ModulemdDependencyTypeEnum type)
+{
+  GArray *runtime = g_ptr_array_index (self->requires, position);
+  GArray *buildtime = g_ptr_array_index (self->buildrequires, position);
+  GArray *edges = g_array_new (FALSE, FALSE, sizeof (guint));
+  guint a = 0;
+  guint b = 0;
+  guint a_len = (type & MODULEMD_DEPENDENCY_TYPE_RUNTIME) ? runtime->len : 0;
+  guint b_len =
+    (type & MODULEMD_DEPENDENCY_TYPE_BUILDTIME) ? buildtime->len : 0;
+  guint next;
+
+  /* Merge the two sorted lists */
+  while (a < a_len || b < b_len)
+    {
+      if (b == b_len || (a < a_len && g_array_index (runtime, guint, a) <=
+                                        g_array_index (buildtime, guint, b)))
+        {
+          next = g_array_index (runtime, guint, a++);
+        }
+      else
+        {
+          next = g_array_index (buildtime, guint, b++);
+        }
+
+      if (edges->len == 0 ||
+          g_array_index (edges, guint, edges->len - 1) != next)
+        {
+          g_array_append_val (edges, next);
+        }
+    }
+
+  return edges;
+}
+
+
+static GPtrArray *
+get_all_edges (ModulemdDependencyGraph *self, ModulemdDependencyTypeEnum type)
+{
+  GPtrArray *all_edges =
+    g_ptr_array_new_with_free_func ((GDestroyNotify)g_array_unref);
+
+  for (guint i = 0; i < self->streams->len; i++)
+    {
+      g_ptr_array_add (all_edges, get_edges (self, i, type));
+    }
+
+  return all_edges;
+}
+
+
+static GPtrArray *
+positions_to_streams (ModulemdDependencyGraph *self, GArray *positions)
+{
+  GPtrArray *streams = g_ptr_array_sized_new (positions->len);
+
+  for (guint i = 0; i < positions->len; i++)
+    {
+      guint position = g_array_index (positions, guint, i);
+
+      g_ptr_array_add (streams, g_ptr_array_index (self->streams, position));
+    }
+
+  return streams;
+}
+
+
+GPtrArray *
+modulemd_dependency_graph_get_requirements (ModulemdDependencyGraph *self,
+                                            ModulemdModuleStream *stream,
+                                            ModulemdDependencyTypeEnum type)
+{
+  g_autoptr (GArray) edges = NULL;
+  guint position;
+
+  g_return_val_if_fail (MODULEMD_IS_DEPENDENCY_GRAPH (self), NULL);
+  g_return_val_if_fail (MODULEMD_IS_MODULE_STREAM (stream), NULL);
+
+  if (!get_position (self, stream, &position))
+    {
+      return g_ptr_array_new ();
+    }
+
+  edges = get_edges (self, position, type);
+  return positions_to_streams (self, edges);
+}
+
+
+GPtrArray *
+modulemd_dependency_graph_get_transitive_requirements (
+  ModulemdDependencyGraph *self,
+  ModulemdModuleStream *stream,
+  ModulemdDependencyTypeEnum type)
+{
+  g_autofree gboolean *reached = NULL;
+  g_autoptr (GArray) pending = NULL;
+  g_autoptr (GArray) edges = NULL;
+  GPtrArray *requirements = NULL;
+  guint position;
+  guint current;
+  guint next;
+
+  g_return_val_if_fail (MODULEMD_IS_DEPENDENCY_GRAPH (self), NULL);
+  g_return_val_if_fail (MODULEMD_IS_MODULE_STREAM (stream), NULL);
+
+  requirements = g_ptr_array_new ();
+  if (!get_position (self, stream, &position))
+    {
+      return requirements;
+    }
+
+  reached = g_new0 (gboolean, self->streams->len);
+  pending = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  /* Start from the direct requirements of @stream. Past those, only the
+   * run-time requirements of the streams reached are followed, unless both
+   * kinds were asked for.
+   */
+  edges = get_edges (self, position, type);
+  if (type != MODULEMD_DEPENDENCY_TYPE_ALL)
+    {
+      type = MODULEMD_DEPENDENCY_TYPE_RUNTIME;
+    }
+
+  while (TRUE)
+    {
+      for (guint i = 0; i < edges->len; i++)
+        {
+          next = g_array_index (edges, guint, i);
+          if (!reached[next])
+            {
+              reached[next] = TRUE;
+              g_array_append_val (pending, next);
+            }
+        }
+      g_clear_pointer (&edges, g_array_unref);
+
+      if (pending->len == 0)
+        {
+          break;
+        }
+
+      current = g_array_index (pending, guint, pending->len - 1);
+      g_array_set_size (pending, pending->len - 1);
+      edges = get_edges (self, current, type);
+    }
+
+  for (guint i = 0; i < self->streams->len; i++)
+    {
+      if (reached[i] && i != position)
+        {
+          g_ptr_array_add (requirements, g_ptr_array_index (self->streams, i));
+        }
+    }
+
+  return requirements;
+}
+
+
+/*
+ * Finds the strongly connected components of the graph formed by @all_edges
+ * with Tarjan's algorithm, without recursion.
+ *
+ * Returns: (transfer full): A #GPtrArray of the sorted #GArray of positions
+ * of each component with more than one stream, sorted by their first
+ * position.
+ */
+static GPtrArray *
+find_cycles (ModulemdDependencyGraph *self, GPtrArray *all_edges)
+{
+  typedef struct
+  {
+    guint node;
+    guint next_edge;
+  } frame;
+
+  guint n = self->streams->len;
+  g_autofree gint *order = g_new (gint, n);
+  g_autofree gint *lowest = g_new (gint, n);
+  g_autofree gboolean *on_stack = g_new0 (gboolean, n);
+  g_autoptr (GArray) stack = g_array_new (FALSE, FALSE, sizeof (guint));
+  g_autoptr (GArray) calls = g_array_new (FALSE, FALSE, sizeof (frame));
+  GPtrArray *cycles =
+    g_ptr_array_new_with_free_func ((GDestroyNotify)g_array_unref);
+  GArray *component = NULL;
+  GArray *edges = NULL;
+  frame *current = NULL;
+  frame start;
+  gint counter = 0;
+  guint node;
+  guint target;
+  guint member;
+
+  for (guint i = 0; i < n; i++)
+    {
+      order[i] = -1;
+    }
+
+  for (guint root = 0; root < n; root++)
+    {
+      if (order[root] != -1)
+        {
+          continue;
+        }
+
+      start.node = root;
+      start.next_edge = 0;
+      g_array_append_val (calls, start);
+      order[root] = lowest[root] = counter++;
+      g_array_append_val (stack, root);
+      on_stack[root] = TRUE;
+
+      while (calls->len > 0)
+        {
+          current = &g_array_index (calls, frame, calls->len - 1);
+          node = current->node;
+          edges = g_ptr_array_index (all_edges, node);
+
+          if (current->next_edge < edges->len)
+            {
+              target = g_array_index (edges, guint, current->next_edge++);
+              if (order[target] == -1)
+                {
+                  start.node = target;
+                  start.next_edge = 0;
+                  g_array_append_val (calls, start);
+                  order[target] = lowest[target] = counter++;
+                  g_array_append_val (stack, target);
+                  on_stack[target] = TRUE;
+                }
+              else if (on_stack[target])
+                {
+                  lowest[node] = MIN (lowest[node], order[target]);
+                }
+              continue;
+            }
+
+          g_array_set_size (calls, calls->len - 1);
+          if (calls->len > 0)
+            {
+              target = g_array_index (calls, frame, calls->len - 1).node;
+              lowest[target] = MIN (lowest[target], lowest[node]);
+            }
+
+          if (lowest[node] != order[node])
+            {
+              continue;
+            }
+
+          component = g_array_new (FALSE, FALSE, sizeof (guint));
+          do
+            {
+              member = g_array_index (stack, guint, stack->len - 1);
+              g_array_set_size (stack, stack->len - 1);
+              on_stack[member] = FALSE;
+              g_array_append_val (component, member);
+            }
+          while (member != node);
+
+          if (component->len < 2)
+            {
+              g_array_unref (component);
+              continue;
+            }
+
+          g_array_sort (component, compare_positions);
+          g_ptr_array_add (cycles, component);
+        }
+    }
+
+  return cycles;
+}
+
+
+static gint
+compare_cycles (gconstpointer a, gconstpointer b)
+{
+  GArray *a_ = *(GArray **)a;
+  GArray *b_ = *(GArray **)b;
+
+  return compare_positions (a_->data, b_->data);
+}
+
+
+GPtrArray *
+modulemd_dependency_graph_get_cycles (ModulemdDependencyGraph *self,
+                                      ModulemdDependencyTypeEnum type)
+{
+  g_autoptr (GPtrArray) all_edges = NULL;
+  g_autoptr (GPtrArray) found = NULL;
+  GPtrArray *cycles = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_DEPENDENCY_GRAPH (self), NULL);
+
+  all_edges = get_all_edges (self, type);
+  found = find_cycles (self, all_edges);
+  g_ptr_array_sort (found, compare_cycles);
+
+  cycles = g_ptr_array_new_with_free_func ((GDestroyNotify)g_ptr_array_unref);
+  for (guint i = 0; i < found->len; i++)
+    {
+      g_ptr_array_add (
+        cycles, positions_to_streams (self, g_ptr_array_index (found, i)));
+    }
+
+  return cycles;
+}
+
+
+/*
+ * A binary min-heap of positions in a #GArray of guint, so that the ready
+ * stream earliest in the graph is always taken next.
+ */
+static void
+heap_push (GArray *heap, guint value)
+{
+  guint i = heap->len;
+  guint parent;
+
+  g_array_append_val (heap, value);
+  while (i > 0)
+    {
+      parent = (i - 1) / 2;
+      if (g_array_index (heap, guint, parent) <= value)
+        {
+          break;
+        }
+      g_array_index (heap, guint, i) = g_array_index (heap, guint, parent);
+      i = parent;
+    }
+  g_array_index (heap, guint, i) = value;
+}
+
+
+static guint
+heap_pop (GArray *heap)
+{
+  guint top = g_array_index (heap, guint, 0);
+  guint last = g_array_index (heap, guint, heap->len - 1);
+  guint len = heap->len - 1;
+  guint i = 0;
+  guint child;
+
+  g_array_set_size (heap, len);
+  if (len == 0)
+    {
+      return top;
+    }
+
+  while ((child = 2 * i + 1) < len)
+    {
+      if (child + 1 < len && g_array_index (heap, guint, child + 1) <
+                               g_array_index (heap, guint, child))
+        {
+          child++;
+        }
+      if (last <= g_array_index (heap, guint, child))
+        {
+          break;
+        }
+      g_array_index (heap, guint, i) = g_array_index (heap, guint, child);
+      i = child;
+    }
+  g_array_index (heap, guint, i) = last;
+
+  return top;
+}
+
+
+GPtrArray *
+modulemd_dependency_graph_get_topological_order (
+  ModulemdDependencyGraph *self,
+  ModulemdDependencyTypeEnum type,
+  GError **error)
+{
+  g_autoptr (GPtrArray) all_edges = NULL;
+  g_autoptr (GPtrArray) dependents = NULL;
+  g_autoptr (GPtrArray) cycles = NULL;
+  g_autoptr (GPtrArray) order = NULL;
+  g_autoptr (GArray) ready = NULL;
+  g_autoptr (GString) members = NULL;
+  g_autofree guint *pending = NULL;
+  g_autofree gchar *nsvca = NULL;
+  GArray *edges = NULL;
+  GArray *cycle = NULL;
+  guint n;
+  guint current;
+  guint next;
+
+  g_return_val_if_fail (MODULEMD_IS_DEPENDENCY_GRAPH (self), NULL);
+
+  n = self->streams->len;
+  all_edges = get_all_edges (self, type);
+  pending = g_new0 (guint, n);
+  dependents = g_ptr_array_new_with_free_func ((GDestroyNotify)g_array_unref);
+  for (guint i = 0; i < n; i++)
+    {
+      g_ptr_array_add (dependents, g_array_new (FALSE, FALSE, sizeof (guint)));
+    }
+
+  for (guint i = 0; i < n; i++)
+    {
+      edges = g_ptr_array_index (all_edges, i);
+      pending[i] = edges->len;
+      for (guint j = 0; j < edges->len; j++)
+        {
+          guint dependency = g_array_index (edges, guint, j);
+
+          g_array_append_val (g_ptr_array_index (dependents, dependency), i);
+        }
+    }
+
+  ready = g_array_new (FALSE, FALSE, sizeof (guint));
+  for (guint i = 0; i < n; i++)
+    {
+      if (pending[i] == 0)
+        {
+          heap_push (ready, i);
+        }
+    }
+
+  order = g_ptr_array_sized_new (n);
+  while (ready->len > 0)
+    {
+      current = heap_pop (ready);
+      g_ptr_array_add (order, g_ptr_array_index (self->streams, current));
+
+      edges = g_ptr_array_index (dependents, current);
+      for (guint j = 0; j < edges->len; j++)
+        {
+          next = g_array_index (edges, guint, j);
+          if (--pending[next] == 0)
+            {
+              heap_push (ready, next);
+            }
+        }
+    }
+
+  if (order->len == n)
+    {
+      return g_steal_pointer (&order);
+    }
+
+  /* Name the streams of one of the cycles that blocked the rest */
+  cycles = find_cycles (self, all_edges);
+  g_ptr_array_sort (cycles, compare_cycles);
+  cycle = g_ptr_array_index (cycles, 0);
+
+  members = g_string_new (NULL);
+  for (guint i = 0; i < cycle->len; i++)
+    {
+      nsvca = modulemd_module_stream_get_NSVCA_as_string (g_ptr_array_index (
+        self->streams, g_array_index (cycle, guint, i)));
+      g_string_append_printf (members, "%s%s", i ? ", " : "", nsvca);
+      g_clear_pointer (&nsvca, g_free);
+    }
+
+  g_set_error (error,
+               MODULEMD_ERROR,
+               MODULEMD_ERROR_VALIDATE,
+               "Module stream dependencies contain a cycle: %s",
+               members->str);
+  return NULL;
+}
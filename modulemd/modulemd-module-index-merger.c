@@ -217,8 +217,11 @@ modulemd_module_index_merger_resolve_ext (ModulemdModuleIndexMerger *self,
         }
 
 
-      /* Merge 'thislevel' into 'final' with override=True */
-      if (!modulemd_module_index_merge (
+      /* Merge 'thislevel' into 'final' with override=True. The streams in
+       * 'thislevel' are private copies already, so they are moved over
+       * rather than copied a second time.
+       */
+      if (!modulemd_module_index_merge_adopting_streams (
             thislevel, final, TRUE, strict_default_streams, &nested_error))
         {
           g_propagate_error (error, g_steal_pointer (&nested_error));
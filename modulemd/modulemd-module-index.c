@@ -15,6 +15,8 @@
 #include <glib.h>
 #include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <yaml.h>
 
 #ifdef HAVE_RPMIO
@@ -51,6 +53,45 @@ struct _ModulemdModuleIndex
 
   ModulemdDefaultsVersionEnum defaults_mdversion;
   ModulemdModuleStreamVersionEnum stream_mdversion;
+
+  guint parse_threads;
+  guint emit_threads;
+  gboolean lazy_streams;
+  gchar *cache_dir;
+
+  /* Incremented whenever a module is added to or removed from @modules */
+  guint64 modules_serial;
+
+  /* The pool that the streams of this index intern their strings in, which
+   * is also the arena for the headers of its lazy streams. It is freed with
+   * the index, since modules that outlive the index copy their strings out
+   * of it first.
+   */
+  modulemd_string_pool *strings;
+
+  /* Reverse lookup tables from the RPM artifacts, components and module
+   * requirements of streams to the streams, brought up to date by
+   * update_reverse_index() before use. The streams are borrowed from
+   * @modules.
+   */
+  GHashTable *rpms_by_nevra;
+  GHashTable *rpms_by_name;
+  GHashTable *rpms_by_name_arch;
+  GHashTable *components_by_name;
+  GHashTable *components_by_repository;
+  GHashTable *components_by_source; /* Repository and ref */
+  GHashTable *requirers_by_stream; /* "module:stream" */
+  GHashTable *requirers_of_all_streams; /* Module name */
+  GHashTable *requirers_excluding_streams; /* Module name */
+  GHashTable *buildrequirers_by_stream;
+  GHashTable *buildrequirers_of_all_streams;
+  GHashTable *buildrequirers_excluding_streams;
+
+  /* Module name to the modulemd_filed_module for the entries added to the
+   * tables above for that module.
+   */
+  GHashTable *filed_modules;
+  guint64 filed_modules_serial;
 };
 
 G_DEFINE_TYPE (ModulemdModuleIndex, modulemd_module_index, G_TYPE_OBJECT)
@@ -68,7 +109,23 @@ modulemd_module_index_finalize (GObject *object)
 {
   ModulemdModuleIndex *self = (ModulemdModuleIndex *)object;
 
+  g_clear_pointer (&self->filed_modules, g_hash_table_unref);
   g_clear_pointer (&self->modules, g_hash_table_unref);
+  g_clear_pointer (&self->cache_dir, g_free);
+  g_clear_pointer (&self->rpms_by_nevra, g_hash_table_unref);
+  g_clear_pointer (&self->rpms_by_name, g_hash_table_unref);
+  g_clear_pointer (&self->rpms_by_name_arch, g_hash_table_unref);
+  g_clear_pointer (&self->components_by_name, g_hash_table_unref);
+  g_clear_pointer (&self->components_by_repository, g_hash_table_unref);
+  g_clear_pointer (&self->components_by_source, g_hash_table_unref);
+  g_clear_pointer (&self->requirers_by_stream, g_hash_table_unref);
+  g_clear_pointer (&self->requirers_of_all_streams, g_hash_table_unref);
+  g_clear_pointer (&self->requirers_excluding_streams, g_hash_table_unref);
+  g_clear_pointer (&self->buildrequirers_by_stream, g_hash_table_unref);
+  g_clear_pointer (&self->buildrequirers_of_all_streams, g_hash_table_unref);
+  g_clear_pointer (&self->buildrequirers_excluding_streams,
+                   g_hash_table_unref);
+  g_clear_pointer (&self->strings, modulemd_string_pool_unref);
 
   G_OBJECT_CLASS (modulemd_module_index_parent_class)->finalize (object);
 }
@@ -110,11 +167,29 @@ modulemd_module_index_class_init (ModulemdModuleIndexClass *klass)
 }
 
 
+/*
+ * Drops the reference of the index to @module, which stops using the arena of
+ * the index first if it is still referenced elsewhere.
+ */
+static void
+release_module (gpointer module)
+{
+  if (G_OBJECT (module)->ref_count > 1)
+    {
+      modulemd_module_set_string_pool (MODULEMD_MODULE (module), NULL);
+    }
+  g_object_unref (module);
+}
+
+
 static void
 modulemd_module_index_init (ModulemdModuleIndex *self)
 {
   self->modules =
-    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
+    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, release_module);
+  self->parse_threads = 1;
+  self->emit_threads = 1;
+  self->strings = modulemd_string_pool_new ();
 }
 
 
@@ -125,344 +200,509 @@ get_or_create_module (ModulemdModuleIndex *self, const gchar *module_name)
   if (module == NULL)
     {
       module = modulemd_module_new (module_name);
+      modulemd_module_set_string_pool (module, self->strings);
       g_hash_table_insert (self->modules, g_strdup (module_name), module);
+      self->modules_serial++;
     }
   return module;
 }
 
 
-static gboolean
-add_subdoc (ModulemdModuleIndex *self,
-            ModulemdSubdocumentInfo *subdoc,
-            gboolean strict,
-            gboolean autogen_module_name,
-            GError **error)
+/*
+ * Reads the data section of a subdocument from @parser with the parser
+ * matching @doctype and @mdversion.
+ *
+ * Returns: (transfer full): The #ModulemdModuleStream, #ModulemdDefaults or
+ * #ModulemdTranslation that was read, or NULL and sets @error.
+ */
+static GObject *
+parse_subdoc_data (yaml_parser_t *parser,
+                   ModulemdYamlDocumentTypeEnum doctype,
+                   guint64 mdversion,
+                   gboolean strict,
+                   GError **error)
 {
-  g_autoptr (GError) nested_error = NULL;
-  g_autoptr (ModulemdModuleStream) stream = NULL;
-  g_autoptr (ModulemdTranslation) translation = NULL;
-  g_autoptr (ModulemdDefaults) defaults = NULL;
-  g_autofree gchar *name = NULL;
-
-  switch (modulemd_subdocument_info_get_doctype (subdoc))
+  switch (doctype)
     {
     case MODULEMD_YAML_DOC_MODULESTREAM:
-      switch (modulemd_subdocument_info_get_mdversion (subdoc))
+      switch (mdversion)
         {
         case MD_MODULESTREAM_VERSION_ONE:
-          stream = MODULEMD_MODULE_STREAM (
-            modulemd_module_stream_v1_parse_yaml (subdoc, strict, error));
-          break;
+          return (GObject *)modulemd_module_stream_v1_parse_yaml_data (
+            parser, strict, error);
 
         case MD_MODULESTREAM_VERSION_TWO:
-          stream =
-            (ModulemdModuleStream *)modulemd_module_stream_v2_parse_yaml (
-              subdoc, strict, error);
-          break;
+          return (GObject *)modulemd_module_stream_v2_parse_yaml_data (
+            parser, strict, error);
 
         default:
           g_set_error (error,
                        MODULEMD_YAML_ERROR,
                        MODULEMD_YAML_ERROR_PARSE,
                        "Invalid mdversion for a stream object");
-          return FALSE;
-        }
-
-      if (stream == NULL)
-        {
-          return FALSE;
+          return NULL;
         }
 
-      if (autogen_module_name &&
-          !modulemd_module_stream_get_module_name (stream))
-        {
-          name = g_strdup_printf ("__unnamed_module_%d",
-                                  g_hash_table_size (self->modules) + 1);
-          modulemd_module_stream_set_module_name (stream, name);
-          g_clear_pointer (&name, g_free);
-        }
-
-      if (autogen_module_name &&
-          !modulemd_module_stream_get_stream_name (stream))
-        {
-          name = g_strdup_printf ("__unnamed_stream_%d",
-                                  g_hash_table_size (self->modules) + 1);
-          modulemd_module_stream_set_stream_name (stream, name);
-          g_clear_pointer (&name, g_free);
-        }
-
-      if (!modulemd_module_stream_validate (stream, &nested_error))
-        {
-          g_propagate_error (error, g_steal_pointer (&nested_error));
-          return FALSE;
-        }
-
-      if (!modulemd_module_index_add_module_stream (self, stream, error))
-        {
-          return FALSE;
-        }
-
-      break;
-
     case MODULEMD_YAML_DOC_DEFAULTS:
-      switch (modulemd_subdocument_info_get_mdversion (subdoc))
+      switch (mdversion)
         {
         case MD_DEFAULTS_VERSION_ONE:
-          defaults = (ModulemdDefaults *)modulemd_defaults_v1_parse_yaml (
-            subdoc, strict, error);
-          if (defaults == NULL)
-            {
-              return FALSE;
-            }
-
-          if (!modulemd_defaults_validate (defaults, &nested_error))
-            {
-              g_propagate_error (error, g_steal_pointer (&nested_error));
-              return FALSE;
-            }
-
-          if (!modulemd_module_index_add_defaults (self, defaults, error))
-            {
-              return FALSE;
-            }
-          break;
+          return (GObject *)modulemd_defaults_v1_parse_yaml_data (
+            parser, strict, error);
 
         default:
           g_set_error (error,
                        MODULEMD_YAML_ERROR,
                        MODULEMD_YAML_ERROR_PARSE,
                        "Invalid mdversion for a defaults object");
-          return FALSE;
+          return NULL;
         }
-      break;
 
     case MODULEMD_YAML_DOC_TRANSLATIONS:
-      translation = modulemd_translation_parse_yaml (subdoc, strict, error);
-      if (translation == NULL)
-        {
-          return FALSE;
-        }
-
-      if (!modulemd_translation_validate (translation, &nested_error))
-        {
-          g_propagate_error (error, g_steal_pointer (&nested_error));
-          return FALSE;
-        }
-
-      if (!modulemd_module_index_add_translation (self, translation, error))
-        {
-          return FALSE;
-        }
-      break;
+      return (GObject *)modulemd_translation_parse_yaml_data (
+        parser, mdversion, strict, error);
 
     default:
       g_set_error (error,
                    MODULEMD_YAML_ERROR,
                    MODULEMD_YAML_ERROR_PARSE,
                    "Invalid doctype encountered");
-      return FALSE;
+      return NULL;
     }
-
-  return TRUE;
 }
 
 
-gboolean
-modulemd_module_index_update_from_parser (ModulemdModuleIndex *self,
-                                          yaml_parser_t *parser,
-                                          gboolean strict,
-                                          gboolean autogen_module_name,
-                                          GPtrArray **failures,
-                                          GError **error)
+/*
+ * Validates an object returned by parse_subdoc_data(). If @autogen_suffix is
+ * non-zero, an unnamed stream is first given placeholder module and stream
+ * names ending in it.
+ */
+static gboolean
+validate_parsed_object (GObject *object, guint autogen_suffix, GError **error)
 {
-  gboolean done = FALSE;
-  gboolean all_passed = TRUE;
-  g_autoptr (ModulemdSubdocumentInfo) subdoc = NULL;
-  MMD_INIT_YAML_EVENT (event);
+  g_autofree gchar *name = NULL;
+  ModulemdModuleStream *stream = NULL;
 
-  if (*failures == NULL)
+  if (MODULEMD_IS_MODULE_STREAM (object))
     {
-      *failures = g_ptr_array_new_with_free_func (g_object_unref);
+      stream = MODULEMD_MODULE_STREAM (object);
+
+      if (autogen_suffix && !modulemd_module_stream_get_module_name (stream))
+        {
+          name = g_strdup_printf ("__unnamed_module_%u", autogen_suffix);
+          modulemd_module_stream_set_module_name (stream, name);
+          g_clear_pointer (&name, g_free);
+        }
+
+      if (autogen_suffix && !modulemd_module_stream_get_stream_name (stream))
+        {
+          name = g_strdup_printf ("__unnamed_stream_%u", autogen_suffix);
+          modulemd_module_stream_set_stream_name (stream, name);
+          g_clear_pointer (&name, g_free);
+        }
+
+      return modulemd_module_stream_validate (stream, error);
     }
 
-  YAML_PARSER_PARSE_WITH_EXIT_BOOL (parser, &event, error);
-  if (event.type != YAML_STREAM_START_EVENT)
+  if (MODULEMD_IS_DEFAULTS (object))
     {
-      MMD_YAML_ERROR_EVENT_EXIT_BOOL (
-        error, event, "Did not encounter stream start");
+      return modulemd_defaults_validate (MODULEMD_DEFAULTS (object), error);
     }
 
-  while (!done)
+  return modulemd_translation_validate (MODULEMD_TRANSLATION (object), error);
+}
+
+
+/*
+ * Adds an object that passed validate_parsed_object() to the index.
+ */
+static gboolean
+add_parsed_object (ModulemdModuleIndex *self, GObject *object, GError **error)
+{
+  if (MODULEMD_IS_MODULE_STREAM (object))
     {
-      YAML_PARSER_PARSE_WITH_EXIT_BOOL (parser, &event, error);
+      /* Nothing else refers to a freshly parsed stream */
+      return modulemd_module_index_adopt_module_stream (
+        self, MODULEMD_MODULE_STREAM (object), error);
+    }
 
-      switch (event.type)
-        {
-        case YAML_DOCUMENT_START_EVENT:
-          /* One more subdocument to parse */
-          subdoc = modulemd_yaml_parse_document_type (parser);
-          if (modulemd_subdocument_info_get_gerror (subdoc) != NULL)
-            {
-              /* Add to failures and ignore */
-              g_ptr_array_add (*failures, g_steal_pointer (&subdoc));
-              all_passed = FALSE;
-            }
-          else
-            {
-              /* Initial parsing worked, parse further */
-              if (!add_subdoc (
-                    self, subdoc, strict, autogen_module_name, error))
-                {
-                  modulemd_subdocument_info_set_gerror (subdoc, *error);
-                  g_clear_pointer (error, g_error_free);
-                  /* Add to failures and ignore */
-                  g_ptr_array_add (*failures, g_steal_pointer (&subdoc));
-                  all_passed = FALSE;
-                }
-            }
-          g_clear_pointer (&subdoc, g_object_unref);
-          break;
+  if (MODULEMD_IS_DEFAULTS (object))
+    {
+      return modulemd_module_index_add_defaults (
+        self, MODULEMD_DEFAULTS (object), error);
+    }
 
-        case YAML_STREAM_END_EVENT: done = TRUE; break;
+  return modulemd_module_index_add_translation (
+    self, MODULEMD_TRANSLATION (object), error);
+}
 
-        default:
-          MMD_YAML_ERROR_EVENT_EXIT_BOOL (
-            error, event, "Unexpected YAML event in document stream");
-          break;
-        }
 
-      yaml_event_delete (&event);
+static GObject *
+parse_subdoc (ModulemdSubdocumentInfo *subdoc, gboolean strict, GError **error)
+{
+  MMD_INIT_YAML_PARSER (parser);
+
+  if (!modulemd_subdocument_info_get_data_parser (
+        subdoc, &parser, strict, error))
+    {
+      return NULL;
     }
 
-  return all_passed;
+  return parse_subdoc_data (&parser,
+                            modulemd_subdocument_info_get_doctype (subdoc),
+                            modulemd_subdocument_info_get_mdversion (subdoc),
+                            strict,
+                            error);
 }
 
 
-static gboolean
-dump_defaults (ModulemdModule *module, yaml_emitter_t *emitter, GError **error)
+/*
+ * Parses the subdocument that @parser is positioned in, just after its
+ * `YAML_DOCUMENT_START_EVENT`, handing the data section straight to the
+ * typed parser.
+ *
+ * If @lazy is not NULL, only the NSVCA header of a stream is read into it
+ * and the rest of its data section is skipped.
+ *
+ * @deferred is set if the data section could not be parsed in-line because it
+ * was missing or came before the document type and version. @ended is set
+ * once the `YAML_DOCUMENT_END_EVENT` has been consumed, with its end mark in
+ * @end_mark.
+ *
+ * Returns: (transfer full): The object that was read, or NULL. Sets @error
+ * unless the subdocument was @deferred or read into @lazy.
+ */
+static GObject *
+read_subdoc_data (yaml_parser_t *parser,
+                  gboolean strict,
+                  modulemd_lazy_stream **lazy,
+                  gboolean *deferred,
+                  gboolean *ended,
+                  yaml_mark_t *end_mark,
+                  GError **error)
 {
-  ModulemdDefaults *defaults = modulemd_module_get_defaults (module);
-  g_autoptr (GError) nested_error = NULL;
-
-  if (defaults == NULL)
+  MMD_INIT_YAML_EVENT (event);
+  ModulemdYamlDocumentTypeEnum doctype = MODULEMD_YAML_DOC_UNKNOWN;
+  guint64 mdversion = 0;
+  gboolean at_data = FALSE;
+  gboolean had_data = FALSE;
+  g_autoptr (GObject) object = NULL;
+
+  YAML_PARSER_PARSE_WITH_EXIT (parser, &event, error);
+  if (event.type != YAML_MAPPING_START_EVENT)
     {
-      return TRUE; /* Nothing to dump -> all a success */
+      MMD_YAML_ERROR_EVENT_EXIT (
+        error, event, "Document did not start with a mappping");
     }
+  yaml_event_delete (&event);
 
-  if (!modulemd_defaults_validate (defaults, &nested_error))
+  if (!modulemd_yaml_parse_document_keys (
+        parser, &doctype, &mdversion, &at_data, error))
     {
-      g_propagate_prefixed_error (error,
-                                  g_steal_pointer (&nested_error),
-                                  "Could not validate defaults to emit: ");
-      return FALSE;
+      return NULL;
     }
 
-  if (modulemd_defaults_get_mdversion (defaults) == MD_DEFAULTS_VERSION_ONE)
+  while (at_data)
     {
-      if (!modulemd_defaults_v1_emit_yaml (
-            (ModulemdDefaultsV1 *)defaults, emitter, error))
+      if (lazy && !had_data &&
+          doctype == MODULEMD_YAML_DOC_MODULESTREAM &&
+          (mdversion == MD_MODULESTREAM_VERSION_ONE ||
+           mdversion == MD_MODULESTREAM_VERSION_TWO))
         {
-          return FALSE;
+          *lazy = modulemd_lazy_stream_parse_yaml_header (parser, error);
+          if (*lazy == NULL)
+            {
+              return NULL;
+            }
+
+          (*lazy)->subdoc = modulemd_subdocument_info_new ();
+          modulemd_subdocument_info_set_doctype ((*lazy)->subdoc, doctype);
+          modulemd_subdocument_info_set_mdversion ((*lazy)->subdoc, mdversion);
+          (*lazy)->strict = strict;
+        }
+      else if (!had_data && doctype != MODULEMD_YAML_DOC_UNKNOWN &&
+               mdversion != 0)
+        {
+          object =
+            parse_subdoc_data (parser, doctype, mdversion, strict, error);
+          if (object == NULL)
+            {
+              return NULL;
+            }
+        }
+      else if (!skip_unknown_yaml (parser, error))
+        {
+          return NULL;
+        }
+      had_data = TRUE;
+
+      if (!modulemd_yaml_parse_document_keys (
+            parser, &doctype, &mdversion, &at_data, error))
+        {
+          return NULL;
         }
     }
-  else
+
+  YAML_PARSER_PARSE_WITH_EXIT (parser, &event, error);
+  if (event.type != YAML_DOCUMENT_END_EVENT)
     {
-      g_set_error_literal (error,
-                           MODULEMD_ERROR,
-                           MODULEMD_ERROR_VALIDATE,
-                           "Provided defaults is not a recognized version");
-      return FALSE;
+      MMD_YAML_ERROR_EVENT_EXIT (
+        error, event, "Document did not end. It just goes on forever...");
     }
+  *ended = TRUE;
+  *end_mark = event.end_mark;
 
-  return TRUE;
+  if (object == NULL && (lazy == NULL || *lazy == NULL))
+    {
+      *deferred = TRUE;
+    }
+
+  return g_steal_pointer (&object);
 }
 
 
-static gboolean
-dump_translations (ModulemdModule *module,
-                   yaml_emitter_t *emitter,
-                   GError **error)
+/*
+ * Skips the rest of a subdocument that failed part way through so that the
+ * next one can be read, returning the end mark of its
+ * `YAML_DOCUMENT_END_EVENT`.
+ */
+static yaml_mark_t
+skip_to_document_end (yaml_parser_t *parser)
 {
-  ModulemdTranslation *translation = NULL;
-  gsize i = 0;
-  g_autoptr (GPtrArray) streams =
-    modulemd_module_get_translated_streams (module);
+  MMD_INIT_YAML_EVENT (event);
+  yaml_mark_t mark = parser->mark;
 
-  for (i = 0; i < streams->len; i++)
+  while (yaml_parser_parse (parser, &event))
     {
-      translation = modulemd_module_get_translation (
-        module, g_ptr_array_index (streams, i));
-
-      if (!modulemd_translation_emit_yaml (translation, emitter, error))
+      mark = event.end_mark;
+      if (event.type == YAML_DOCUMENT_END_EVENT ||
+          event.type == YAML_STREAM_END_EVENT ||
+          event.type == YAML_NO_EVENT)
         {
-          return FALSE;
+          break;
         }
+      yaml_event_delete (&event);
     }
 
-  return TRUE;
+  return mark;
 }
 
 
-static gint
-compare_stream_SVCA (gconstpointer a, gconstpointer b)
+/* The outcome of reading one subdocument from a YAML stream */
+typedef struct
 {
-  ModulemdModuleStream *a_ = *(ModulemdModuleStream **)a;
-  ModulemdModuleStream *b_ = *(ModulemdModuleStream **)b;
-  g_autofree gchar *a_nsvca = modulemd_module_stream_get_NSVCA_as_string (a_);
-  g_autofree gchar *b_nsvca = modulemd_module_stream_get_NSVCA_as_string (b_);
-  return g_strcmp0 (a_nsvca, b_nsvca);
+  yaml_mark_t start_mark;
+  yaml_mark_t end_mark;
+
+  /* The validated object, if the subdocument was read successfully */
+  GObject *object;
+
+  /* The header and text of a stream that was read without parsing it */
+  modulemd_lazy_stream *lazy;
+
+  /* Describes the subdocument if it failed. Also set if it was read through
+   * modulemd_yaml_parse_document_type().
+   */
+  ModulemdSubdocumentInfo *subdoc;
+} SubdocResult;
+
+
+static void
+subdoc_result_clear (SubdocResult *result)
+{
+  g_clear_object (&result->object);
+  g_clear_pointer (&result->lazy, modulemd_lazy_stream_free);
+  g_clear_object (&result->subdoc);
 }
 
 
-static gboolean
-dump_streams (ModulemdModule *module, yaml_emitter_t *emitter, GError **error)
+static void
+subdoc_result_fail (SubdocResult *result,
+                    modulemd_yaml_capture *capture,
+                    GError *error)
 {
-  ModulemdModuleStream *stream = NULL;
-  gsize i = 0;
-  GPtrArray *streams = modulemd_module_get_all_streams (module);
-  g_autoptr (GError) nested_error = NULL;
+  g_clear_object (&result->object);
+  g_clear_pointer (&result->lazy, modulemd_lazy_stream_free);
 
-  /*
-   * Make sure we get a stable sorting by sorting just before dumping.
+  /* Only a failed subdocument needs its text, which is read back out of the
+   * raw input. Header problems are reported exactly as the re-emitting parser
+   * would report them.
    */
-  g_ptr_array_sort (streams, compare_stream_SVCA);
+  if (result->subdoc == NULL)
+    {
+      result->subdoc = modulemd_yaml_capture_get_subdocument (
+        capture, &result->start_mark, &result->end_mark);
+    }
 
-  for (i = 0; i < streams->len; i++)
+  if (modulemd_subdocument_info_get_gerror (result->subdoc) == NULL)
     {
-      stream = (ModulemdModuleStream *)g_ptr_array_index (streams, i);
+      modulemd_subdocument_info_set_gerror (result->subdoc, error);
+    }
+}
 
-      if (!modulemd_module_stream_validate (stream, &nested_error))
-        {
-          g_propagate_prefixed_error (error,
-                                      g_steal_pointer (&nested_error),
-                                      "Could not validate stream to emit: ");
-          return FALSE;
-        }
 
-      if (modulemd_module_stream_get_mdversion (stream) ==
-          MD_MODULESTREAM_VERSION_ONE)
+/*
+ * Reads and validates the subdocument whose `YAML_DOCUMENT_START_EVENT` at
+ * @result->start_mark has just been consumed from @parser. If @capture is
+ * NULL, the subdocument is read through modulemd_yaml_parse_document_type()
+ * instead of in a single pass. See validate_parsed_object() for
+ * @autogen_suffix.
+ *
+ * If @lazy is set and @capture is not NULL, a stream that names its module
+ * and stream is not parsed. Its header and text are kept in @result->lazy
+ * instead.
+ */
+static void
+read_subdoc (yaml_parser_t *parser,
+             modulemd_yaml_capture *capture,
+             gboolean strict,
+             gboolean lazy,
+             guint autogen_suffix,
+             SubdocResult *result)
+{
+  gboolean deferred = FALSE;
+  gboolean ended = FALSE;
+  g_autoptr (GObject) object = NULL;
+  g_autoptr (modulemd_lazy_stream) lazy_stream = NULL;
+  g_autofree gchar *text = NULL;
+  g_autoptr (GError) nested_error = NULL;
+
+  if (capture == NULL)
+    {
+      result->subdoc = modulemd_yaml_parse_document_type (parser);
+      if (modulemd_subdocument_info_get_gerror (result->subdoc) != NULL)
+        {
+          return;
+        }
+
+      object = parse_subdoc (result->subdoc, strict, &nested_error);
+    }
+  else
+    {
+      modulemd_yaml_capture_forget (capture, &result->start_mark);
+
+      object = read_subdoc_data (parser,
+                                 strict,
+                                 lazy ? &lazy_stream : NULL,
+                                 &deferred,
+                                 &ended,
+                                 &result->end_mark,
+                                 &nested_error);
+
+      if (lazy_stream && ended)
         {
-          if (!modulemd_module_stream_v1_emit_yaml (
-                MODULEMD_MODULE_STREAM_V1 (stream), emitter, error))
+          if (lazy_stream->module_name && lazy_stream->stream_name)
             {
-              return FALSE;
+              text = modulemd_yaml_capture_dup (
+                capture, &result->start_mark, &result->end_mark);
+              modulemd_subdocument_info_set_yaml (lazy_stream->subdoc, text);
+              result->lazy = g_steal_pointer (&lazy_stream);
+              return;
             }
+
+          /* The index cannot hold it, so parse it fully to report why */
+          deferred = TRUE;
         }
-      else if (modulemd_module_stream_get_mdversion (stream) ==
-               MD_MODULESTREAM_VERSION_TWO)
+
+      if (object == NULL && !deferred)
         {
-          if (!modulemd_module_stream_v2_emit_yaml (
-                MODULEMD_MODULE_STREAM_V2 (stream), emitter, error))
+          if (!ended)
             {
-              return FALSE;
+              result->end_mark = skip_to_document_end (parser);
             }
+          subdoc_result_fail (result, capture, nested_error);
+          return;
         }
-      else
+
+      if (deferred)
         {
-          g_set_error_literal (error,
-                               MODULEMD_ERROR,
-                               MODULEMD_ERROR_VALIDATE,
-                               "Provided stream is not a recognized version");
+          /* The document type and version came after the data section (or
+           * there was no data section), so read it again from its text.
+           */
+          result->subdoc = modulemd_yaml_capture_get_subdocument (
+            capture, &result->start_mark, &result->end_mark);
+          if (modulemd_subdocument_info_get_gerror (result->subdoc) != NULL)
+            {
+              return;
+            }
+
+          object = parse_subdoc (result->subdoc, strict, &nested_error);
+        }
+    }
+
+  if (object &&
+      !validate_parsed_object (object, autogen_suffix, &nested_error))
+    {
+      g_clear_object (&object);
+    }
+
+  if (object == NULL)
+    {
+      subdoc_result_fail (result, capture, nested_error);
+      return;
+    }
+
+  result->object = g_steal_pointer (&object);
+}
+
+
+GObject *
+modulemd_module_index_read_subdoc (yaml_parser_t *parser,
+                                   modulemd_yaml_capture *capture,
+                                   gboolean strict,
+                                   const yaml_mark_t *start_mark,
+                                   ModulemdSubdocumentInfo **failure)
+{
+  SubdocResult result;
+  GObject *object = NULL;
+
+  memset (&result, 0, sizeof (SubdocResult));
+  result.start_mark = *start_mark;
+  read_subdoc (parser, capture, strict, FALSE, 0, &result);
+
+  object = g_steal_pointer (&result.object);
+  if (object == NULL)
+    {
+      *failure = g_steal_pointer (&result.subdoc);
+    }
+  subdoc_result_clear (&result);
+
+  return object;
+}
+
+
+/*
+ * Adds a stream that has not been parsed yet to the index, the same way as
+ * modulemd_module_index_add_module_stream() adds a parsed one.
+ */
+static gboolean
+add_lazy_stream (ModulemdModuleIndex *self,
+                 modulemd_lazy_stream *lazy,
+                 GError **error)
+{
+  g_autoptr (GError) nested_error = NULL;
+  ModulemdModuleStreamVersionEnum mdversion = MD_MODULESTREAM_VERSION_UNSET;
+
+  mdversion =
+    modulemd_module_add_lazy_stream (get_or_create_module (self,
+                                                           lazy->module_name),
+                                     lazy,
+                                     self->stream_mdversion,
+                                     &nested_error);
+  if (mdversion == MD_MODULESTREAM_VERSION_ERROR)
+    {
+      g_propagate_error (error, g_steal_pointer (&nested_error));
+      return FALSE;
+    }
+
+  if (mdversion > self->stream_mdversion)
+    {
+      /* Upgrade any streams we've already seen to this version */
+      g_debug ("Upgrading all streams to version %i", mdversion);
+      if (!modulemd_module_index_upgrade_streams (
+            self, mdversion, &nested_error))
+        {
+          g_propagate_error (error, g_steal_pointer (&nested_error));
           return FALSE;
         }
     }
@@ -471,477 +711,3174 @@ dump_streams (ModulemdModule *module, yaml_emitter_t *emitter, GError **error)
 }
 
 
+/*
+ * Adds the object read by read_subdoc() to the index, or records the
+ * subdocument in @failures if it could not be read or added.
+ *
+ * Returns: TRUE if the object was added.
+ */
 static gboolean
-modulemd_module_index_dump_to_emitter (ModulemdModuleIndex *self,
-                                       yaml_emitter_t *emitter,
-                                       GError **error)
+add_subdoc_result (ModulemdModuleIndex *self,
+                   modulemd_yaml_capture *capture,
+                   SubdocResult *result,
+                   GPtrArray *failures)
 {
-  ModulemdModule *module = NULL;
-  gsize i;
-  g_autoptr (GPtrArray) modules =
-    modulemd_ordered_str_keys (self->modules, modulemd_strcmp_sort);
+  g_autoptr (GError) nested_error = NULL;
 
-  if (modules->len == 0)
+  if (result->lazy != NULL)
     {
-      g_set_error_literal (error,
-                           MODULEMD_ERROR,
-                           MODULEMD_ERROR_VALIDATE,
-                           "Index contains no modules.");
+      if (add_lazy_stream (
+            self, g_steal_pointer (&result->lazy), &nested_error))
+        {
+          return TRUE;
+        }
+
+      subdoc_result_fail (result, capture, nested_error);
+    }
+  else if (result->object != NULL)
+    {
+      if (add_parsed_object (self, result->object, &nested_error))
+        {
+          return TRUE;
+        }
+
+      subdoc_result_fail (result, capture, nested_error);
+    }
+
+  /* Add to failures and ignore */
+  g_ptr_array_add (failures, g_steal_pointer (&result->subdoc));
+  return FALSE;
+}
+
+
+/* One subdocument's worth of a YAML stream, parsed on a worker thread */
+typedef struct
+{
+  const gchar *text;
+  gsize len;
+
+  /* The line within the whole stream on which @text starts */
+  gsize line;
+
+  gboolean strict;
+  gboolean lazy;
+
+  /* @text behind @line blank lines, if it had to be parsed again */
+  gchar *padded;
+
+  modulemd_yaml_capture capture;
+  GArray *results; /* SubdocResult */
+  GError *error;
+} ParseJob;
+
+
+static void
+parse_job_clear (ParseJob *job)
+{
+  g_clear_pointer (&job->results, g_array_unref);
+  modulemd_yaml_capture_clear (&job->capture);
+  g_clear_pointer (&job->padded, g_free);
+  g_clear_error (&job->error);
+}
+
+
+static gboolean
+parse_job_text (ParseJob *job, const gchar *text, gsize len)
+{
+  MMD_INIT_YAML_PARSER (parser);
+  MMD_INIT_YAML_EVENT (event);
+  SubdocResult result;
+  gboolean done = FALSE;
+
+  g_array_set_size (job->results, 0);
+  modulemd_yaml_capture_clear (&job->capture);
+  modulemd_yaml_capture_set_input_string (&job->capture, &parser, text, len);
+
+  while (!done)
+    {
+      YAML_PARSER_PARSE_WITH_EXIT_BOOL (&parser, &event, &job->error);
+
+      switch (event.type)
+        {
+        case YAML_STREAM_START_EVENT: break;
+
+        case YAML_DOCUMENT_START_EVENT:
+          memset (&result, 0, sizeof (SubdocResult));
+          result.start_mark = event.start_mark;
+          read_subdoc (
+            &parser, &job->capture, job->strict, job->lazy, 0, &result);
+          g_array_append_val (job->results, result);
+          break;
+
+        case YAML_STREAM_END_EVENT: done = TRUE; break;
+
+        default:
+          MMD_YAML_ERROR_EVENT_EXIT_BOOL (
+            &job->error, event, "Unexpected YAML event in document stream");
+          break;
+        }
+
+      yaml_event_delete (&event);
+    }
+
+  return TRUE;
+}
+
+
+static void
+parse_job_read (ParseJob *job, modulemd_string_pool *pool)
+{
+  SubdocResult *result = NULL;
+  gboolean failed;
+  guint i;
+  MMD_INIT_STRING_POOL_SCOPE (scope, pool);
+
+  job->results = g_array_new (FALSE, TRUE, sizeof (SubdocResult));
+  g_array_set_clear_func (job->results, (GDestroyNotify)subdoc_result_clear);
+
+  failed = !parse_job_text (job, job->text, job->len);
+  for (i = 0; i < job->results->len; i++)
+    {
+      result = &g_array_index (job->results, SubdocResult, i);
+      if (result->object == NULL && result->lazy == NULL)
+        {
+          failed = TRUE;
+        }
+    }
+
+  if (!failed || job->line == 0)
+    {
+      return;
+    }
+
+  /* Error messages carry line numbers, which must count from the start of
+   * the whole stream. Failures are rare, so rather than offsetting every
+   * subdocument, a failed one is parsed again behind enough blank lines to
+   * put it back in its place.
+   */
+  g_clear_error (&job->error);
+  job->padded = g_malloc (job->line + job->len + 1);
+  memset (job->padded, '\n', job->line);
+  memcpy (job->padded + job->line, job->text, job->len);
+  job->padded[job->line + job->len] = '\0';
+
+  parse_job_text (job, job->padded, job->line + job->len);
+}
+
+
+/*
+ * Runs @data, a #ParseJob, with one of the string pools in @user_data, a
+ * #GAsyncQueue holding one for each worker thread. The strings of the objects
+ * parsed by each thread are shared through its pool without locking.
+ */
+static void
+parse_job_run (gpointer data, gpointer user_data)
+{
+  GAsyncQueue *pools = (GAsyncQueue *)user_data;
+  modulemd_string_pool *pool = g_async_queue_pop (pools);
+
+  parse_job_read ((ParseJob *)data, pool);
+  g_async_queue_push (pools, pool);
+}
+
+
+static gboolean
+is_document_marker (const gchar *line, const gchar *line_end, gchar c)
+{
+  if (line_end - line < 3 || line[0] != c || line[1] != c || line[2] != c)
+    {
+      return FALSE;
+    }
+
+  return line_end - line == 3 || line[3] == ' ' || line[3] == '\t' ||
+         line[3] == '\r' || line[3] == '\n';
+}
+
+
+static void
+add_parse_job (GArray *jobs,
+               const gchar *text,
+               const gchar *text_end,
+               gsize line,
+               gboolean strict,
+               gboolean lazy)
+{
+  ParseJob job;
+
+  if (text_end == text)
+    {
+      return;
+    }
+
+  memset (&job, 0, sizeof (ParseJob));
+  job.text = text;
+  job.len = text_end - text;
+  job.line = line;
+  job.strict = strict;
+  job.lazy = lazy;
+  g_array_append_val (jobs, job);
+}
+
+
+/*
+ * Splits @text into one #ParseJob per subdocument at its `---` and `...`
+ * markers, which libyaml always treats as document boundaries when they start
+ * a line.
+ *
+ * Returns: (transfer full): An array of #ParseJob or NULL if @text uses
+ * directives or is not UTF-8, which makes splitting it unsafe.
+ */
+static GArray *
+split_parse_jobs (const gchar *text,
+                  gsize len,
+                  gboolean strict,
+                  gboolean lazy)
+{
+  g_autoptr (GArray) jobs = g_array_new (FALSE, TRUE, sizeof (ParseJob));
+  const gchar *end = text + len;
+  const gchar *chunk = text;
+  const gchar *line = text;
+  const gchar *line_end = NULL;
+  gsize lineno = 0;
+  gsize chunk_line = 0;
+
+  g_array_set_clear_func (jobs, (GDestroyNotify)parse_job_clear);
+
+  if (len >= 2 && (text[0] == '\0' || text[1] == '\0' ||
+                   (guchar)text[0] == 0xFE || (guchar)text[0] == 0xFF))
+    {
+      return NULL;
+    }
+
+  while (line < end)
+    {
+      line_end = memchr (line, '\n', end - line);
+      line_end = line_end ? line_end + 1 : end;
+
+      if (*line == '%')
+        {
+          return NULL;
+        }
+
+      if (line != chunk && is_document_marker (line, line_end, '-'))
+        {
+          add_parse_job (jobs, chunk, line, chunk_line, strict, lazy);
+          chunk = line;
+          chunk_line = lineno;
+        }
+      else if (is_document_marker (line, line_end, '.'))
+        {
+          add_parse_job (jobs, chunk, line_end, chunk_line, strict, lazy);
+          chunk = line_end;
+          chunk_line = lineno + 1;
+        }
+
+      line = line_end;
+      lineno++;
+    }
+
+  add_parse_job (jobs, chunk, end, chunk_line, strict, lazy);
+
+  return g_steal_pointer (&jobs);
+}
+
+
+/*
+ * Parses and validates the subdocuments of @text on a pool of @threads
+ * threads, then adds them to the index in the order they appear in @text.
+ *
+ * Returns: -1 if @text cannot be split into subdocuments, in which case it
+ * must be read serially. Otherwise the same as
+ * modulemd_module_index_update_from_parser().
+ */
+static gint
+update_from_string_parallel (ModulemdModuleIndex *self,
+                             const gchar *text,
+                             gsize len,
+                             guint threads,
+                             gboolean strict,
+                             GPtrArray *failures,
+                             GError **error)
+{
+  g_autoptr (GArray) jobs = NULL;
+  g_autoptr (GError) nested_error = NULL;
+  g_autoptr (GAsyncQueue) string_pools = NULL;
+  modulemd_string_pool *string_pool = NULL;
+  GThreadPool *pool = NULL;
+  ParseJob *job = NULL;
+  SubdocResult *result = NULL;
+  gboolean all_passed = TRUE;
+  guint i;
+  guint j;
+
+  jobs = split_parse_jobs (text, len, strict, self->lazy_streams);
+  if (jobs == NULL || jobs->len < 2)
+    {
+      return -1;
+    }
+
+  threads = MIN (threads, jobs->len);
+  string_pools =
+    g_async_queue_new_full ((GDestroyNotify)modulemd_string_pool_unref);
+  for (i = 0; i < threads; i++)
+    {
+      g_async_queue_push (string_pools, modulemd_string_pool_new ());
+    }
+
+  pool = g_thread_pool_new (
+    parse_job_run, string_pools, threads, FALSE, &nested_error);
+  if (pool == NULL)
+    {
+      g_propagate_error (error, g_steal_pointer (&nested_error));
       return FALSE;
     }
 
-  if (!mmd_emitter_start_stream (emitter, error))
+  for (i = 0; i < jobs->len; i++)
+    {
+      g_thread_pool_push (pool, &g_array_index (jobs, ParseJob, i), NULL);
+    }
+
+  /* Wait for all of the jobs to finish */
+  g_thread_pool_free (pool, FALSE, TRUE);
+
+  /* Merge the strings of the worker threads into the index before adding
+   * their objects, so that the lookup tables mostly file them under the same
+   * copies that they hold.
+   */
+  while ((string_pool = g_async_queue_try_pop (string_pools)) != NULL)
+    {
+      modulemd_string_pool_absorb (self->strings, string_pool);
+      modulemd_string_pool_unref (string_pool);
+    }
+
+  for (i = 0; i < jobs->len; i++)
+    {
+      job = &g_array_index (jobs, ParseJob, i);
+
+      for (j = 0; j < job->results->len; j++)
+        {
+          result = &g_array_index (job->results, SubdocResult, j);
+          if (!add_subdoc_result (self, &job->capture, result, failures))
+            {
+              all_passed = FALSE;
+            }
+        }
+
+      if (job->error)
+        {
+          g_propagate_error (error, g_steal_pointer (&job->error));
+          return FALSE;
+        }
+    }
+
+  return all_passed;
+}
+
+
+gboolean
+modulemd_module_index_update_from_parser (ModulemdModuleIndex *self,
+                                          yaml_parser_t *parser,
+                                          modulemd_yaml_capture *capture,
+                                          gboolean strict,
+                                          gboolean autogen_module_name,
+                                          GPtrArray **failures,
+                                          GError **error)
+{
+  gboolean done = FALSE;
+  gboolean all_passed = TRUE;
+  gint parallel_result;
+  guint autogen_suffix = 0;
+  guint threads = self->parse_threads;
+  SubdocResult result;
+  MMD_INIT_YAML_EVENT (event);
+  MMD_INIT_STRING_POOL_SCOPE (scope, self->strings);
+
+  if (*failures == NULL)
+    {
+      *failures = g_ptr_array_new_with_free_func (g_object_unref);
+    }
+
+  if (threads == 0)
+    {
+      threads = g_get_num_processors ();
+    }
+
+  /* Placeholder names depend on the order in which streams are added, so
+   * autogenerating them rules out parsing in parallel.
+   */
+  if (threads > 1 && capture && capture->string && !autogen_module_name)
+    {
+      parallel_result =
+        update_from_string_parallel (self,
+                                     (const gchar *)capture->string,
+                                     capture->string_len,
+                                     threads,
+                                     strict,
+                                     *failures,
+                                     error);
+      if (parallel_result >= 0)
+        {
+          return parallel_result;
+        }
+    }
+
+  YAML_PARSER_PARSE_WITH_EXIT_BOOL (parser, &event, error);
+  if (event.type != YAML_STREAM_START_EVENT)
+    {
+      MMD_YAML_ERROR_EVENT_EXIT_BOOL (
+        error, event, "Did not encounter stream start");
+    }
+
+  /* Subdocument text can only be recovered from the parser marks when they
+   * count UTF-8 characters. Otherwise fall back to re-emitting every
+   * subdocument before parsing it.
+   */
+  if (event.data.stream_start.encoding != YAML_UTF8_ENCODING)
+    {
+      capture = NULL;
+    }
+  yaml_event_delete (&event);
+
+  while (!done)
+    {
+      YAML_PARSER_PARSE_WITH_EXIT_BOOL (parser, &event, error);
+
+      switch (event.type)
+        {
+        case YAML_DOCUMENT_START_EVENT:
+          /* One more subdocument to parse */
+          if (autogen_module_name)
+            {
+              autogen_suffix = g_hash_table_size (self->modules) + 1;
+            }
+
+          memset (&result, 0, sizeof (SubdocResult));
+          result.start_mark = event.start_mark;
+          read_subdoc (parser,
+                       capture,
+                       strict,
+                       self->lazy_streams,
+                       autogen_suffix,
+                       &result);
+
+          if (!add_subdoc_result (self, capture, &result, *failures))
+            {
+              all_passed = FALSE;
+            }
+          subdoc_result_clear (&result);
+          break;
+
+        case YAML_STREAM_END_EVENT: done = TRUE; break;
+
+        default:
+          MMD_YAML_ERROR_EVENT_EXIT_BOOL (
+            error, event, "Unexpected YAML event in document stream");
+          break;
+        }
+
+      yaml_event_delete (&event);
+    }
+
+  return all_passed;
+}
+
+
+static gboolean
+dump_defaults (ModulemdModule *module, yaml_emitter_t *emitter, GError **error)
+{
+  ModulemdDefaults *defaults = modulemd_module_get_defaults (module);
+  g_autoptr (GError) nested_error = NULL;
+
+  if (defaults == NULL)
+    {
+      return TRUE; /* Nothing to dump -> all a success */
+    }
+
+  if (!modulemd_defaults_validate (defaults, &nested_error))
+    {
+      g_propagate_prefixed_error (error,
+                                  g_steal_pointer (&nested_error),
+                                  "Could not validate defaults to emit: ");
+      return FALSE;
+    }
+
+  if (modulemd_defaults_get_mdversion (defaults) == MD_DEFAULTS_VERSION_ONE)
+    {
+      if (!modulemd_defaults_v1_emit_yaml (
+            (ModulemdDefaultsV1 *)defaults, emitter, error))
+        {
+          return FALSE;
+        }
+    }
+  else
+    {
+      g_set_error_literal (error,
+                           MODULEMD_ERROR,
+                           MODULEMD_ERROR_VALIDATE,
+                           "Provided defaults is not a recognized version");
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+static gboolean
+dump_translations (ModulemdModule *module,
+                   yaml_emitter_t *emitter,
+                   GError **error)
+{
+  ModulemdTranslation *translation = NULL;
+  gsize i = 0;
+  g_autoptr (GPtrArray) streams =
+    modulemd_module_get_translated_streams (module);
+
+  for (i = 0; i < streams->len; i++)
+    {
+      translation = modulemd_module_get_translation (
+        module, g_ptr_array_index (streams, i));
+
+      if (!modulemd_translation_emit_yaml (translation, emitter, error))
+        {
+          return FALSE;
+        }
+    }
+
+  return TRUE;
+}
+
+
+static gint
+compare_stream_SVCA (gconstpointer a, gconstpointer b)
+{
+  ModulemdModuleStream *a_ = *(ModulemdModuleStream **)a;
+  ModulemdModuleStream *b_ = *(ModulemdModuleStream **)b;
+  g_autofree gchar *a_nsvca = modulemd_module_stream_get_NSVCA_as_string (a_);
+  g_autofree gchar *b_nsvca = modulemd_module_stream_get_NSVCA_as_string (b_);
+  return g_strcmp0 (a_nsvca, b_nsvca);
+}
+
+
+static gboolean
+dump_stream (ModulemdModuleStream *stream,
+             yaml_emitter_t *emitter,
+             GError **error)
+{
+  g_autoptr (GError) nested_error = NULL;
+
+  if (!modulemd_module_stream_validate (stream, &nested_error))
+    {
+      g_propagate_prefixed_error (error,
+                                  g_steal_pointer (&nested_error),
+                                  "Could not validate stream to emit: ");
+      return FALSE;
+    }
+
+  if (modulemd_module_stream_get_mdversion (stream) ==
+      MD_MODULESTREAM_VERSION_ONE)
+    {
+      return modulemd_module_stream_v1_emit_yaml (
+        MODULEMD_MODULE_STREAM_V1 (stream), emitter, error);
+    }
+  else if (modulemd_module_stream_get_mdversion (stream) ==
+           MD_MODULESTREAM_VERSION_TWO)
+    {
+      return modulemd_module_stream_v2_emit_yaml (
+        MODULEMD_MODULE_STREAM_V2 (stream), emitter, error);
+    }
+
+  g_set_error_literal (error,
+                       MODULEMD_ERROR,
+                       MODULEMD_ERROR_VALIDATE,
+                       "Provided stream is not a recognized version");
+  return FALSE;
+}
+
+
+/*
+ * Returns: (transfer container): The streams of @module, sorted for output.
+ * The array of the module itself must not be reordered, since it is kept in
+ * document order along with the position of each stream.
+ */
+static GPtrArray *
+get_sorted_streams (ModulemdModule *module)
+{
+  GPtrArray *streams = modulemd_module_get_all_streams (module);
+  GPtrArray *sorted = g_ptr_array_sized_new (streams->len);
+
+  for (guint i = 0; i < streams->len; i++)
+    {
+      g_ptr_array_add (sorted, g_ptr_array_index (streams, i));
+    }
+  g_ptr_array_sort (sorted, compare_stream_SVCA);
+
+  return sorted;
+}
+
+
+static gboolean
+dump_streams (ModulemdModule *module, yaml_emitter_t *emitter, GError **error)
+{
+  gsize i = 0;
+  g_autoptr (GPtrArray) streams = NULL;
+
+  /*
+   * Make sure we get a stable sorting by sorting just before dumping.
+   */
+  streams = get_sorted_streams (module);
+
+  for (i = 0; i < streams->len; i++)
+    {
+      if (!dump_stream (g_ptr_array_index (streams, i), emitter, error))
+        {
+          return FALSE;
+        }
+    }
+
+  return TRUE;
+}
+
+
+static gboolean
+dump_module (ModulemdModule *module, yaml_emitter_t *emitter, GError **error)
+{
+  if (!dump_defaults (module, emitter, error))
+    {
+      return FALSE;
+    }
+
+  if (!dump_translations (module, emitter, error))
+    {
+      return FALSE;
+    }
+
+  if (!dump_streams (module, emitter, error))
+    {
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+static gboolean
+modulemd_module_index_dump_to_emitter (ModulemdModuleIndex *self,
+                                       yaml_emitter_t *emitter,
+                                       GError **error)
+{
+  ModulemdModule *module = NULL;
+  gsize i;
+  g_autoptr (GPtrArray) modules =
+    modulemd_ordered_str_keys (self->modules, modulemd_strcmp_sort);
+
+  if (modules->len == 0)
+    {
+      g_set_error_literal (error,
+                           MODULEMD_ERROR,
+                           MODULEMD_ERROR_VALIDATE,
+                           "Index contains no modules.");
+      return FALSE;
+    }
+
+  if (!mmd_emitter_start_stream (emitter, error))
+    {
+      return FALSE;
+    }
+
+  for (i = 0; i < modules->len; i++)
+    {
+      module = modulemd_module_index_get_module (
+        self, g_ptr_array_index (modules, i));
+
+      if (!dump_module (module, emitter, error))
+        {
+          return FALSE;
+        }
+    }
+
+  if (!mmd_emitter_end_stream (emitter, error))
+    {
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+/* The documents of one module, emitted on a worker thread */
+typedef struct
+{
+  ModulemdModule *module;
+  GBytes *yaml;
+  GError *error;
+} EmitJob;
+
+
+static void
+emit_job_clear (EmitJob *job)
+{
+  g_clear_pointer (&job->yaml, g_bytes_unref);
+  g_clear_error (&job->error);
+}
+
+
+static void
+emit_job_run (gpointer data, gpointer user_data)
+{
+  EmitJob *job = (EmitJob *)data;
+
+  MMD_INIT_YAML_EMITTER (emitter);
+  MMD_INIT_YAML_STRING (&emitter, yaml_string);
+
+  if (!mmd_emitter_start_stream (&emitter, &job->error) ||
+      !dump_module (job->module, &emitter, &job->error) ||
+      !mmd_emitter_end_stream (&emitter, &job->error))
+    {
+      return;
+    }
+
+  job->yaml =
+    modulemd_yaml_string_free_to_bytes (g_steal_pointer (&yaml_string));
+}
+
+
+/*
+ * Emits the documents of each module in @modules into a separate buffer on a
+ * pool of @threads threads, then writes the buffers to @handler in order.
+ * Every document ends with an explicit `...` marker, so the concatenated
+ * buffers are byte-for-byte the same as a single stream holding all of them.
+ */
+static gboolean
+dump_to_output_parallel (ModulemdModuleIndex *self,
+                         GPtrArray *modules,
+                         guint threads,
+                         yaml_write_handler_t *handler,
+                         void *data,
+                         GError **error)
+{
+  g_autoptr (GArray) jobs = NULL;
+  g_autoptr (GError) nested_error = NULL;
+  GThreadPool *pool = NULL;
+  EmitJob *job = NULL;
+  gsize data_len;
+  guint i;
+
+  jobs = g_array_sized_new (FALSE, TRUE, sizeof (EmitJob), modules->len);
+  g_array_set_clear_func (jobs, (GDestroyNotify)emit_job_clear);
+  g_array_set_size (jobs, modules->len);
+
+  for (i = 0; i < modules->len; i++)
+    {
+      g_array_index (jobs, EmitJob, i).module =
+        modulemd_module_index_get_module (self,
+                                          g_ptr_array_index (modules, i));
+    }
+
+  pool = g_thread_pool_new (
+    emit_job_run, NULL, MIN (threads, jobs->len), FALSE, &nested_error);
+  if (pool == NULL)
+    {
+      g_propagate_error (error, g_steal_pointer (&nested_error));
+      return FALSE;
+    }
+
+  for (i = 0; i < jobs->len; i++)
+    {
+      g_thread_pool_push (pool, &g_array_index (jobs, EmitJob, i), NULL);
+    }
+
+  /* Wait for all of the jobs to finish */
+  g_thread_pool_free (pool, FALSE, TRUE);
+
+  /* Report the same error as emitting serially would, without writing any
+   * output first.
+   */
+  for (i = 0; i < jobs->len; i++)
+    {
+      job = &g_array_index (jobs, EmitJob, i);
+      if (job->error != NULL)
+        {
+          g_propagate_error (error, g_steal_pointer (&job->error));
+          return FALSE;
+        }
+    }
+
+  for (i = 0; i < jobs->len; i++)
+    {
+      job = &g_array_index (jobs, EmitJob, i);
+      data_len = g_bytes_get_size (job->yaml);
+      if (data_len > 0 &&
+          !handler (data,
+                    (unsigned char *)g_bytes_get_data (job->yaml, NULL),
+                    data_len))
+        {
+          g_set_error_literal (error,
+                               MODULEMD_YAML_ERROR,
+                               MODULEMD_YAML_ERROR_EMIT,
+                               "Could not write the YAML stream");
+          return FALSE;
+        }
+      g_clear_pointer (&job->yaml, g_bytes_unref);
+    }
+
+  return TRUE;
+}
+
+
+/*
+ * Dumps the index as a YAML stream written to @handler, emitting modules on
+ * as many threads as modulemd_module_index_set_emit_threads() allows.
+ */
+static gboolean
+dump_to_output (ModulemdModuleIndex *self,
+                yaml_write_handler_t *handler,
+                void *data,
+                GError **error)
+{
+  guint threads = self->emit_threads;
+  g_autoptr (GPtrArray) modules = NULL;
+
+  if (threads == 0)
+    {
+      threads = g_get_num_processors ();
+    }
+
+  if (threads > 1 && g_hash_table_size (self->modules) > 1)
+    {
+      modules =
+        modulemd_ordered_str_keys (self->modules, modulemd_strcmp_sort);
+      return dump_to_output_parallel (
+        self, modules, threads, handler, data, error);
+    }
+
+  MMD_INIT_YAML_EMITTER (emitter);
+  yaml_emitter_set_output (&emitter, handler, data);
+
+  return modulemd_module_index_dump_to_emitter (self, &emitter, error);
+}
+
+
+static int
+write_yaml_file (void *data, unsigned char *buffer, size_t size)
+{
+  return fwrite (buffer, 1, size, (FILE *)data) == size;
+}
+
+
+static GVariant *
+dump_to_binary_variant (ModulemdModuleIndex *self, GError **error);
+
+static gboolean
+update_from_binary_variant (ModulemdModuleIndex *self,
+                            GVariant *variant,
+                            gboolean strict,
+                            GPtrArray **failures,
+                            GError **error);
+
+
+/* The binary form of an index is a GVariant of type MMD_BINARY_TYPE: a magic
+ * string, the version of libmodulemd that wrote it, the format version and
+ * the contents in the format of that version. Only the library version that
+ * wrote an index reads it, since the contents are in the YAML of that
+ * version. Version 2 contents are MMD_BINARY_V2_TYPE: a YAML stream holding
+ * all of the defaults and translations, followed by every module stream as
+ * its header, whether it was validated before it was written and the YAML of
+ * its document. The streams are loaded as lazy streams, whose YAML is read
+ * from the binary index itself once they are parsed.
+ */
+#define MMD_BINARY_MAGIC "libmodulemd-index"
+#define MMD_BINARY_VERSION 2
+#define MMD_BINARY_TYPE "(ssuv)"
+#define MMD_BINARY_V2_TYPE "(sa(usstmsmsbs))"
+
+
+/* A cache entry is a GVariant of type MMD_CACHE_TYPE: a magic string, the
+ * identity of the file it was read from and the contents of that file as a
+ * binary index. The identity includes the versions of libmodulemd and of the
+ * binary format that wrote the entry. There is one entry per path, and it is
+ * stale as soon as any of the rest no longer matches.
+ */
+#define MMD_CACHE_MAGIC "libmodulemd-cache"
+#define MMD_CACHE_IDENTITY_TYPE "(tttxbsu)"
+#define MMD_CACHE_TYPE "(s" MMD_CACHE_IDENTITY_TYPE "v)"
+#define MMD_CACHE_SUFFIX ".mmdcache"
+
+
+static gchar *
+cache_entry_path (const gchar *cache_dir, const gchar *yaml_file)
+{
+  g_autofree gchar *cwd = NULL;
+  g_autofree gchar *abs_path = NULL;
+  g_autofree gchar *checksum = NULL;
+  g_autofree gchar *basename = NULL;
+
+  if (g_path_is_absolute (yaml_file))
+    {
+      abs_path = g_strdup (yaml_file);
+    }
+  else
+    {
+      cwd = g_get_current_dir ();
+      abs_path = g_build_filename (cwd, yaml_file, NULL);
+    }
+
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA256, abs_path, -1);
+  basename = g_strconcat (checksum, MMD_CACHE_SUFFIX, NULL);
+
+  return g_build_filename (cache_dir, basename, NULL);
+}
+
+
+/*
+ * Returns: (transfer full): The device, inode, size and modification time of
+ * the file open at @fd along with @strict and the versions of libmodulemd and
+ * of the binary format, or NULL if the file cannot be read.
+ */
+static GVariant *
+cache_file_identity (int fd, gboolean strict)
+{
+  struct stat st;
+
+  if (fstat (fd, &st) != 0)
+    {
+      return NULL;
+    }
+
+  return g_variant_ref_sink (g_variant_new (
+    MMD_CACHE_IDENTITY_TYPE,
+    (guint64)st.st_dev,
+    (guint64)st.st_ino,
+    (guint64)st.st_size,
+    (gint64)st.st_mtim.tv_sec * G_GINT64_CONSTANT (1000000000) +
+      st.st_mtim.tv_nsec,
+    strict,
+    LIBMODULEMD_VERSION,
+    MMD_BINARY_VERSION));
+}
+
+
+/*
+ * Returns: (transfer full): The binary index stored in the cache entry at
+ * @cache_path if it is for a file with @identity, or NULL.
+ */
+static GVariant *
+cache_lookup (const gchar *cache_path, GVariant *identity)
+{
+  g_autoptr (GMappedFile) mapped = NULL;
+  g_autoptr (GBytes) bytes = NULL;
+  g_autoptr (GVariant) entry = NULL;
+  g_autoptr (GVariant) entry_identity = NULL;
+  g_autoptr (GVariant) binary = NULL;
+  const gchar *magic = NULL;
+
+  mapped = g_mapped_file_new (cache_path, FALSE, NULL);
+  if (mapped == NULL)
+    {
+      return NULL;
+    }
+
+  bytes = g_mapped_file_get_bytes (mapped);
+  entry = g_variant_ref_sink (
+    g_variant_new_from_bytes (G_VARIANT_TYPE (MMD_CACHE_TYPE), bytes, FALSE));
+  g_variant_get (entry,
+                 "(&s@" MMD_CACHE_IDENTITY_TYPE "v)",
+                 &magic,
+                 &entry_identity,
+                 &binary);
+
+  if (!g_str_equal (magic, MMD_CACHE_MAGIC) ||
+      !g_variant_equal (entry_identity, identity) ||
+      !g_variant_is_of_type (binary, G_VARIANT_TYPE (MMD_BINARY_TYPE)))
+    {
+      g_debug ("Ignoring stale cache entry %s", cache_path);
+      return NULL;
+    }
+
+  return g_steal_pointer (&binary);
+}
+
+
+/*
+ * Replaces the cache entry at @cache_path with the contents of @self. Errors
+ * are not fatal, since the file has been read already.
+ */
+static void
+cache_store (ModulemdModuleIndex *self,
+             const gchar *cache_path,
+             GVariant *identity)
+{
+  g_autoptr (GVariant) binary = NULL;
+  g_autoptr (GVariant) entry = NULL;
+  g_autoptr (GBytes) bytes = NULL;
+  g_autoptr (GError) nested_error = NULL;
+
+  binary = dump_to_binary_variant (self, &nested_error);
+  if (binary == NULL)
+    {
+      g_debug ("Not caching %s: %s", cache_path, nested_error->message);
+      return;
+    }
+
+  entry = g_variant_ref_sink (
+    g_variant_new ("(s@" MMD_CACHE_IDENTITY_TYPE "v)",
+                   MMD_CACHE_MAGIC,
+                   identity,
+                   binary));
+  bytes = g_variant_get_data_as_bytes (entry);
+
+  if (g_mkdir_with_parents (self->cache_dir, 0755) != 0 ||
+      !g_file_set_contents (cache_path,
+                            g_bytes_get_data (bytes, NULL),
+                            g_bytes_get_size (bytes),
+                            &nested_error))
+    {
+      g_debug ("Could not write cache entry %s: %s",
+               cache_path,
+               nested_error ? nested_error->message : g_strerror (errno));
+    }
+}
+
+
+static gboolean
+update_from_open_file (ModulemdModuleIndex *self,
+                       const gchar *yaml_file,
+                       FILE *yaml_stream,
+                       gboolean strict,
+                       GPtrArray **failures,
+                       GError **error)
+{
+  g_autoptr (GMappedFile) mapped = NULL;
+  g_autoptr (GError) nested_error = NULL;
+  int fd;
+  ModulemdCompressionTypeEnum comtype;
+  g_autofree gchar *fmode = NULL;
+  g_autoptr (modulemd_decompressor) decompressor = NULL;
+  gboolean ret;
+
+  /* To avoid TOCTOU race conditions, do everything from the same opened
+   * file
+   */
+  fd = fileno (yaml_stream);
+
+  /* Determine if the file is compressed */
+  comtype = modulemd_detect_compression (yaml_file, fd, &nested_error);
+  if (comtype == MODULEMD_COMPRESSION_TYPE_DETECTION_FAILED)
+    {
+      g_propagate_error (error, g_steal_pointer (&nested_error));
+      return FALSE;
+    }
+  if (comtype == MODULEMD_COMPRESSION_TYPE_NO_COMPRESSION ||
+      comtype == MODULEMD_COMPRESSION_TYPE_UNKNOWN_COMPRESSION)
+    {
+      /* If it's not compressed (or we can't figure out what compression is in
+       * use), map it and let libyaml read it straight out of memory. If it
+       * cannot be mapped, just use the libyaml function. It's fast and will
+       * fail quickly if the file is unreadable.
+       */
+      mapped = modulemd_yaml_map_file (fd);
+      if (mapped == NULL)
+        {
+          return modulemd_module_index_update_from_stream (
+            self, yaml_stream, strict, failures, error);
+        }
+
+      MMD_INIT_YAML_CAPTURE (capture);
+      MMD_INIT_YAML_PARSER (parser);
+
+      modulemd_yaml_capture_set_input_string (
+        &capture,
+        &parser,
+        g_mapped_file_get_contents (mapped),
+        g_mapped_file_get_length (mapped));
+
+      return modulemd_module_index_update_from_parser (
+        self, &parser, &capture, strict, FALSE, failures, error);
+    }
+
+  /* Prefer the decompressors built into libmodulemd and only fall back to
+   * rpmio for compression types that they do not cover.
+   */
+  decompressor = modulemd_decompressor_new (comtype, fd, &nested_error);
+  if (decompressor != NULL)
+    {
+      ret = modulemd_module_index_update_from_custom (
+        self,
+        modulemd_decompressor_read_fn,
+        decompressor,
+        strict,
+        failures,
+        &nested_error);
+
+      /* A decompression failure surfaces from libyaml as a generic read
+       * error, so report the real reason instead.
+       */
+      if (modulemd_decompressor_get_error (decompressor) != NULL)
+        {
+          g_propagate_error (
+            error,
+            g_error_copy (modulemd_decompressor_get_error (decompressor)));
+          return FALSE;
+        }
+      if (!ret)
+        {
+          g_propagate_error (error, g_steal_pointer (&nested_error));
+        }
+      return ret;
+    }
+  if (!g_error_matches (
+        nested_error, MODULEMD_ERROR, MODULEMD_ERROR_NOT_IMPLEMENTED))
+    {
+      g_propagate_error (error, g_steal_pointer (&nested_error));
+      return FALSE;
+    }
+  g_clear_error (&nested_error);
+
+#ifdef HAVE_RPMIO
+  /* We're handling a compressed input file, so we'll use librpm's "rpmio"
+   * suite of tools to deal with it. We need to construct a special "mode"
+   * argument to pass to Fdopen().
+   */
+  FD_t rpmio_fd = NULL;
+  g_auto (FD_t) fd_dup = NULL;
+  int saved_errno;
+
+  fmode = modulemd_get_rpmio_fmode ("r", comtype);
+  if (!fmode)
+    {
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_FILE_ACCESS,
+                   "Unable to construct rpmio fmode from comtype [%d]",
+                   comtype);
+      return FALSE;
+    }
+
+  /* Create an rpmio file descriptor object from the current file descriptor,
+   * setting the appropriate "mode" so that librpm will read it with the
+   * correct handlers.
+   */
+  fd_dup = fdDup (fd);
+  saved_errno = errno;
+  if (!fd_dup)
+    {
+      g_set_error (
+        error,
+        MODULEMD_ERROR,
+        MODULEMD_ERROR_NOT_IMPLEMENTED,
+        "Cannot open compressed file. Error in rpmio::fdDup(%d): %s",
+        fd,
+        strerror (saved_errno));
+      return FALSE;
+    }
+
+  g_debug ("Calling rpmio::Fdopen (%p, %s)", fd_dup, fmode);
+  rpmio_fd = Fdopen (fd_dup, fmode);
+
+  if (!rpmio_fd)
+    {
+      g_set_error_literal (
+        error,
+        MODULEMD_ERROR,
+        MODULEMD_ERROR_NOT_IMPLEMENTED,
+        "Cannot open compressed file. Error in rpmio::Fdopen().");
+      return FALSE;
+    }
+
+  g_debug ("rpmio::Fdopen (%p, %s) succeeded", fd_dup, fmode);
+
+  return modulemd_module_index_update_from_custom (
+    self, compressed_stream_read_fn, rpmio_fd, strict, failures, error);
+
+#else /* HAVE_RPMIO */
+  g_set_error_literal (
+    error,
+    MODULEMD_ERROR,
+    MODULEMD_ERROR_NOT_IMPLEMENTED,
+    "Cannot open compressed file. libmodulemd was not compiled "
+    "with rpmio support.");
+  return FALSE;
+#endif /* HAVE_RPMIO */
+}
+
+
+gboolean
+modulemd_module_index_update_from_file (ModulemdModuleIndex *self,
+                                        const gchar *yaml_file,
+                                        gboolean strict,
+                                        GPtrArray **failures,
+                                        GError **error)
+{
+  if (*failures == NULL)
+    {
+      *failures = g_ptr_array_new_full (0, g_object_unref);
+    }
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+
+  int saved_errno;
+  g_autoptr (FILE) yaml_stream = NULL;
+  g_autofree gchar *cache_path = NULL;
+  g_autoptr (GVariant) identity = NULL;
+  g_autoptr (GVariant) cached = NULL;
+  gboolean was_empty;
+
+  yaml_stream = g_fopen (yaml_file, "rbe");
+  saved_errno = errno;
+
+  if (yaml_stream == NULL)
+    {
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_YAML_ERROR_OPEN,
+                   "Failed to open file: %s",
+                   g_strerror (saved_errno));
+      return FALSE;
+    }
+
+  if (self->cache_dir != NULL)
+    {
+      identity = cache_file_identity (fileno (yaml_stream), strict);
+    }
+
+  if (identity == NULL)
+    {
+      return update_from_open_file (
+        self, yaml_file, yaml_stream, strict, failures, error);
+    }
+
+  cache_path = cache_entry_path (self->cache_dir, yaml_file);
+  cached = cache_lookup (cache_path, identity);
+  if (cached != NULL)
+    {
+      g_debug ("Reading %s from cache entry %s", yaml_file, cache_path);
+      return update_from_binary_variant (
+        self, cached, strict, failures, error);
+    }
+
+  was_empty = g_hash_table_size (self->modules) == 0;
+  if (!update_from_open_file (
+        self, yaml_file, yaml_stream, strict, failures, error))
+    {
+      return FALSE;
+    }
+
+  /* The entry is made from the whole index, so it can only be stored when
+   * the index holds nothing but what was read from this file.
+   */
+  if (was_empty && (*failures)->len == 0)
+    {
+      cache_store (self, cache_path, identity);
+    }
+
+  return TRUE;
+}
+
+
+gboolean
+modulemd_module_index_update_from_string (ModulemdModuleIndex *self,
+                                          const gchar *yaml_string,
+                                          gboolean strict,
+                                          GPtrArray **failures,
+                                          GError **error)
+{
+  if (*failures == NULL)
+    {
+      *failures = g_ptr_array_new_full (0, g_object_unref);
+    }
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+
+  if (!yaml_string)
+    {
+      g_set_error (
+        error, MODULEMD_ERROR, MODULEMD_YAML_ERROR_OPEN, "No string provided");
+      return FALSE;
+    }
+
+  MMD_INIT_YAML_CAPTURE (capture);
+  MMD_INIT_YAML_PARSER (parser);
+
+  modulemd_yaml_capture_set_input_string (
+    &capture, &parser, yaml_string, strlen (yaml_string));
+
+  return modulemd_module_index_update_from_parser (
+    self, &parser, &capture, strict, FALSE, failures, error);
+}
+
+
+gboolean
+modulemd_module_index_update_from_stream (ModulemdModuleIndex *self,
+                                          FILE *yaml_stream,
+                                          gboolean strict,
+                                          GPtrArray **failures,
+                                          GError **error)
+{
+  if (*failures == NULL)
+    {
+      *failures = g_ptr_array_new_full (0, g_object_unref);
+    }
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+
+  if (!yaml_stream)
+    {
+      g_set_error (
+        error, MODULEMD_ERROR, MODULEMD_YAML_ERROR_OPEN, "No stream provided");
+      return FALSE;
+    }
+
+  MMD_INIT_YAML_CAPTURE (capture);
+  MMD_INIT_YAML_PARSER (parser);
+
+  modulemd_yaml_capture_set_input_file (&capture, &parser, yaml_stream);
+
+  return modulemd_module_index_update_from_parser (
+    self, &parser, &capture, strict, FALSE, failures, error);
+}
+
+
+gboolean
+modulemd_module_index_update_from_custom (ModulemdModuleIndex *self,
+                                          ModulemdReadHandler custom_read_fn,
+                                          void *custom_pvt_data,
+                                          gboolean strict,
+                                          GPtrArray **failures,
+                                          GError **error)
+{
+  if (*failures == NULL)
+    {
+      *failures = g_ptr_array_new_full (0, g_object_unref);
+    }
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+  g_return_val_if_fail (custom_read_fn, FALSE);
+
+  MMD_INIT_YAML_CAPTURE (capture);
+  MMD_INIT_YAML_PARSER (parser);
+
+  modulemd_yaml_capture_set_input (
+    &capture, &parser, custom_read_fn, custom_pvt_data);
+
+  return modulemd_module_index_update_from_parser (
+    self, &parser, &capture, strict, FALSE, failures, error);
+}
+
+
+/* One file of a directory being read by modules_from_directory() */
+typedef struct
+{
+  gchar *path;
+  const gchar *cache_dir;
+  gboolean strict;
+  gboolean strict_default_streams;
+
+  /* The contents of this file */
+  ModulemdModuleIndex *index;
+
+  GError *error;
+} DirectoryJob;
+
+
+static void
+directory_job_clear (DirectoryJob *job)
+{
+  g_clear_pointer (&job->path, g_free);
+  g_clear_object (&job->index);
+  g_clear_error (&job->error);
+}
+
+
+static void
+directory_job_read (gpointer data, gpointer user_data)
+{
+  DirectoryJob *job = (DirectoryJob *)data;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) nested_error = NULL;
+  ModulemdSubdocumentInfo *subdoc = NULL;
+
+  g_debug ("Reading modulemd from %s", job->path);
+
+  job->index = modulemd_module_index_new ();
+  modulemd_module_index_set_cache_dir (job->index, job->cache_dir);
+  if (modulemd_module_index_update_from_file (
+        job->index, job->path, job->strict, &failures, &nested_error))
+    {
+      return;
+    }
+
+  /* Report the first subdocument that could not be read */
+  if (nested_error == NULL && failures->len > 0)
+    {
+      subdoc = g_ptr_array_index (failures, 0);
+      nested_error =
+        g_error_copy (modulemd_subdocument_info_get_gerror (subdoc));
+    }
+
+  if (nested_error != NULL)
+    {
+      g_propagate_prefixed_error (
+        &job->error, g_steal_pointer (&nested_error), "%s: ", job->path);
+    }
+}
+
+
+/*
+ * Runs @func on each of @targets on a thread pool and waits for them all to
+ * finish.
+ */
+static gboolean
+run_directory_jobs (GPtrArray *targets, GFunc func, GError **error)
+{
+  GThreadPool *pool = NULL;
+  guint i;
+
+  pool = g_thread_pool_new (func,
+                            NULL,
+                            MIN (g_get_num_processors (), targets->len),
+                            FALSE,
+                            error);
+  if (pool == NULL)
+    {
+      return FALSE;
+    }
+
+  for (i = 0; i < targets->len; i++)
+    {
+      g_thread_pool_push (pool, g_ptr_array_index (targets, i), NULL);
+    }
+
+  g_thread_pool_free (pool, FALSE, TRUE);
+  return TRUE;
+}
+
+
+/*
+ * modules_from_directory:
+ * @path: A directory containing one or more modulemd YAML documents
+ * @file_suffix: A file suffix to limit the files to be read. Pass "" if you
+ * need to read all files.
+ * @strict: Whether to fail on unknown fields
+ * @strict_default_streams: Whether to fail on default stream merges.
+ * @cache_dir: The cache directory to read the files through, or NULL
+ * @error: Error return value
+ *
+ * The files are read concurrently, each into its own index. The indexes are
+ * then merged one at a time in the order of their file names, since the
+ * result of merging several of them, or whether it fails, can depend on
+ * the order in which they are merged.
+ */
+static ModulemdModuleIndex *
+modules_from_directory (const gchar *path,
+                        const gchar *file_suffix,
+                        gboolean strict,
+                        gboolean strict_default_streams,
+                        const gchar *cache_dir,
+                        GError **error)
+{
+  const gchar *filename = NULL;
+  g_autoptr (GDir) dir = NULL;
+  g_autoptr (GPtrArray) filenames = NULL;
+  g_autoptr (GArray) jobs = NULL;
+  g_autoptr (GPtrArray) targets = NULL;
+  g_autoptr (ModulemdModuleIndex) index = NULL;
+  g_autoptr (GError) nested_error = NULL;
+  DirectoryJob job;
+  DirectoryJob *target = NULL;
+  guint i;
+
+  /* Open the directory */
+  dir = g_dir_open (path, 0, &nested_error);
+  if (!dir)
+    {
+      g_propagate_error (error, g_steal_pointer (&nested_error));
+      return FALSE;
+    }
+
+  filenames = g_ptr_array_new_with_free_func (g_free);
+  while ((filename = g_dir_read_name (dir)) != NULL)
+    {
+      if (g_str_has_suffix (filename, file_suffix))
+        {
+          g_ptr_array_add (filenames, g_strdup (filename));
+        }
+    }
+
+  if (filenames->len == 0)
+    {
+      return modulemd_module_index_new ();
+    }
+
+  /* Sort the files so that errors are reported consistently */
+  g_ptr_array_sort (filenames, modulemd_strcmp_sort);
+
+  jobs = g_array_sized_new (
+    FALSE, TRUE, sizeof (DirectoryJob), filenames->len);
+  g_array_set_clear_func (jobs, (GDestroyNotify)directory_job_clear);
+  targets = g_ptr_array_sized_new (filenames->len);
+  for (i = 0; i < filenames->len; i++)
+    {
+      memset (&job, 0, sizeof (DirectoryJob));
+      job.path =
+        g_build_path ("/", path, g_ptr_array_index (filenames, i), NULL);
+      job.cache_dir = cache_dir;
+      job.strict = strict;
+      job.strict_default_streams = strict_default_streams;
+      g_array_append_val (jobs, job);
+    }
+
+  for (i = 0; i < jobs->len; i++)
+    {
+      g_ptr_array_add (targets, &g_array_index (jobs, DirectoryJob, i));
+    }
+
+  if (!run_directory_jobs (targets, directory_job_read, error))
+    {
+      return NULL;
+    }
+
+  index = modulemd_module_index_new ();
+  for (i = 0; i < jobs->len; i++)
+    {
+      target = &g_array_index (jobs, DirectoryJob, i);
+      if (target->error)
+        {
+          g_propagate_error (error, g_steal_pointer (&target->error));
+          return NULL;
+        }
+
+      if (!modulemd_module_index_merge (target->index,
+                                        index,
+                                        FALSE,
+                                        target->strict_default_streams,
+                                        &nested_error))
+        {
+          g_propagate_error (error, g_steal_pointer (&nested_error));
+          return NULL;
+        }
+    }
+
+  return g_steal_pointer (&index);
+}
+
+
+gboolean
+modulemd_module_index_update_from_defaults_directory (
+  ModulemdModuleIndex *self,
+  const gchar *path,
+  gboolean strict,
+  const gchar *overrides_path,
+  GError **error)
+{
+  g_autoptr (ModulemdModuleIndex) defaults_idx = NULL;
+  g_autoptr (ModulemdModuleIndex) override_idx = NULL;
+  g_autoptr (GError) nested_error = NULL;
+
+  /* Read the regular path first */
+  defaults_idx = modules_from_directory (
+    path, MMD_YAML_SUFFIX, strict, strict, self->cache_dir, &nested_error);
+  if (!defaults_idx)
+    {
+      g_propagate_error (error, g_steal_pointer (&nested_error));
+      return FALSE;
+    }
+
+  /* If an override path was provided, use that too */
+  if (overrides_path)
+    {
+      override_idx = modules_from_directory (overrides_path,
+                                             MMD_YAML_SUFFIX,
+                                             strict,
+                                             strict,
+                                             self->cache_dir,
+                                             &nested_error);
+      if (!override_idx)
+        {
+          g_propagate_error (error, g_steal_pointer (&nested_error));
+          return FALSE;
+        }
+
+      if (!modulemd_module_index_merge (
+            override_idx, defaults_idx, TRUE, strict, &nested_error))
+        {
+          g_propagate_error (error, g_steal_pointer (&nested_error));
+          return FALSE;
+        }
+    }
+
+  /* Now that we've verified that the content in the two paths is compatible,
+   * attempt to merge it into the existing index.
+   */
+  if (!modulemd_module_index_merge (
+        defaults_idx, self, TRUE, strict, &nested_error))
+    {
+      g_propagate_error (error, g_steal_pointer (&nested_error));
+      return FALSE;
+    }
+
+
+  return TRUE;
+}
+
+
+gchar *
+modulemd_module_index_dump_to_string (ModulemdModuleIndex *self,
+                                      GError **error)
+{
+  g_autoptr (modulemd_yaml_string) yaml_string = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), NULL);
+
+  yaml_string = g_malloc0_n (1, sizeof (modulemd_yaml_string));
+
+  if (!dump_to_output (self, write_yaml_string, yaml_string, error))
+    {
+      return NULL;
+    }
+
+  return g_steal_pointer (&yaml_string->str);
+}
+
+
+gboolean
+modulemd_module_index_dump_to_stream (ModulemdModuleIndex *self,
+                                      FILE *yaml_stream,
+                                      GError **error)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+
+  return dump_to_output (self, write_yaml_file, yaml_stream, error);
+}
+
+
+gboolean
+modulemd_module_index_dump_to_custom (ModulemdModuleIndex *self,
+                                      ModulemdWriteHandler custom_write_fn,
+                                      void *custom_pvt_data,
+                                      GError **error)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+
+  return dump_to_output (self, custom_write_fn, custom_pvt_data, error);
+}
+
+
+gchar *
+modulemd_module_index_dump_to_file (ModulemdModuleIndex *self,
+                                    const gchar *path,
+                                    ModulemdCompressionTypeEnum comtype,
+                                    gint level,
+                                    GError **error)
+{
+  g_autofree gchar *filename = NULL;
+  g_autoptr (FILE) yaml_stream = NULL;
+  g_autoptr (GError) nested_error = NULL;
+  modulemd_compressed_writer *writer = NULL;
+  const gchar *suffix = NULL;
+  gboolean emitted;
+  int saved_errno;
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), NULL);
+  g_return_val_if_fail (path, NULL);
+  g_return_val_if_fail (level >= 0 && level <= 9, NULL);
+
+  suffix = modulemd_compression_suffix (comtype);
+  if (suffix && !g_str_has_suffix (path, suffix))
+    {
+      filename = g_strconcat (path, suffix, NULL);
+    }
+  else
+    {
+      filename = g_strdup (path);
+    }
+
+  if (comtype == MODULEMD_COMPRESSION_TYPE_NO_COMPRESSION)
+    {
+      yaml_stream = g_fopen (filename, "wbe");
+      saved_errno = errno;
+
+      if (yaml_stream == NULL)
+        {
+          g_set_error (error,
+                       MODULEMD_ERROR,
+                       MODULEMD_ERROR_FILE_ACCESS,
+                       "Failed to open file: %s",
+                       g_strerror (saved_errno));
+          return NULL;
+        }
+
+      emitted =
+        dump_to_output (self, write_yaml_file, yaml_stream, &nested_error);
+
+      if (emitted && fclose (g_steal_pointer (&yaml_stream)) != 0)
+        {
+          saved_errno = errno;
+          g_set_error (&nested_error,
+                       MODULEMD_ERROR,
+                       MODULEMD_ERROR_FILE_ACCESS,
+                       "Failed to write file: %s",
+                       g_strerror (saved_errno));
+          emitted = FALSE;
+        }
+    }
+  else
+    {
+      /* The emitter fills buffers that are compressed on another thread */
+      writer =
+        modulemd_compressed_writer_new (filename, comtype, level, error);
+      if (writer == NULL)
+        {
+          return NULL;
+        }
+
+      emitted = dump_to_output (
+        self, modulemd_compressed_writer_write_fn, writer, &nested_error);
+
+      /* Report the first error, but always wait for the thread to finish */
+      if (!modulemd_compressed_writer_close (
+            writer, emitted ? &nested_error : NULL))
+        {
+          emitted = FALSE;
+        }
+    }
+
+  if (!emitted)
+    {
+      g_clear_pointer (&yaml_stream, fclose);
+      g_unlink (filename);
+      g_propagate_error (error, g_steal_pointer (&nested_error));
+      return NULL;
+    }
+
+  return g_steal_pointer (&filename);
+}
+
+
+static gchar *
+dump_stream_to_string (ModulemdModuleStream *stream, GError **error)
+{
+  MMD_INIT_YAML_EMITTER (emitter);
+  MMD_INIT_YAML_STRING (&emitter, yaml_string);
+
+  if (!mmd_emitter_start_stream (&emitter, error) ||
+      !dump_stream (stream, &emitter, error) ||
+      !mmd_emitter_end_stream (&emitter, error))
+    {
+      return NULL;
+    }
+
+  return g_steal_pointer (&yaml_string->str);
+}
+
+
+static gchar *
+dump_defaults_and_translations (ModulemdModuleIndex *self,
+                                GPtrArray *modules,
+                                GError **error)
+{
+  ModulemdModule *module = NULL;
+  g_autoptr (GPtrArray) translated = NULL;
+  gboolean empty = TRUE;
+  gsize i;
+
+  MMD_INIT_YAML_EMITTER (emitter);
+  MMD_INIT_YAML_STRING (&emitter, yaml_string);
+
+  if (!mmd_emitter_start_stream (&emitter, error))
+    {
+      return NULL;
+    }
+
+  for (i = 0; i < modules->len; i++)
+    {
+      module = modulemd_module_index_get_module (
+        self, g_ptr_array_index (modules, i));
+      translated = modulemd_module_get_translated_streams (module);
+      empty = empty && modulemd_module_get_defaults (module) == NULL &&
+              translated->len == 0;
+      g_clear_pointer (&translated, g_ptr_array_unref);
+
+      if (!dump_defaults (module, &emitter, error) ||
+          !dump_translations (module, &emitter, error))
+        {
+          return NULL;
+        }
+    }
+
+  if (!mmd_emitter_end_stream (&emitter, error))
+    {
+      return NULL;
+    }
+
+  if (empty)
+    {
+      return g_strdup ("");
+    }
+
+  return g_steal_pointer (&yaml_string->str);
+}
+
+
+/*
+ * Adds an entry for either @stream or @lazy to the GVariantBuilder in
+ * @user_data.
+ */
+static gboolean
+add_binary_stream (ModulemdModuleStream *stream,
+                   modulemd_lazy_stream *lazy,
+                   gpointer user_data,
+                   GError **error)
+{
+  GVariantBuilder *builder = (GVariantBuilder *)user_data;
+  gchar *stream_yaml = NULL;
+
+  if (lazy != NULL)
+    {
+      /* A stream that was never parsed is written as it was read */
+      g_variant_builder_add (
+        builder,
+        "(usstmsmsbs)",
+        (guint32)modulemd_subdocument_info_get_mdversion (lazy->subdoc),
+        lazy->module_name,
+        lazy->stream_name,
+        lazy->version,
+        lazy->context,
+        lazy->arch,
+        lazy->validated,
+        modulemd_subdocument_info_get_yaml (lazy->subdoc));
+      return TRUE;
+    }
+
+  stream_yaml = dump_stream_to_string (stream, error);
+  if (stream_yaml == NULL)
+    {
+      return FALSE;
+    }
+
+  /* The stream was validated to emit it. The YAML is handed over to the
+   * variant without copying it.
+   */
+  g_variant_builder_add (builder,
+                         "(usstmsmsb@s)",
+                         modulemd_module_stream_get_mdversion (stream),
+                         modulemd_module_stream_get_module_name (stream),
+                         modulemd_module_stream_get_stream_name (stream),
+                         modulemd_module_stream_get_version (stream),
+                         modulemd_module_stream_get_context (stream),
+                         modulemd_module_stream_get_arch (stream),
+                         TRUE,
+                         g_variant_new_take_string (stream_yaml));
+
+  return TRUE;
+}
+
+
+static GVariant *
+dump_to_binary_variant (ModulemdModuleIndex *self, GError **error)
+{
+  ModulemdModule *module = NULL;
+  g_autoptr (GPtrArray) modules = NULL;
+  g_autofree gchar *other_yaml = NULL;
+  GVariantBuilder builder;
+  gsize i;
+
+  modules = modulemd_ordered_str_keys (self->modules, modulemd_strcmp_sort);
+  if (modules->len == 0)
+    {
+      g_set_error_literal (error,
+                           MODULEMD_ERROR,
+                           MODULEMD_ERROR_VALIDATE,
+                           "Index contains no modules.");
+      return NULL;
+    }
+
+  other_yaml = dump_defaults_and_translations (self, modules, error);
+  if (other_yaml == NULL)
+    {
+      return NULL;
+    }
+
+  g_variant_builder_init (&builder, G_VARIANT_TYPE ("a(usstmsmsbs)"));
+
+  /* The streams are written in the order in which they were added, so that
+   * they load in the same order. Lazy streams are not parsed.
+   */
+  for (i = 0; i < modules->len; i++)
+    {
+      module = modulemd_module_index_get_module (
+        self, g_ptr_array_index (modules, i));
+      if (!modulemd_module_foreach_stream (
+            module, add_binary_stream, &builder, error))
+        {
+          g_variant_builder_clear (&builder);
+          return NULL;
+        }
+    }
+
+  return g_variant_ref_sink (
+    g_variant_new (MMD_BINARY_TYPE,
+                   MMD_BINARY_MAGIC,
+                   LIBMODULEMD_VERSION,
+                   MMD_BINARY_VERSION,
+                   g_variant_new (MMD_BINARY_V2_TYPE, other_yaml, &builder)));
+}
+
+
+GBytes *
+modulemd_module_index_dump_to_binary (ModulemdModuleIndex *self,
+                                      GError **error)
+{
+  g_autoptr (GVariant) variant = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), NULL);
+
+  variant = dump_to_binary_variant (self, error);
+  if (variant == NULL)
+    {
+      return NULL;
+    }
+
+  return g_variant_get_data_as_bytes (variant);
+}
+
+
+gboolean
+modulemd_module_index_dump_to_binary_file (ModulemdModuleIndex *self,
+                                           const gchar *path,
+                                           GError **error)
+{
+  g_autoptr (GBytes) bytes = NULL;
+  g_autoptr (GError) nested_error = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+  g_return_val_if_fail (path, FALSE);
+
+  bytes = modulemd_module_index_dump_to_binary (self, error);
+  if (bytes == NULL)
+    {
+      return FALSE;
+    }
+
+  /* Replace the file atomically so that readers never map a partial one */
+  if (!g_file_set_contents (path,
+                            g_bytes_get_data (bytes, NULL),
+                            g_bytes_get_size (bytes),
+                            &nested_error))
+    {
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_FILE_ACCESS,
+                   "Failed to write file: %s",
+                   nested_error->message);
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+
+/*
+ * Adds the binary index in @variant to @self. Its streams are parsed as
+ * strictly as @strict says once they are first used.
+ */
+static gboolean
+update_from_binary_variant (ModulemdModuleIndex *self,
+                            GVariant *variant,
+                            gboolean strict,
+                            GPtrArray **failures,
+                            GError **error)
+{
+  g_autoptr (GVariant) contents = NULL;
+  g_autoptr (GVariant) streams = NULL;
+  g_autoptr (GVariant) stream_yaml = NULL;
+  g_autoptr (GError) nested_error = NULL;
+  g_autoptr (modulemd_lazy_stream) lazy = NULL;
+  ModulemdSubdocumentInfo *failure = NULL;
+  const gchar *magic = NULL;
+  const gchar *library_version = NULL;
+  const gchar *other_yaml = NULL;
+  const gchar *module_name = NULL;
+  const gchar *stream_name = NULL;
+  const gchar *context = NULL;
+  const gchar *arch = NULL;
+  guint32 version;
+  guint32 mdversion;
+  gboolean ret = TRUE;
+  gsize i;
+
+  g_variant_get (
+    variant, "(&s&suv)", &magic, &library_version, &version, &contents);
+
+  if (!g_str_equal (magic, MMD_BINARY_MAGIC))
+    {
+      g_set_error_literal (error,
+                           MODULEMD_ERROR,
+                           MODULEMD_ERROR_VALIDATE,
+                           "Not a binary libmodulemd index");
+      return FALSE;
+    }
+
+  if (!g_str_equal (library_version, LIBMODULEMD_VERSION))
+    {
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_NOT_IMPLEMENTED,
+                   "Binary index was written by libmodulemd %s, not %s",
+                   library_version,
+                   LIBMODULEMD_VERSION);
+      return FALSE;
+    }
+
+  if (version != MMD_BINARY_VERSION ||
+      !g_variant_is_of_type (contents, G_VARIANT_TYPE (MMD_BINARY_V2_TYPE)))
+    {
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_NOT_IMPLEMENTED,
+                   "Unsupported binary index format version %u",
+                   version);
+      return FALSE;
+    }
+
+  g_variant_get (contents, "(&s@a(usstmsmsbs))", &other_yaml, &streams);
+
+  if (*other_yaml != '\0' &&
+      !modulemd_module_index_update_from_string (
+        self, other_yaml, FALSE, failures, &nested_error))
+    {
+      if (nested_error != NULL)
+        {
+          g_propagate_error (error, g_steal_pointer (&nested_error));
+          return FALSE;
+        }
+      ret = FALSE;
+    }
+
+  for (i = 0; i < g_variant_n_children (streams); i++)
+    {
+      lazy = g_new0 (modulemd_lazy_stream, 1);
+      g_variant_get_child (streams,
+                           i,
+                           "(u&s&stm&sm&sb@s)",
+                           &mdversion,
+                           &module_name,
+                           &stream_name,
+                           &lazy->version,
+                           &context,
+                           &arch,
+                           &lazy->validated,
+                           &stream_yaml);
+      lazy->strict = strict;
+
+      /* Like those of lazy streams read from YAML, the header strings go in
+       * the arena of the index.
+       */
+      lazy->module_name =
+        modulemd_string_pool_insert (self->strings, module_name);
+      lazy->stream_name =
+        modulemd_string_pool_insert (self->strings, stream_name);
+      lazy->context = modulemd_string_pool_insert (self->strings, context);
+      lazy->arch = modulemd_string_pool_insert (self->strings, arch);
+      lazy->pooled = TRUE;
+
+      /* The YAML stays where it is until the stream is parsed */
+      lazy->subdoc = modulemd_subdocument_info_new ();
+      modulemd_subdocument_info_set_doctype (lazy->subdoc,
+                                             MODULEMD_YAML_DOC_MODULESTREAM);
+      modulemd_subdocument_info_set_mdversion (lazy->subdoc, mdversion);
+      modulemd_subdocument_info_set_yaml_variant (lazy->subdoc, stream_yaml);
+
+      if ((mdversion != MD_MODULESTREAM_VERSION_ONE &&
+           mdversion != MD_MODULESTREAM_VERSION_TWO) ||
+          *lazy->module_name == '\0' || *lazy->stream_name == '\0')
+        {
+          g_set_error_literal (&nested_error,
+                               MODULEMD_YAML_ERROR,
+                               MODULEMD_YAML_ERROR_PARSE,
+                               "Invalid stream in binary index");
+        }
+      else if (add_lazy_stream (self, g_steal_pointer (&lazy), &nested_error))
+        {
+          g_clear_pointer (&stream_yaml, g_variant_unref);
+          continue;
+        }
+
+      g_clear_pointer (&lazy, modulemd_lazy_stream_free);
+
+      failure = modulemd_subdocument_info_new ();
+      modulemd_subdocument_info_set_yaml_variant (failure, stream_yaml);
+      modulemd_subdocument_info_set_gerror (failure, nested_error);
+      g_ptr_array_add (*failures, failure);
+      g_clear_pointer (&stream_yaml, g_variant_unref);
+      g_clear_error (&nested_error);
+      ret = FALSE;
+    }
+
+  return ret;
+}
+
+
+gboolean
+modulemd_module_index_update_from_binary (ModulemdModuleIndex *self,
+                                          GBytes *bytes,
+                                          GPtrArray **failures,
+                                          GError **error)
+{
+  g_autoptr (GVariant) variant = NULL;
+
+  if (*failures == NULL)
+    {
+      *failures = g_ptr_array_new_full (0, g_object_unref);
+    }
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+  g_return_val_if_fail (bytes, FALSE);
+
+  /* The data is not trusted, so GVariant checks every offset in it as it is
+   * read. Malformed data reads as empty values rather than crashing.
+   */
+  variant = g_variant_ref_sink (
+    g_variant_new_from_bytes (G_VARIANT_TYPE (MMD_BINARY_TYPE), bytes, FALSE));
+
+  return update_from_binary_variant (self, variant, FALSE, failures, error);
+}
+
+
+gboolean
+modulemd_module_index_update_from_binary_file (ModulemdModuleIndex *self,
+                                               const gchar *path,
+                                               GPtrArray **failures,
+                                               GError **error)
+{
+  g_autoptr (GMappedFile) mapped = NULL;
+  g_autoptr (GBytes) bytes = NULL;
+  g_autoptr (GError) nested_error = NULL;
+
+  if (*failures == NULL)
+    {
+      *failures = g_ptr_array_new_full (0, g_object_unref);
+    }
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+  g_return_val_if_fail (path, FALSE);
+
+  /* Read-only pages of the file are shared by every process that loads it */
+  mapped = g_mapped_file_new (path, FALSE, &nested_error);
+  if (mapped == NULL)
+    {
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_FILE_ACCESS,
+                   "Failed to open file: %s",
+                   nested_error->message);
+      return FALSE;
+    }
+
+  bytes = g_mapped_file_get_bytes (mapped);
+
+  return modulemd_module_index_update_from_binary (
+    self, bytes, failures, error);
+}
+
+
+GStrv
+modulemd_module_index_get_module_names_as_strv (ModulemdModuleIndex *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), NULL);
+
+  return modulemd_ordered_str_keys_as_strv (self->modules);
+}
+
+
+ModulemdModule *
+modulemd_module_index_get_module (ModulemdModuleIndex *self,
+                                  const gchar *module_name)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), NULL);
+
+  return g_hash_table_lookup (self->modules, module_name);
+}
+
+
+gboolean
+modulemd_module_index_remove_module (ModulemdModuleIndex *self,
+                                     const gchar *module_name)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+
+  if (!g_hash_table_remove (self->modules, module_name))
+    {
+      return FALSE;
+    }
+
+  self->modules_serial++;
+  return TRUE;
+}
+
+
+GPtrArray *
+modulemd_module_index_search_streams (ModulemdModuleIndex *self,
+                                      const gchar *module_name,
+                                      const gchar *stream_name,
+                                      const gchar *version,
+                                      const gchar *context,
+                                      const gchar *arch)
+{
+  g_autoptr (GPtrArray) matching_streams = NULL;
+  g_autoptr (GPtrArray) module_names = NULL;
+  g_autoptr (GPtrArray) module_streams = NULL;
+  ModulemdModule *module = NULL;
+  const gchar *name = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), NULL);
+
+  matching_streams = g_ptr_array_new ();
+
+  if (module_name && !modulemd_is_glob (module_name))
+    {
+      module = g_hash_table_lookup (self->modules, module_name);
+      if (module == NULL)
+        {
+          return g_steal_pointer (&matching_streams);
+        }
+
+      return modulemd_module_search_streams_by_glob (
+        module, stream_name, version, context, arch);
+    }
+
+  module_names =
+    modulemd_ordered_str_keys (self->modules, modulemd_strcmp_sort);
+  for (guint i = 0; i < module_names->len; i++)
+    {
+      name = g_ptr_array_index (module_names, i);
+      if (!modulemd_glob_matches (module_name, name))
+        {
+          continue;
+        }
+
+      module_streams = modulemd_module_search_streams_by_glob (
+        g_hash_table_lookup (self->modules, name),
+        stream_name,
+        version,
+        context,
+        arch);
+      for (guint j = 0; j < module_streams->len; j++)
+        {
+          g_ptr_array_add (matching_streams,
+                           g_ptr_array_index (module_streams, j));
+        }
+      g_clear_pointer (&module_streams, g_ptr_array_unref);
+    }
+
+  return g_steal_pointer (&matching_streams);
+}
+
+
+/*
+ * Splits the binary RPM @nevra into its name and the name with its
+ * architecture. @canonical is set to @nevra with an explicit zero epoch if
+ * it did not have one, so that "foo-1.0-1.noarch" and "foo-0:1.0-1.noarch"
+ * are the same artifact.
+ *
+ * Returns: FALSE and leaves the out arguments untouched if @nevra is not of
+ * the form name-[epoch:]version-release.arch.
+ */
+static gboolean
+split_nevra (const gchar *nevra,
+             gchar **canonical,
+             gchar **name,
+             gchar **name_arch)
+{
+  const gchar *arch_dot = NULL;
+  const gchar *release_dash = NULL;
+  const gchar *version_dash = NULL;
+  g_autofree gchar *rpm_name = NULL;
+  gboolean has_epoch;
+
+  arch_dot = strrchr (nevra, '.');
+  if (arch_dot == NULL || arch_dot[1] == '\0')
+    {
+      return FALSE;
+    }
+
+  release_dash = g_strrstr_len (nevra, arch_dot - nevra, "-");
+  if (release_dash == NULL)
+    {
+      return FALSE;
+    }
+
+  version_dash = g_strrstr_len (nevra, release_dash - nevra, "-");
+  if (version_dash == NULL || version_dash == nevra)
+    {
+      return FALSE;
+    }
+
+  rpm_name = g_strndup (nevra, version_dash - nevra);
+  has_epoch = memchr (version_dash, ':', release_dash - version_dash) != NULL;
+
+  *canonical = g_strdup_printf (
+    "%s-%s%s", rpm_name, has_epoch ? "" : "0:", version_dash + 1);
+  *name_arch = g_strdup_printf ("%s.%s", rpm_name, arch_dot + 1);
+  *name = g_steal_pointer (&rpm_name);
+
+  return TRUE;
+}
+
+
+static gchar *
+get_component_source_key (const gchar *repository, const gchar *ref)
+{
+  return g_strdup_printf ("%s\n%s", repository, ref);
+}
+
+
+/*
+ * One entry that was added to a reverse lookup table of the index, kept so
+ * that it can be taken out again without looking at @stream, which may have
+ * been changed or freed in the meantime.
+ */
+typedef struct
+{
+  GHashTable *multimap;
+  GRefString *key;
+  ModulemdModuleStream *stream;
+} modulemd_filed_entry;
+
+
+static void
+modulemd_filed_entry_clear (gpointer data)
+{
+  modulemd_filed_entry *entry = data;
+
+  g_clear_pointer (&entry->key, g_ref_string_release);
+}
+
+
+/*
+ * A stream whose entries were added to the reverse lookup tables, and the
+ * generations it had then.
+ */
+typedef struct
+{
+  ModulemdModuleStream *stream;
+  guint64 generation;
+  guint64 child_generation;
+} modulemd_filed_stream;
+
+
+/*
+ * The entries added to the reverse lookup tables for the streams of @module,
+ * as they were when @module had @streams_serial and each of @streams had the
+ * generations recorded for it.
+ */
+typedef struct
+{
+  ModulemdModule *module;
+  guint64 streams_serial;
+  GArray *streams;
+  GArray *entries;
+} modulemd_filed_module;
+
+
+static modulemd_filed_module *
+modulemd_filed_module_new (ModulemdModule *module)
+{
+  modulemd_filed_module *filed = g_new0 (modulemd_filed_module, 1);
+
+  filed->module = g_object_ref (module);
+  filed->streams = g_array_new (FALSE, FALSE, sizeof (modulemd_filed_stream));
+  filed->entries = g_array_new (FALSE, FALSE, sizeof (modulemd_filed_entry));
+  g_array_set_clear_func (filed->entries, modulemd_filed_entry_clear);
+
+  return filed;
+}
+
+
+static void
+modulemd_filed_module_free (gpointer data)
+{
+  modulemd_filed_module *filed = data;
+
+  g_clear_object (&filed->module);
+  g_clear_pointer (&filed->streams, g_array_unref);
+  g_clear_pointer (&filed->entries, g_array_unref);
+  g_free (filed);
+}
+
+
+/*
+ * Adds @stream to the list for @key in @multimap unless it was the last
+ * stream added to it, so that a stream listing several artifacts with the
+ * same name appears only once.
+ */
+static void
+file_stream (modulemd_filed_module *filed,
+             GHashTable *multimap,
+             const gchar *key,
+             ModulemdModuleStream *stream)
+{
+  GPtrArray *list = NULL;
+  modulemd_filed_entry entry;
+
+  if (key == NULL)
+    {
+      return;
+    }
+
+  list = modulemd_multimap_lookup (multimap, key);
+  if (list != NULL && list->len > 0 &&
+      g_ptr_array_index (list, list->len - 1) == stream)
+    {
+      return;
+    }
+
+  modulemd_multimap_add (multimap, key, stream);
+
+  entry.multimap = multimap;
+  entry.key = modulemd_intern_string (key);
+  entry.stream = stream;
+  g_array_append_val (filed->entries, entry);
+}
+
+
+static void
+unfile_module (modulemd_filed_module *filed)
+{
+  modulemd_filed_entry *entry = NULL;
+
+  for (guint i = 0; i < filed->entries->len; i++)
+    {
+      entry = &g_array_index (filed->entries, modulemd_filed_entry, i);
+      modulemd_multimap_remove (entry->multimap, entry->key, entry->stream);
+    }
+
+  g_array_set_size (filed->entries, 0);
+}
+
+
+static void
+unfile_stream (modulemd_filed_module *filed, ModulemdModuleStream *stream)
+{
+  modulemd_filed_entry *entry = NULL;
+  guint i = 0;
+
+  while (i < filed->entries->len)
+    {
+      entry = &g_array_index (filed->entries, modulemd_filed_entry, i);
+      if (entry->stream != stream)
+        {
+          i++;
+          continue;
+        }
+
+      modulemd_multimap_remove (entry->multimap, entry->key, entry->stream);
+      g_array_remove_index_fast (filed->entries, i);
+    }
+}
+
+
+static void
+file_rpm_artifacts (ModulemdModuleIndex *self,
+                    modulemd_filed_module *filed,
+                    ModulemdModuleStream *stream)
+{
+  g_auto (GStrv) artifacts = NULL;
+
+  switch (modulemd_module_stream_get_mdversion (stream))
+    {
+    case MD_MODULESTREAM_VERSION_ONE:
+      artifacts = modulemd_module_stream_v1_get_rpm_artifacts_as_strv (
+        MODULEMD_MODULE_STREAM_V1 (stream));
+      break;
+
+    case MD_MODULESTREAM_VERSION_TWO:
+      artifacts = modulemd_module_stream_v2_get_rpm_artifacts_as_strv (
+        MODULEMD_MODULE_STREAM_V2 (stream));
+      break;
+
+    default: return;
+    }
+
+  for (guint i = 0; artifacts && artifacts[i]; i++)
+    {
+      g_autofree gchar *canonical = NULL;
+      g_autofree gchar *name = NULL;
+      g_autofree gchar *name_arch = NULL;
+
+      if (!split_nevra (artifacts[i], &canonical, &name, &name_arch))
+        {
+          file_stream (filed, self->rpms_by_nevra, artifacts[i], stream);
+          continue;
+        }
+
+      file_stream (filed, self->rpms_by_nevra, canonical, stream);
+      file_stream (filed, self->rpms_by_name, name, stream);
+      file_stream (filed, self->rpms_by_name_arch, name_arch, stream);
+    }
+}
+
+
+static void
+file_rpm_components (ModulemdModuleIndex *self,
+                     modulemd_filed_module *filed,
+                     ModulemdModuleStream *stream)
+{
+  g_auto (GStrv) keys = NULL;
+  ModulemdComponentRpm *component = NULL;
+  const gchar *name = NULL;
+  const gchar *repository = NULL;
+  const gchar *ref = NULL;
+  g_autofree gchar *source_key = NULL;
+
+  switch (modulemd_module_stream_get_mdversion (stream))
+    {
+    case MD_MODULESTREAM_VERSION_ONE:
+      keys = modulemd_module_stream_v1_get_rpm_component_names_as_strv (
+        MODULEMD_MODULE_STREAM_V1 (stream));
+      break;
+
+    case MD_MODULESTREAM_VERSION_TWO:
+      keys = modulemd_module_stream_v2_get_rpm_component_names_as_strv (
+        MODULEMD_MODULE_STREAM_V2 (stream));
+      break;
+
+    default: return;
+    }
+
+  for (guint i = 0; keys && keys[i]; i++)
+    {
+      if (modulemd_module_stream_get_mdversion (stream) ==
+          MD_MODULESTREAM_VERSION_ONE)
+        {
+          component = modulemd_module_stream_v1_get_rpm_component (
+            MODULEMD_MODULE_STREAM_V1 (stream), keys[i]);
+        }
+      else
+        {
+          component = modulemd_module_stream_v2_get_rpm_component (
+            MODULEMD_MODULE_STREAM_V2 (stream), keys[i]);
+        }
+
+      name = modulemd_component_get_name (MODULEMD_COMPONENT (component));
+      file_stream (filed, self->components_by_name, name, stream);
+
+      repository = modulemd_component_rpm_get_repository (component);
+      ref = modulemd_component_rpm_get_ref (component);
+      if (repository == NULL)
+        {
+          continue;
+        }
+
+      file_stream (filed, self->components_by_repository, repository, stream);
+      if (ref != NULL)
+        {
+          source_key = get_component_source_key (repository, ref);
+          file_stream (filed, self->components_by_source, source_key, stream);
+          g_clear_pointer (&source_key, g_free);
+        }
+    }
+}
+
+
+static gchar *
+get_module_stream_key (const gchar *module_name, const gchar *stream_name)
+{
+  return g_strdup_printf ("%s:%s", module_name, stream_name);
+}
+
+
+/*
+ * Files @stream under the module and stream names it requires at run time
+ * or, if @buildtime is TRUE, at build time. Empty stream sets are filed under
+ * the module name in the all-streams table and negated ones in the
+ * excluding-streams table, which only holds candidates that still have to be
+ * checked against the stream being looked up.
+ */
+static void
+file_requirements (ModulemdModuleIndex *self,
+                   modulemd_filed_module *filed,
+                   ModulemdModuleStream *stream,
+                   gboolean buildtime)
+{
+  GHashTable *by_stream = buildtime ? self->buildrequirers_by_stream
+                                    : self->requirers_by_stream;
+  GHashTable *of_all = buildtime ? self->buildrequirers_of_all_streams
+                                 : self->requirers_of_all_streams;
+  GHashTable *excluding = buildtime ? self->buildrequirers_excluding_streams
+                                    : self->requirers_excluding_streams;
+  g_auto (GStrv) modules = NULL;
+  g_auto (GStrv) streams = NULL;
+  g_autofree gchar *key = NULL;
+  ModulemdDependencies *dep = NULL;
+  GPtrArray *deps = NULL;
+  const gchar *required = NULL;
+
+  if (modulemd_module_stream_get_mdversion (stream) ==
+      MD_MODULESTREAM_VERSION_ONE)
+    {
+      if (buildtime)
+        {
+          modules = modulemd_module_stream_v1_get_buildtime_modules_as_strv (
+            MODULEMD_MODULE_STREAM_V1 (stream));
+        }
+      else
+        {
+          modules = modulemd_module_stream_v1_get_runtime_modules_as_strv (
+            MODULEMD_MODULE_STREAM_V1 (stream));
+        }
+
+      for (guint i = 0; modules && modules[i]; i++)
+        {
+          required =
+            buildtime
+              ? modulemd_module_stream_v1_get_buildtime_requirement_stream (
+                  MODULEMD_MODULE_STREAM_V1 (stream), modules[i])
+              : modulemd_module_stream_v1_get_runtime_requirement_stream (
+                  MODULEMD_MODULE_STREAM_V1 (stream), modules[i]);
+          key = get_module_stream_key (modules[i], required);
+          file_stream (filed, by_stream, key, stream);
+          g_clear_pointer (&key, g_free);
+        }
+      return;
+    }
+
+  if (modulemd_module_stream_get_mdversion (stream) !=
+      MD_MODULESTREAM_VERSION_TWO)
     {
-      return FALSE;
+      return;
     }
 
-  for (i = 0; i < modules->len; i++)
+  deps = modulemd_module_stream_v2_get_dependencies (
+    MODULEMD_MODULE_STREAM_V2 (stream));
+  for (guint i = 0; i < deps->len; i++)
     {
-      module = modulemd_module_index_get_module (
-        self, g_ptr_array_index (modules, i));
-
-      if (!dump_defaults (module, emitter, error))
+      dep = g_ptr_array_index (deps, i);
+      if (buildtime)
         {
-          return FALSE;
+          modules = modulemd_dependencies_get_buildtime_modules_as_strv (dep);
         }
-
-      if (!dump_translations (module, emitter, error))
+      else
         {
-          return FALSE;
+          modules = modulemd_dependencies_get_runtime_modules_as_strv (dep);
         }
 
-      if (!dump_streams (module, emitter, error))
+      for (guint j = 0; modules[j]; j++)
         {
-          return FALSE;
+          if (buildtime)
+            {
+              streams = modulemd_dependencies_get_buildtime_streams_as_strv (
+                dep, modules[j]);
+            }
+          else
+            {
+              streams = modulemd_dependencies_get_runtime_streams_as_strv (
+                dep, modules[j]);
+            }
+
+          if (streams[0] == NULL)
+            {
+              file_stream (filed, of_all, modules[j], stream);
+            }
+          else if (streams[0][0] == '-')
+            {
+              file_stream (filed, excluding, modules[j], stream);
+            }
+          else
+            {
+              for (guint k = 0; streams[k]; k++)
+                {
+                  key = get_module_stream_key (modules[j], streams[k]);
+                  file_stream (filed, by_stream, key, stream);
+                  g_clear_pointer (&key, g_free);
+                }
+            }
+          g_clear_pointer (&streams, g_strfreev);
         }
+      g_clear_pointer (&modules, g_strfreev);
     }
+}
 
-  if (!mmd_emitter_end_stream (emitter, error))
-    {
-      return FALSE;
-    }
 
-  return TRUE;
+static void
+file_module_stream (ModulemdModuleIndex *self,
+                    modulemd_filed_module *filed,
+                    ModulemdModuleStream *stream)
+{
+  file_rpm_artifacts (self, filed, stream);
+  file_rpm_components (self, filed, stream);
+  file_requirements (self, filed, stream, FALSE);
+  file_requirements (self, filed, stream, TRUE);
 }
 
 
-gboolean
-modulemd_module_index_update_from_file (ModulemdModuleIndex *self,
-                                        const gchar *yaml_file,
-                                        gboolean strict,
-                                        GPtrArray **failures,
-                                        GError **error)
+static void
+file_module (ModulemdModuleIndex *self, modulemd_filed_module *filed)
 {
-  if (*failures == NULL)
+  GPtrArray *streams = NULL;
+  modulemd_filed_stream filed_stream;
+
+  g_array_set_size (filed->streams, 0);
+
+  streams = modulemd_module_get_all_streams (filed->module);
+  for (guint i = 0; i < streams->len; i++)
     {
-      *failures = g_ptr_array_new_full (0, g_object_unref);
+      filed_stream.stream = g_ptr_array_index (streams, i);
+      modulemd_module_stream_get_generation (filed_stream.stream,
+                                             &filed_stream.generation,
+                                             &filed_stream.child_generation);
+      file_module_stream (self, filed, filed_stream.stream);
+      g_array_append_val (filed->streams, filed_stream);
     }
 
-  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+  /* Reading lazily-parsed streams above changes the serial */
+  filed->streams_serial = modulemd_module_get_streams_serial (filed->module);
+}
 
-  int saved_errno;
-  g_autoptr (FILE) yaml_stream = NULL;
-  g_autoptr (GError) nested_error = NULL;
-  int fd;
-  ModulemdCompressionTypeEnum comtype;
-  g_autofree gchar *fmode = NULL;
 
-  yaml_stream = g_fopen (yaml_file, "rbe");
-  saved_errno = errno;
+/*
+ * Files again the streams of @filed that were modified in place since they
+ * were filed. Such changes do not touch the streams serial of the module.
+ */
+static void
+refile_changed_streams (ModulemdModuleIndex *self,
+                        modulemd_filed_module *filed)
+{
+  modulemd_filed_stream *filed_stream = NULL;
+  ModulemdModuleStream *stream = NULL;
+  guint64 generation;
+  guint64 child_generation;
 
-  if (yaml_stream == NULL)
+  for (guint i = 0; i < filed->streams->len; i++)
     {
-      g_set_error (error,
-                   MODULEMD_ERROR,
-                   MODULEMD_YAML_ERROR_OPEN,
-                   "Failed to open file: %s",
-                   g_strerror (saved_errno));
-      return FALSE;
-    }
-
-  /* To avoid TOCTOU race conditions, do everything from the same opened
-   * file
-   */
-  fd = fileno (yaml_stream);
+      filed_stream = &g_array_index (filed->streams, modulemd_filed_stream, i);
+      stream = filed_stream->stream;
+      modulemd_module_stream_get_generation (
+        stream, &generation, &child_generation);
+
+      /* Removing a child can leave the sum of the two unchanged */
+      if (generation == filed_stream->generation &&
+          child_generation == filed_stream->child_generation)
+        {
+          continue;
+        }
 
-  /* Determine if the file is compressed */
-  comtype = modulemd_detect_compression (yaml_file, fd, &nested_error);
-  if (comtype == MODULEMD_COMPRESSION_TYPE_DETECTION_FAILED)
-    {
-      g_propagate_error (error, g_steal_pointer (&nested_error));
-      return FALSE;
-    }
-  if (comtype == MODULEMD_COMPRESSION_TYPE_NO_COMPRESSION ||
-      comtype == MODULEMD_COMPRESSION_TYPE_UNKNOWN_COMPRESSION)
-    {
-      /* If it's not compressed (or we can't figure out what compression is in
-       * use), just use the libyaml function. It's fast and will fail quickly
-       * if the file is unreadable.
-       */
-      return modulemd_module_index_update_from_stream (
-        self, yaml_stream, strict, failures, error);
+      unfile_stream (filed, stream);
+      file_module_stream (self, filed, stream);
+      filed_stream->generation = generation;
+      filed_stream->child_generation = child_generation;
     }
+}
 
-#ifdef HAVE_RPMIO
-  /* We're handling a compressed input file, so we'll use librpm's "rpmio"
-   * suite of tools to deal with it. We need to construct a special "mode"
-   * argument to pass to Fdopen().
-   */
-  FD_t rpmio_fd = NULL;
-  g_auto (FD_t) fd_dup = NULL;
 
-  fmode = modulemd_get_rpmio_fmode ("r", comtype);
-  if (!fmode)
-    {
-      g_set_error (error,
-                   MODULEMD_ERROR,
-                   MODULEMD_ERROR_FILE_ACCESS,
-                   "Unable to construct rpmio fmode from comtype [%d]",
-                   comtype);
-      return FALSE;
-    }
+/*
+ * Brings the reverse lookup tables of @self up to date. Modules that were
+ * added, removed or had streams added, removed or renamed since the last
+ * call are filed again, and so are the streams of the other modules whose
+ * contents were changed in place.
+ */
+static void
+update_reverse_index (ModulemdModuleIndex *self)
+{
+  GHashTableIter iter;
+  gpointer key;
+  gpointer value;
+  modulemd_filed_module *filed = NULL;
+  MMD_INIT_STRING_POOL_SCOPE (scope, self->strings);
 
-  /* Create an rpmio file descriptor object from the current file descriptor,
-   * setting the appropriate "mode" so that librpm will read it with the
-   * correct handlers.
-   */
-  fd_dup = fdDup (fd);
-  saved_errno = errno;
-  if (!fd_dup)
+  if (self->filed_modules == NULL)
     {
-      g_set_error (
-        error,
-        MODULEMD_ERROR,
-        MODULEMD_ERROR_NOT_IMPLEMENTED,
-        "Cannot open compressed file. Error in rpmio::fdDup(%d): %s",
-        fd,
-        strerror (saved_errno));
-      return FALSE;
+      self->rpms_by_nevra = modulemd_multimap_new ();
+      self->rpms_by_name = modulemd_multimap_new ();
+      self->rpms_by_name_arch = modulemd_multimap_new ();
+      self->components_by_name = modulemd_multimap_new ();
+      self->components_by_repository = modulemd_multimap_new ();
+      self->components_by_source = modulemd_multimap_new ();
+      self->requirers_by_stream = modulemd_multimap_new ();
+      self->requirers_of_all_streams = modulemd_multimap_new ();
+      self->requirers_excluding_streams = modulemd_multimap_new ();
+      self->buildrequirers_by_stream = modulemd_multimap_new ();
+      self->buildrequirers_of_all_streams = modulemd_multimap_new ();
+      self->buildrequirers_excluding_streams = modulemd_multimap_new ();
+      self->filed_modules = g_hash_table_new_full (
+        g_str_hash, g_str_equal, g_free, modulemd_filed_module_free);
     }
 
-  g_debug ("Calling rpmio::Fdopen (%p, %s)", fd_dup, fmode);
-  rpmio_fd = Fdopen (fd_dup, fmode);
-
-  if (!rpmio_fd)
+  /* Drop the entries of modules that are no longer in the index */
+  if (self->filed_modules_serial != self->modules_serial)
     {
-      g_set_error_literal (
-        error,
-        MODULEMD_ERROR,
-        MODULEMD_ERROR_NOT_IMPLEMENTED,
-        "Cannot open compressed file. Error in rpmio::Fdopen().");
-      return FALSE;
+      g_hash_table_iter_init (&iter, self->filed_modules);
+      while (g_hash_table_iter_next (&iter, &key, &value))
+        {
+          filed = value;
+          if (g_hash_table_lookup (self->modules, key) != filed->module)
+            {
+              unfile_module (filed);
+              g_hash_table_iter_remove (&iter);
+            }
+        }
+      self->filed_modules_serial = self->modules_serial;
     }
 
-  g_debug ("rpmio::Fdopen (%p, %s) succeeded", fd_dup, fmode);
-
-  return modulemd_module_index_update_from_custom (
-    self, compressed_stream_read_fn, rpmio_fd, strict, failures, error);
+  g_hash_table_iter_init (&iter, self->modules);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      filed = g_hash_table_lookup (self->filed_modules, key);
+      if (filed == NULL)
+        {
+          filed = modulemd_filed_module_new (MODULEMD_MODULE (value));
+          g_hash_table_insert (self->filed_modules, g_strdup (key), filed);
+        }
+      else if (filed->streams_serial ==
+               modulemd_module_get_streams_serial (filed->module))
+        {
+          refile_changed_streams (self, filed);
+          continue;
+        }
 
-#else /* HAVE_RPMIO */
-  g_set_error_literal (
-    error,
-    MODULEMD_ERROR,
-    MODULEMD_ERROR_NOT_IMPLEMENTED,
-    "Cannot open compressed file. libmodulemd was not compiled "
-    "with rpmio support.");
-  return FALSE;
-#endif /* HAVE_RPMIO */
+      unfile_module (filed);
+      file_module (self, filed);
+    }
 }
 
 
-gboolean
-modulemd_module_index_update_from_string (ModulemdModuleIndex *self,
-                                          const gchar *yaml_string,
-                                          gboolean strict,
-                                          GPtrArray **failures,
-                                          GError **error)
+static gint
+compare_module_streams (gconstpointer a, gconstpointer b)
 {
-  if (*failures == NULL)
-    {
-      *failures = g_ptr_array_new_full (0, g_object_unref);
-    }
-
-  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+  int cmp = 0;
+  ModulemdModuleStream *a_ = *(ModulemdModuleStream **)a;
+  ModulemdModuleStream *b_ = *(ModulemdModuleStream **)b;
 
-  if (!yaml_string)
+  cmp = g_strcmp0 (modulemd_module_stream_get_module_name (a_),
+                   modulemd_module_stream_get_module_name (b_));
+  if (cmp != 0)
     {
-      g_set_error (
-        error, MODULEMD_ERROR, MODULEMD_YAML_ERROR_OPEN, "No string provided");
-      return FALSE;
+      return cmp;
     }
 
-  MMD_INIT_YAML_PARSER (parser);
-
-  yaml_parser_set_input_string (
-    &parser, (const unsigned char *)yaml_string, strlen (yaml_string));
-
-  return modulemd_module_index_update_from_parser (
-    self, &parser, strict, FALSE, failures, error);
+  return modulemd_module_compare_streams (a, b);
 }
 
 
-gboolean
-modulemd_module_index_update_from_stream (ModulemdModuleIndex *self,
-                                          FILE *yaml_stream,
-                                          gboolean strict,
-                                          GPtrArray **failures,
-                                          GError **error)
+/*
+ * Returns: (transfer container): A sorted copy of the list for @key in
+ * @multimap, which is empty if there is no such list.
+ */
+static GPtrArray *
+lookup_streams (GHashTable *multimap, const gchar *key)
 {
-  if (*failures == NULL)
+  GPtrArray *list = modulemd_multimap_lookup (multimap, key);
+  GPtrArray *streams = NULL;
+
+  if (list == NULL)
     {
-      *failures = g_ptr_array_new_full (0, g_object_unref);
+      return g_ptr_array_new ();
     }
 
-  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
-
-  if (!yaml_stream)
+  streams = g_ptr_array_sized_new (list->len);
+  for (guint i = 0; i < list->len; i++)
     {
-      g_set_error (
-        error, MODULEMD_ERROR, MODULEMD_YAML_ERROR_OPEN, "No stream provided");
-      return FALSE;
+      g_ptr_array_add (streams, g_ptr_array_index (list, i));
     }
+  g_ptr_array_sort (streams, compare_module_streams);
 
-  MMD_INIT_YAML_PARSER (parser);
-
-  yaml_parser_set_input_file (&parser, yaml_stream);
-
-  return modulemd_module_index_update_from_parser (
-    self, &parser, strict, FALSE, failures, error);
+  return streams;
 }
 
 
-gboolean
-modulemd_module_index_update_from_custom (ModulemdModuleIndex *self,
-                                          ModulemdReadHandler custom_read_fn,
-                                          void *custom_pvt_data,
-                                          gboolean strict,
-                                          GPtrArray **failures,
-                                          GError **error)
+static GPtrArray *
+lookup_rpm_artifact (ModulemdModuleIndex *self, const gchar *nevra)
 {
-  if (*failures == NULL)
+  g_autofree gchar *canonical = NULL;
+  g_autofree gchar *name = NULL;
+  g_autofree gchar *name_arch = NULL;
+
+  if (!split_nevra (nevra, &canonical, &name, &name_arch))
     {
-      *failures = g_ptr_array_new_full (0, g_object_unref);
+      return lookup_streams (self->rpms_by_nevra, nevra);
     }
 
-  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
-  g_return_val_if_fail (custom_read_fn, FALSE);
-
-  MMD_INIT_YAML_PARSER (parser);
+  return lookup_streams (self->rpms_by_nevra, canonical);
+}
 
-  yaml_parser_set_input (&parser, custom_read_fn, custom_pvt_data);
 
-  return modulemd_module_index_update_from_parser (
-    self, &parser, strict, FALSE, failures, error);
+static GPtrArray *
+lookup_rpm_component (ModulemdModuleIndex *self, const gchar *name)
+{
+  return lookup_streams (self->components_by_name, name);
 }
 
 
 /*
- * modules_from_directory:
- * @path: A directory containing one or more modulemd YAML documents
- * @file_suffix: A file suffix to limit the files to be read. Pass "" if you
- * need to read all files.
- * @strict: Whether to fail on unknown fields
- * @strict_default_streams: Whether to fail on default stream merges.
- * @error: Error return value
+ * Returns: (transfer container): The streams that require @module_name at
+ * @stream_name, at build time if @buildtime is TRUE, sorted as by
+ * lookup_streams().
  */
-static ModulemdModuleIndex *
-modules_from_directory (const gchar *path,
-                        const gchar *file_suffix,
-                        gboolean strict,
-                        gboolean strict_default_streams,
-                        GError **error)
+static GPtrArray *
+lookup_requiring (ModulemdModuleIndex *self,
+                  const gchar *module_name,
+                  const gchar *stream_name,
+                  gboolean buildtime)
 {
-  const gchar *filename = NULL;
-  g_autoptr (GDir) dir = NULL;
-  g_autofree gchar *filepath = NULL;
-  g_autoptr (ModulemdModuleIndex) index = NULL;
-  g_autoptr (ModulemdModuleIndex) intermediate = NULL;
-  g_autoptr (GPtrArray) failures = NULL;
-  g_autoptr (GError) nested_error = NULL;
-
-  index = modulemd_module_index_new ();
+  g_autofree gchar *key = get_module_stream_key (module_name, stream_name);
+  GPtrArray *requiring = g_ptr_array_new ();
+  GPtrArray *list = NULL;
+  ModulemdModuleStream *stream = NULL;
+  guint kept = 0;
 
-  /* Open the directory */
-  dir = g_dir_open (path, 0, &nested_error);
-  if (!dir)
+  list = modulemd_multimap_lookup (buildtime ? self->buildrequirers_by_stream
+                                             : self->requirers_by_stream,
+                                   key);
+  for (guint i = 0; list && i < list->len; i++)
     {
-      g_propagate_error (error, g_steal_pointer (&nested_error));
-      return FALSE;
+      g_ptr_array_add (requiring, g_ptr_array_index (list, i));
+    }
+
+  list = modulemd_multimap_lookup (buildtime
+                                     ? self->buildrequirers_of_all_streams
+                                     : self->requirers_of_all_streams,
+                                   module_name);
+  for (guint i = 0; list && i < list->len; i++)
+    {
+      g_ptr_array_add (requiring, g_ptr_array_index (list, i));
     }
 
-  while ((filename = g_dir_read_name (dir)) != NULL)
+  /* A negated set requires every stream it does not name */
+  list = modulemd_multimap_lookup (buildtime
+                                     ? self->buildrequirers_excluding_streams
+                                     : self->requirers_excluding_streams,
+                                   module_name);
+  for (guint i = 0; list && i < list->len; i++)
     {
-      if (g_str_has_suffix (filename, file_suffix))
+      stream = g_ptr_array_index (list, i);
+      if (buildtime ? modulemd_module_stream_build_depends_on_stream (
+                        stream, module_name, stream_name)
+                    : modulemd_module_stream_depends_on_stream (
+                        stream, module_name, stream_name))
         {
-          intermediate = modulemd_module_index_new ();
-
-          filepath = g_build_path ("/", path, filename, NULL);
-          g_debug ("Reading modulemd from %s", filepath);
-          if (!modulemd_module_index_update_from_file (
-                intermediate, filepath, strict, &failures, error))
-            {
-              return FALSE;
-            }
-
-          if (!modulemd_module_index_merge (intermediate,
-                                            index,
-                                            FALSE,
-                                            strict_default_streams,
-                                            &nested_error))
-            {
-              g_propagate_error (error, g_steal_pointer (&nested_error));
-              return FALSE;
-            }
+          g_ptr_array_add (requiring, stream);
+        }
+    }
 
-          g_clear_pointer (&failures, g_ptr_array_unref);
-          g_clear_pointer (&filepath, g_free);
-          g_clear_object (&intermediate);
+  /* A stream with several dependencies may have been found more than once */
+  g_ptr_array_sort (requiring, compare_module_streams);
+  for (guint i = 0; i < requiring->len; i++)
+    {
+      if (kept > 0 && g_ptr_array_index (requiring, kept - 1) ==
+                        g_ptr_array_index (requiring, i))
+        {
+          continue;
         }
+      g_ptr_array_index (requiring, kept++) = g_ptr_array_index (requiring, i);
     }
+  g_ptr_array_set_size (requiring, kept);
 
-  return g_steal_pointer (&index);
+  return requiring;
 }
 
 
-gboolean
-modulemd_module_index_update_from_defaults_directory (
-  ModulemdModuleIndex *self,
-  const gchar *path,
-  gboolean strict,
-  const gchar *overrides_path,
-  GError **error)
+/*
+ * Looks up a "module:stream" @key as by lookup_requiring().
+ */
+static GPtrArray *
+lookup_requiring_key (ModulemdModuleIndex *self,
+                      const gchar *key,
+                      gboolean buildtime)
 {
-  g_autoptr (ModulemdModuleIndex) defaults_idx = NULL;
-  g_autoptr (ModulemdModuleIndex) override_idx = NULL;
-  g_autoptr (GError) nested_error = NULL;
+  g_autofree gchar *module_name = NULL;
+  const gchar *colon = strchr (key, ':');
 
-  /* Read the regular path first */
-  defaults_idx = modules_from_directory (
-    path, MMD_YAML_SUFFIX, strict, strict, &nested_error);
-  if (!defaults_idx)
+  if (colon == NULL)
     {
-      g_propagate_error (error, g_steal_pointer (&nested_error));
-      return FALSE;
+      return g_ptr_array_new ();
     }
 
-  /* If an override path was provided, use that too */
-  if (overrides_path)
+  module_name = g_strndup (key, colon - key);
+  return lookup_requiring (self, module_name, colon + 1, buildtime);
+}
+
+
+static GPtrArray *
+lookup_runtime_requiring_key (ModulemdModuleIndex *self, const gchar *key)
+{
+  return lookup_requiring_key (self, key, FALSE);
+}
+
+
+static GPtrArray *
+lookup_buildtime_requiring_key (ModulemdModuleIndex *self, const gchar *key)
+{
+  return lookup_requiring_key (self, key, TRUE);
+}
+
+
+/*
+ * Returns: (transfer full): A table mapping each of @keys for which @lookup
+ * found any streams to the list of those streams.
+ */
+static GHashTable *
+lookup_all (ModulemdModuleIndex *self,
+            const gchar *const *keys,
+            GPtrArray *(*lookup) (ModulemdModuleIndex *, const gchar *))
+{
+  g_autoptr (GHashTable) found = NULL;
+  g_autoptr (GPtrArray) streams = NULL;
+
+  found = g_hash_table_new_full (
+    g_str_hash, g_str_equal, g_free, (GDestroyNotify)g_ptr_array_unref);
+
+  update_reverse_index (self);
+
+  for (guint i = 0; keys && keys[i]; i++)
     {
-      override_idx = modules_from_directory (
-        overrides_path, MMD_YAML_SUFFIX, strict, strict, &nested_error);
-      if (!override_idx)
+      streams = lookup (self, keys[i]);
+      if (streams->len == 0)
         {
-          g_propagate_error (error, g_steal_pointer (&nested_error));
-          return FALSE;
+          g_clear_pointer (&streams, g_ptr_array_unref);
+          continue;
         }
 
-      if (!modulemd_module_index_merge (
-            override_idx, defaults_idx, TRUE, strict, &nested_error))
-        {
-          g_propagate_error (error, g_steal_pointer (&nested_error));
-          return FALSE;
-        }
+      g_hash_table_replace (
+        found, g_strdup (keys[i]), g_steal_pointer (&streams));
     }
 
-  /* Now that we've verified that the content in the two paths is compatible,
-   * attempt to merge it into the existing index.
-   */
-  if (!modulemd_module_index_merge (
-        defaults_idx, self, TRUE, strict, &nested_error))
-    {
-      g_propagate_error (error, g_steal_pointer (&nested_error));
-      return FALSE;
-    }
+  return g_steal_pointer (&found);
+}
 
 
-  return TRUE;
+GPtrArray *
+modulemd_module_index_get_streams_by_rpm_artifact (ModulemdModuleIndex *self,
+                                                   const gchar *nevra)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), NULL);
+  g_return_val_if_fail (nevra, NULL);
+
+  update_reverse_index (self);
+
+  return lookup_rpm_artifact (self, nevra);
 }
 
 
-gchar *
-modulemd_module_index_dump_to_string (ModulemdModuleIndex *self,
-                                      GError **error)
+GHashTable *
+modulemd_module_index_get_streams_by_rpm_artifacts (
+  ModulemdModuleIndex *self, const gchar *const *nevras)
 {
   g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), NULL);
 
-  MMD_INIT_YAML_EMITTER (emitter);
-  MMD_INIT_YAML_STRING (&emitter, yaml_string);
+  return lookup_all (self, nevras, lookup_rpm_artifact);
+}
+
+
+GPtrArray *
+modulemd_module_index_get_streams_by_rpm_name (ModulemdModuleIndex *self,
+                                               const gchar *name,
+                                               const gchar *arch)
+{
+  g_autofree gchar *name_arch = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), NULL);
+  g_return_val_if_fail (name, NULL);
+
+  update_reverse_index (self);
 
-  if (!modulemd_module_index_dump_to_emitter (self, &emitter, error))
+  if (arch == NULL)
     {
-      return NULL;
+      return lookup_streams (self->rpms_by_name, name);
     }
 
-  return g_steal_pointer (&yaml_string->str);
+  name_arch = g_strdup_printf ("%s.%s", name, arch);
+  return lookup_streams (self->rpms_by_name_arch, name_arch);
 }
 
 
-gboolean
-modulemd_module_index_dump_to_stream (ModulemdModuleIndex *self,
-                                      FILE *yaml_stream,
-                                      GError **error)
+GPtrArray *
+modulemd_module_index_get_streams_by_rpm_component (ModulemdModuleIndex *self,
+                                                    const gchar *name)
 {
-  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), NULL);
+  g_return_val_if_fail (name, NULL);
 
-  MMD_INIT_YAML_EMITTER (emitter);
-  yaml_emitter_set_output_file (&emitter, yaml_stream);
+  update_reverse_index (self);
 
-  return modulemd_module_index_dump_to_emitter (self, &emitter, error);
+  return lookup_rpm_component (self, name);
 }
 
 
-gboolean
-modulemd_module_index_dump_to_custom (ModulemdModuleIndex *self,
-                                      ModulemdWriteHandler custom_write_fn,
-                                      void *custom_pvt_data,
-                                      GError **error)
+GHashTable *
+modulemd_module_index_get_streams_by_rpm_components (
+  ModulemdModuleIndex *self, const gchar *const *names)
 {
-  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
-
-  MMD_INIT_YAML_EMITTER (emitter);
-  yaml_emitter_set_output (&emitter, custom_write_fn, custom_pvt_data);
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), NULL);
 
-  return modulemd_module_index_dump_to_emitter (self, &emitter, error);
+  return lookup_all (self, names, lookup_rpm_component);
 }
 
 
-GStrv
-modulemd_module_index_get_module_names_as_strv (ModulemdModuleIndex *self)
+GPtrArray *
+modulemd_module_index_get_streams_by_rpm_component_source (
+  ModulemdModuleIndex *self, const gchar *repository, const gchar *ref)
 {
+  g_autofree gchar *source_key = NULL;
+
   g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), NULL);
+  g_return_val_if_fail (repository, NULL);
 
-  return modulemd_ordered_str_keys_as_strv (self->modules);
+  update_reverse_index (self);
+
+  if (ref == NULL)
+    {
+      return lookup_streams (self->components_by_repository, repository);
+    }
+
+  source_key = get_component_source_key (repository, ref);
+  return lookup_streams (self->components_by_source, source_key);
 }
 
 
-ModulemdModule *
-modulemd_module_index_get_module (ModulemdModuleIndex *self,
-                                  const gchar *module_name)
+GPtrArray *
+modulemd_module_index_get_streams_requiring_stream (ModulemdModuleIndex *self,
+                                                    const gchar *module_name,
+                                                    const gchar *stream_name,
+                                                    gboolean buildtime)
 {
   g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), NULL);
+  g_return_val_if_fail (module_name && stream_name, NULL);
 
-  return g_hash_table_lookup (self->modules, module_name);
+  update_reverse_index (self);
+
+  return lookup_requiring (self, module_name, stream_name, buildtime);
 }
 
 
-gboolean
-modulemd_module_index_remove_module (ModulemdModuleIndex *self,
-                                     const gchar *module_name)
+GHashTable *
+modulemd_module_index_get_streams_requiring_streams (
+  ModulemdModuleIndex *self,
+  const gchar *const *module_streams,
+  gboolean buildtime)
 {
-  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), NULL);
 
-  return g_hash_table_remove (self->modules, module_name);
+  return lookup_all (self,
+                     module_streams,
+                     buildtime ? lookup_buildtime_requiring_key
+                               : lookup_runtime_requiring_key);
 }
 
 
-gboolean
-modulemd_module_index_add_module_stream (ModulemdModuleIndex *self,
-                                         ModulemdModuleStream *stream,
-                                         GError **error)
+/*
+ * When @adopt is TRUE, the index takes a reference to @stream instead of a
+ * copy of it. See modulemd_module_adopt_stream().
+ */
+static gboolean
+add_module_stream (ModulemdModuleIndex *self,
+                   ModulemdModuleStream *stream,
+                   gboolean adopt,
+                   GError **error)
 {
   g_autoptr (GError) nested_error = NULL;
   ModulemdModuleStreamVersionEnum mdversion = MD_MODULESTREAM_VERSION_UNSET;
+  ModulemdModule *module = NULL;
   g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+  g_return_val_if_fail (MODULEMD_IS_MODULE_STREAM (stream), FALSE);
+  MMD_INIT_STRING_POOL_SCOPE (scope, self->strings);
 
   if (!modulemd_module_stream_get_module_name (stream) ||
       !modulemd_module_stream_get_stream_name (stream))
@@ -954,12 +3891,18 @@ modulemd_module_index_add_module_stream (ModulemdModuleIndex *self,
       return FALSE;
     }
 
-  mdversion = modulemd_module_add_stream (
-    get_or_create_module (self,
-                          modulemd_module_stream_get_module_name (stream)),
-    stream,
-    self->stream_mdversion,
-    &nested_error);
+  module = get_or_create_module (
+    self, modulemd_module_stream_get_module_name (stream));
+  if (adopt)
+    {
+      mdversion = modulemd_module_adopt_stream (
+        module, stream, self->stream_mdversion, &nested_error);
+    }
+  else
+    {
+      mdversion = modulemd_module_add_stream (
+        module, stream, self->stream_mdversion, &nested_error);
+    }
 
   if (mdversion == MD_MODULESTREAM_VERSION_ERROR)
     {
@@ -983,6 +3926,24 @@ modulemd_module_index_add_module_stream (ModulemdModuleIndex *self,
 }
 
 
+gboolean
+modulemd_module_index_add_module_stream (ModulemdModuleIndex *self,
+                                         ModulemdModuleStream *stream,
+                                         GError **error)
+{
+  return add_module_stream (self, stream, FALSE, error);
+}
+
+
+gboolean
+modulemd_module_index_adopt_module_stream (ModulemdModuleIndex *self,
+                                           ModulemdModuleStream *stream,
+                                           GError **error)
+{
+  return add_module_stream (self, stream, TRUE, error);
+}
+
+
 gboolean
 modulemd_module_index_upgrade_streams (
   ModulemdModuleIndex *self,
@@ -994,6 +3955,7 @@ modulemd_module_index_upgrade_streams (
   gpointer value;
   g_autoptr (ModulemdModule) module = NULL;
   g_autoptr (GError) nested_error = NULL;
+  MMD_INIT_STRING_POOL_SCOPE (scope, self->strings);
 
   if (mdversion < self->stream_mdversion)
     {
@@ -1011,13 +3973,6 @@ modulemd_module_index_upgrade_streams (
     {
       module = g_object_ref (MODULEMD_MODULE (value));
 
-      /* Skip any module without streams */
-      if (modulemd_module_get_all_streams (module)->len == 0)
-        {
-          g_clear_object (&module);
-          continue;
-        }
-
       if (!modulemd_module_upgrade_streams (module, mdversion, &nested_error))
         {
           g_propagate_prefixed_error (
@@ -1206,12 +4161,19 @@ modulemd_module_index_add_translation (ModulemdModuleIndex *self,
 }
 
 
-gboolean
-modulemd_module_index_merge (ModulemdModuleIndex *from,
-                             ModulemdModuleIndex *into,
-                             gboolean override,
-                             gboolean strict_default_streams,
-                             GError **error)
+/*
+ * When @adopt_streams is TRUE, @into takes references to the streams of
+ * @from instead of copies of them, and the strings of @from are merged into
+ * the pool of @into so that it keeps sharing them. Copies are interned in the
+ * pool of @into as they are made.
+ */
+static gboolean
+merge (ModulemdModuleIndex *from,
+       ModulemdModuleIndex *into,
+       gboolean override,
+       gboolean strict_default_streams,
+       gboolean adopt_streams,
+       GError **error)
 {
   MODULEMD_INIT_TRACE ();
   GHashTableIter iter;
@@ -1233,7 +4195,12 @@ modulemd_module_index_merge (ModulemdModuleIndex *from,
   guint i;
   g_autoptr (GPtrArray) translated_stream_names = NULL;
   gchar *translated_stream_name = NULL;
+  MMD_INIT_STRING_POOL_SCOPE (scope, into->strings);
 
+  if (adopt_streams)
+    {
+      modulemd_string_pool_absorb (into->strings, from->strings);
+    }
 
   /* Loop through each module in the Index */
   g_hash_table_iter_init (&iter, from->modules);
@@ -1259,8 +4226,7 @@ modulemd_module_index_merge (ModulemdModuleIndex *from,
         {
           stream = g_ptr_array_index (streams, i);
 
-          if (!modulemd_module_index_add_module_stream (
-                into, stream, &nested_error))
+          if (!add_module_stream (into, stream, adopt_streams, &nested_error))
             {
               g_propagate_error (error, g_steal_pointer (&nested_error));
               return FALSE;
@@ -1356,6 +4322,29 @@ modulemd_module_index_merge (ModulemdModuleIndex *from,
 }
 
 
+gboolean
+modulemd_module_index_merge (ModulemdModuleIndex *from,
+                             ModulemdModuleIndex *into,
+                             gboolean override,
+                             gboolean strict_default_streams,
+                             GError **error)
+{
+  return merge (from, into, override, strict_default_streams, FALSE, error);
+}
+
+
+gboolean
+modulemd_module_index_merge_adopting_streams (
+  ModulemdModuleIndex *from,
+  ModulemdModuleIndex *into,
+  gboolean override,
+  gboolean strict_default_streams,
+  GError **error)
+{
+  return merge (from, into, override, strict_default_streams, TRUE, error);
+}
+
+
 ModulemdDefaultsVersionEnum
 modulemd_module_index_get_defaults_mdversion (ModulemdModuleIndex *self)
 {
@@ -1368,3 +4357,111 @@ modulemd_module_index_get_stream_mdversion (ModulemdModuleIndex *self)
 {
   return self->stream_mdversion;
 }
+
+
+void
+modulemd_module_index_set_parse_threads (ModulemdModuleIndex *self,
+                                         guint threads)
+{
+  g_return_if_fail (MODULEMD_IS_MODULE_INDEX (self));
+
+  self->parse_threads = threads;
+}
+
+
+guint
+modulemd_module_index_get_parse_threads (ModulemdModuleIndex *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), 1);
+
+  return self->parse_threads;
+}
+
+
+void
+modulemd_module_index_set_emit_threads (ModulemdModuleIndex *self,
+                                        guint threads)
+{
+  g_return_if_fail (MODULEMD_IS_MODULE_INDEX (self));
+
+  self->emit_threads = threads;
+}
+
+
+guint
+modulemd_module_index_get_emit_threads (ModulemdModuleIndex *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), 1);
+
+  return self->emit_threads;
+}
+
+
+void
+modulemd_module_index_set_lazy_streams (ModulemdModuleIndex *self,
+                                        gboolean lazy)
+{
+  g_return_if_fail (MODULEMD_IS_MODULE_INDEX (self));
+
+  self->lazy_streams = lazy;
+}
+
+
+gboolean
+modulemd_module_index_get_lazy_streams (ModulemdModuleIndex *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+
+  return self->lazy_streams;
+}
+
+
+gboolean
+modulemd_module_index_load_lazy_streams (ModulemdModuleIndex *self,
+                                         GPtrArray **failures)
+{
+  g_autoptr (GPtrArray) modules = NULL;
+  ModulemdModule *module = NULL;
+  gboolean success = TRUE;
+
+  if (*failures == NULL)
+    {
+      *failures = g_ptr_array_new_full (0, g_object_unref);
+    }
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), FALSE);
+
+  /* Report the failures in the order of the module names */
+  modules = modulemd_ordered_str_keys (self->modules, modulemd_strcmp_sort);
+  for (guint i = 0; i < modules->len; i++)
+    {
+      module =
+        g_hash_table_lookup (self->modules, g_ptr_array_index (modules, i));
+      if (!modulemd_module_load_lazy_streams (module, *failures))
+        {
+          success = FALSE;
+        }
+    }
+
+  return success;
+}
+
+
+void
+modulemd_module_index_set_cache_dir (ModulemdModuleIndex *self,
+                                     const gchar *cache_dir)
+{
+  g_return_if_fail (MODULEMD_IS_MODULE_INDEX (self));
+
+  g_clear_pointer (&self->cache_dir, g_free);
+  self->cache_dir = g_strdup (cache_dir);
+}
+
+
+const gchar *
+modulemd_module_index_get_cache_dir (ModulemdModuleIndex *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULE_INDEX (self), NULL);
+
+  return self->cache_dir;
+}
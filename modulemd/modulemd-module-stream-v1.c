@@ -119,6 +119,7 @@ modulemd_module_stream_v1_set_arch (ModulemdModuleStreamV1 *self,
                                     const gchar *arch)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   modulemd_module_stream_set_arch (MODULEMD_MODULE_STREAM (self), arch);
 
@@ -140,6 +141,7 @@ modulemd_module_stream_v1_set_buildopts (ModulemdModuleStreamV1 *self,
                                          ModulemdBuildopts *buildopts)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_clear_object (&self->buildopts);
   self->buildopts = modulemd_buildopts_copy (buildopts);
@@ -162,6 +164,7 @@ modulemd_module_stream_v1_set_community (ModulemdModuleStreamV1 *self,
                                          const gchar *community)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_clear_pointer (&self->community, g_free);
   self->community = g_strdup (community);
@@ -184,6 +187,7 @@ modulemd_module_stream_v1_set_description (ModulemdModuleStreamV1 *self,
                                            const gchar *description)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_clear_pointer (&self->description, g_free);
   self->description = g_strdup (description);
@@ -214,6 +218,7 @@ modulemd_module_stream_v1_set_documentation (ModulemdModuleStreamV1 *self,
                                              const gchar *documentation)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_clear_pointer (&self->documentation, g_free);
   self->documentation = g_strdup (documentation);
@@ -236,6 +241,7 @@ modulemd_module_stream_v1_set_summary (ModulemdModuleStreamV1 *self,
                                        const gchar *summary)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_clear_pointer (&self->summary, g_free);
   self->summary = g_strdup (summary);
@@ -265,6 +271,7 @@ modulemd_module_stream_v1_set_tracker (ModulemdModuleStreamV1 *self,
                                        const gchar *tracker)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_clear_pointer (&self->tracker, g_free);
   self->tracker = g_strdup (tracker);
@@ -299,6 +306,7 @@ modulemd_module_stream_v1_add_component (ModulemdModuleStreamV1 *self,
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
   g_return_if_fail (MODULEMD_IS_COMPONENT (component));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   if (MODULEMD_IS_COMPONENT_RPM (component))
     {
@@ -334,6 +342,7 @@ modulemd_module_stream_v1_remove_module_component (
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove (self->module_components, component_name);
 }
@@ -344,6 +353,7 @@ modulemd_module_stream_v1_clear_module_components (
   ModulemdModuleStreamV1 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->module_components);
 }
@@ -360,6 +370,7 @@ modulemd_module_stream_v1_remove_rpm_component (ModulemdModuleStreamV1 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove (self->rpm_components, component_name);
 }
@@ -369,6 +380,7 @@ void
 modulemd_module_stream_v1_clear_rpm_components (ModulemdModuleStreamV1 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->rpm_components);
 }
@@ -424,6 +436,7 @@ modulemd_module_stream_v1_add_content_license (ModulemdModuleStreamV1 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_add (self->content_licenses, g_strdup (license));
 }
@@ -434,6 +447,7 @@ modulemd_module_stream_v1_replace_content_licenses (
   ModulemdModuleStreamV1 *self, GHashTable *set)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   MODULEMD_REPLACE_SET (self->content_licenses, set);
 }
@@ -443,6 +457,7 @@ void
 modulemd_module_stream_v1_clear_content_licenses (ModulemdModuleStreamV1 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->content_licenses);
 }
@@ -458,6 +473,7 @@ modulemd_module_stream_v1_add_module_license (ModulemdModuleStreamV1 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_add (self->module_licenses, g_strdup (license));
 }
@@ -468,6 +484,7 @@ modulemd_module_stream_v1_replace_module_licenses (
   ModulemdModuleStreamV1 *self, GHashTable *set)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   MODULEMD_REPLACE_SET (self->module_licenses, set);
 }
@@ -477,6 +494,7 @@ void
 modulemd_module_stream_v1_clear_module_licenses (ModulemdModuleStreamV1 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->module_licenses);
 }
@@ -492,6 +510,7 @@ modulemd_module_stream_v1_remove_content_license (ModulemdModuleStreamV1 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove (self->content_licenses, license);
 }
@@ -507,6 +526,7 @@ modulemd_module_stream_v1_remove_module_license (ModulemdModuleStreamV1 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove (self->module_licenses, license);
 }
@@ -542,6 +562,7 @@ modulemd_module_stream_v1_add_profile (ModulemdModuleStreamV1 *self,
     }
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
   g_return_if_fail (MODULEMD_IS_PROFILE (profile));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   ModulemdProfile *copied_profile = modulemd_profile_copy (profile);
   modulemd_profile_set_owner (copied_profile, MODULEMD_MODULE_STREAM (self));
@@ -556,6 +577,7 @@ void
 modulemd_module_stream_v1_clear_profiles (ModulemdModuleStreamV1 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->profiles);
 }
@@ -591,6 +613,7 @@ modulemd_module_stream_v1_add_rpm_api (ModulemdModuleStreamV1 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_add (self->rpm_api, g_strdup (rpm));
 }
@@ -601,6 +624,7 @@ modulemd_module_stream_v1_replace_rpm_api (ModulemdModuleStreamV1 *self,
                                            GHashTable *set)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   MODULEMD_REPLACE_SET (self->rpm_api, set);
 }
@@ -616,6 +640,7 @@ modulemd_module_stream_v1_remove_rpm_api (ModulemdModuleStreamV1 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove (self->rpm_api, rpm);
 }
@@ -625,6 +650,7 @@ void
 modulemd_module_stream_v1_clear_rpm_api (ModulemdModuleStreamV1 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->rpm_api);
 }
@@ -649,6 +675,7 @@ modulemd_module_stream_v1_add_rpm_artifact (ModulemdModuleStreamV1 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_add (self->rpm_artifacts, g_strdup (nevr));
 }
@@ -659,6 +686,7 @@ modulemd_module_stream_v1_replace_rpm_artifacts (ModulemdModuleStreamV1 *self,
                                                  GHashTable *set)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   MODULEMD_REPLACE_SET (self->rpm_artifacts, set);
 }
@@ -674,6 +702,7 @@ modulemd_module_stream_v1_remove_rpm_artifact (ModulemdModuleStreamV1 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove (self->rpm_artifacts, nevr);
 }
@@ -683,6 +712,7 @@ void
 modulemd_module_stream_v1_clear_rpm_artifacts (ModulemdModuleStreamV1 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->rpm_artifacts);
 }
@@ -708,6 +738,7 @@ modulemd_module_stream_v1_add_rpm_filter (ModulemdModuleStreamV1 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_add (self->rpm_filters, g_strdup (rpm));
 }
@@ -718,6 +749,7 @@ modulemd_module_stream_v1_replace_rpm_filters (ModulemdModuleStreamV1 *self,
                                                GHashTable *set)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   MODULEMD_REPLACE_SET (self->rpm_filters, set);
 }
@@ -733,6 +765,7 @@ modulemd_module_stream_v1_remove_rpm_filter (ModulemdModuleStreamV1 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove (self->rpm_filters, rpm);
 }
@@ -742,6 +775,7 @@ void
 modulemd_module_stream_v1_clear_rpm_filters (ModulemdModuleStreamV1 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->rpm_filters);
 }
@@ -767,6 +801,7 @@ modulemd_module_stream_v1_add_servicelevel (ModulemdModuleStreamV1 *self,
     }
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
   g_return_if_fail (MODULEMD_IS_SERVICE_LEVEL (servicelevel));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_replace (
     self->servicelevels,
@@ -779,6 +814,7 @@ void
 modulemd_module_stream_v1_clear_servicelevels (ModulemdModuleStreamV1 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->servicelevels);
 }
@@ -808,6 +844,7 @@ void
 modulemd_module_stream_v1_set_eol (ModulemdModuleStreamV1 *self, GDate *eol)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   /* The "eol" field in the YAML is a relic of an early iteration and has been
    * entirely replaced by the ServiceLevel concept. If we encounter it, we just
@@ -840,6 +877,7 @@ modulemd_module_stream_v1_add_buildtime_requirement (
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
   g_return_if_fail (module_name && module_stream);
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_replace (
     self->buildtime_deps, g_strdup (module_name), g_strdup (module_stream));
@@ -851,6 +889,7 @@ modulemd_module_stream_v1_replace_buildtime_deps (ModulemdModuleStreamV1 *self,
                                                   GHashTable *deps)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   if (deps)
     {
@@ -872,6 +911,7 @@ modulemd_module_stream_v1_add_runtime_requirement (
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
   g_return_if_fail (module_name && module_stream);
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_replace (
     self->runtime_deps, g_strdup (module_name), g_strdup (module_stream));
@@ -883,6 +923,7 @@ modulemd_module_stream_v1_replace_runtime_deps (ModulemdModuleStreamV1 *self,
                                                 GHashTable *deps)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   if (deps)
     {
@@ -902,6 +943,7 @@ modulemd_module_stream_v1_remove_buildtime_requirement (
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
   g_return_if_fail (module_name);
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove (self->buildtime_deps, module_name);
 }
@@ -913,6 +955,7 @@ modulemd_module_stream_v1_remove_runtime_requirement (
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
   g_return_if_fail (module_name);
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove (self->runtime_deps, module_name);
 }
@@ -923,6 +966,7 @@ modulemd_module_stream_v1_clear_buildtime_requirements (
   ModulemdModuleStreamV1 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->buildtime_deps);
 }
@@ -933,6 +977,7 @@ modulemd_module_stream_v1_clear_runtime_requirements (
   ModulemdModuleStreamV1 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->runtime_deps);
 }
@@ -982,6 +1027,7 @@ void
 modulemd_module_stream_v1_set_xmd (ModulemdModuleStreamV1 *self, GVariant *xmd)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   /* Do nothing if we were passed the same pointer */
   if (self->xmd == xmd)
@@ -1140,6 +1186,26 @@ modulemd_module_stream_v1_equals (ModulemdModuleStream *self_1,
 }
 
 
+guint64
+modulemd_module_stream_v1_get_child_generation (ModulemdModuleStreamV1 *self)
+{
+  GHashTableIter iter;
+  gpointer value;
+  guint64 generation = 0;
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_STREAM_V1 (self), 0);
+
+  g_hash_table_iter_init (&iter, self->rpm_components);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      generation +=
+        modulemd_component_get_generation (MODULEMD_COMPONENT (value));
+    }
+
+  return generation;
+}
+
+
 static gboolean
 modulemd_module_stream_v1_validate (ModulemdModuleStream *self, GError **error)
 {
@@ -1531,8 +1597,24 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                       gboolean strict,
                                       GError **error)
 {
-  MODULEMD_INIT_TRACE ();
   MMD_INIT_YAML_PARSER (parser);
+
+  if (!modulemd_subdocument_info_get_data_parser (
+        subdoc, &parser, strict, error))
+    {
+      return NULL;
+    }
+
+  return modulemd_module_stream_v1_parse_yaml_data (&parser, strict, error);
+}
+
+
+ModulemdModuleStreamV1 *
+modulemd_module_stream_v1_parse_yaml_data (yaml_parser_t *parser,
+                                           gboolean strict,
+                                           GError **error)
+{
+  MODULEMD_INIT_TRACE ();
   MMD_INIT_YAML_EVENT (event);
   gboolean done = FALSE;
   g_autoptr (GError) nested_error = NULL;
@@ -1542,21 +1624,14 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
   g_autoptr (GVariant) xmd = NULL;
   g_autoptr (GDate) eol = NULL;
   g_autoptr (ModulemdServiceLevel) sl = NULL;
-
-  if (!modulemd_subdocument_info_get_data_parser (
-        subdoc, &parser, strict, error))
-    {
-      return NULL;
-    }
-
   guint64 version;
 
-  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
   modulestream = modulemd_module_stream_v1_new (NULL, NULL);
 
   /* Read the MAPPING_START */
-  YAML_PARSER_PARSE_WITH_EXIT (&parser, &event, error);
+  YAML_PARSER_PARSE_WITH_EXIT (parser, &event, error);
   if (event.type != YAML_MAPPING_START_EVENT)
     {
       MMD_YAML_ERROR_EVENT_EXIT (
@@ -1566,7 +1641,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
   /* Process through the mapping */
   while (!done)
     {
-      YAML_PARSER_PARSE_WITH_EXIT (&parser, &event, error);
+      YAML_PARSER_PARSE_WITH_EXIT (parser, &event, error);
 
       switch (event.type)
         {
@@ -1579,7 +1654,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
           if (g_str_equal ((const gchar *)event.data.scalar.value, "name"))
             {
               MMD_SET_PARSED_YAML_STRING (
-                &parser,
+                parser,
                 error,
                 modulemd_module_stream_set_module_name,
                 MODULEMD_MODULE_STREAM (modulestream));
@@ -1590,7 +1665,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "stream"))
             {
               MMD_SET_PARSED_YAML_STRING (
-                &parser,
+                parser,
                 error,
                 modulemd_module_stream_set_stream_name,
                 MODULEMD_MODULE_STREAM (modulestream));
@@ -1600,7 +1675,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
           else if (g_str_equal ((const gchar *)event.data.scalar.value,
                                 "version"))
             {
-              version = modulemd_yaml_parse_uint64 (&parser, &nested_error);
+              version = modulemd_yaml_parse_uint64 (parser, &nested_error);
               if (nested_error)
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
@@ -1616,7 +1691,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "context"))
             {
               MMD_SET_PARSED_YAML_STRING (
-                &parser,
+                parser,
                 error,
                 modulemd_module_stream_set_context,
                 MODULEMD_MODULE_STREAM (modulestream));
@@ -1626,7 +1701,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
           else if (g_str_equal ((const gchar *)event.data.scalar.value,
                                 "arch"))
             {
-              MMD_SET_PARSED_YAML_STRING (&parser,
+              MMD_SET_PARSED_YAML_STRING (parser,
                                           error,
                                           modulemd_module_stream_v1_set_arch,
                                           modulestream);
@@ -1637,7 +1712,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "summary"))
             {
               MMD_SET_PARSED_YAML_STRING (
-                &parser,
+                parser,
                 error,
                 modulemd_module_stream_v1_set_summary,
                 modulestream);
@@ -1648,7 +1723,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "description"))
             {
               MMD_SET_PARSED_YAML_STRING (
-                &parser,
+                parser,
                 error,
                 modulemd_module_stream_v1_set_description,
                 modulestream);
@@ -1659,7 +1734,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "servicelevels"))
             {
               if (!modulemd_module_stream_v1_parse_servicelevels (
-                    &parser, modulestream, strict, &nested_error))
+                    parser, modulestream, strict, &nested_error))
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return NULL;
@@ -1671,7 +1746,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "license"))
             {
               if (!modulemd_module_stream_v1_parse_licenses (
-                    &parser, modulestream, strict, &nested_error))
+                    parser, modulestream, strict, &nested_error))
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return NULL;
@@ -1682,7 +1757,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
           else if (g_str_equal ((const gchar *)event.data.scalar.value, "xmd"))
             {
               xmd =
-                modulemd_module_stream_v1_parse_raw (&parser, &nested_error);
+                modulemd_module_stream_v1_parse_raw (parser, &nested_error);
               if (!xmd)
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
@@ -1697,7 +1772,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "dependencies"))
             {
               if (!modulemd_module_stream_v1_parse_deps (
-                    &parser, modulestream, strict, &nested_error))
+                    parser, modulestream, strict, &nested_error))
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return NULL;
@@ -1709,7 +1784,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "references"))
             {
               if (!modulemd_module_stream_v1_parse_refs (
-                    &parser, modulestream, strict, &nested_error))
+                    parser, modulestream, strict, &nested_error))
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return NULL;
@@ -1721,7 +1796,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "profiles"))
             {
               if (!modulemd_module_stream_v1_parse_profiles (
-                    &parser, modulestream, strict, &nested_error))
+                    parser, modulestream, strict, &nested_error))
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return NULL;
@@ -1732,7 +1807,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
           else if (g_str_equal ((const gchar *)event.data.scalar.value, "api"))
             {
               set = modulemd_yaml_parse_string_set_from_map (
-                &parser, "rpms", strict, &nested_error);
+                parser, "rpms", strict, &nested_error);
               modulemd_module_stream_v1_replace_rpm_api (modulestream, set);
               g_clear_pointer (&set, g_hash_table_unref);
             }
@@ -1742,7 +1817,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "filter"))
             {
               set = modulemd_yaml_parse_string_set_from_map (
-                &parser, "rpms", strict, &nested_error);
+                parser, "rpms", strict, &nested_error);
               modulemd_module_stream_v1_replace_rpm_filters (modulestream,
                                                              set);
               g_clear_pointer (&set, g_hash_table_unref);
@@ -1753,7 +1828,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "buildopts"))
             {
               buildopts =
-                modulemd_buildopts_parse_yaml (&parser, strict, &nested_error);
+                modulemd_buildopts_parse_yaml (parser, strict, &nested_error);
               if (!buildopts)
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
@@ -1770,7 +1845,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "components"))
             {
               if (!modulemd_module_stream_v1_parse_components (
-                    &parser, modulestream, strict, &nested_error))
+                    parser, modulestream, strict, &nested_error))
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return NULL;
@@ -1782,7 +1857,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "artifacts"))
             {
               set = modulemd_yaml_parse_string_set_from_map (
-                &parser, "rpms", strict, &nested_error);
+                parser, "rpms", strict, &nested_error);
               if (!set)
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
@@ -1796,7 +1871,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
           /* EOL (Deprecated) */
           else if (g_str_equal ((const gchar *)event.data.scalar.value, "eol"))
             {
-              eol = modulemd_yaml_parse_date (&parser, &nested_error);
+              eol = modulemd_yaml_parse_date (parser, &nested_error);
               if (!eol)
                 {
                   MMD_YAML_ERROR_EVENT_EXIT (
@@ -1821,7 +1896,7 @@ modulemd_module_stream_v1_parse_yaml (ModulemdSubdocumentInfo *subdoc,
           /* Unknown key */
           else
             {
-              SKIP_UNKNOWN (&parser,
+              SKIP_UNKNOWN (parser,
                             NULL,
                             "Unexpected key in data: %s",
                             (const gchar *)event.data.scalar.value);
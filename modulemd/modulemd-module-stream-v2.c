@@ -75,9 +75,9 @@ modulemd_module_stream_v2_finalize (GObject *object)
   /* Properties */
   g_clear_object (&self->buildopts);
   g_clear_pointer (&self->community, g_free);
-  g_clear_pointer (&self->description, g_free);
+  g_clear_pointer (&self->description, g_ref_string_release);
   g_clear_pointer (&self->documentation, g_free);
-  g_clear_pointer (&self->summary, g_free);
+  g_clear_pointer (&self->summary, g_ref_string_release);
   g_clear_pointer (&self->tracker, g_free);
 
   /* Internal Data Structures */
@@ -273,6 +273,7 @@ modulemd_module_stream_v2_set_arch (ModulemdModuleStreamV2 *self,
                                     const gchar *arch)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   modulemd_module_stream_set_arch (MODULEMD_MODULE_STREAM (self), arch);
 
@@ -294,6 +295,7 @@ modulemd_module_stream_v2_set_buildopts (ModulemdModuleStreamV2 *self,
                                          ModulemdBuildopts *buildopts)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_clear_object (&self->buildopts);
   self->buildopts = modulemd_buildopts_copy (buildopts);
@@ -316,6 +318,7 @@ modulemd_module_stream_v2_set_community (ModulemdModuleStreamV2 *self,
                                          const gchar *community)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_clear_pointer (&self->community, g_free);
   self->community = g_strdup (community);
@@ -338,9 +341,10 @@ modulemd_module_stream_v2_set_description (ModulemdModuleStreamV2 *self,
                                            const gchar *description)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
-  g_clear_pointer (&self->description, g_free);
-  self->description = g_strdup (description);
+  g_clear_pointer (&self->description, g_ref_string_release);
+  self->description = modulemd_intern_string (description);
 }
 
 
@@ -368,6 +372,7 @@ modulemd_module_stream_v2_set_documentation (ModulemdModuleStreamV2 *self,
                                              const gchar *documentation)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_clear_pointer (&self->documentation, g_free);
   self->documentation = g_strdup (documentation);
@@ -390,9 +395,10 @@ modulemd_module_stream_v2_set_summary (ModulemdModuleStreamV2 *self,
                                        const gchar *summary)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
-  g_clear_pointer (&self->summary, g_free);
-  self->summary = g_strdup (summary);
+  g_clear_pointer (&self->summary, g_ref_string_release);
+  self->summary = modulemd_intern_string (summary);
 }
 
 
@@ -419,6 +425,7 @@ modulemd_module_stream_v2_set_tracker (ModulemdModuleStreamV2 *self,
                                        const gchar *tracker)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_clear_pointer (&self->tracker, g_free);
   self->tracker = g_strdup (tracker);
@@ -452,6 +459,7 @@ modulemd_module_stream_v2_add_component (ModulemdModuleStreamV2 *self,
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
   g_return_if_fail (MODULEMD_IS_COMPONENT (component));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   if (MODULEMD_IS_COMPONENT_RPM (component))
     {
@@ -487,6 +495,7 @@ modulemd_module_stream_v2_remove_module_component (
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove (self->module_components, component_name);
 }
@@ -497,6 +506,7 @@ modulemd_module_stream_v2_clear_module_components (
   ModulemdModuleStreamV2 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->module_components);
 }
@@ -513,6 +523,7 @@ modulemd_module_stream_v2_remove_rpm_component (ModulemdModuleStreamV2 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove (self->rpm_components, component_name);
 }
@@ -522,6 +533,7 @@ void
 modulemd_module_stream_v2_clear_rpm_components (ModulemdModuleStreamV2 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->rpm_components);
 }
@@ -567,6 +579,33 @@ modulemd_module_stream_v2_get_rpm_component (ModulemdModuleStreamV2 *self,
 }
 
 
+GPtrArray *
+modulemd_module_stream_v2_get_rpm_component_build_batches (
+  ModulemdModuleStreamV2 *self, GError **error)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self), NULL);
+
+  return modulemd_module_stream_plan_component_builds (
+    self->rpm_components, NULL, error);
+}
+
+
+GStrv
+modulemd_module_stream_v2_get_rpm_component_critical_path (
+  ModulemdModuleStreamV2 *self, GError **error)
+{
+  g_autoptr (GPtrArray) batches = NULL;
+  GStrv critical_path = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self), NULL);
+
+  batches = modulemd_module_stream_plan_component_builds (
+    self->rpm_components, &critical_path, error);
+
+  return critical_path;
+}
+
+
 void
 modulemd_module_stream_v2_add_content_license (ModulemdModuleStreamV2 *self,
                                                const gchar *license)
@@ -577,8 +616,9 @@ modulemd_module_stream_v2_add_content_license (ModulemdModuleStreamV2 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
-  g_hash_table_add (self->content_licenses, g_strdup (license));
+  modulemd_interned_set_add (self->content_licenses, license);
 }
 
 
@@ -587,8 +627,9 @@ modulemd_module_stream_v2_replace_content_licenses (
   ModulemdModuleStreamV2 *self, GHashTable *set)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
-  MODULEMD_REPLACE_SET (self->content_licenses, set);
+  MODULEMD_REPLACE_INTERNED_SET (self->content_licenses, set);
 }
 
 
@@ -602,8 +643,9 @@ modulemd_module_stream_v2_add_module_license (ModulemdModuleStreamV2 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
-  g_hash_table_add (self->module_licenses, g_strdup (license));
+  modulemd_interned_set_add (self->module_licenses, license);
 }
 
 
@@ -612,8 +654,9 @@ modulemd_module_stream_v2_replace_module_licenses (
   ModulemdModuleStreamV2 *self, GHashTable *set)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
-  MODULEMD_REPLACE_SET (self->module_licenses, set);
+  MODULEMD_REPLACE_INTERNED_SET (self->module_licenses, set);
 }
 
 
@@ -627,6 +670,7 @@ modulemd_module_stream_v2_remove_content_license (ModulemdModuleStreamV2 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove (self->content_licenses, license);
 }
@@ -642,6 +686,7 @@ modulemd_module_stream_v2_remove_module_license (ModulemdModuleStreamV2 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove (self->module_licenses, license);
 }
@@ -651,6 +696,7 @@ void
 modulemd_module_stream_v2_clear_content_licenses (ModulemdModuleStreamV2 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->content_licenses);
 }
@@ -660,6 +706,7 @@ void
 modulemd_module_stream_v2_clear_module_licenses (ModulemdModuleStreamV2 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->module_licenses);
 }
@@ -695,6 +742,7 @@ modulemd_module_stream_v2_add_profile (ModulemdModuleStreamV2 *self,
     }
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
   g_return_if_fail (MODULEMD_IS_PROFILE (profile));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   ModulemdProfile *copied_profile = modulemd_profile_copy (profile);
   modulemd_profile_set_owner (copied_profile, MODULEMD_MODULE_STREAM (self));
@@ -709,6 +757,7 @@ void
 modulemd_module_stream_v2_clear_profiles (ModulemdModuleStreamV2 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->profiles);
 }
@@ -744,8 +793,9 @@ modulemd_module_stream_v2_add_rpm_api (ModulemdModuleStreamV2 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
-  g_hash_table_add (self->rpm_api, g_strdup (rpm));
+  modulemd_interned_set_add (self->rpm_api, rpm);
 }
 
 
@@ -754,8 +804,9 @@ modulemd_module_stream_v2_replace_rpm_api (ModulemdModuleStreamV2 *self,
                                            GHashTable *set)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
-  MODULEMD_REPLACE_SET (self->rpm_api, set);
+  MODULEMD_REPLACE_INTERNED_SET (self->rpm_api, set);
 }
 
 
@@ -769,6 +820,7 @@ modulemd_module_stream_v2_remove_rpm_api (ModulemdModuleStreamV2 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove (self->rpm_api, rpm);
 }
@@ -778,6 +830,7 @@ void
 modulemd_module_stream_v2_clear_rpm_api (ModulemdModuleStreamV2 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->rpm_api);
 }
@@ -802,8 +855,9 @@ modulemd_module_stream_v2_add_rpm_artifact (ModulemdModuleStreamV2 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
-  g_hash_table_add (self->rpm_artifacts, g_strdup (nevr));
+  modulemd_interned_set_add (self->rpm_artifacts, nevr);
 }
 
 
@@ -812,8 +866,9 @@ modulemd_module_stream_v2_replace_rpm_artifacts (ModulemdModuleStreamV2 *self,
                                                  GHashTable *set)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
-  MODULEMD_REPLACE_SET (self->rpm_artifacts, set);
+  MODULEMD_REPLACE_INTERNED_SET (self->rpm_artifacts, set);
 }
 
 
@@ -827,6 +882,7 @@ modulemd_module_stream_v2_remove_rpm_artifact (ModulemdModuleStreamV2 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove (self->rpm_artifacts, nevr);
 }
@@ -836,6 +892,7 @@ void
 modulemd_module_stream_v2_clear_rpm_artifacts (ModulemdModuleStreamV2 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->rpm_artifacts);
 }
@@ -879,6 +936,7 @@ modulemd_module_stream_v2_set_rpm_artifact_map_entry (
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
   g_return_if_fail (entry && digest && checksum);
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   digest_table = get_or_create_digest_table (self, digest);
 
@@ -915,8 +973,9 @@ modulemd_module_stream_v2_add_rpm_filter (ModulemdModuleStreamV2 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
-  g_hash_table_add (self->rpm_filters, g_strdup (rpm));
+  modulemd_interned_set_add (self->rpm_filters, rpm);
 }
 
 
@@ -925,8 +984,9 @@ modulemd_module_stream_v2_replace_rpm_filters (ModulemdModuleStreamV2 *self,
                                                GHashTable *set)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
-  MODULEMD_REPLACE_SET (self->rpm_filters, set);
+  MODULEMD_REPLACE_INTERNED_SET (self->rpm_filters, set);
 }
 
 
@@ -940,6 +1000,7 @@ modulemd_module_stream_v2_remove_rpm_filter (ModulemdModuleStreamV2 *self,
     }
 
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove (self->rpm_filters, rpm);
 }
@@ -949,6 +1010,7 @@ void
 modulemd_module_stream_v2_clear_rpm_filters (ModulemdModuleStreamV2 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->rpm_filters);
 }
@@ -974,6 +1036,7 @@ modulemd_module_stream_v2_add_servicelevel (ModulemdModuleStreamV2 *self,
     }
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
   g_return_if_fail (MODULEMD_IS_SERVICE_LEVEL (servicelevel));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_replace (
     self->servicelevels,
@@ -986,6 +1049,7 @@ void
 modulemd_module_stream_v2_clear_servicelevels (ModulemdModuleStreamV2 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_hash_table_remove_all (self->servicelevels);
 }
@@ -1016,6 +1080,7 @@ modulemd_module_stream_v2_add_dependencies (ModulemdModuleStreamV2 *self,
                                             ModulemdDependencies *deps)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_ptr_array_add (self->dependencies, modulemd_dependencies_copy (deps));
 }
@@ -1027,6 +1092,7 @@ modulemd_module_stream_v2_replace_dependencies (ModulemdModuleStreamV2 *self,
 {
   gsize i;
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   for (i = 0; i < array->len; i++)
     {
@@ -1040,6 +1106,7 @@ void
 modulemd_module_stream_v2_clear_dependencies (ModulemdModuleStreamV2 *self)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   g_ptr_array_set_size (self->dependencies, 0);
 }
@@ -1059,6 +1126,7 @@ modulemd_module_stream_v2_remove_dependencies (ModulemdModuleStreamV2 *self,
 {
   guint index;
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   while (g_ptr_array_find_with_equal_func (
     self->dependencies, deps, dep_equal_wrapper, &index))
@@ -1081,6 +1149,7 @@ void
 modulemd_module_stream_v2_set_xmd (ModulemdModuleStreamV2 *self, GVariant *xmd)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self));
+  modulemd_module_stream_invalidate (MODULEMD_MODULE_STREAM (self));
 
   /* Do nothing if we were passed the same pointer */
   if (self->xmd == xmd)
@@ -1100,6 +1169,37 @@ modulemd_module_stream_v2_get_xmd (ModulemdModuleStreamV2 *self)
 }
 
 
+guint64
+modulemd_module_stream_v2_get_child_generation (ModulemdModuleStreamV2 *self)
+{
+  GHashTableIter iter;
+  gpointer value;
+  guint64 generation = 0;
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE_STREAM_V2 (self), 0);
+
+  g_hash_table_iter_init (&iter, self->rpm_components);
+  while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+      generation +=
+        modulemd_component_get_generation (MODULEMD_COMPONENT (value));
+    }
+
+  if (self->buildopts != NULL)
+    {
+      generation += modulemd_buildopts_get_generation (self->buildopts);
+    }
+
+  for (guint i = 0; i < self->dependencies->len; i++)
+    {
+      generation += modulemd_dependencies_get_generation (
+        MODULEMD_DEPENDENCIES (g_ptr_array_index (self->dependencies, i)));
+    }
+
+  return generation;
+}
+
+
 static gboolean
 modulemd_module_stream_v2_validate (ModulemdModuleStream *self, GError **error)
 {
@@ -1493,25 +1593,20 @@ modulemd_module_stream_v2_init (ModulemdModuleStreamV2 *self)
     g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
 
 
-  self->content_licenses =
-    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
-  self->module_licenses =
-    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  self->content_licenses = modulemd_interned_set_new ();
+  self->module_licenses = modulemd_interned_set_new ();
 
   self->profiles =
     g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
 
-  self->rpm_api =
-    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  self->rpm_api = modulemd_interned_set_new ();
 
-  self->rpm_artifacts =
-    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  self->rpm_artifacts = modulemd_interned_set_new ();
 
   self->rpm_artifact_map = g_hash_table_new_full (
     g_str_hash, g_str_equal, g_free, modulemd_hash_table_unref);
 
-  self->rpm_filters =
-    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  self->rpm_filters = modulemd_interned_set_new ();
 
   self->servicelevels =
     g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
@@ -1577,8 +1672,24 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                       gboolean strict,
                                       GError **error)
 {
-  MODULEMD_INIT_TRACE ();
   MMD_INIT_YAML_PARSER (parser);
+
+  if (!modulemd_subdocument_info_get_data_parser (
+        subdoc, &parser, strict, error))
+    {
+      return NULL;
+    }
+
+  return modulemd_module_stream_v2_parse_yaml_data (&parser, strict, error);
+}
+
+
+ModulemdModuleStreamV2 *
+modulemd_module_stream_v2_parse_yaml_data (yaml_parser_t *parser,
+                                           gboolean strict,
+                                           GError **error)
+{
+  MODULEMD_INIT_TRACE ();
   MMD_INIT_YAML_EVENT (event);
   gboolean done = FALSE;
   g_autoptr (GError) nested_error = NULL;
@@ -1588,18 +1699,12 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
   g_autoptr (GVariant) xmd = NULL;
   guint64 version;
 
-  if (!modulemd_subdocument_info_get_data_parser (
-        subdoc, &parser, strict, error))
-    {
-      return FALSE;
-    }
-
-  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
   modulestream = modulemd_module_stream_v2_new (NULL, NULL);
 
   /* Read the MAPPING_START */
-  YAML_PARSER_PARSE_WITH_EXIT (&parser, &event, error);
+  YAML_PARSER_PARSE_WITH_EXIT (parser, &event, error);
   if (event.type != YAML_MAPPING_START_EVENT)
     {
       MMD_YAML_ERROR_EVENT_EXIT (
@@ -1609,7 +1714,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
   /* Process through the mapping */
   while (!done)
     {
-      YAML_PARSER_PARSE_WITH_EXIT (&parser, &event, error);
+      YAML_PARSER_PARSE_WITH_EXIT (parser, &event, error);
 
       switch (event.type)
         {
@@ -1622,7 +1727,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
           if (g_str_equal ((const gchar *)event.data.scalar.value, "name"))
             {
               MMD_SET_PARSED_YAML_STRING (
-                &parser,
+                parser,
                 error,
                 modulemd_module_stream_set_module_name,
                 MODULEMD_MODULE_STREAM (modulestream));
@@ -1633,7 +1738,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "stream"))
             {
               MMD_SET_PARSED_YAML_STRING (
-                &parser,
+                parser,
                 error,
                 modulemd_module_stream_set_stream_name,
                 MODULEMD_MODULE_STREAM (modulestream));
@@ -1643,7 +1748,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
           else if (g_str_equal ((const gchar *)event.data.scalar.value,
                                 "version"))
             {
-              version = modulemd_yaml_parse_uint64 (&parser, &nested_error);
+              version = modulemd_yaml_parse_uint64 (parser, &nested_error);
               if (nested_error)
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
@@ -1659,7 +1764,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "context"))
             {
               MMD_SET_PARSED_YAML_STRING (
-                &parser,
+                parser,
                 error,
                 modulemd_module_stream_set_context,
                 MODULEMD_MODULE_STREAM (modulestream));
@@ -1669,7 +1774,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
           else if (g_str_equal ((const gchar *)event.data.scalar.value,
                                 "arch"))
             {
-              MMD_SET_PARSED_YAML_STRING (&parser,
+              MMD_SET_PARSED_YAML_STRING (parser,
                                           error,
                                           modulemd_module_stream_v2_set_arch,
                                           modulestream);
@@ -1680,7 +1785,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "summary"))
             {
               MMD_SET_PARSED_YAML_STRING (
-                &parser,
+                parser,
                 error,
                 modulemd_module_stream_v2_set_summary,
                 modulestream);
@@ -1691,7 +1796,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "description"))
             {
               MMD_SET_PARSED_YAML_STRING (
-                &parser,
+                parser,
                 error,
                 modulemd_module_stream_v2_set_description,
                 modulestream);
@@ -1702,7 +1807,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "servicelevels"))
             {
               if (!modulemd_module_stream_v2_parse_servicelevels (
-                    &parser, modulestream, strict, &nested_error))
+                    parser, modulestream, strict, &nested_error))
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return NULL;
@@ -1714,7 +1819,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "license"))
             {
               if (!modulemd_module_stream_v2_parse_licenses (
-                    &parser, modulestream, strict, &nested_error))
+                    parser, modulestream, strict, &nested_error))
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return NULL;
@@ -1725,7 +1830,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
           else if (g_str_equal ((const gchar *)event.data.scalar.value, "xmd"))
             {
               xmd =
-                modulemd_module_stream_v2_parse_raw (&parser, &nested_error);
+                modulemd_module_stream_v2_parse_raw (parser, &nested_error);
               if (!xmd)
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
@@ -1740,7 +1845,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "dependencies"))
             {
               if (!modulemd_module_stream_v2_parse_deps (
-                    &parser, modulestream, strict, &nested_error))
+                    parser, modulestream, strict, &nested_error))
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return NULL;
@@ -1752,7 +1857,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "references"))
             {
               if (!modulemd_module_stream_v2_parse_refs (
-                    &parser, modulestream, strict, &nested_error))
+                    parser, modulestream, strict, &nested_error))
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return NULL;
@@ -1764,7 +1869,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "profiles"))
             {
               if (!modulemd_module_stream_v2_parse_profiles (
-                    &parser, modulestream, strict, &nested_error))
+                    parser, modulestream, strict, &nested_error))
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return NULL;
@@ -1774,21 +1879,20 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
           /* API */
           else if (g_str_equal ((const gchar *)event.data.scalar.value, "api"))
             {
-              set = modulemd_yaml_parse_string_set_from_map (
-                &parser, "rpms", strict, &nested_error);
-              modulemd_module_stream_v2_replace_rpm_api (modulestream, set);
-              g_clear_pointer (&set, g_hash_table_unref);
+              set = modulemd_yaml_parse_interned_string_set_from_map (
+                parser, "rpms", strict, &nested_error);
+              modulemd_interned_set_take (&modulestream->rpm_api,
+                                          g_steal_pointer (&set));
             }
 
           /* Filter */
           else if (g_str_equal ((const gchar *)event.data.scalar.value,
                                 "filter"))
             {
-              set = modulemd_yaml_parse_string_set_from_map (
-                &parser, "rpms", strict, &nested_error);
-              modulemd_module_stream_v2_replace_rpm_filters (modulestream,
-                                                             set);
-              g_clear_pointer (&set, g_hash_table_unref);
+              set = modulemd_yaml_parse_interned_string_set_from_map (
+                parser, "rpms", strict, &nested_error);
+              modulemd_interned_set_take (&modulestream->rpm_filters,
+                                          g_steal_pointer (&set));
             }
 
           /* Build Options */
@@ -1796,7 +1900,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "buildopts"))
             {
               buildopts =
-                modulemd_buildopts_parse_yaml (&parser, strict, &nested_error);
+                modulemd_buildopts_parse_yaml (parser, strict, &nested_error);
               if (!buildopts)
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
@@ -1813,7 +1917,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "components"))
             {
               if (!modulemd_module_stream_v2_parse_components (
-                    &parser, modulestream, strict, &nested_error))
+                    parser, modulestream, strict, &nested_error))
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return NULL;
@@ -1825,7 +1929,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                 "artifacts"))
             {
               if (!modulemd_module_stream_v2_parse_artifacts (
-                    &parser, modulestream, strict, &nested_error))
+                    parser, modulestream, strict, &nested_error))
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return NULL;
@@ -1836,7 +1940,7 @@ modulemd_module_stream_v2_parse_yaml (ModulemdSubdocumentInfo *subdoc,
 
           else
             {
-              SKIP_UNKNOWN (&parser,
+              SKIP_UNKNOWN (parser,
                             NULL,
                             "Unexpected key in data: %s",
                             (const gchar *)event.data.scalar.value);
@@ -1911,23 +2015,23 @@ modulemd_module_stream_v2_parse_licenses (yaml_parser_t *parser,
 
           if (g_str_equal ((const gchar *)event.data.scalar.value, "module"))
             {
-              set = modulemd_yaml_parse_string_set (parser, &nested_error);
+              set = modulemd_yaml_parse_interned_string_set (parser,
+                                                             &nested_error);
               if (!set)
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return FALSE;
                 }
-              modulemd_module_stream_v2_replace_module_licenses (modulestream,
-                                                                 set);
-              g_clear_pointer (&set, g_hash_table_unref);
+              modulemd_interned_set_take (&modulestream->module_licenses,
+                                          g_steal_pointer (&set));
             }
           else if (g_str_equal ((const gchar *)event.data.scalar.value,
                                 "content"))
             {
-              set = modulemd_yaml_parse_string_set (parser, &nested_error);
-              modulemd_module_stream_v2_replace_content_licenses (modulestream,
-                                                                  set);
-              g_clear_pointer (&set, g_hash_table_unref);
+              set = modulemd_yaml_parse_interned_string_set (parser,
+                                                             &nested_error);
+              modulemd_interned_set_take (&modulestream->content_licenses,
+                                          g_steal_pointer (&set));
             }
           else
             {
@@ -2535,16 +2639,16 @@ modulemd_module_stream_v2_parse_artifacts (
         case YAML_SCALAR_EVENT:
           if (g_str_equal ((const gchar *)event.data.scalar.value, "rpms"))
             {
-              set = modulemd_yaml_parse_string_set (parser, &nested_error);
+              set = modulemd_yaml_parse_interned_string_set (parser,
+                                                             &nested_error);
               if (!set)
                 {
                   g_propagate_error (error, g_steal_pointer (&nested_error));
                   return FALSE;
                 }
 
-              modulemd_module_stream_v2_replace_rpm_artifacts (modulestream,
-                                                               set);
-              g_clear_pointer (&set, g_hash_table_unref);
+              modulemd_interned_set_take (&modulestream->rpm_artifacts,
+                                          g_steal_pointer (&set));
             }
 
           else if (g_str_equal ((const gchar *)event.data.scalar.value,
@@ -33,6 +33,17 @@ typedef struct
   gchar *context;
   gchar *arch;
   ModulemdTranslation *translation;
+
+  /* Increased by every method that modifies this stream. It starts at one so
+   * that a validated_generation of zero means "never validated".
+   */
+  guint64 generation;
+
+  /* The generation of this stream and the sum of the generations of its
+   * child objects when it last passed validation.
+   */
+  guint64 validated_generation;
+  guint64 validated_child_generation;
 } ModulemdModuleStreamPrivate;
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (ModulemdModuleStream,
@@ -92,6 +103,7 @@ modulemd_module_stream_read_file (const gchar *path,
 {
   MMD_INIT_YAML_PARSER (parser);
   g_autoptr (FILE) yaml_stream = NULL;
+  g_autoptr (GMappedFile) mapped = NULL;
   gint err;
 
   g_return_val_if_fail (path, NULL);
@@ -111,7 +123,18 @@ modulemd_module_stream_read_file (const gchar *path,
       return NULL;
     }
 
-  yaml_parser_set_input_file (&parser, yaml_stream);
+  mapped = modulemd_yaml_map_file (fileno (yaml_stream));
+  if (mapped)
+    {
+      yaml_parser_set_input_string (
+        &parser,
+        (const unsigned char *)g_mapped_file_get_contents (mapped),
+        g_mapped_file_get_length (mapped));
+    }
+  else
+    {
+      yaml_parser_set_input_file (&parser, yaml_stream);
+    }
 
   return modulemd_module_stream_read_yaml (
     &parser, module_name, module_stream, strict, error);
@@ -305,10 +328,10 @@ modulemd_module_stream_finalize (GObject *object)
   ModulemdModuleStreamPrivate *priv =
     modulemd_module_stream_get_instance_private (self);
 
-  g_clear_pointer (&priv->module_name, g_free);
-  g_clear_pointer (&priv->stream_name, g_free);
-  g_clear_pointer (&priv->context, g_free);
-  g_clear_pointer (&priv->arch, g_free);
+  g_clear_pointer (&priv->module_name, g_ref_string_release);
+  g_clear_pointer (&priv->stream_name, g_ref_string_release);
+  g_clear_pointer (&priv->context, g_ref_string_release);
+  g_clear_pointer (&priv->arch, g_ref_string_release);
   g_clear_pointer (&priv->translation, g_object_unref);
 
   G_OBJECT_CLASS (modulemd_module_stream_parent_class)->finalize (object);
@@ -430,12 +453,19 @@ modulemd_module_stream_default_copy (ModulemdModuleStream *self,
 }
 
 
+static gboolean
+modulemd_module_stream_is_validated (ModulemdModuleStream *self);
+
+static void
+modulemd_module_stream_set_validated (ModulemdModuleStream *self);
+
 ModulemdModuleStream *
 modulemd_module_stream_copy (ModulemdModuleStream *self,
                              const gchar *module_name,
                              const gchar *module_stream)
 {
   ModulemdModuleStreamClass *klass;
+  ModulemdModuleStream *copy = NULL;
 
   if (!self)
     {
@@ -447,7 +477,17 @@ modulemd_module_stream_copy (ModulemdModuleStream *self,
   klass = MODULEMD_MODULE_STREAM_GET_CLASS (self);
   g_return_val_if_fail (klass->copy, NULL);
 
-  return klass->copy (self, module_name, module_stream);
+  copy = klass->copy (self, module_name, module_stream);
+
+  /* A copy of a stream that is known to be valid is valid as well. The module
+   * and stream names do not take part in validation.
+   */
+  if (copy != NULL && modulemd_module_stream_is_validated (self))
+    {
+      modulemd_module_stream_set_validated (copy);
+    }
+
+  return copy;
 }
 
 
@@ -738,6 +778,357 @@ modulemd_module_stream_validate_components (GHashTable *components,
 }
 
 
+static gint
+compare_build_orders (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+  const gint64 *buildorders = user_data;
+  guint index_a = *(const guint *)a;
+  guint index_b = *(const guint *)b;
+
+  if (buildorders[index_a] != buildorders[index_b])
+    {
+      return buildorders[index_a] < buildorders[index_b] ? -1 : 1;
+    }
+
+  return index_a < index_b ? -1 : index_a > index_b;
+}
+
+
+/*
+ * Sets @levels to the position of the batch of each component, with the
+ * components that have the lowest buildorder in the first batch. Every
+ * component must wait for all of the components of the previous batch, so
+ * @predecessors is set to the first one of them.
+ *
+ * Returns: The number of batches.
+ */
+static guint
+plan_buildorder_batches (GHashTable *components,
+                         GPtrArray *names,
+                         guint *levels,
+                         guint *predecessors)
+{
+  g_autofree gint64 *buildorders = NULL;
+  g_autoptr (GArray) order = NULL;
+  g_autoptr (GArray) first_in_level = NULL;
+  guint i;
+  guint n_levels = 0;
+
+  buildorders = g_new0 (gint64, names->len);
+  order = g_array_sized_new (FALSE, FALSE, sizeof (guint), names->len);
+  for (i = 0; i < names->len; i++)
+    {
+      buildorders[i] = modulemd_component_get_buildorder (
+        g_hash_table_lookup (components, g_ptr_array_index (names, i)));
+      g_array_append_val (order, i);
+    }
+  g_array_sort_with_data (order, compare_build_orders, buildorders);
+
+  first_in_level = g_array_new (FALSE, FALSE, sizeof (guint));
+  for (guint j = 0; j < order->len; j++)
+    {
+      i = g_array_index (order, guint, j);
+      if (j == 0 ||
+          buildorders[i] != buildorders[g_array_index (order, guint, j - 1)])
+        {
+          g_array_append_val (first_in_level, i);
+          n_levels++;
+        }
+
+      levels[i] = n_levels - 1;
+      predecessors[i] =
+        n_levels > 1 ? g_array_index (first_in_level, guint, n_levels - 2)
+                     : G_MAXUINT;
+    }
+
+  return n_levels;
+}
+
+
+/*
+ * Sets @levels to the position of the batch of each component, with each
+ * component in the batch right after the last of its buildafter entries.
+ * @predecessors is set to the first of those entries in that batch. The
+ * components that are part of or wait for a cycle keep a level of
+ * G_MAXUINT.
+ *
+ * Returns: The number of batches.
+ */
+static guint
+plan_buildafter_batches (GHashTable *components,
+                         GPtrArray *names,
+                         GHashTable *indexes,
+                         guint *levels,
+                         guint *predecessors)
+{
+  g_autoptr (GPtrArray) dependents = NULL;
+  g_autoptr (GArray) current = NULL;
+  g_autoptr (GArray) next = NULL;
+  g_autofree guint *in_degree = NULL;
+  GHashTable *buildafter = NULL;
+  GArray *list = NULL;
+  GHashTableIter iter;
+  gpointer key;
+  guint i;
+  guint j;
+  guint n_levels = 0;
+
+  in_degree = g_new0 (guint, names->len);
+  dependents =
+    g_ptr_array_new_full (names->len, (GDestroyNotify)g_array_unref);
+  current = g_array_new (FALSE, FALSE, sizeof (guint));
+  next = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  for (i = 0; i < names->len; i++)
+    {
+      g_ptr_array_add (dependents, g_array_new (FALSE, FALSE, sizeof (guint)));
+    }
+
+  for (i = 0; i < names->len; i++)
+    {
+      buildafter = modulemd_component_get_buildafter_internal (
+        g_hash_table_lookup (components, g_ptr_array_index (names, i)));
+
+      g_hash_table_iter_init (&iter, buildafter);
+      while (g_hash_table_iter_next (&iter, &key, NULL))
+        {
+          j = GPOINTER_TO_UINT (g_hash_table_lookup (indexes, key)) - 1;
+          g_array_append_val (g_ptr_array_index (dependents, j), i);
+          in_degree[i]++;
+        }
+
+      if (in_degree[i] == 0)
+        {
+          g_array_append_val (current, i);
+        }
+    }
+
+  /* Kahn's algorithm, one batch at a time */
+  while (current->len > 0)
+    {
+      for (guint c = 0; c < current->len; c++)
+        {
+          i = g_array_index (current, guint, c);
+          levels[i] = n_levels;
+
+          list = g_ptr_array_index (dependents, i);
+          for (guint d = 0; d < list->len; d++)
+            {
+              j = g_array_index (list, guint, d);
+              if (--in_degree[j] == 0)
+                {
+                  g_array_append_val (next, j);
+                }
+            }
+        }
+
+      g_array_set_size (current, 0);
+      g_array_append_vals (current, next->data, next->len);
+      g_array_set_size (next, 0);
+      n_levels++;
+    }
+
+  for (i = 0; i < names->len; i++)
+    {
+      if (levels[i] == G_MAXUINT || levels[i] == 0)
+        {
+          continue;
+        }
+
+      buildafter = modulemd_component_get_buildafter_internal (
+        g_hash_table_lookup (components, g_ptr_array_index (names, i)));
+
+      g_hash_table_iter_init (&iter, buildafter);
+      while (g_hash_table_iter_next (&iter, &key, NULL))
+        {
+          j = GPOINTER_TO_UINT (g_hash_table_lookup (indexes, key)) - 1;
+          if (levels[j] == levels[i] - 1 && j < predecessors[i])
+            {
+              predecessors[i] = j;
+            }
+        }
+    }
+
+  return n_levels;
+}
+
+
+/*
+ * Reports a cycle among the components left unplanned by
+ * plan_buildafter_batches(). Each of them waits for at least one other
+ * unplanned component, so following those leads back to one of them.
+ */
+static void
+set_buildafter_cycle_error (GHashTable *components,
+                            GPtrArray *names,
+                            GHashTable *indexes,
+                            guint *levels,
+                            GError **error)
+{
+  g_autofree guint *positions = NULL;
+  g_autoptr (GString) cycle = NULL;
+  g_autoptr (GArray) path = NULL;
+  GHashTableIter iter;
+  gpointer key;
+  guint current = 0;
+  guint next;
+  guint j;
+
+  positions = g_new (guint, names->len);
+  path = g_array_new (FALSE, FALSE, sizeof (guint));
+  for (guint i = 0; i < names->len; i++)
+    {
+      positions[i] = G_MAXUINT;
+    }
+
+  while (levels[current] != G_MAXUINT)
+    {
+      current++;
+    }
+
+  while (positions[current] == G_MAXUINT)
+    {
+      positions[current] = path->len;
+      g_array_append_val (path, current);
+
+      next = G_MAXUINT;
+      g_hash_table_iter_init (
+        &iter,
+        modulemd_component_get_buildafter_internal (g_hash_table_lookup (
+          components, g_ptr_array_index (names, current))));
+      while (g_hash_table_iter_next (&iter, &key, NULL))
+        {
+          j = GPOINTER_TO_UINT (g_hash_table_lookup (indexes, key)) - 1;
+          if (levels[j] == G_MAXUINT && j < next)
+            {
+              next = j;
+            }
+        }
+      current = next;
+    }
+
+  cycle = g_string_new (NULL);
+  for (guint p = positions[current]; p < path->len; p++)
+    {
+      g_string_append_printf (
+        cycle,
+        "%s'%s'",
+        cycle->len ? ", " : "",
+        (const gchar *)g_ptr_array_index (names,
+                                          g_array_index (path, guint, p)));
+    }
+
+  g_set_error (error,
+               MODULEMD_ERROR,
+               MODULEMD_ERROR_VALIDATE,
+               "Buildafter cycle between components %s",
+               cycle->str);
+}
+
+
+GPtrArray *
+modulemd_module_stream_plan_component_builds (GHashTable *components,
+                                              GStrv *critical_path,
+                                              GError **error)
+{
+  g_autoptr (GPtrArray) names = NULL;
+  g_autoptr (GHashTable) indexes = NULL;
+  g_autoptr (GPtrArray) builders = NULL;
+  g_autoptr (GPtrArray) batches = NULL;
+  g_autofree guint *levels = NULL;
+  g_autofree guint *predecessors = NULL;
+  gboolean has_buildafter = FALSE;
+  GPtrArray *batch = NULL;
+  guint n_levels;
+  guint i;
+
+  if (!modulemd_module_stream_validate_components (components, error))
+    {
+      return NULL;
+    }
+
+  names = modulemd_ordered_str_keys (components, modulemd_strcmp_sort);
+  indexes = g_hash_table_new (g_str_hash, g_str_equal);
+  levels = g_new (guint, names->len);
+  predecessors = g_new (guint, names->len);
+
+  for (i = 0; i < names->len; i++)
+    {
+      g_hash_table_insert (
+        indexes, g_ptr_array_index (names, i), GUINT_TO_POINTER (i + 1));
+      levels[i] = G_MAXUINT;
+      predecessors[i] = G_MAXUINT;
+
+      if (modulemd_component_has_buildafter (
+            g_hash_table_lookup (components, g_ptr_array_index (names, i))))
+        {
+          has_buildafter = TRUE;
+        }
+    }
+
+  /* Validation ensures that buildorder and buildafter aren't mixed */
+  if (has_buildafter)
+    {
+      n_levels = plan_buildafter_batches (
+        components, names, indexes, levels, predecessors);
+    }
+  else
+    {
+      n_levels =
+        plan_buildorder_batches (components, names, levels, predecessors);
+    }
+
+  for (i = 0; i < names->len; i++)
+    {
+      if (levels[i] == G_MAXUINT)
+        {
+          set_buildafter_cycle_error (
+            components, names, indexes, levels, error);
+          return NULL;
+        }
+    }
+
+  /* The names are sorted, so each batch is as well */
+  batches = g_ptr_array_new_full (n_levels, (GDestroyNotify)g_strfreev);
+  builders = g_ptr_array_sized_new (n_levels);
+  for (i = 0; i < n_levels; i++)
+    {
+      g_ptr_array_add (builders, g_ptr_array_new ());
+    }
+  for (i = 0; i < names->len; i++)
+    {
+      g_ptr_array_add (g_ptr_array_index (builders, levels[i]),
+                       g_strdup (g_ptr_array_index (names, i)));
+    }
+  for (i = 0; i < n_levels; i++)
+    {
+      batch = g_ptr_array_index (builders, i);
+      g_ptr_array_add (batch, NULL);
+      g_ptr_array_add (batches, g_ptr_array_free (batch, FALSE));
+    }
+
+  if (critical_path != NULL)
+    {
+      *critical_path = g_new0 (gchar *, n_levels + 1);
+
+      /* Walk back from the first component of the last batch */
+      i = 0;
+      while (n_levels > 0 && levels[i] != n_levels - 1)
+        {
+          i++;
+        }
+      for (guint level = n_levels; level > 0; level--)
+        {
+          (*critical_path)[level - 1] =
+            g_strdup (g_ptr_array_index (names, i));
+          i = predecessors[i];
+        }
+    }
+
+  return g_steal_pointer (&batches);
+}
+
+
 gboolean
 modulemd_module_stream_validate_component_rpm_arches (GHashTable *components,
                                                       GStrv module_arches,
@@ -794,6 +1185,81 @@ modulemd_module_stream_validate_component_rpm_arches (GHashTable *components,
 }
 
 
+/*
+ * Returns the sum of the generations of the child objects of @self that are
+ * checked by its validate() implementation. Changing one of them always
+ * increases the sum, and adding or removing one also increases the
+ * generation of @self, so the pair identifies the validated state.
+ */
+static guint64
+modulemd_module_stream_get_child_generation (ModulemdModuleStream *self)
+{
+  switch (modulemd_module_stream_get_mdversion (self))
+    {
+    case MD_MODULESTREAM_VERSION_ONE:
+      return modulemd_module_stream_v1_get_child_generation (
+        MODULEMD_MODULE_STREAM_V1 (self));
+
+    case MD_MODULESTREAM_VERSION_TWO:
+      return modulemd_module_stream_v2_get_child_generation (
+        MODULEMD_MODULE_STREAM_V2 (self));
+
+    default: return 0;
+    }
+}
+
+
+static gboolean
+modulemd_module_stream_is_validated (ModulemdModuleStream *self)
+{
+  ModulemdModuleStreamPrivate *priv =
+    modulemd_module_stream_get_instance_private (self);
+
+  return priv->validated_generation == priv->generation &&
+         priv->validated_child_generation ==
+           modulemd_module_stream_get_child_generation (self);
+}
+
+
+static void
+modulemd_module_stream_set_validated (ModulemdModuleStream *self)
+{
+  ModulemdModuleStreamPrivate *priv =
+    modulemd_module_stream_get_instance_private (self);
+
+  priv->validated_generation = priv->generation;
+  priv->validated_child_generation =
+    modulemd_module_stream_get_child_generation (self);
+}
+
+
+void
+modulemd_module_stream_invalidate (ModulemdModuleStream *self)
+{
+  g_return_if_fail (MODULEMD_IS_MODULE_STREAM (self));
+
+  ModulemdModuleStreamPrivate *priv =
+    modulemd_module_stream_get_instance_private (self);
+
+  priv->generation++;
+}
+
+
+void
+modulemd_module_stream_get_generation (ModulemdModuleStream *self,
+                                       guint64 *generation,
+                                       guint64 *child_generation)
+{
+  g_return_if_fail (MODULEMD_IS_MODULE_STREAM (self));
+
+  ModulemdModuleStreamPrivate *priv =
+    modulemd_module_stream_get_instance_private (self);
+
+  *generation = priv->generation;
+  *child_generation = modulemd_module_stream_get_child_generation (self);
+}
+
+
 gboolean
 modulemd_module_stream_validate (ModulemdModuleStream *self, GError **error)
 {
@@ -806,10 +1272,22 @@ modulemd_module_stream_validate (ModulemdModuleStream *self, GError **error)
 
   g_return_val_if_fail (MODULEMD_IS_MODULE_STREAM (self), FALSE);
 
+  /* Nothing has changed since this stream last passed validation */
+  if (modulemd_module_stream_is_validated (self))
+    {
+      return TRUE;
+    }
+
   klass = MODULEMD_MODULE_STREAM_GET_CLASS (self);
   g_return_val_if_fail (klass->validate, FALSE);
 
-  return klass->validate (self, error);
+  if (!klass->validate (self, error))
+    {
+      return FALSE;
+    }
+
+  modulemd_module_stream_set_validated (self);
+  return TRUE;
 }
 
 
@@ -837,12 +1315,13 @@ modulemd_module_stream_set_module_name (ModulemdModuleStream *self,
                                         const gchar *module_name)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM (self));
+  modulemd_module_stream_invalidate (self);
 
   ModulemdModuleStreamPrivate *priv =
     modulemd_module_stream_get_instance_private (self);
 
-  g_clear_pointer (&priv->module_name, g_free);
-  priv->module_name = g_strdup (module_name);
+  g_clear_pointer (&priv->module_name, g_ref_string_release);
+  priv->module_name = modulemd_intern_string (module_name);
 
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_MODULE_NAME]);
 }
@@ -865,14 +1344,15 @@ modulemd_module_stream_set_stream_name (ModulemdModuleStream *self,
                                         const gchar *stream_name)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM (self));
+  modulemd_module_stream_invalidate (self);
 
   ModulemdModuleStreamPrivate *priv =
     modulemd_module_stream_get_instance_private (self);
 
-  g_clear_pointer (&priv->stream_name, g_free);
-  priv->stream_name = g_strdup (stream_name);
+  g_clear_pointer (&priv->stream_name, g_ref_string_release);
+  priv->stream_name = modulemd_intern_string (stream_name);
 
-  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_MODULE_NAME]);
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_STREAM_NAME]);
 }
 
 
@@ -893,6 +1373,7 @@ modulemd_module_stream_set_version (ModulemdModuleStream *self,
                                     guint64 version)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM (self));
+  modulemd_module_stream_invalidate (self);
 
   ModulemdModuleStreamPrivate *priv =
     modulemd_module_stream_get_instance_private (self);
@@ -920,12 +1401,13 @@ modulemd_module_stream_set_context (ModulemdModuleStream *self,
                                     const gchar *context)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM (self));
+  modulemd_module_stream_invalidate (self);
 
   ModulemdModuleStreamPrivate *priv =
     modulemd_module_stream_get_instance_private (self);
 
-  g_clear_pointer (&priv->context, g_free);
-  priv->context = g_strdup (context);
+  g_clear_pointer (&priv->context, g_ref_string_release);
+  priv->context = modulemd_intern_string (context);
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_CONTEXT]);
 }
 
@@ -946,13 +1428,14 @@ void
 modulemd_module_stream_set_arch (ModulemdModuleStream *self, const gchar *arch)
 {
   g_return_if_fail (MODULEMD_IS_MODULE_STREAM (self));
+  modulemd_module_stream_invalidate (self);
 
   ModulemdModuleStreamPrivate *priv =
     modulemd_module_stream_get_instance_private (self);
 
-  g_clear_pointer (&priv->arch, g_free);
-  priv->arch = g_strdup (arch);
-  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_CONTEXT]);
+  g_clear_pointer (&priv->arch, g_ref_string_release);
+  priv->arch = modulemd_intern_string (arch);
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_ARCH]);
 }
 
 
@@ -1225,6 +1708,10 @@ modulemd_module_stream_class_init (ModulemdModuleStreamClass *klass)
 static void
 modulemd_module_stream_init (ModulemdModuleStream *self)
 {
+  ModulemdModuleStreamPrivate *priv =
+    modulemd_module_stream_get_instance_private (self);
+
+  priv->generation = 1;
 }
 
 
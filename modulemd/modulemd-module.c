@@ -19,6 +19,9 @@
 #include "private/glib-extensions.h"
 #include "private/modulemd-module-private.h"
 #include "private/modulemd-module-stream-private.h"
+#include "private/modulemd-module-stream-v1-private.h"
+#include "private/modulemd-module-stream-v2-private.h"
+#include "private/modulemd-subdocument-info-private.h"
 #include "private/modulemd-translation-private.h"
 #include "private/modulemd-util.h"
 #include "private/modulemd-yaml.h"
@@ -30,8 +33,50 @@ struct _ModulemdModule
   gchar *module_name;
 
   GPtrArray *streams;
+
+  /* The position of each of @streams in the order in which the streams were
+   * added, counting lazy streams too. It is sorted, so that streams parsed
+   * later can be inserted where they were added.
+   */
+  GArray *stream_positions; /* <guint64> */
+  guint64 next_position;
+
+  /* The parsed streams again, keyed by their NSVCA for exact lookups and
+   * grouped by stream name, context and arch for searches that specify one
+   * of those. They borrow the streams from @streams and are updated whenever
+   * one of the streams is renamed. @stream_keys records the NSVCA that each
+   * stream is currently filed under.
+   */
+  GHashTable *stream_keys; /* <ModulemdModuleStream, modulemd_nsvca> */
+  GHashTable *streams_by_nsvca; /* <modulemd_nsvca, ModulemdModuleStream> */
+  GHashTable *streams_by_name; /* <string, GPtrArray<ModulemdModuleStream>> */
+  GHashTable *streams_by_context; /* Same as streams_by_name */
+  GHashTable *streams_by_arch; /* Same as streams_by_name */
+
+  /* Incremented whenever a stream is added, removed or renamed */
+  guint64 streams_serial;
+
   ModulemdDefaults *defaults;
   GHashTable *translations;
+
+  /* Streams that have not been parsed yet and the mdversion to upgrade them
+   * to once they are.
+   */
+  GPtrArray *lazy_streams; /* <modulemd_lazy_stream> */
+  ModulemdModuleStreamVersionEnum lazy_mdversion;
+
+  /* The lazy streams again, filed like the parsed streams above. Only the
+   * ones whose NSVCA is complete are in @lazy_by_nsvca, since no others can
+   * match a lookup that gives all of it.
+   */
+  GHashTable *lazy_by_nsvca; /* <modulemd_nsvca, modulemd_lazy_stream> */
+  GHashTable *lazy_by_name; /* <string, GPtrArray<modulemd_lazy_stream>> */
+
+  /* The subdocuments of lazy streams that could not be parsed */
+  GPtrArray *lazy_failures; /* <ModulemdSubdocumentInfo> */
+
+  /* The pool of the index holding this module, if any */
+  modulemd_string_pool *strings;
 };
 
 G_DEFINE_TYPE (ModulemdModule, modulemd_module, G_TYPE_OBJECT)
@@ -48,6 +93,365 @@ enum
 static GParamSpec *properties[N_PROPS];
 
 
+typedef struct _modulemd_nsvca
+{
+  const gchar *stream_name;
+  guint64 version;
+  const gchar *context;
+  const gchar *arch;
+} modulemd_nsvca;
+
+
+static void
+modulemd_nsvca_free (gpointer nsvca)
+{
+  /* All of the fields are just pointers to static data,
+   * so nothing to free here.
+   */
+
+  g_free ((modulemd_nsvca *)nsvca);
+}
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (modulemd_nsvca, modulemd_nsvca_free);
+
+
+/* Frees a key of streams_by_nsvca, whose fields are interned strings */
+static void
+modulemd_nsvca_key_free (gpointer nsvca)
+{
+  modulemd_nsvca *key = (modulemd_nsvca *)nsvca;
+
+  if (key->stream_name)
+    {
+      g_ref_string_release ((gchar *)key->stream_name);
+    }
+  if (key->context)
+    {
+      g_ref_string_release ((gchar *)key->context);
+    }
+  if (key->arch)
+    {
+      g_ref_string_release ((gchar *)key->arch);
+    }
+  g_free (key);
+}
+
+
+static guint
+modulemd_nsvca_hash (gconstpointer nsvca)
+{
+  const modulemd_nsvca *key = (const modulemd_nsvca *)nsvca;
+  guint hash = key->stream_name ? g_str_hash (key->stream_name) : 0;
+
+  hash = hash * 31 + g_int64_hash (&key->version);
+  hash = hash * 31 + (key->context ? g_str_hash (key->context) : 0);
+  hash = hash * 31 + (key->arch ? g_str_hash (key->arch) : 0);
+
+  return hash;
+}
+
+
+static gboolean
+modulemd_nsvca_equal (gconstpointer a, gconstpointer b)
+{
+  const modulemd_nsvca *a_ = (const modulemd_nsvca *)a;
+  const modulemd_nsvca *b_ = (const modulemd_nsvca *)b;
+
+  return a_->version == b_->version &&
+         modulemd_interned_str_equal (a_->stream_name, b_->stream_name) &&
+         modulemd_interned_str_equal (a_->context, b_->context) &&
+         modulemd_interned_str_equal (a_->arch, b_->arch);
+}
+
+
+/*
+ * Files @stream in the lookup tables of @self under its current NSVCA.
+ */
+static void
+index_stream (ModulemdModule *self, ModulemdModuleStream *stream)
+{
+  modulemd_nsvca *key = g_new0 (modulemd_nsvca, 1);
+  MMD_INIT_STRING_POOL_SCOPE (scope, self->strings);
+
+  key->stream_name =
+    modulemd_intern_string (modulemd_module_stream_get_stream_name (stream));
+  key->version = modulemd_module_stream_get_version (stream);
+  key->context =
+    modulemd_intern_string (modulemd_module_stream_get_context (stream));
+  key->arch =
+    modulemd_intern_string (modulemd_module_stream_get_arch (stream));
+
+  g_hash_table_replace (self->stream_keys, stream, key);
+  g_hash_table_replace (self->streams_by_nsvca, key, stream);
+  modulemd_multimap_add (self->streams_by_name, key->stream_name, stream);
+  modulemd_multimap_add (self->streams_by_context, key->context, stream);
+  modulemd_multimap_add (self->streams_by_arch, key->arch, stream);
+}
+
+
+/*
+ * Removes @stream from the lookup tables of @self, using the NSVCA it was
+ * filed under rather than its current one.
+ */
+static void
+unindex_stream (ModulemdModule *self, ModulemdModuleStream *stream)
+{
+  modulemd_nsvca *key = g_hash_table_lookup (self->stream_keys, stream);
+
+  if (key == NULL)
+    {
+      return;
+    }
+
+  /* Unless another stream with the same NSVCA has replaced it since */
+  if (g_hash_table_lookup (self->streams_by_nsvca, key) == stream)
+    {
+      g_hash_table_remove (self->streams_by_nsvca, key);
+    }
+  modulemd_multimap_remove (self->streams_by_name, key->stream_name, stream);
+  modulemd_multimap_remove (self->streams_by_context, key->context, stream);
+  modulemd_multimap_remove (self->streams_by_arch, key->arch, stream);
+
+  g_hash_table_remove (self->stream_keys, stream);
+}
+
+
+static void
+stream_notify_cb (GObject *object, GParamSpec *pspec, gpointer user_data)
+{
+  ModulemdModule *self = MODULEMD_MODULE (user_data);
+  ModulemdModuleStream *stream = MODULEMD_MODULE_STREAM (object);
+  const gchar *name = g_param_spec_get_name (pspec);
+
+  if (!g_str_equal (name, "stream-name") && !g_str_equal (name, "version") &&
+      !g_str_equal (name, "context") && !g_str_equal (name, "arch"))
+    {
+      return;
+    }
+
+  unindex_stream (self, stream);
+  index_stream (self, stream);
+  self->streams_serial++;
+}
+
+
+/*
+ * Adds @stream to the parsed streams of @self at @position in the order in
+ * which streams were added, taking ownership of it.
+ */
+static void
+insert_stream (ModulemdModule *self,
+               ModulemdModuleStream *stream,
+               guint64 position)
+{
+  guint low = 0;
+  guint high = self->stream_positions->len;
+  guint middle;
+
+  while (low < high)
+    {
+      middle = low + (high - low) / 2;
+      if (g_array_index (self->stream_positions, guint64, middle) < position)
+        {
+          low = middle + 1;
+        }
+      else
+        {
+          high = middle;
+        }
+    }
+
+  index_stream (self, stream);
+  g_signal_connect (stream, "notify", G_CALLBACK (stream_notify_cb), self);
+  g_ptr_array_insert (self->streams, low, stream);
+  g_array_insert_val (self->stream_positions, low, position);
+  self->streams_serial++;
+}
+
+
+/*
+ * Appends @stream to the parsed streams of @self, taking ownership of it.
+ */
+static void
+append_stream (ModulemdModule *self, ModulemdModuleStream *stream)
+{
+  insert_stream (self, stream, self->next_position++);
+}
+
+
+/*
+ * Removes and releases the parsed stream at @index.
+ */
+static void
+remove_stream_index (ModulemdModule *self, guint index)
+{
+  ModulemdModuleStream *stream = g_ptr_array_index (self->streams, index);
+
+  g_signal_handlers_disconnect_by_data (stream, self);
+  unindex_stream (self, stream);
+  g_ptr_array_remove_index (self->streams, index);
+  g_array_remove_index (self->stream_positions, index);
+  self->streams_serial++;
+}
+
+
+/*
+ * Releases all of the parsed streams.
+ */
+static void
+clear_streams (ModulemdModule *self)
+{
+  for (guint i = 0; i < self->streams->len; i++)
+    {
+      g_signal_handlers_disconnect_by_data (
+        g_ptr_array_index (self->streams, i), self);
+    }
+
+  g_hash_table_remove_all (self->streams_by_nsvca);
+  g_hash_table_remove_all (self->streams_by_name);
+  g_hash_table_remove_all (self->streams_by_context);
+  g_hash_table_remove_all (self->streams_by_arch);
+  g_hash_table_remove_all (self->stream_keys);
+  g_ptr_array_set_size (self->streams, 0);
+  g_array_set_size (self->stream_positions, 0);
+  self->streams_serial++;
+}
+
+
+/*
+ * Looks up the parsed stream with exactly this NSVCA, none of which may be
+ * NULL or zero.
+ */
+static ModulemdModuleStream *
+lookup_stream (ModulemdModule *self,
+               const gchar *stream_name,
+               const guint64 version,
+               const gchar *context,
+               const gchar *arch)
+{
+  modulemd_nsvca nsvca = { stream_name, version, context, arch };
+
+  return g_hash_table_lookup (self->streams_by_nsvca, &nsvca);
+}
+
+
+/*
+ * Returns the parsed streams of @self that match, in no particular order.
+ * As for modulemd_module_search_streams(), a zero @version or NULL @context
+ * or @arch matches any value.
+ */
+static GPtrArray *
+search_parsed_streams (ModulemdModule *self,
+                       const gchar *stream_name,
+                       const guint64 version,
+                       const gchar *context,
+                       const gchar *arch)
+{
+  gsize i = 0;
+  g_autoptr (GPtrArray) matching_streams = NULL;
+  GPtrArray *candidates = self->streams;
+  ModulemdModuleStream *under_consideration = NULL;
+  gpointer interned = NULL;
+
+  if (stream_name && version && context && arch)
+    {
+      /* Only one stream can match all of them */
+      matching_streams = g_ptr_array_sized_new (1);
+      under_consideration =
+        lookup_stream (self, stream_name, version, context, arch);
+      if (under_consideration != NULL)
+        {
+          g_ptr_array_add (matching_streams, under_consideration);
+        }
+      return g_steal_pointer (&matching_streams);
+    }
+
+  if (stream_name)
+    {
+      /* Only the streams with this name can match */
+      if (!g_hash_table_lookup_extended (self->streams_by_name,
+                                         stream_name,
+                                         &interned,
+                                         (gpointer *)&candidates))
+        {
+          return g_ptr_array_new ();
+        }
+      stream_name = interned;
+    }
+
+  /* Compare against the copies interned in the lookup tables, which the
+   * streams filed under them usually share, so that most of the comparisons
+   * below are by pointer. A context or arch that no stream has cannot match.
+   */
+  if (context)
+    {
+      if (!g_hash_table_lookup_extended (
+            self->streams_by_context, context, &interned, NULL))
+        {
+          return g_ptr_array_new ();
+        }
+      context = interned;
+    }
+
+  if (arch)
+    {
+      if (!g_hash_table_lookup_extended (
+            self->streams_by_arch, arch, &interned, NULL))
+        {
+          return g_ptr_array_new ();
+        }
+      arch = interned;
+    }
+
+  /* Assume the worst-case scenario that all candidates match to spare us
+   * extra mallocs.
+   */
+  matching_streams = g_ptr_array_sized_new (candidates->len);
+
+  for (i = 0; i < candidates->len; i++)
+    {
+      under_consideration =
+        (ModulemdModuleStream *)g_ptr_array_index (candidates, i);
+
+      /* Skip this one unless the stream name matches */
+      if (!modulemd_interned_str_equal (
+            modulemd_module_stream_get_stream_name (under_consideration),
+            stream_name))
+        {
+          continue;
+        }
+
+      /* Skip this one unless the stream version matches OR the version is zero
+       * which indicates that it shouldn't prevent the other cases from
+       * matching.
+       */
+      if (version &&
+          modulemd_module_stream_get_version (under_consideration) != version)
+        {
+          continue;
+        }
+
+      if (context &&
+          !modulemd_interned_str_equal (
+            modulemd_module_stream_get_context (under_consideration), context))
+        {
+          continue;
+        }
+
+      if (arch &&
+          !modulemd_interned_str_equal (
+            modulemd_module_stream_get_arch (under_consideration), arch))
+        {
+          continue;
+        }
+
+      g_ptr_array_add (matching_streams, under_consideration);
+    }
+
+  return g_steal_pointer (&matching_streams);
+}
+
+
 ModulemdModule *
 modulemd_module_new (const gchar *module_name)
 {
@@ -55,6 +459,10 @@ modulemd_module_new (const gchar *module_name)
 }
 
 
+static void
+materialize_all_lazy_streams (ModulemdModule *self);
+
+
 ModulemdModule *
 modulemd_module_copy (ModulemdModule *self)
 {
@@ -65,9 +473,11 @@ modulemd_module_copy (ModulemdModule *self)
   m = modulemd_module_new (modulemd_module_get_module_name (self));
   m->defaults = modulemd_defaults_copy (self->defaults);
 
+  materialize_all_lazy_streams (self);
+
   for (i = 0; i < self->streams->len; i++)
     {
-      g_ptr_array_add (m->streams, g_ptr_array_index (self->streams, i));
+      append_stream (m, g_object_ref (g_ptr_array_index (self->streams, i)));
     }
 
   return g_steal_pointer (&m);
@@ -89,8 +499,20 @@ modulemd_module_finalize (GObject *object)
 
   g_clear_pointer (&self->module_name, g_free);
   g_clear_object (&self->defaults);
+  clear_streams (self);
+  g_clear_pointer (&self->streams_by_nsvca, g_hash_table_unref);
+  g_clear_pointer (&self->streams_by_name, g_hash_table_unref);
+  g_clear_pointer (&self->streams_by_context, g_hash_table_unref);
+  g_clear_pointer (&self->streams_by_arch, g_hash_table_unref);
+  g_clear_pointer (&self->stream_keys, g_hash_table_unref);
   g_clear_pointer (&self->streams, g_ptr_array_unref);
+  g_clear_pointer (&self->stream_positions, g_array_unref);
+  g_clear_pointer (&self->lazy_by_nsvca, g_hash_table_unref);
+  g_clear_pointer (&self->lazy_by_name, g_hash_table_unref);
+  g_clear_pointer (&self->lazy_streams, g_ptr_array_unref);
+  g_clear_pointer (&self->lazy_failures, g_ptr_array_unref);
   g_clear_pointer (&self->translations, g_hash_table_unref);
+  g_clear_pointer (&self->strings, modulemd_string_pool_unref);
 
   G_OBJECT_CLASS (modulemd_module_parent_class)->finalize (object);
 }
@@ -119,6 +541,428 @@ modulemd_module_get_module_name (ModulemdModule *self)
 }
 
 
+void
+modulemd_lazy_stream_free (modulemd_lazy_stream *lazy)
+{
+  if (!lazy->pooled)
+    {
+      g_clear_pointer (&lazy->module_name, g_free);
+      g_clear_pointer (&lazy->stream_name, g_free);
+      g_clear_pointer (&lazy->context, g_free);
+      g_clear_pointer (&lazy->arch, g_free);
+    }
+  g_clear_object (&lazy->subdoc);
+  g_free (lazy);
+}
+
+
+/*
+ * Gives @lazy its own copies of the strings it borrows from a pool, if any.
+ */
+static void
+lazy_stream_copy_strings (modulemd_lazy_stream *lazy)
+{
+  if (!lazy->pooled)
+    {
+      return;
+    }
+
+  lazy->module_name = g_strdup (lazy->module_name);
+  lazy->stream_name = g_strdup (lazy->stream_name);
+  lazy->context = g_strdup (lazy->context);
+  lazy->arch = g_strdup (lazy->arch);
+  lazy->pooled = FALSE;
+}
+
+
+/*
+ * Reads a string from the header of @lazy into @field, allocating it in the
+ * current pool if @lazy uses one.
+ */
+static gboolean
+parse_lazy_stream_string (yaml_parser_t *parser,
+                          modulemd_lazy_stream *lazy,
+                          gchar **field,
+                          GError **error)
+{
+  MMD_INIT_YAML_EVENT (event);
+  const gchar *value = NULL;
+
+  YAML_PARSER_PARSE_WITH_EXIT_BOOL (parser, &event, error);
+  if (event.type != YAML_SCALAR_EVENT)
+    {
+      MMD_YAML_ERROR_EVENT_EXIT_BOOL (error, event, "String was not a scalar");
+    }
+
+  value = (const gchar *)event.data.scalar.value;
+  if (lazy->pooled)
+    {
+      *field = modulemd_string_pool_insert (
+        modulemd_string_pool_get_current (), value);
+    }
+  else
+    {
+      g_free (*field);
+      *field = g_strdup (value);
+    }
+
+  return TRUE;
+}
+
+
+modulemd_lazy_stream *
+modulemd_lazy_stream_parse_yaml_header (yaml_parser_t *parser, GError **error)
+{
+  MMD_INIT_YAML_EVENT (event);
+  gboolean done = FALSE;
+  const gchar *key = NULL;
+  g_autoptr (GError) nested_error = NULL;
+  g_autoptr (modulemd_lazy_stream) lazy = g_new0 (modulemd_lazy_stream, 1);
+
+  /* The strings of lazy streams read into an index are only needed for as
+   * long as the index holds them, so they go in its arena.
+   */
+  lazy->pooled = modulemd_string_pool_get_current () != NULL;
+
+  YAML_PARSER_PARSE_WITH_EXIT (parser, &event, error);
+  if (event.type != YAML_MAPPING_START_EVENT)
+    {
+      MMD_YAML_ERROR_EVENT_EXIT (
+        error, event, "Data section did not begin with a map.");
+    }
+  yaml_event_delete (&event);
+
+  while (!done)
+    {
+      YAML_PARSER_PARSE_WITH_EXIT (parser, &event, error);
+
+      switch (event.type)
+        {
+        case YAML_MAPPING_END_EVENT: done = TRUE; break;
+
+        case YAML_SCALAR_EVENT:
+          key = (const gchar *)event.data.scalar.value;
+
+          if (g_str_equal (key, "name"))
+            {
+              parse_lazy_stream_string (
+                parser, lazy, &lazy->module_name, &nested_error);
+            }
+          else if (g_str_equal (key, "stream"))
+            {
+              parse_lazy_stream_string (
+                parser, lazy, &lazy->stream_name, &nested_error);
+            }
+          else if (g_str_equal (key, "version"))
+            {
+              lazy->version =
+                modulemd_yaml_parse_uint64 (parser, &nested_error);
+            }
+          else if (g_str_equal (key, "context"))
+            {
+              parse_lazy_stream_string (
+                parser, lazy, &lazy->context, &nested_error);
+            }
+          else if (g_str_equal (key, "arch"))
+            {
+              parse_lazy_stream_string (
+                parser, lazy, &lazy->arch, &nested_error);
+            }
+          else
+            {
+              /* Everything else is read when the stream is parsed */
+              skip_unknown_yaml (parser, &nested_error);
+            }
+
+          if (nested_error)
+            {
+              g_propagate_error (error, g_steal_pointer (&nested_error));
+              return NULL;
+            }
+          break;
+
+        default:
+          MMD_YAML_ERROR_EVENT_EXIT (
+            error, event, "Unexpected YAML event in ModuleStream");
+          break;
+        }
+
+      yaml_event_delete (&event);
+    }
+
+  return g_steal_pointer (&lazy);
+}
+
+
+ModulemdModuleStream *
+modulemd_lazy_stream_parse (modulemd_lazy_stream *lazy, GError **error)
+{
+  g_autoptr (ModulemdModuleStream) stream = NULL;
+
+  switch (modulemd_subdocument_info_get_mdversion (lazy->subdoc))
+    {
+    case MD_MODULESTREAM_VERSION_ONE:
+      stream = (ModulemdModuleStream *)modulemd_module_stream_v1_parse_yaml (
+        lazy->subdoc, lazy->strict, error);
+      break;
+
+    case MD_MODULESTREAM_VERSION_TWO:
+      stream = (ModulemdModuleStream *)modulemd_module_stream_v2_parse_yaml (
+        lazy->subdoc, lazy->strict, error);
+      break;
+
+    default:
+      g_set_error (error,
+                   MODULEMD_YAML_ERROR,
+                   MODULEMD_YAML_ERROR_PARSE,
+                   "Invalid mdversion for a stream object");
+      return NULL;
+    }
+
+  if (stream == NULL ||
+      (!lazy->validated && !modulemd_module_stream_validate (stream, error)))
+    {
+      return NULL;
+    }
+
+  return g_steal_pointer (&stream);
+}
+
+
+static gboolean
+lazy_stream_has_nsvca (modulemd_lazy_stream *lazy)
+{
+  return lazy->stream_name && lazy->version && lazy->context && lazy->arch;
+}
+
+
+/*
+ * Files @lazy in the lookup tables of @self. Unlike parsed streams, lazy
+ * streams cannot be renamed, so they stay under the same NSVCA.
+ */
+static void
+index_lazy_stream (ModulemdModule *self, modulemd_lazy_stream *lazy)
+{
+  modulemd_nsvca *key = NULL;
+
+  if (lazy_stream_has_nsvca (lazy))
+    {
+      key = g_new0 (modulemd_nsvca, 1);
+      key->stream_name = lazy->stream_name;
+      key->version = lazy->version;
+      key->context = lazy->context;
+      key->arch = lazy->arch;
+      g_hash_table_replace (self->lazy_by_nsvca, key, lazy);
+    }
+  modulemd_multimap_add (self->lazy_by_name, lazy->stream_name, lazy);
+}
+
+
+/*
+ * Removes @lazy from the lazy streams of @self and frees it.
+ */
+static void
+remove_lazy_stream (ModulemdModule *self, modulemd_lazy_stream *lazy)
+{
+  modulemd_nsvca nsvca = {
+    lazy->stream_name, lazy->version, lazy->context, lazy->arch
+  };
+  guint index = lazy->index;
+
+  if (lazy_stream_has_nsvca (lazy) &&
+      g_hash_table_lookup (self->lazy_by_nsvca, &nsvca) == lazy)
+    {
+      g_hash_table_remove (self->lazy_by_nsvca, &nsvca);
+    }
+  modulemd_multimap_remove (self->lazy_by_name, lazy->stream_name, lazy);
+
+  /* The last lazy stream takes its place */
+  g_ptr_array_remove_index_fast (self->lazy_streams, index);
+  if (index < self->lazy_streams->len)
+    {
+      ((modulemd_lazy_stream *)g_ptr_array_index (self->lazy_streams, index))
+        ->index = index;
+    }
+}
+
+
+static gint
+compare_lazy_stream_positions (gconstpointer a, gconstpointer b)
+{
+  const modulemd_lazy_stream *a_ = *(const modulemd_lazy_stream **)a;
+  const modulemd_lazy_stream *b_ = *(const modulemd_lazy_stream **)b;
+
+  if (a_->position == b_->position)
+    {
+      return 0;
+    }
+
+  return a_->position < b_->position ? -1 : 1;
+}
+
+
+/*
+ * Parses @lazy and adds it to the parsed streams where it was added to @self.
+ * A stream that cannot be parsed or upgraded is dropped, since the accessors
+ * that got here have no way to report it. Its subdocument is kept in
+ * @lazy_failures for modulemd_module_load_lazy_streams() instead.
+ */
+static void
+load_lazy_stream (ModulemdModule *self, modulemd_lazy_stream *lazy)
+{
+  g_autoptr (ModulemdModuleStream) stream = NULL;
+  g_autoptr (ModulemdModuleStream) upgraded = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdTranslation *translation = NULL;
+  MMD_INIT_STRING_POOL_SCOPE (scope, self->strings);
+
+  stream = modulemd_lazy_stream_parse (lazy, &error);
+  if (stream != NULL &&
+      modulemd_module_stream_get_mdversion (stream) < self->lazy_mdversion)
+    {
+      upgraded = modulemd_module_stream_upgrade (
+        stream, self->lazy_mdversion, &error);
+      g_clear_object (&stream);
+      stream = g_steal_pointer (&upgraded);
+    }
+
+  if (stream == NULL)
+    {
+      g_info ("Dropping stream %s of module %s: %s",
+              lazy->stream_name,
+              self->module_name,
+              error->message);
+      modulemd_subdocument_info_set_gerror (lazy->subdoc, error);
+      g_ptr_array_add (self->lazy_failures, g_object_ref (lazy->subdoc));
+      return;
+    }
+
+  translation = g_hash_table_lookup (self->translations, lazy->stream_name);
+  if (translation != NULL)
+    {
+      modulemd_module_stream_associate_translation (stream, translation);
+    }
+
+  insert_stream (self, g_steal_pointer (&stream), lazy->position);
+}
+
+
+/*
+ * Parses each of @lazies, which are removed from the lazy streams of @self.
+ * They are parsed in the order in which they were added, so that failures
+ * are reported in that order too.
+ */
+static void
+materialize_lazy_streams (ModulemdModule *self, GPtrArray *lazies)
+{
+  modulemd_lazy_stream *lazy = NULL;
+
+  g_ptr_array_sort (lazies, compare_lazy_stream_positions);
+
+  for (guint i = 0; i < lazies->len; i++)
+    {
+      lazy = g_ptr_array_index (lazies, i);
+      load_lazy_stream (self, lazy);
+      remove_lazy_stream (self, lazy);
+    }
+}
+
+
+static void
+materialize_all_lazy_streams (ModulemdModule *self)
+{
+  if (self->lazy_streams->len == 0)
+    {
+      return;
+    }
+
+  g_ptr_array_sort (self->lazy_streams, compare_lazy_stream_positions);
+
+  for (guint i = 0; i < self->lazy_streams->len; i++)
+    {
+      load_lazy_stream (self, g_ptr_array_index (self->lazy_streams, i));
+    }
+
+  g_hash_table_remove_all (self->lazy_by_nsvca);
+  g_hash_table_remove_all (self->lazy_by_name);
+  g_ptr_array_set_size (self->lazy_streams, 0);
+}
+
+
+static gboolean
+lazy_stream_matches (modulemd_lazy_stream *lazy,
+                     const gchar *stream_name,
+                     const guint64 version,
+                     const gchar *context,
+                     const gchar *arch)
+{
+  return modulemd_interned_str_equal (lazy->stream_name, stream_name) &&
+         (!version || lazy->version == version) &&
+         (!context || modulemd_interned_str_equal (lazy->context, context)) &&
+         (!arch || modulemd_interned_str_equal (lazy->arch, arch));
+}
+
+
+/*
+ * Returns the lazy streams of @self that match, like search_parsed_streams()
+ * does for the parsed ones.
+ */
+static GPtrArray *
+search_lazy_streams (ModulemdModule *self,
+                     const gchar *stream_name,
+                     const guint64 version,
+                     const gchar *context,
+                     const gchar *arch)
+{
+  g_autoptr (GPtrArray) matching_streams = g_ptr_array_new ();
+  modulemd_nsvca nsvca = { stream_name, version, context, arch };
+  modulemd_lazy_stream *lazy = NULL;
+  GPtrArray *candidates = NULL;
+
+  if (stream_name && version && context && arch)
+    {
+      lazy = g_hash_table_lookup (self->lazy_by_nsvca, &nsvca);
+      if (lazy != NULL)
+        {
+          g_ptr_array_add (matching_streams, lazy);
+        }
+      return g_steal_pointer (&matching_streams);
+    }
+
+  /* Every lazy stream has a name, so no other one can match */
+  candidates = modulemd_multimap_lookup (self->lazy_by_name, stream_name);
+  if (candidates == NULL)
+    {
+      return g_steal_pointer (&matching_streams);
+    }
+
+  for (guint i = 0; i < candidates->len; i++)
+    {
+      lazy = g_ptr_array_index (candidates, i);
+      if (lazy_stream_matches (lazy, stream_name, version, context, arch))
+        {
+          g_ptr_array_add (matching_streams, lazy);
+        }
+    }
+
+  return g_steal_pointer (&matching_streams);
+}
+
+
+static void
+materialize_matching_lazy_streams (ModulemdModule *self,
+                                   const gchar *stream_name,
+                                   const guint64 version,
+                                   const gchar *context,
+                                   const gchar *arch)
+{
+  g_autoptr (GPtrArray) lazies = NULL;
+
+  lazies = search_lazy_streams (self, stream_name, version, context, arch);
+  materialize_lazy_streams (self, lazies);
+}
+
+
 static void
 modulemd_module_get_property (GObject *object,
                               guint prop_id,
@@ -179,6 +1023,20 @@ static void
 modulemd_module_init (ModulemdModule *self)
 {
   self->streams = g_ptr_array_new_full (0, g_object_unref);
+  self->stream_positions = g_array_new (FALSE, FALSE, sizeof (guint64));
+  self->stream_keys = g_hash_table_new_full (
+    g_direct_hash, g_direct_equal, NULL, modulemd_nsvca_key_free);
+  self->streams_by_nsvca =
+    g_hash_table_new (modulemd_nsvca_hash, modulemd_nsvca_equal);
+  self->streams_by_name = modulemd_multimap_new ();
+  self->streams_by_context = modulemd_multimap_new ();
+  self->streams_by_arch = modulemd_multimap_new ();
+  self->lazy_streams =
+    g_ptr_array_new_with_free_func ((GDestroyNotify)modulemd_lazy_stream_free);
+  self->lazy_by_nsvca = g_hash_table_new_full (
+    modulemd_nsvca_hash, modulemd_nsvca_equal, modulemd_nsvca_free, NULL);
+  self->lazy_by_name = modulemd_multimap_new ();
+  self->lazy_failures = g_ptr_array_new_with_free_func (g_object_unref);
   self->translations =
     g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
 }
@@ -252,6 +1110,15 @@ modulemd_module_set_defaults (ModulemdModule *self,
 }
 
 
+guint64
+modulemd_module_get_streams_serial (ModulemdModule *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULE (self), 0);
+
+  return self->streams_serial;
+}
+
+
 ModulemdDefaults *
 modulemd_module_get_defaults (ModulemdModule *self)
 {
@@ -261,11 +1128,16 @@ modulemd_module_get_defaults (ModulemdModule *self)
 }
 
 
-ModulemdModuleStreamVersionEnum
-modulemd_module_add_stream (ModulemdModule *self,
-                            ModulemdModuleStream *stream,
-                            ModulemdModuleStreamVersionEnum index_mdversion,
-                            GError **error)
+/*
+ * When @adopt is TRUE, @stream itself is stored in @self with an added
+ * reference instead of a copy of it, unless it needs to be upgraded.
+ */
+static ModulemdModuleStreamVersionEnum
+add_stream (ModulemdModule *self,
+            ModulemdModuleStream *stream,
+            ModulemdModuleStreamVersionEnum index_mdversion,
+            gboolean adopt,
+            GError **error)
 {
   ModulemdModuleStream *old = NULL;
   ModulemdTranslation *translation = NULL;
@@ -273,6 +1145,7 @@ modulemd_module_add_stream (ModulemdModule *self,
   g_autoptr (GError) nested_error = NULL;
   const gchar *module_name = NULL;
   const gchar *stream_name = NULL;
+  guint index;
 
   g_return_val_if_fail (MODULEMD_IS_MODULE (self),
                         MD_MODULESTREAM_VERSION_ERROR);
@@ -326,7 +1199,14 @@ modulemd_module_add_stream (ModulemdModule *self,
     modulemd_module_stream_get_arch (stream),
     &nested_error);
 
-  if (old != NULL)
+  if (old == stream)
+    {
+      /* This exact object is already part of the module, and removing it
+       * first could drop the last reference to it.
+       */
+      return modulemd_module_stream_get_mdversion (stream);
+    }
+  else if (old != NULL)
     {
       /* We're probably deduplicating content here, so remove the old one in
        * favor of the new one.
@@ -345,7 +1225,8 @@ modulemd_module_add_stream (ModulemdModule *self,
         }
 
       /* First, drop the existing stream */
-      g_ptr_array_remove (self->streams, old);
+      g_ptr_array_find (self->streams, old, &index);
+      remove_stream_index (self, index);
       old = NULL;
     }
   else if (old == NULL && g_error_matches (nested_error,
@@ -374,12 +1255,16 @@ modulemd_module_add_stream (ModulemdModule *self,
           return MD_MODULESTREAM_VERSION_ERROR;
         }
     }
+  else if (adopt)
+    {
+      newstream = g_object_ref (stream);
+    }
   else
     {
       newstream = modulemd_module_stream_copy (stream, NULL, NULL);
     }
 
-  g_ptr_array_add (self->streams, newstream);
+  append_stream (self, newstream);
 
   translation = g_hash_table_lookup (
     self->translations, modulemd_module_stream_get_stream_name (stream));
@@ -392,6 +1277,170 @@ modulemd_module_add_stream (ModulemdModule *self,
 }
 
 
+ModulemdModuleStreamVersionEnum
+modulemd_module_add_stream (ModulemdModule *self,
+                            ModulemdModuleStream *stream,
+                            ModulemdModuleStreamVersionEnum index_mdversion,
+                            GError **error)
+{
+  return add_stream (self, stream, index_mdversion, FALSE, error);
+}
+
+
+ModulemdModuleStreamVersionEnum
+modulemd_module_adopt_stream (ModulemdModule *self,
+                              ModulemdModuleStream *stream,
+                              ModulemdModuleStreamVersionEnum index_mdversion,
+                              GError **error)
+{
+  return add_stream (self, stream, index_mdversion, TRUE, error);
+}
+
+
+/*
+ * Whether modulemd_module_add_stream() would find an existing stream matching
+ * the NSVCA of @lazy, checked without parsing any lazy streams.
+ */
+static gboolean
+has_stream_matching (ModulemdModule *self, modulemd_lazy_stream *lazy)
+{
+  g_autoptr (GPtrArray) matching_streams = NULL;
+
+  matching_streams = search_parsed_streams (
+    self, lazy->stream_name, lazy->version, lazy->context, lazy->arch);
+  if (matching_streams->len > 0)
+    {
+      return TRUE;
+    }
+  g_clear_pointer (&matching_streams, g_ptr_array_unref);
+
+  matching_streams = search_lazy_streams (
+    self, lazy->stream_name, lazy->version, lazy->context, lazy->arch);
+
+  return matching_streams->len > 0;
+}
+
+
+ModulemdModuleStreamVersionEnum
+modulemd_module_add_lazy_stream (
+  ModulemdModule *self,
+  modulemd_lazy_stream *lazy,
+  ModulemdModuleStreamVersionEnum index_mdversion,
+  GError **error)
+{
+  g_autoptr (modulemd_lazy_stream) owned = lazy;
+  g_autoptr (ModulemdModuleStream) stream = NULL;
+  ModulemdModuleStreamVersionEnum mdversion;
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE (self),
+                        MD_MODULESTREAM_VERSION_ERROR);
+  g_return_val_if_fail (lazy->subdoc, MD_MODULESTREAM_VERSION_ERROR);
+
+  if (g_strcmp0 (lazy->module_name, modulemd_module_get_module_name (self)) !=
+      0)
+    {
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_VALIDATE,
+                   "Attempted to add stream for module '%s' to module '%s'",
+                   lazy->module_name,
+                   modulemd_module_get_module_name (self));
+      return MD_MODULESTREAM_VERSION_ERROR;
+    }
+
+  if (has_stream_matching (self, lazy))
+    {
+      /* Deduplication needs the full content of both streams */
+      stream = modulemd_lazy_stream_parse (lazy, error);
+      if (stream == NULL)
+        {
+          return MD_MODULESTREAM_VERSION_ERROR;
+        }
+
+      return modulemd_module_adopt_stream (
+        self, stream, index_mdversion, error);
+    }
+
+  mdversion = modulemd_subdocument_info_get_mdversion (lazy->subdoc);
+  self->lazy_mdversion = MAX (self->lazy_mdversion, index_mdversion);
+  lazy->position = self->next_position++;
+  lazy->index = self->lazy_streams->len;
+  index_lazy_stream (self, lazy);
+  g_ptr_array_add (self->lazy_streams, g_steal_pointer (&owned));
+  self->streams_serial++;
+
+  return MAX (mdversion, index_mdversion);
+}
+
+
+gboolean
+modulemd_module_load_lazy_streams (ModulemdModule *self, GPtrArray *failures)
+{
+  g_return_val_if_fail (MODULEMD_IS_MODULE (self), FALSE);
+
+  materialize_all_lazy_streams (self);
+
+  for (guint i = 0; i < self->lazy_failures->len; i++)
+    {
+      g_ptr_array_add (
+        failures, g_object_ref (g_ptr_array_index (self->lazy_failures, i)));
+    }
+
+  return self->lazy_failures->len == 0;
+}
+
+
+gboolean
+modulemd_module_foreach_stream (ModulemdModule *self,
+                                ModulemdModuleStreamVisitor visitor,
+                                gpointer user_data,
+                                GError **error)
+{
+  g_autoptr (GPtrArray) lazies = NULL;
+  modulemd_lazy_stream *lazy = NULL;
+  guint i = 0;
+  guint j = 0;
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE (self), FALSE);
+
+  lazies = g_ptr_array_sized_new (self->lazy_streams->len);
+  for (i = 0; i < self->lazy_streams->len; i++)
+    {
+      g_ptr_array_add (lazies, g_ptr_array_index (self->lazy_streams, i));
+    }
+  g_ptr_array_sort (lazies, compare_lazy_stream_positions);
+
+  /* The parsed streams are in order already, so merge the two */
+  i = 0;
+  while (i < self->streams->len || j < lazies->len)
+    {
+      lazy = j < lazies->len ? g_ptr_array_index (lazies, j) : NULL;
+      if (i < self->streams->len &&
+          (lazy == NULL ||
+           g_array_index (self->stream_positions, guint64, i) <
+             lazy->position))
+        {
+          if (!visitor (
+                g_ptr_array_index (self->streams, i), NULL, user_data, error))
+            {
+              return FALSE;
+            }
+          i++;
+        }
+      else
+        {
+          if (!visitor (NULL, lazy, user_data, error))
+            {
+              return FALSE;
+            }
+          j++;
+        }
+    }
+
+  return TRUE;
+}
+
+
 GStrv
 modulemd_module_get_stream_names_as_strv (ModulemdModule *self)
 {
@@ -412,6 +1461,15 @@ modulemd_module_get_stream_names_as_strv (ModulemdModule *self)
                           g_ptr_array_index (self->streams, i)));
     }
 
+  /* Unparsed streams know their names already */
+  for (guint i = 0; i < self->lazy_streams->len; i++)
+    {
+      g_hash_table_add (
+        stream_names,
+        ((modulemd_lazy_stream *)g_ptr_array_index (self->lazy_streams, i))
+          ->stream_name);
+    }
+
   return modulemd_ordered_str_keys_as_strv (stream_names);
 }
 
@@ -421,12 +1479,14 @@ modulemd_module_get_all_streams (ModulemdModule *self)
 {
   g_return_val_if_fail (MODULEMD_IS_MODULE (self), NULL);
 
+  materialize_all_lazy_streams (self);
+
   return self->streams;
 }
 
 
-static gint
-compare_streams (gconstpointer a, gconstpointer b)
+gint
+modulemd_module_compare_streams (gconstpointer a, gconstpointer b)
 {
   int cmp = 0;
   guint64 a_ver;
@@ -498,59 +1558,21 @@ modulemd_module_search_streams (ModulemdModule *self,
                                 const gchar *context,
                                 const gchar *arch)
 {
-  gsize i = 0;
   g_autoptr (GPtrArray) matching_streams = NULL;
-  ModulemdModuleStream *under_consideration = NULL;
 
   g_return_val_if_fail (MODULEMD_IS_MODULE (self), NULL);
 
-  /* Assume the worst-case scenario that all streams match to spare us extra
-   * mallocs.
-   */
-  matching_streams = g_ptr_array_sized_new (self->streams->len);
+  /* Only the streams that can match need to be parsed */
+  materialize_matching_lazy_streams (
+    self, stream_name, version, context, arch);
 
-  for (i = 0; i < self->streams->len; i++)
+  matching_streams =
+    search_parsed_streams (self, stream_name, version, context, arch);
+  if (matching_streams->len > 1)
     {
-      under_consideration =
-        (ModulemdModuleStream *)g_ptr_array_index (self->streams, i);
-
-      /* Skip this one unless the stream name matches */
-      if (g_strcmp0 (
-            modulemd_module_stream_get_stream_name (under_consideration),
-            stream_name) != 0)
-        {
-          continue;
-        }
-
-      /* Skip this one unless the stream version matches OR the version is zero
-       * which indicates that it shouldn't prevent the other cases from
-       * matching.
-       */
-      if (version &&
-          modulemd_module_stream_get_version (under_consideration) != version)
-        {
-          continue;
-        }
-
-      if (context &&
-          g_strcmp0 (modulemd_module_stream_get_context (under_consideration),
-                     context) != 0)
-        {
-          continue;
-        }
-
-      if (arch &&
-          g_strcmp0 (modulemd_module_stream_get_arch (under_consideration),
-                     arch) != 0)
-        {
-          continue;
-        }
-
-      g_ptr_array_add (matching_streams, under_consideration);
+      g_ptr_array_sort (matching_streams, modulemd_module_compare_streams);
     }
 
-  g_ptr_array_sort (matching_streams, compare_streams);
-
   return g_steal_pointer (&matching_streams);
 }
 
@@ -592,26 +1614,150 @@ modulemd_module_get_stream_by_NSVCA (ModulemdModule *self,
 }
 
 
-typedef struct _modulemd_nsvca
+static gboolean
+version_glob_matches (const gchar *pattern, guint64 version)
 {
-  const gchar *stream_name;
-  guint64 version;
-  const gchar *context;
-  const gchar *arch;
-} modulemd_nsvca;
+  gchar buf[24];
 
+  if (pattern == NULL)
+    {
+      return TRUE;
+    }
 
-static void
-modulemd_nsvca_free (gpointer nsvca)
+  g_snprintf (buf, sizeof (buf), "%" G_GUINT64_FORMAT, version);
+  return modulemd_glob_matches (pattern, buf);
+}
+
+
+static gboolean
+stream_matches_glob (ModulemdModuleStream *stream,
+                     const gchar *stream_name,
+                     const gchar *version,
+                     const gchar *context,
+                     const gchar *arch)
 {
-  /* All of the fields are just pointers to static data,
-   * so nothing to free here.
-   */
+  return modulemd_glob_matches (
+           stream_name, modulemd_module_stream_get_stream_name (stream)) &&
+         version_glob_matches (version,
+                               modulemd_module_stream_get_version (stream)) &&
+         modulemd_glob_matches (context,
+                                modulemd_module_stream_get_context (stream)) &&
+         modulemd_glob_matches (arch,
+                                modulemd_module_stream_get_arch (stream));
+}
 
-  g_free ((modulemd_nsvca *)nsvca);
+
+/*
+ * Narrows @candidates down to the streams filed under @value in @buckets if
+ * @value is given literally and that is fewer streams. Returns FALSE if no
+ * stream can match.
+ */
+static gboolean
+narrow_candidates (GHashTable *buckets,
+                   const gchar *value,
+                   GPtrArray **candidates)
+{
+  GPtrArray *bucket = NULL;
+
+  if (value == NULL || modulemd_is_glob (value))
+    {
+      return TRUE;
+    }
+
+  bucket = modulemd_multimap_lookup (buckets, value);
+  if (bucket == NULL)
+    {
+      return FALSE;
+    }
+
+  if (bucket->len < (*candidates)->len)
+    {
+      *candidates = bucket;
+    }
+
+  return TRUE;
 }
 
-G_DEFINE_AUTOPTR_CLEANUP_FUNC (modulemd_nsvca, modulemd_nsvca_free);
+
+GPtrArray *
+modulemd_module_search_streams_by_glob (ModulemdModule *self,
+                                        const gchar *stream_name,
+                                        const gchar *version,
+                                        const gchar *context,
+                                        const gchar *arch)
+{
+  g_autoptr (GPtrArray) matching_streams = NULL;
+  g_autoptr (GPtrArray) lazies = NULL;
+  GPtrArray *candidates = NULL;
+  ModulemdModuleStream *stream = NULL;
+  modulemd_lazy_stream *lazy = NULL;
+  guint64 exact_version = 0;
+  guint i = 0;
+
+  g_return_val_if_fail (MODULEMD_IS_MODULE (self), NULL);
+
+  /* Only the streams that can match need to be parsed */
+  candidates = self->lazy_streams;
+  if (stream_name && !modulemd_is_glob (stream_name))
+    {
+      candidates = modulemd_multimap_lookup (self->lazy_by_name, stream_name);
+    }
+
+  lazies = g_ptr_array_new ();
+  for (i = 0; candidates && i < candidates->len; i++)
+    {
+      lazy = g_ptr_array_index (candidates, i);
+      if (modulemd_glob_matches (stream_name, lazy->stream_name) &&
+          version_glob_matches (version, lazy->version) &&
+          modulemd_glob_matches (context, lazy->context) &&
+          modulemd_glob_matches (arch, lazy->arch))
+        {
+          g_ptr_array_add (lazies, lazy);
+        }
+    }
+  materialize_lazy_streams (self, lazies);
+
+  matching_streams = g_ptr_array_new ();
+
+  if (stream_name && !modulemd_is_glob (stream_name) && version &&
+      !modulemd_is_glob (version) && context && !modulemd_is_glob (context) &&
+      arch && !modulemd_is_glob (arch))
+    {
+      /* A fully-specified NSVCA matches at most one stream */
+      if (g_ascii_string_to_unsigned (
+            version, 10, 1, G_MAXUINT64, &exact_version, NULL))
+        {
+          stream =
+            lookup_stream (self, stream_name, exact_version, context, arch);
+          if (stream != NULL)
+            {
+              g_ptr_array_add (matching_streams, stream);
+            }
+        }
+      return g_steal_pointer (&matching_streams);
+    }
+
+  candidates = self->streams;
+  if (!narrow_candidates (self->streams_by_name, stream_name, &candidates) ||
+      !narrow_candidates (self->streams_by_context, context, &candidates) ||
+      !narrow_candidates (self->streams_by_arch, arch, &candidates))
+    {
+      return g_steal_pointer (&matching_streams);
+    }
+
+  for (i = 0; i < candidates->len; i++)
+    {
+      stream = g_ptr_array_index (candidates, i);
+      if (stream_matches_glob (stream, stream_name, version, context, arch))
+        {
+          g_ptr_array_add (matching_streams, stream);
+        }
+    }
+
+  g_ptr_array_sort (matching_streams, modulemd_module_compare_streams);
+
+  return g_steal_pointer (&matching_streams);
+}
 
 
 static gboolean
@@ -664,6 +1810,8 @@ modulemd_module_remove_streams_by_NSVCA (ModulemdModule *self,
 {
   gboolean found = FALSE;
   guint index;
+  ModulemdModuleStream *stream = NULL;
+  g_autoptr (GPtrArray) lazies = NULL;
   g_autoptr (modulemd_nsvca) nsvca = g_malloc0_n (1, sizeof (modulemd_nsvca));
 
   nsvca->stream_name = stream_name;
@@ -671,19 +1819,39 @@ modulemd_module_remove_streams_by_NSVCA (ModulemdModule *self,
   nsvca->context = context;
   nsvca->arch = arch;
 
-  /* Iterate through the streams and remove any that match the requested
-   * parameters
-   */
-  do
+  if (stream_name && version && context && arch)
+    {
+      /* At most one stream can match all of them */
+      stream = lookup_stream (self, stream_name, version, context, arch);
+      if (stream != NULL && g_ptr_array_find (self->streams, stream, &index))
+        {
+          remove_stream_index (self, index);
+        }
+    }
+  else
     {
-      found = g_ptr_array_find_with_equal_func (
-        self->streams, nsvca, match_nsvca, &index);
-      if (found)
+      /* Iterate through the streams and remove any that match the requested
+       * parameters
+       */
+      do
         {
-          g_ptr_array_remove_index (self->streams, index);
+          found = g_ptr_array_find_with_equal_func (
+            self->streams, nsvca, match_nsvca, &index);
+          if (found)
+            {
+              remove_stream_index (self, index);
+            }
         }
+      while (found);
+    }
+
+  /* Streams that were never parsed can be dropped without parsing them */
+  lazies = search_lazy_streams (self, stream_name, version, context, arch);
+  for (index = 0; index < lazies->len; index++)
+    {
+      remove_lazy_stream (self, g_ptr_array_index (lazies, index));
+      self->streams_serial++;
     }
-  while (found);
 }
 
 
@@ -741,6 +1909,7 @@ modulemd_module_upgrade_streams (ModulemdModule *self,
                                  GError **error)
 {
   g_autoptr (GPtrArray) new_streams = NULL;
+  g_autoptr (GArray) positions = NULL;
   ModulemdModuleStreamVersionEnum current_mdversion;
   g_autoptr (ModulemdModuleStream) modulestream = NULL;
   g_autoptr (ModulemdModuleStream) upgraded_stream = NULL;
@@ -792,9 +1961,59 @@ modulemd_module_upgrade_streams (ModulemdModule *self,
       g_clear_object (&modulestream);
     }
 
-  /* Replace the old stream list with the new one */
-  g_ptr_array_unref (self->streams);
-  self->streams = g_steal_pointer (&new_streams);
+  /* Replace the old stream list with the new one, keeping the order */
+  positions = g_array_sized_new (
+    FALSE, FALSE, sizeof (guint64), self->stream_positions->len);
+  g_array_append_vals (positions,
+                       self->stream_positions->data,
+                       self->stream_positions->len);
+  clear_streams (self);
+  for (guint i = 0; i < new_streams->len; i++)
+    {
+      insert_stream (self,
+                     g_object_ref (g_ptr_array_index (new_streams, i)),
+                     g_array_index (positions, guint64, i));
+    }
+
+  /* Unparsed streams are upgraded once they are parsed */
+  self->lazy_mdversion = mdversion;
 
   return TRUE;
 }
+
+
+void
+modulemd_module_set_string_pool (ModulemdModule *self,
+                                 modulemd_string_pool *pool)
+{
+  modulemd_lazy_stream *lazy = NULL;
+
+  g_return_if_fail (MODULEMD_IS_MODULE (self));
+
+  if (pool == self->strings)
+    {
+      return;
+    }
+
+  if (self->strings != NULL && self->lazy_streams->len > 0)
+    {
+      /* The NSVCA keys of the lazy streams point at their strings, so the
+       * streams are filed again once they have their own copies.
+       */
+      g_hash_table_remove_all (self->lazy_by_nsvca);
+      g_hash_table_remove_all (self->lazy_by_name);
+      for (guint i = 0; i < self->lazy_streams->len; i++)
+        {
+          lazy = g_ptr_array_index (self->lazy_streams, i);
+          lazy_stream_copy_strings (lazy);
+          index_lazy_stream (self, lazy);
+        }
+    }
+
+  if (pool != NULL)
+    {
+      modulemd_string_pool_ref (pool);
+    }
+  g_clear_pointer (&self->strings, modulemd_string_pool_unref);
+  self->strings = pool;
+}
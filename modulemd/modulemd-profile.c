@@ -192,7 +192,7 @@ void
 modulemd_profile_add_rpm (ModulemdProfile *self, const gchar *rpm)
 {
   g_return_if_fail (MODULEMD_IS_PROFILE (self));
-  g_hash_table_add (self->rpms, g_strdup (rpm));
+  modulemd_interned_set_add (self->rpms, rpm);
 }
 
 
@@ -290,7 +290,7 @@ modulemd_profile_class_init (ModulemdProfileClass *klass)
 static void
 modulemd_profile_init (ModulemdProfile *self)
 {
-  self->rpms = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  self->rpms = modulemd_interned_set_new ();
 }
 
 
@@ -307,6 +307,7 @@ modulemd_profile_parse_yaml (yaml_parser_t *parser,
   gboolean done = FALSE;
   gboolean in_map = FALSE;
   g_autofree gchar *value = NULL;
+  g_autoptr (GHashTable) rpms = NULL;
   g_autoptr (ModulemdProfile) p = NULL;
   g_autoptr (GError) nested_error = NULL;
 
@@ -336,9 +337,9 @@ modulemd_profile_parse_yaml (yaml_parser_t *parser,
             }
           if (g_str_equal (event.data.scalar.value, "rpms"))
             {
-              g_hash_table_unref (p->rpms);
-              p->rpms = modulemd_yaml_parse_string_set (parser, &nested_error);
-              if (p->rpms == NULL)
+              rpms = modulemd_yaml_parse_interned_string_set (parser,
+                                                              &nested_error);
+              if (rpms == NULL)
                 {
                   MMD_YAML_ERROR_EVENT_EXIT (
                     error,
@@ -346,6 +347,8 @@ modulemd_profile_parse_yaml (yaml_parser_t *parser,
                     "Failed to parse rpm list in profile: %s",
                     nested_error->message);
                 }
+
+              modulemd_interned_set_take (&p->rpms, g_steal_pointer (&rpms));
             }
           else if (g_str_equal (event.data.scalar.value, "description"))
             {
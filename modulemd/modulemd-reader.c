@@ -0,0 +1,385 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2020 Red Hat, Inc.
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#include <errno.h>
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <stdio.h>
+#include <string.h>
+#include <yaml.h>
+
+#ifdef HAVE_RPMIO
+#include <rpm/rpmio.h>
+#endif
+
+#include "modulemd-compression.h"
+#include "modulemd-errors.h"
+#include "modulemd-reader.h"
+#include "modulemd-subdocument-info.h"
+#include "private/modulemd-compression-private.h"
+#include "private/modulemd-module-index-private.h"
+#include "private/modulemd-util.h"
+#include "private/modulemd-yaml.h"
+
+
+struct _ModulemdReader
+{
+  GObject parent_instance;
+
+  yaml_parser_t parser;
+
+  /* Attached to @parser unless the input is not UTF-8 */
+  modulemd_yaml_capture capture;
+  gboolean use_capture;
+
+  gboolean strict;
+  gboolean started;
+  gboolean finished;
+
+  /* The input that @parser reads from */
+  gchar *string;
+  FILE *file;
+  GMappedFile *mapped;
+  modulemd_decompressor *decompressor;
+#ifdef HAVE_RPMIO
+  FD_t rpmio_fd;
+#endif
+};
+
+G_DEFINE_TYPE (ModulemdReader, modulemd_reader, G_TYPE_OBJECT)
+
+
+static void
+modulemd_reader_finalize (GObject *object)
+{
+  ModulemdReader *self = (ModulemdReader *)object;
+
+  yaml_parser_delete (&self->parser);
+  modulemd_yaml_capture_clear (&self->capture);
+
+  g_clear_pointer (&self->string, g_free);
+  g_clear_pointer (&self->mapped, g_mapped_file_unref);
+  g_clear_pointer (&self->decompressor, modulemd_decompressor_free);
+#ifdef HAVE_RPMIO
+  g_clear_pointer (&self->rpmio_fd, mmd_Fclose);
+#endif
+  g_clear_pointer (&self->file, fclose);
+
+  G_OBJECT_CLASS (modulemd_reader_parent_class)->finalize (object);
+}
+
+
+static void
+modulemd_reader_class_init (ModulemdReaderClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = modulemd_reader_finalize;
+}
+
+
+static void
+modulemd_reader_init (ModulemdReader *self)
+{
+  yaml_parser_initialize (&self->parser);
+  memset (&self->capture, 0, sizeof (modulemd_yaml_capture));
+  self->use_capture = TRUE;
+}
+
+
+ModulemdReader *
+modulemd_reader_new_for_string (const gchar *yaml_string, gboolean strict)
+{
+  g_autoptr (ModulemdReader) self = NULL;
+
+  g_return_val_if_fail (yaml_string, NULL);
+
+  self = g_object_new (MODULEMD_TYPE_READER, NULL);
+  self->strict = strict;
+  self->string = g_strdup (yaml_string);
+
+  modulemd_yaml_capture_set_input_string (
+    &self->capture, &self->parser, self->string, strlen (self->string));
+
+  return g_steal_pointer (&self);
+}
+
+
+/*
+ * Chooses how @self->parser reads the already opened @self->file, the same
+ * way as modulemd_module_index_update_from_file() does.
+ */
+static gboolean
+modulemd_reader_set_input_file (ModulemdReader *self,
+                                const gchar *yaml_file,
+                                GError **error)
+{
+  g_autoptr (GError) nested_error = NULL;
+  int fd = fileno (self->file);
+  ModulemdCompressionTypeEnum comtype;
+
+  comtype = modulemd_detect_compression (yaml_file, fd, &nested_error);
+  if (comtype == MODULEMD_COMPRESSION_TYPE_DETECTION_FAILED)
+    {
+      g_propagate_error (error, g_steal_pointer (&nested_error));
+      return FALSE;
+    }
+
+  if (comtype == MODULEMD_COMPRESSION_TYPE_NO_COMPRESSION ||
+      comtype == MODULEMD_COMPRESSION_TYPE_UNKNOWN_COMPRESSION)
+    {
+      self->mapped = modulemd_yaml_map_file (fd);
+      if (self->mapped == NULL)
+        {
+          modulemd_yaml_capture_set_input_file (
+            &self->capture, &self->parser, self->file);
+          return TRUE;
+        }
+
+      modulemd_yaml_capture_set_input_string (
+        &self->capture,
+        &self->parser,
+        g_mapped_file_get_contents (self->mapped),
+        g_mapped_file_get_length (self->mapped));
+      return TRUE;
+    }
+
+  self->decompressor = modulemd_decompressor_new (comtype, fd, &nested_error);
+  if (self->decompressor != NULL)
+    {
+      modulemd_yaml_capture_set_input (&self->capture,
+                                       &self->parser,
+                                       modulemd_decompressor_read_fn,
+                                       self->decompressor);
+      return TRUE;
+    }
+  if (!g_error_matches (
+        nested_error, MODULEMD_ERROR, MODULEMD_ERROR_NOT_IMPLEMENTED))
+    {
+      g_propagate_error (error, g_steal_pointer (&nested_error));
+      return FALSE;
+    }
+  g_clear_error (&nested_error);
+
+#ifdef HAVE_RPMIO
+  g_autofree gchar *fmode = NULL;
+  FD_t rpmio_fd = NULL;
+  int saved_errno;
+
+  fmode = modulemd_get_rpmio_fmode ("r", comtype);
+  if (!fmode)
+    {
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_ERROR_FILE_ACCESS,
+                   "Unable to construct rpmio fmode from comtype [%d]",
+                   comtype);
+      return FALSE;
+    }
+
+  self->rpmio_fd = fdDup (fd);
+  saved_errno = errno;
+  if (!self->rpmio_fd)
+    {
+      g_set_error (
+        error,
+        MODULEMD_ERROR,
+        MODULEMD_ERROR_NOT_IMPLEMENTED,
+        "Cannot open compressed file. Error in rpmio::fdDup(%d): %s",
+        fd,
+        strerror (saved_errno));
+      return FALSE;
+    }
+
+  rpmio_fd = Fdopen (self->rpmio_fd, fmode);
+  if (!rpmio_fd)
+    {
+      g_set_error_literal (
+        error,
+        MODULEMD_ERROR,
+        MODULEMD_ERROR_NOT_IMPLEMENTED,
+        "Cannot open compressed file. Error in rpmio::Fdopen().");
+      return FALSE;
+    }
+
+  modulemd_yaml_capture_set_input (
+    &self->capture, &self->parser, compressed_stream_read_fn, rpmio_fd);
+  return TRUE;
+
+#else /* HAVE_RPMIO */
+  g_set_error_literal (
+    error,
+    MODULEMD_ERROR,
+    MODULEMD_ERROR_NOT_IMPLEMENTED,
+    "Cannot open compressed file. libmodulemd was not compiled "
+    "with rpmio support.");
+  return FALSE;
+#endif /* HAVE_RPMIO */
+}
+
+
+ModulemdReader *
+modulemd_reader_new_for_file (const gchar *yaml_file,
+                              gboolean strict,
+                              GError **error)
+{
+  g_autoptr (ModulemdReader) self = NULL;
+  int saved_errno;
+
+  g_return_val_if_fail (yaml_file, NULL);
+
+  self = g_object_new (MODULEMD_TYPE_READER, NULL);
+  self->strict = strict;
+
+  self->file = g_fopen (yaml_file, "rbe");
+  saved_errno = errno;
+
+  if (self->file == NULL)
+    {
+      g_set_error (error,
+                   MODULEMD_ERROR,
+                   MODULEMD_YAML_ERROR_OPEN,
+                   "Failed to open file: %s",
+                   g_strerror (saved_errno));
+      return NULL;
+    }
+
+  if (!modulemd_reader_set_input_file (self, yaml_file, error))
+    {
+      return NULL;
+    }
+
+  return g_steal_pointer (&self);
+}
+
+
+/*
+ * Reads the next subdocument from @self->parser.
+ *
+ * Returns: (transfer full): The object that was read. NULL and sets @failure
+ * if the subdocument was invalid. NULL and sets @error if the YAML stream
+ * cannot be read any further. NULL without setting either at the end of the
+ * stream.
+ */
+static GObject *
+modulemd_reader_read (ModulemdReader *self,
+                      ModulemdSubdocumentInfo **failure,
+                      GError **error)
+{
+  MMD_INIT_YAML_EVENT (event);
+
+  if (!self->started)
+    {
+      YAML_PARSER_PARSE_WITH_EXIT (&self->parser, &event, error);
+      if (event.type != YAML_STREAM_START_EVENT)
+        {
+          MMD_YAML_ERROR_EVENT_EXIT (
+            error, event, "Did not encounter stream start");
+        }
+
+      /* As in modulemd_module_index_update_from_parser(), subdocument text
+       * can only be recovered from the parser marks for UTF-8 input.
+       */
+      self->use_capture =
+        event.data.stream_start.encoding == YAML_UTF8_ENCODING;
+      yaml_event_delete (&event);
+      self->started = TRUE;
+    }
+
+  YAML_PARSER_PARSE_WITH_EXIT (&self->parser, &event, error);
+
+  switch (event.type)
+    {
+    case YAML_DOCUMENT_START_EVENT:
+      return modulemd_module_index_read_subdoc (
+        &self->parser,
+        self->use_capture ? &self->capture : NULL,
+        self->strict,
+        &event.start_mark,
+        failure);
+
+    case YAML_STREAM_END_EVENT: return NULL;
+
+    default:
+      MMD_YAML_ERROR_EVENT_EXIT (
+        error, event, "Unexpected YAML event in document stream");
+    }
+}
+
+
+GObject *
+modulemd_reader_next_document (ModulemdReader *self, GError **error)
+{
+  g_autoptr (ModulemdSubdocumentInfo) failure = NULL;
+  g_autoptr (GError) nested_error = NULL;
+  const GError *reason = NULL;
+  GObject *object = NULL;
+
+  g_return_val_if_fail (MODULEMD_IS_READER (self), NULL);
+
+  if (self->finished)
+    {
+      return NULL;
+    }
+
+  object = modulemd_reader_read (self, &failure, &nested_error);
+  if (object != NULL)
+    {
+      return object;
+    }
+
+  if (failure != NULL)
+    {
+      reason = modulemd_subdocument_info_get_gerror (failure);
+      if (self->parser.error == YAML_NO_ERROR)
+        {
+          /* Skip this subdocument and carry on with the next one */
+          g_propagate_error (error, g_error_copy (reason));
+          return NULL;
+        }
+
+      /* The subdocument broke the YAML stream itself, so nothing after it
+       * can be read.
+       */
+      nested_error = g_error_copy (reason);
+    }
+
+  self->finished = TRUE;
+  if (nested_error == NULL)
+    {
+      return NULL; /* End of the stream */
+    }
+
+  /* A decompression failure surfaces from libyaml as a generic read error,
+   * so report the real reason instead.
+   */
+  if (self->decompressor &&
+      modulemd_decompressor_get_error (self->decompressor) != NULL)
+    {
+      reason = modulemd_decompressor_get_error (self->decompressor);
+      g_propagate_error (error, g_error_copy (reason));
+      return NULL;
+    }
+
+  g_propagate_error (error, g_steal_pointer (&nested_error));
+  return NULL;
+}
+
+
+gboolean
+modulemd_reader_is_finished (ModulemdReader *self)
+{
+  g_return_val_if_fail (MODULEMD_IS_READER (self), FALSE);
+
+  return self->finished;
+}
@@ -363,6 +363,26 @@ modulemd_rpm_map_entry_init (ModulemdRpmMapEntry *self)
 }
 
 /* === YAML Functions === */
+enum
+{
+  RPM_MAP_KEY_ARCH,
+  RPM_MAP_KEY_EPOCH,
+  RPM_MAP_KEY_NAME,
+  RPM_MAP_KEY_NEVRA,
+  RPM_MAP_KEY_RELEASE,
+  RPM_MAP_KEY_VERSION
+};
+
+/* The keys of an rpm-map entry mapping, in strcmp() order */
+static const modulemd_yaml_key rpm_map_entry_keys[] = {
+  { "arch", RPM_MAP_KEY_ARCH },
+  { "epoch", RPM_MAP_KEY_EPOCH },
+  { "name", RPM_MAP_KEY_NAME },
+  { "nevra", RPM_MAP_KEY_NEVRA },
+  { "release", RPM_MAP_KEY_RELEASE },
+  { "version", RPM_MAP_KEY_VERSION },
+};
+
 ModulemdRpmMapEntry *
 modulemd_rpm_map_entry_parse_yaml (yaml_parser_t *parser,
                                    gboolean strict,
@@ -400,8 +420,12 @@ modulemd_rpm_map_entry_parse_yaml (yaml_parser_t *parser,
         case YAML_MAPPING_END_EVENT: done = TRUE; break;
 
         case YAML_SCALAR_EVENT:
-          if (g_str_equal (event.data.scalar.value, "name"))
+          switch (modulemd_yaml_lookup_key (
+            rpm_map_entry_keys,
+            G_N_ELEMENTS (rpm_map_entry_keys),
+            (const gchar *)event.data.scalar.value))
             {
+            case RPM_MAP_KEY_NAME:
               scalar = modulemd_yaml_parse_string (parser, &nested_error);
               if (!scalar)
                 {
@@ -413,9 +437,9 @@ modulemd_rpm_map_entry_parse_yaml (yaml_parser_t *parser,
                 }
               modulemd_rpm_map_entry_set_name (entry, scalar);
               g_clear_pointer (&scalar, g_free);
-            }
-          else if (g_str_equal (event.data.scalar.value, "epoch"))
-            {
+              break;
+
+            case RPM_MAP_KEY_EPOCH:
               epoch = modulemd_yaml_parse_uint64 (parser, &nested_error);
               if (nested_error)
                 {
@@ -427,9 +451,9 @@ modulemd_rpm_map_entry_parse_yaml (yaml_parser_t *parser,
                 }
               modulemd_rpm_map_entry_set_epoch (entry, epoch);
               seen_epoch = TRUE;
-            }
-          else if (g_str_equal (event.data.scalar.value, "version"))
-            {
+              break;
+
+            case RPM_MAP_KEY_VERSION:
               scalar = modulemd_yaml_parse_string (parser, &nested_error);
               if (!scalar)
                 {
@@ -441,9 +465,9 @@ modulemd_rpm_map_entry_parse_yaml (yaml_parser_t *parser,
                 }
               modulemd_rpm_map_entry_set_version (entry, scalar);
               g_clear_pointer (&scalar, g_free);
-            }
-          else if (g_str_equal (event.data.scalar.value, "release"))
-            {
+              break;
+
+            case RPM_MAP_KEY_RELEASE:
               scalar = modulemd_yaml_parse_string (parser, &nested_error);
               if (!scalar)
                 {
@@ -455,9 +479,9 @@ modulemd_rpm_map_entry_parse_yaml (yaml_parser_t *parser,
                 }
               modulemd_rpm_map_entry_set_release (entry, scalar);
               g_clear_pointer (&scalar, g_free);
-            }
-          else if (g_str_equal (event.data.scalar.value, "arch"))
-            {
+              break;
+
+            case RPM_MAP_KEY_ARCH:
               scalar = modulemd_yaml_parse_string (parser, &nested_error);
               if (!scalar)
                 {
@@ -469,9 +493,9 @@ modulemd_rpm_map_entry_parse_yaml (yaml_parser_t *parser,
                 }
               modulemd_rpm_map_entry_set_arch (entry, scalar);
               g_clear_pointer (&scalar, g_free);
-            }
-          else if (g_str_equal (event.data.scalar.value, "nevra"))
-            {
+              break;
+
+            case RPM_MAP_KEY_NEVRA:
               nevra = modulemd_yaml_parse_string (parser, &nested_error);
               if (!nevra)
                 {
@@ -481,9 +505,9 @@ modulemd_rpm_map_entry_parse_yaml (yaml_parser_t *parser,
                     "Failed to parse package nevra: %s",
                     nested_error->message);
                 }
-            }
-          else
-            {
+              break;
+
+            default:
               SKIP_UNKNOWN (parser,
                             NULL,
                             "Unexpected key in rpm-map entry: %s",
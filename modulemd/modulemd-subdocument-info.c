@@ -31,6 +31,9 @@ struct _ModulemdSubdocumentInfo
   guint64 mdversion;
   GError *error;
   gchar *contents;
+
+  /* Holds @contents if it is borrowed rather than owned */
+  GVariant *contents_variant;
 };
 
 G_DEFINE_TYPE (ModulemdSubdocumentInfo,
@@ -65,13 +68,25 @@ modulemd_subdocument_info_copy (ModulemdSubdocumentInfo *self)
 }
 
 
+static void
+clear_contents (ModulemdSubdocumentInfo *self)
+{
+  if (self->contents_variant)
+    {
+      self->contents = NULL;
+      g_clear_pointer (&self->contents_variant, g_variant_unref);
+    }
+  g_clear_pointer (&self->contents, g_free);
+}
+
+
 static void
 modulemd_subdocument_info_finalize (GObject *object)
 {
   ModulemdSubdocumentInfo *self = (ModulemdSubdocumentInfo *)object;
 
   g_clear_pointer (&self->error, g_error_free);
-  g_clear_pointer (&self->contents, g_free);
+  clear_contents (self);
 
   G_OBJECT_CLASS (modulemd_subdocument_info_parent_class)->finalize (object);
 }
@@ -85,11 +100,37 @@ modulemd_subdocument_info_set_yaml (ModulemdSubdocumentInfo *self,
 
   g_debug ("Setting YAML: %s\n", contents);
 
-  g_clear_pointer (&self->contents, g_free);
+  clear_contents (self);
   self->contents = g_strdup (contents);
 }
 
 
+void
+modulemd_subdocument_info_take_yaml (ModulemdSubdocumentInfo *self,
+                                     gchar *contents)
+{
+  g_return_if_fail (MODULEMD_IS_SUBDOCUMENT_INFO (self));
+
+  g_debug ("Setting YAML: %s\n", contents);
+
+  clear_contents (self);
+  self->contents = contents;
+}
+
+
+void
+modulemd_subdocument_info_set_yaml_variant (ModulemdSubdocumentInfo *self,
+                                            GVariant *contents)
+{
+  g_return_if_fail (MODULEMD_IS_SUBDOCUMENT_INFO (self));
+  g_return_if_fail (g_variant_is_of_type (contents, G_VARIANT_TYPE_STRING));
+
+  clear_contents (self);
+  self->contents_variant = g_variant_ref (contents);
+  self->contents = (gchar *)g_variant_get_string (contents, NULL);
+}
+
+
 const gchar *
 modulemd_subdocument_info_get_yaml (ModulemdSubdocumentInfo *self)
 {
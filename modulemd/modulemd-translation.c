@@ -38,6 +38,12 @@ struct _ModulemdTranslation
   guint64 modified;
 
   GHashTable *translation_entries;
+
+  /* Increased by every method that modifies this object. It starts at one so
+   * that a validated_generation of zero means "never validated".
+   */
+  guint64 generation;
+  guint64 validated_generation;
 };
 
 G_DEFINE_TYPE (ModulemdTranslation, modulemd_translation, G_TYPE_OBJECT)
@@ -96,6 +102,12 @@ modulemd_translation_copy (ModulemdTranslation *self)
       modulemd_translation_set_translation_entry (t, value);
     }
 
+  /* A copy of a translation that is known to be valid is valid as well */
+  if (self->validated_generation == self->generation)
+    {
+      t->validated_generation = t->generation;
+    }
+
   return g_steal_pointer (&t);
 }
 
@@ -105,6 +117,12 @@ modulemd_translation_validate (ModulemdTranslation *self, GError **error)
 {
   g_return_val_if_fail (MODULEMD_IS_TRANSLATION (self), FALSE);
 
+  /* Nothing has changed since this translation last passed validation */
+  if (self->validated_generation == self->generation)
+    {
+      return TRUE;
+    }
+
   if (g_str_equal (modulemd_translation_get_module_name (self),
                    T_PLACEHOLDER_STRING))
     {
@@ -148,6 +166,7 @@ modulemd_translation_validate (ModulemdTranslation *self, GError **error)
       return FALSE;
     }
 
+  self->validated_generation = self->generation;
   return TRUE;
 }
 
@@ -198,6 +217,7 @@ modulemd_translation_set_version (ModulemdTranslation *self, guint64 version)
 {
   g_return_if_fail (MODULEMD_IS_TRANSLATION (self));
   g_return_if_fail (version != 0);
+  self->generation++;
 
   self->version = version;
 
@@ -212,6 +232,7 @@ modulemd_translation_set_module_name (ModulemdTranslation *self,
   g_return_if_fail (MODULEMD_IS_TRANSLATION (self));
   g_return_if_fail (module_name);
   g_return_if_fail (g_strcmp0 (module_name, T_DEFAULT_STRING));
+  self->generation++;
 
   g_clear_pointer (&self->module_name, g_free);
   self->module_name = g_strdup (module_name);
@@ -227,6 +248,7 @@ modulemd_translation_set_module_stream (ModulemdTranslation *self,
   g_return_if_fail (MODULEMD_IS_TRANSLATION (self));
   g_return_if_fail (module_stream);
   g_return_if_fail (g_strcmp0 (module_stream, T_DEFAULT_STRING));
+  self->generation++;
 
   g_clear_pointer (&self->module_stream, g_free);
   self->module_stream = g_strdup (module_stream);
@@ -239,6 +261,7 @@ void
 modulemd_translation_set_modified (ModulemdTranslation *self, guint64 modified)
 {
   g_return_if_fail (MODULEMD_IS_TRANSLATION (self));
+  self->generation++;
 
   self->modified = modified;
 
@@ -260,6 +283,7 @@ modulemd_translation_set_translation_entry (
   ModulemdTranslation *self, ModulemdTranslationEntry *translation_entry)
 {
   g_return_if_fail (MODULEMD_IS_TRANSLATION (self));
+  self->generation++;
 
   g_hash_table_insert (
     self->translation_entries,
@@ -380,6 +404,7 @@ modulemd_translation_class_init (ModulemdTranslationClass *klass)
 static void
 modulemd_translation_init (ModulemdTranslation *self)
 {
+  self->generation = 1;
   self->translation_entries =
     g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_object_unref);
 }
@@ -476,8 +501,26 @@ modulemd_translation_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                                  gboolean strict,
                                  GError **error)
 {
-  MODULEMD_INIT_TRACE ();
   MMD_INIT_YAML_PARSER (parser);
+
+  if (!modulemd_subdocument_info_get_data_parser (
+        subdoc, &parser, strict, error))
+    {
+      return NULL;
+    }
+
+  return modulemd_translation_parse_yaml_data (
+    &parser, modulemd_subdocument_info_get_mdversion (subdoc), strict, error);
+}
+
+
+ModulemdTranslation *
+modulemd_translation_parse_yaml_data (yaml_parser_t *parser,
+                                      guint64 version,
+                                      gboolean strict,
+                                      GError **error)
+{
+  MODULEMD_INIT_TRACE ();
   MMD_INIT_YAML_EVENT (event);
   gboolean done = FALSE;
   g_autoptr (ModulemdTranslation) t = NULL;
@@ -485,21 +528,14 @@ modulemd_translation_parse_yaml (ModulemdSubdocumentInfo *subdoc,
   g_autofree gchar *value = NULL;
   guint64 modified;
   g_autoptr (GHashTable) entries = NULL;
-  guint64 version = modulemd_subdocument_info_get_mdversion (subdoc);
 
-  if (!modulemd_subdocument_info_get_data_parser (
-        subdoc, &parser, strict, error))
-    {
-      return NULL;
-    }
-
-  g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
   /* Create a translation with placeholder module info. */
   t = modulemd_translation_new (
     version, T_PLACEHOLDER_STRING, T_PLACEHOLDER_STRING, 0);
 
-  YAML_PARSER_PARSE_WITH_EXIT (&parser, &event, error);
+  YAML_PARSER_PARSE_WITH_EXIT (parser, &event, error);
   if (event.type != YAML_MAPPING_START_EVENT)
     {
       MMD_YAML_ERROR_EVENT_EXIT_BOOL (
@@ -508,7 +544,7 @@ modulemd_translation_parse_yaml (ModulemdSubdocumentInfo *subdoc,
 
   while (!done)
     {
-      YAML_PARSER_PARSE_WITH_EXIT (&parser, &event, error);
+      YAML_PARSER_PARSE_WITH_EXIT (parser, &event, error);
 
       switch (event.type)
         {
@@ -523,7 +559,7 @@ modulemd_translation_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                   MMD_YAML_ERROR_EVENT_EXIT (
                     error, event, "Module name encountered twice");
                 }
-              value = modulemd_yaml_parse_string (&parser, &nested_error);
+              value = modulemd_yaml_parse_string (parser, &nested_error);
               if (!value)
                 {
                   MMD_YAML_ERROR_EVENT_EXIT (
@@ -544,7 +580,7 @@ modulemd_translation_parse_yaml (ModulemdSubdocumentInfo *subdoc,
                   MMD_YAML_ERROR_EVENT_EXIT (
                     error, event, "Module stream encountered twice");
                 }
-              value = modulemd_yaml_parse_string (&parser, &nested_error);
+              value = modulemd_yaml_parse_string (parser, &nested_error);
               if (!value)
                 {
                   MMD_YAML_ERROR_EVENT_EXIT (
@@ -559,7 +595,7 @@ modulemd_translation_parse_yaml (ModulemdSubdocumentInfo *subdoc,
             }
           else if (g_str_equal (event.data.scalar.value, "modified"))
             {
-              modified = modulemd_yaml_parse_uint64 (&parser, &nested_error);
+              modified = modulemd_yaml_parse_uint64 (parser, &nested_error);
               if (nested_error)
                 {
                   MMD_YAML_ERROR_EVENT_EXIT (
@@ -574,7 +610,7 @@ modulemd_translation_parse_yaml (ModulemdSubdocumentInfo *subdoc,
           else if (g_str_equal (event.data.scalar.value, "translations"))
             {
               entries = modulemd_translation_parse_yaml_entries (
-                &parser, strict, &nested_error);
+                parser, strict, &nested_error);
               if (!entries)
                 {
                   MMD_YAML_ERROR_EVENT_EXIT (
@@ -589,7 +625,7 @@ modulemd_translation_parse_yaml (ModulemdSubdocumentInfo *subdoc,
             }
           else
             {
-              SKIP_UNKNOWN (&parser,
+              SKIP_UNKNOWN (parser,
                             NULL,
                             "Unexpected key in translation data: %s",
                             (const gchar *)event.data.scalar.value);
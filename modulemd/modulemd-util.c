@@ -89,6 +89,381 @@ modulemd_hash_table_deep_set_copy (GHashTable *orig)
 }
 
 
+/* A block of strings that are freed all at once, shared by the pool that
+ * allocated it and the pools that absorbed that one.
+ */
+typedef struct
+{
+  GStringChunk *chunk;
+} modulemd_string_arena;
+
+#define MMD_STRING_ARENA_BLOCK_SIZE 4096
+
+
+static modulemd_string_arena *
+modulemd_string_arena_new (void)
+{
+  modulemd_string_arena *arena = g_atomic_rc_box_new0 (modulemd_string_arena);
+
+  arena->chunk = g_string_chunk_new (MMD_STRING_ARENA_BLOCK_SIZE);
+
+  return arena;
+}
+
+
+static void
+modulemd_string_arena_clear (gpointer arena)
+{
+  g_string_chunk_free (((modulemd_string_arena *)arena)->chunk);
+}
+
+
+static void
+modulemd_string_arena_release (gpointer arena)
+{
+  g_atomic_rc_box_release_full (arena, modulemd_string_arena_clear);
+}
+
+
+struct _modulemd_string_pool
+{
+  gatomicrefcount ref_count;
+
+  /* The interned strings, each holding a reference for the pool */
+  GHashTable *strings; /* <GRefString> */
+
+  /* The arena of this pool, followed by those of the pools it absorbed */
+  GPtrArray *arenas; /* <modulemd_string_arena> */
+};
+
+/* The pool that modulemd_intern_string() uses on each thread */
+static GPrivate current_string_pool = G_PRIVATE_INIT (NULL);
+
+
+modulemd_string_pool *
+modulemd_string_pool_new (void)
+{
+  modulemd_string_pool *pool = g_new0 (modulemd_string_pool, 1);
+
+  g_atomic_ref_count_init (&pool->ref_count);
+  pool->strings = g_hash_table_new_full (g_str_hash,
+                                         modulemd_interned_str_equal,
+                                         (GDestroyNotify)g_ref_string_release,
+                                         NULL);
+  pool->arenas =
+    g_ptr_array_new_with_free_func (modulemd_string_arena_release);
+  g_ptr_array_add (pool->arenas, modulemd_string_arena_new ());
+
+  return pool;
+}
+
+
+modulemd_string_pool *
+modulemd_string_pool_ref (modulemd_string_pool *pool)
+{
+  g_return_val_if_fail (pool, NULL);
+
+  g_atomic_ref_count_inc (&pool->ref_count);
+  return pool;
+}
+
+
+void
+modulemd_string_pool_unref (modulemd_string_pool *pool)
+{
+  g_return_if_fail (pool);
+
+  if (!g_atomic_ref_count_dec (&pool->ref_count))
+    {
+      return;
+    }
+
+  g_clear_pointer (&pool->strings, g_hash_table_unref);
+  g_clear_pointer (&pool->arenas, g_ptr_array_unref);
+  g_free (pool);
+}
+
+
+void
+modulemd_string_pool_absorb (modulemd_string_pool *pool,
+                             modulemd_string_pool *other)
+{
+  GHashTableIter iter;
+  gpointer key;
+  gpointer arena;
+
+  g_return_if_fail (pool && other);
+
+  if (pool == other)
+    {
+      return;
+    }
+
+  g_hash_table_iter_init (&iter, other->strings);
+  while (g_hash_table_iter_next (&iter, &key, NULL))
+    {
+      if (!g_hash_table_contains (pool->strings, key))
+        {
+          g_hash_table_add (pool->strings, g_ref_string_acquire (key));
+        }
+    }
+
+  for (guint i = 0; i < other->arenas->len; i++)
+    {
+      arena = g_ptr_array_index (other->arenas, i);
+      if (!g_ptr_array_find (pool->arenas, arena, NULL))
+        {
+          g_ptr_array_add (pool->arenas, g_atomic_rc_box_acquire (arena));
+        }
+    }
+}
+
+
+gchar *
+modulemd_string_pool_insert (modulemd_string_pool *pool, const gchar *str)
+{
+  modulemd_string_arena *arena = NULL;
+
+  g_return_val_if_fail (pool, NULL);
+
+  if (str == NULL)
+    {
+      return NULL;
+    }
+
+  arena = g_ptr_array_index (pool->arenas, 0);
+  return g_string_chunk_insert_const (arena->chunk, str);
+}
+
+
+modulemd_string_pool *
+modulemd_string_pool_get_current (void)
+{
+  return g_private_get (&current_string_pool);
+}
+
+
+void
+modulemd_string_pool_scope_enter (modulemd_string_pool_scope *scope,
+                                  modulemd_string_pool *pool)
+{
+  scope->previous = g_private_get (&current_string_pool);
+  scope->entered = TRUE;
+  if (pool != NULL)
+    {
+      g_private_set (&current_string_pool, pool);
+    }
+}
+
+
+void
+modulemd_string_pool_scope_leave (modulemd_string_pool_scope *scope)
+{
+  if (!scope->entered)
+    {
+      return;
+    }
+
+  g_private_set (&current_string_pool, scope->previous);
+  scope->previous = NULL;
+  scope->entered = FALSE;
+}
+
+
+gchar *
+modulemd_intern_string (const gchar *str)
+{
+  modulemd_string_pool *pool = NULL;
+  gpointer interned = NULL;
+
+  if (str == NULL)
+    {
+      return NULL;
+    }
+
+  /* Without a pool, fall back to an unshared copy rather than the global
+   * table of g_ref_string_new_intern(), whose lock would serialize the
+   * threads that parse in parallel.
+   */
+  pool = g_private_get (&current_string_pool);
+  if (pool == NULL)
+    {
+      return g_ref_string_new (str);
+    }
+
+  if (!g_hash_table_lookup_extended (pool->strings, str, &interned, NULL))
+    {
+      interned = g_ref_string_new (str);
+      g_hash_table_add (pool->strings, interned);
+    }
+
+  return g_ref_string_acquire (interned);
+}
+
+
+gboolean
+modulemd_interned_str_equal (gconstpointer a, gconstpointer b)
+{
+  if (a == b)
+    {
+      return TRUE;
+    }
+
+  return a != NULL && b != NULL && g_str_equal (a, b);
+}
+
+
+GHashTable *
+modulemd_interned_set_new (void)
+{
+  return g_hash_table_new_full (g_str_hash,
+                                modulemd_interned_str_equal,
+                                (GDestroyNotify)g_ref_string_release,
+                                NULL);
+}
+
+
+void
+modulemd_interned_set_add (GHashTable *set, const gchar *str)
+{
+  g_return_if_fail (set);
+  g_return_if_fail (str);
+
+  g_hash_table_add (set, modulemd_intern_string (str));
+}
+
+
+void
+modulemd_interned_set_take (GHashTable **dest, GHashTable *set)
+{
+  g_return_if_fail (dest && *dest);
+
+  if (set == NULL)
+    {
+      g_hash_table_remove_all (*dest);
+      return;
+    }
+
+  g_hash_table_unref (*dest);
+  *dest = set;
+}
+
+
+GHashTable *
+modulemd_interned_set_copy (GHashTable *orig)
+{
+  GHashTable *new;
+  GHashTableIter iter;
+  gpointer key;
+
+  g_return_val_if_fail (orig, NULL);
+
+  new = modulemd_interned_set_new ();
+
+  g_hash_table_iter_init (&iter, orig);
+  while (g_hash_table_iter_next (&iter, &key, NULL))
+    {
+      modulemd_interned_set_add (new, (const gchar *)key);
+    }
+
+  return new;
+}
+
+
+GHashTable *
+modulemd_multimap_new (void)
+{
+  return g_hash_table_new_full (g_str_hash,
+                                modulemd_interned_str_equal,
+                                (GDestroyNotify)g_ref_string_release,
+                                (GDestroyNotify)g_ptr_array_unref);
+}
+
+
+void
+modulemd_multimap_add (GHashTable *multimap,
+                       const gchar *key,
+                       gpointer value)
+{
+  GPtrArray *list = NULL;
+
+  if (key == NULL)
+    {
+      return;
+    }
+
+  list = g_hash_table_lookup (multimap, key);
+  if (list == NULL)
+    {
+      list = g_ptr_array_new ();
+      g_hash_table_insert (multimap, modulemd_intern_string (key), list);
+    }
+  g_ptr_array_add (list, value);
+}
+
+
+void
+modulemd_multimap_remove (GHashTable *multimap,
+                          const gchar *key,
+                          gpointer value)
+{
+  GPtrArray *list = NULL;
+
+  if (key == NULL)
+    {
+      return;
+    }
+
+  list = g_hash_table_lookup (multimap, key);
+  if (list == NULL)
+    {
+      return;
+    }
+
+  g_ptr_array_remove_fast (list, value);
+  if (list->len == 0)
+    {
+      g_hash_table_remove (multimap, key);
+    }
+}
+
+
+GPtrArray *
+modulemd_multimap_lookup (GHashTable *multimap, const gchar *key)
+{
+  if (key == NULL)
+    {
+      return NULL;
+    }
+
+  return g_hash_table_lookup (multimap, key);
+}
+
+
+gboolean
+modulemd_is_glob (const gchar *pattern)
+{
+  return pattern != NULL && strpbrk (pattern, "*?") != NULL;
+}
+
+
+gboolean
+modulemd_glob_matches (const gchar *pattern, const gchar *value)
+{
+  if (pattern == NULL)
+    {
+      return TRUE;
+    }
+
+  if (!modulemd_is_glob (pattern))
+    {
+      return g_strcmp0 (pattern, value) == 0;
+    }
+
+  return g_pattern_match_simple (pattern, value ? value : "");
+}
+
+
 GHashTable *
 modulemd_hash_table_deep_str_set_copy (GHashTable *orig)
 {
@@ -147,9 +522,13 @@ modulemd_hash_table_sets_are_equal_wrapper (const void *a, const void *b)
 gboolean
 modulemd_hash_table_sets_are_equal (GHashTable *a, GHashTable *b)
 {
-  g_autoptr (GPtrArray) set_a = NULL;
-  g_autoptr (GPtrArray) set_b = NULL;
+  GHashTableIter iter;
+  gpointer key;
 
+  if (a == b)
+    {
+      return TRUE;
+    }
 
   if (g_hash_table_size (a) != g_hash_table_size (b))
     {
@@ -159,17 +538,15 @@ modulemd_hash_table_sets_are_equal (GHashTable *a, GHashTable *b)
       return FALSE;
     }
 
-  set_a = modulemd_ordered_str_keys (a, modulemd_strcmp_sort);
-  set_b = modulemd_ordered_str_keys (b, modulemd_strcmp_sort);
-
-  for (guint i = 0; i < set_a->len; i++)
+  /* Sets of the same size are identical if every string in one of them is
+   * also in the other. This avoids copying and sorting both sets. Sets from
+   * modulemd_interned_set_new() whose strings were interned in the same pool
+   * find each string by comparing pointers.
+   */
+  g_hash_table_iter_init (&iter, a);
+  while (g_hash_table_iter_next (&iter, &key, NULL))
     {
-      /* These are guaranteed to be returned ordered, so we can
-       * assume that any difference at any index means that the
-       * lists are not identical.
-       */
-      if (!g_str_equal (g_ptr_array_index (set_a, i),
-                        g_ptr_array_index (set_b, i)))
+      if (!g_hash_table_contains (b, key))
         {
           /* No match, so this simpleset is not equal */
           return FALSE;
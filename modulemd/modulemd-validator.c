@@ -100,9 +100,11 @@ static GOptionEntry entries[] = {
 static gboolean
 parse_file (const gchar *filename, GPtrArray **failures, GError **error)
 {
+  MMD_INIT_YAML_CAPTURE (capture);
   MMD_INIT_YAML_PARSER (parser);
   MMD_INIT_YAML_EVENT (event);
   g_autoptr (FILE) yaml_stream = NULL;
+  g_autoptr (GMappedFile) mapped = NULL;
   int saved_errno;
   g_autoptr (ModulemdModuleIndex) index = NULL;
 
@@ -128,11 +130,23 @@ parse_file (const gchar *filename, GPtrArray **failures, GError **error)
     }
 
 
-  yaml_parser_set_input_file (&parser, yaml_stream);
+  mapped = modulemd_yaml_map_file (fileno (yaml_stream));
+  if (mapped)
+    {
+      modulemd_yaml_capture_set_input_string (
+        &capture,
+        &parser,
+        g_mapped_file_get_contents (mapped),
+        g_mapped_file_get_length (mapped));
+    }
+  else
+    {
+      modulemd_yaml_capture_set_input_file (&capture, &parser, yaml_stream);
+    }
 
   index = modulemd_module_index_new ();
   return modulemd_module_index_update_from_parser (
-    index, &parser, TRUE, TRUE, failures, error);
+    index, &parser, &capture, TRUE, TRUE, failures, error);
 }
 
 
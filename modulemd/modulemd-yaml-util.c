@@ -15,8 +15,12 @@
 #include "private/modulemd-subdocument-info-private.h"
 #include "private/modulemd-util.h"
 #include "private/modulemd-yaml.h"
+#include <errno.h>
 #include <glib.h>
 #include <inttypes.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <yaml.h>
 
 
@@ -27,6 +31,29 @@ modulemd_yaml_error_quark (void)
 }
 
 
+/* The smallest buffer allocated for a modulemd_yaml_string. libyaml flushes
+ * its own output buffer in chunks of about this size.
+ */
+#define MMD_YAML_STRING_MIN_ALLOC 16384
+
+
+modulemd_yaml_string *
+modulemd_yaml_string_new (gsize size_hint)
+{
+  modulemd_yaml_string *yaml_string =
+    g_malloc0_n (1, sizeof (modulemd_yaml_string));
+
+  if (size_hint > 0 && size_hint < G_MAXSIZE)
+    {
+      yaml_string->alloc = size_hint + 1;
+      yaml_string->str = g_malloc (yaml_string->alloc);
+      yaml_string->str[0] = '\0';
+    }
+
+  return yaml_string;
+}
+
+
 void
 modulemd_yaml_string_free (modulemd_yaml_string *yaml_string)
 {
@@ -35,18 +62,61 @@ modulemd_yaml_string_free (modulemd_yaml_string *yaml_string)
 }
 
 
+GBytes *
+modulemd_yaml_string_free_to_bytes (modulemd_yaml_string *yaml_string)
+{
+  gsize len = yaml_string->len;
+  gchar *str = g_steal_pointer (&yaml_string->str);
+
+  modulemd_yaml_string_free (yaml_string);
+
+  if (str == NULL)
+    {
+      return g_bytes_new_take (g_malloc0 (1), 0);
+    }
+
+  return g_bytes_new_take (str, len);
+}
+
+
 int
 write_yaml_string (void *data, unsigned char *buffer, size_t size)
 {
   modulemd_yaml_string *yaml_string = (modulemd_yaml_string *)data;
-  gsize total;
+  gsize needed;
+  gsize alloc;
 
-  if (!g_size_checked_add (&total, yaml_string->len, size + 1))
+  if (!g_size_checked_add (&needed, yaml_string->len, size) ||
+      !g_size_checked_add (&needed, needed, 1))
     {
       return 0;
     }
 
-  yaml_string->str = g_realloc_n (yaml_string->str, total, sizeof (char));
+  /* The contents may have been stolen from a string that is written to
+   * again.
+   */
+  if (yaml_string->str == NULL)
+    {
+      yaml_string->alloc = 0;
+    }
+
+  if (needed > yaml_string->alloc)
+    {
+      /* Grow geometrically so that the whole string is not copied again on
+       * every flush from libyaml.
+       */
+      alloc = MAX (yaml_string->alloc, MMD_YAML_STRING_MIN_ALLOC);
+      while (alloc < needed)
+        {
+          if (!g_size_checked_mul (&alloc, alloc, 2))
+            {
+              alloc = needed;
+            }
+        }
+
+      yaml_string->str = g_realloc (yaml_string->str, alloc);
+      yaml_string->alloc = alloc;
+    }
 
   memcpy (yaml_string->str + yaml_string->len, buffer, size);
   yaml_string->len += size;
@@ -56,6 +126,228 @@ write_yaml_string (void *data, unsigned char *buffer, size_t size)
 }
 
 
+static int
+modulemd_yaml_capture_read_handler (void *data,
+                                    unsigned char *buffer,
+                                    size_t size,
+                                    size_t *size_read)
+{
+  modulemd_yaml_capture *capture = (modulemd_yaml_capture *)data;
+
+  if (capture->file)
+    {
+      *size_read = fread (buffer, 1, size, capture->file);
+      if (ferror (capture->file))
+        {
+          return 0;
+        }
+    }
+  else if (!capture->read_fn (capture->read_data, buffer, size, size_read))
+    {
+      return 0;
+    }
+
+  g_byte_array_append (capture->buffer, buffer, *size_read);
+
+  return 1;
+}
+
+
+void
+modulemd_yaml_capture_set_input_string (modulemd_yaml_capture *capture,
+                                        yaml_parser_t *parser,
+                                        const gchar *string,
+                                        gsize length)
+{
+  capture->string = (const guint8 *)string;
+  capture->string_len = length;
+
+  yaml_parser_set_input_string (parser, (const unsigned char *)string, length);
+}
+
+
+void
+modulemd_yaml_capture_set_input_file (modulemd_yaml_capture *capture,
+                                      yaml_parser_t *parser,
+                                      FILE *file)
+{
+  capture->file = file;
+  capture->buffer = g_byte_array_new ();
+
+  yaml_parser_set_input (
+    parser, modulemd_yaml_capture_read_handler, (void *)capture);
+}
+
+
+void
+modulemd_yaml_capture_set_input (modulemd_yaml_capture *capture,
+                                 yaml_parser_t *parser,
+                                 yaml_read_handler_t *handler,
+                                 void *data)
+{
+  capture->read_fn = handler;
+  capture->read_data = data;
+  capture->buffer = g_byte_array_new ();
+
+  yaml_parser_set_input (
+    parser, modulemd_yaml_capture_read_handler, (void *)capture);
+}
+
+
+/*
+ * libyaml marks count characters rather than bytes, so walk forward from the
+ * oldest retained character to find the byte position of @index within the
+ * retained data.
+ */
+static gsize
+modulemd_yaml_capture_locate (modulemd_yaml_capture *capture,
+                              gsize index,
+                              const guint8 **data)
+{
+  const guint8 *retained;
+  gsize len;
+  gsize pos = 0;
+  gsize chars;
+
+  if (capture->buffer)
+    {
+      retained = capture->buffer->data;
+      len = capture->buffer->len;
+    }
+  else
+    {
+      retained = capture->string + capture->offset;
+      len = capture->string_len - capture->offset;
+    }
+
+  /* libyaml does not count a leading byte order mark as a character */
+  if (capture->offset == 0 && len >= 3 && retained[0] == 0xEF &&
+      retained[1] == 0xBB && retained[2] == 0xBF)
+    {
+      pos = 3;
+    }
+
+  g_return_val_if_fail (index >= capture->index, pos);
+
+  for (chars = index - capture->index; chars > 0 && pos < len; chars--)
+    {
+      pos++;
+      while (pos < len && (retained[pos] & 0xC0) == 0x80)
+        {
+          pos++;
+        }
+    }
+
+  *data = retained;
+  return pos;
+}
+
+
+void
+modulemd_yaml_capture_forget (modulemd_yaml_capture *capture,
+                              const yaml_mark_t *mark)
+{
+  const guint8 *data = NULL;
+  gsize pos;
+
+  if (capture == NULL)
+    {
+      return;
+    }
+
+  pos = modulemd_yaml_capture_locate (capture, mark->index, &data);
+
+  if (capture->buffer)
+    {
+      g_byte_array_remove_range (capture->buffer, 0, pos);
+    }
+
+  capture->offset += pos;
+  capture->index = mark->index;
+}
+
+
+gchar *
+modulemd_yaml_capture_dup (modulemd_yaml_capture *capture,
+                           const yaml_mark_t *start_mark,
+                           const yaml_mark_t *end_mark)
+{
+  const guint8 *data = NULL;
+  gsize start;
+  gsize end;
+
+  start = modulemd_yaml_capture_locate (capture, start_mark->index, &data);
+  end = modulemd_yaml_capture_locate (capture, end_mark->index, &data);
+
+  if (end < start)
+    {
+      end = start;
+    }
+
+  return g_strndup ((const gchar *)data + start, end - start);
+}
+
+
+void
+modulemd_yaml_capture_clear (modulemd_yaml_capture *capture)
+{
+  g_clear_pointer (&capture->buffer, g_byte_array_unref);
+  capture->string = NULL;
+  capture->string_len = 0;
+  capture->file = NULL;
+  capture->read_fn = NULL;
+  capture->read_data = NULL;
+  capture->offset = 0;
+  capture->index = 0;
+}
+
+
+GMappedFile *
+modulemd_yaml_map_file (int fd)
+{
+  struct stat st;
+  g_autoptr (GError) error = NULL;
+  GMappedFile *mapped = NULL;
+
+  /* Pipes and character devices report no useful size, and an empty file
+   * cannot be mapped at all, so leave those to stdio.
+   */
+  if (fstat (fd, &st) != 0 || !S_ISREG (st.st_mode) || st.st_size == 0)
+    {
+      return NULL;
+    }
+
+  mapped = g_mapped_file_new_from_fd (fd, FALSE, &error);
+  if (mapped == NULL)
+    {
+      g_debug ("Unable to map file, falling back to stdio: %s",
+               error->message);
+      return NULL;
+    }
+
+#ifdef MADV_SEQUENTIAL
+  /* The parser reads the whole file exactly once, front to back */
+  if (madvise (g_mapped_file_get_contents (mapped),
+               g_mapped_file_get_length (mapped),
+               MADV_SEQUENTIAL) != 0)
+    {
+      g_debug ("madvise (MADV_SEQUENTIAL) failed: %s", g_strerror (errno));
+    }
+#endif
+
+#ifdef MADV_WILLNEED
+  if (madvise (g_mapped_file_get_contents (mapped),
+               g_mapped_file_get_length (mapped),
+               MADV_WILLNEED) != 0)
+    {
+      g_debug ("madvise (MADV_WILLNEED) failed: %s", g_strerror (errno));
+    }
+#endif
+
+  return mapped;
+}
+
+
 const gchar *
 mmd_yaml_get_event_name (yaml_event_type_t type)
 {
@@ -454,14 +746,67 @@ modulemd_yaml_parse_uint64 (yaml_parser_t *parser, GError **error)
 }
 
 
-GHashTable *
-modulemd_yaml_parse_string_set (yaml_parser_t *parser, GError **error)
+gint
+modulemd_yaml_lookup_key (const modulemd_yaml_key *keys,
+                          gsize n_keys,
+                          const gchar *name)
+{
+  gsize lower = 0;
+  gsize upper = n_keys;
+  gsize middle;
+  int cmp;
+
+  g_return_val_if_fail (keys, -1);
+
+  if (name == NULL)
+    {
+      return -1;
+    }
+
+  while (lower < upper)
+    {
+      middle = lower + (upper - lower) / 2;
+      cmp = strcmp (name, keys[middle].name);
+      if (cmp == 0)
+        {
+          return keys[middle].id;
+        }
+
+      if (cmp < 0)
+        {
+          upper = middle;
+        }
+      else
+        {
+          lower = middle + 1;
+        }
+    }
+
+  return -1;
+}
+
+
+/*
+ * When @interned is TRUE, the set is created with modulemd_interned_set_new()
+ * and filled directly with interned strings, so that it can be stored in an
+ * object without making another copy of it.
+ */
+static GHashTable *
+parse_string_set (yaml_parser_t *parser, gboolean interned, GError **error)
 {
   MMD_INIT_YAML_EVENT (event);
   gboolean done = FALSE;
   gboolean in_list = FALSE;
-  g_autoptr (GHashTable) result =
-    g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  g_autoptr (GHashTable) result = NULL;
+
+  if (interned)
+    {
+      result = modulemd_interned_set_new ();
+    }
+  else
+    {
+      result = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    }
 
   while (!done)
     {
@@ -484,8 +829,16 @@ modulemd_yaml_parse_string_set (yaml_parser_t *parser, GError **error)
         case YAML_SCALAR_EVENT:
           g_debug ("Parsing scalar: %s",
                    (const gchar *)event.data.scalar.value);
-          g_hash_table_add (result,
-                            g_strdup ((const gchar *)event.data.scalar.value));
+          if (interned)
+            {
+              modulemd_interned_set_add (
+                result, (const gchar *)event.data.scalar.value);
+            }
+          else
+            {
+              g_hash_table_add (
+                result, g_strdup ((const gchar *)event.data.scalar.value));
+            }
 
           if (!in_list)
             {
@@ -509,10 +862,26 @@ modulemd_yaml_parse_string_set (yaml_parser_t *parser, GError **error)
 
 
 GHashTable *
-modulemd_yaml_parse_string_set_from_map (yaml_parser_t *parser,
-                                         const gchar *key,
-                                         gboolean strict,
+modulemd_yaml_parse_string_set (yaml_parser_t *parser, GError **error)
+{
+  return parse_string_set (parser, FALSE, error);
+}
+
+
+GHashTable *
+modulemd_yaml_parse_interned_string_set (yaml_parser_t *parser,
                                          GError **error)
+{
+  return parse_string_set (parser, TRUE, error);
+}
+
+
+static GHashTable *
+parse_string_set_from_map (yaml_parser_t *parser,
+                           const gchar *key,
+                           gboolean strict,
+                           gboolean interned,
+                           GError **error)
 {
   MMD_INIT_YAML_EVENT (event);
   gboolean done = FALSE;
@@ -547,7 +916,7 @@ modulemd_yaml_parse_string_set_from_map (yaml_parser_t *parser,
 
           if (g_str_equal ((const gchar *)event.data.scalar.value, key))
             {
-              set = modulemd_yaml_parse_string_set (parser, &nested_error);
+              set = parse_string_set (parser, interned, &nested_error);
               if (!set)
                 {
                   g_propagate_error (error, nested_error);
@@ -575,6 +944,26 @@ modulemd_yaml_parse_string_set_from_map (yaml_parser_t *parser,
 }
 
 
+GHashTable *
+modulemd_yaml_parse_string_set_from_map (yaml_parser_t *parser,
+                                         const gchar *key,
+                                         gboolean strict,
+                                         GError **error)
+{
+  return parse_string_set_from_map (parser, key, strict, FALSE, error);
+}
+
+
+GHashTable *
+modulemd_yaml_parse_interned_string_set_from_map (yaml_parser_t *parser,
+                                                  const gchar *key,
+                                                  gboolean strict,
+                                                  GError **error)
+{
+  return parse_string_set_from_map (parser, key, strict, TRUE, error);
+}
+
+
 GHashTable *
 modulemd_yaml_parse_string_string_map (yaml_parser_t *parser, GError **error)
 {
@@ -631,6 +1020,26 @@ modulemd_yaml_parse_string_string_map (yaml_parser_t *parser, GError **error)
 }
 
 
+static ModulemdYamlDocumentTypeEnum
+modulemd_yaml_get_doctype_from_string (const gchar *doctype)
+{
+  if (g_str_equal (doctype, "modulemd"))
+    {
+      return MODULEMD_YAML_DOC_MODULESTREAM;
+    }
+  else if (g_str_equal (doctype, "modulemd-defaults"))
+    {
+      return MODULEMD_YAML_DOC_DEFAULTS;
+    }
+  else if (g_str_equal (doctype, "modulemd-translations"))
+    {
+      return MODULEMD_YAML_DOC_TRANSLATIONS;
+    }
+
+  return MODULEMD_YAML_DOC_UNKNOWN;
+}
+
+
 static gboolean
 modulemd_yaml_parse_document_type_internal (
   yaml_parser_t *parser,
@@ -738,19 +1147,8 @@ modulemd_yaml_parse_document_type_internal (
                   return FALSE;
                 }
 
-              if (g_str_equal (doctype_scalar, "modulemd"))
-                {
-                  doctype = MODULEMD_YAML_DOC_MODULESTREAM;
-                }
-              else if (g_str_equal (doctype_scalar, "modulemd-defaults"))
-                {
-                  doctype = MODULEMD_YAML_DOC_DEFAULTS;
-                }
-              else if (g_str_equal (doctype_scalar, "modulemd-translations"))
-                {
-                  doctype = MODULEMD_YAML_DOC_TRANSLATIONS;
-                }
-              else
+              doctype = modulemd_yaml_get_doctype_from_string (doctype_scalar);
+              if (doctype == MODULEMD_YAML_DOC_UNKNOWN)
                 {
                   MMD_YAML_ERROR_EVENT_EXIT_BOOL (
                     error, event, "Document type %s unknown.", doctype_scalar);
@@ -851,11 +1249,16 @@ modulemd_yaml_parse_document_type_internal (
 }
 
 
-ModulemdSubdocumentInfo *
-modulemd_yaml_parse_document_type (yaml_parser_t *parser)
+/*
+ * Implements modulemd_yaml_parse_document_type(), re-emitting the subdocument
+ * into a string with room for @size_hint bytes.
+ */
+static ModulemdSubdocumentInfo *
+modulemd_yaml_parse_document_type_sized (yaml_parser_t *parser,
+                                         gsize size_hint)
 {
   MMD_INIT_YAML_EMITTER (emitter);
-  MMD_INIT_YAML_STRING (&emitter, yaml_string);
+  MMD_INIT_YAML_STRING_SIZED (&emitter, yaml_string, size_hint);
   g_autoptr (ModulemdSubdocumentInfo) s = modulemd_subdocument_info_new ();
   ModulemdYamlDocumentTypeEnum doctype = MODULEMD_YAML_DOC_UNKNOWN;
   guint64 mdversion = 0;
@@ -869,12 +1272,146 @@ modulemd_yaml_parse_document_type (yaml_parser_t *parser)
 
   modulemd_subdocument_info_set_doctype (s, doctype);
   modulemd_subdocument_info_set_mdversion (s, mdversion);
-  modulemd_subdocument_info_set_yaml (s, yaml_string->str);
+  if (yaml_string->len > 0)
+    {
+      modulemd_subdocument_info_take_yaml (
+        s, g_steal_pointer (&yaml_string->str));
+    }
 
   return g_steal_pointer (&s);
 }
 
 
+ModulemdSubdocumentInfo *
+modulemd_yaml_parse_document_type (yaml_parser_t *parser)
+{
+  return modulemd_yaml_parse_document_type_sized (parser, 0);
+}
+
+
+ModulemdSubdocumentInfo *
+modulemd_yaml_capture_get_subdocument (modulemd_yaml_capture *capture,
+                                       const yaml_mark_t *start_mark,
+                                       const yaml_mark_t *end_mark)
+{
+  g_autofree gchar *text = NULL;
+  gsize len;
+  MMD_INIT_YAML_PARSER (parser);
+  MMD_INIT_YAML_EVENT (event);
+
+  text = modulemd_yaml_capture_dup (capture, start_mark, end_mark);
+  len = strlen (text);
+  yaml_parser_set_input_string (&parser, (const unsigned char *)text, len);
+
+  /* modulemd_yaml_parse_document_type() expects the stream and document
+   * starts to have been consumed already.
+   */
+  if (yaml_parser_parse (&parser, &event))
+    {
+      yaml_event_delete (&event);
+      if (yaml_parser_parse (&parser, &event))
+        {
+          yaml_event_delete (&event);
+        }
+    }
+
+  /* The re-emitted text is usually about as long as the original */
+  return modulemd_yaml_parse_document_type_sized (&parser, len);
+}
+
+
+gboolean
+modulemd_yaml_parse_document_keys (yaml_parser_t *parser,
+                                   ModulemdYamlDocumentTypeEnum *doctype,
+                                   guint64 *mdversion,
+                                   gboolean *at_data,
+                                   GError **error)
+{
+  MODULEMD_INIT_TRACE ();
+  MMD_INIT_YAML_EVENT (event);
+  g_autofree gchar *doctype_scalar = NULL;
+  g_autoptr (GError) nested_error = NULL;
+
+  *at_data = FALSE;
+
+  while (TRUE)
+    {
+      YAML_PARSER_PARSE_WITH_EXIT_BOOL (parser, &event, error);
+
+      switch (event.type)
+        {
+        case YAML_MAPPING_END_EVENT: return TRUE;
+
+        case YAML_SCALAR_EVENT:
+          if (g_str_equal (event.data.scalar.value, "data"))
+            {
+              *at_data = TRUE;
+              return TRUE;
+            }
+          else if (g_str_equal (event.data.scalar.value, "document"))
+            {
+              if (*doctype != MODULEMD_YAML_DOC_UNKNOWN)
+                {
+                  MMD_YAML_ERROR_EVENT_EXIT_BOOL (
+                    error, event, "Document type encountered twice.");
+                }
+
+              doctype_scalar =
+                modulemd_yaml_parse_string (parser, &nested_error);
+              if (!doctype_scalar)
+                {
+                  g_propagate_error (error, g_steal_pointer (&nested_error));
+                  return FALSE;
+                }
+
+              *doctype =
+                modulemd_yaml_get_doctype_from_string (doctype_scalar);
+              if (*doctype == MODULEMD_YAML_DOC_UNKNOWN)
+                {
+                  MMD_YAML_ERROR_EVENT_EXIT_BOOL (
+                    error, event, "Document type %s unknown.", doctype_scalar);
+                }
+
+              g_clear_pointer (&doctype_scalar, g_free);
+            }
+          else if (g_str_equal (event.data.scalar.value, "version"))
+            {
+              if (*mdversion != 0)
+                {
+                  MMD_YAML_ERROR_EVENT_EXIT_BOOL (
+                    error, event, "Metadata version encountered twice.");
+                }
+
+              *mdversion = modulemd_yaml_parse_uint64 (parser, &nested_error);
+              if (nested_error)
+                {
+                  g_propagate_error (error, g_steal_pointer (&nested_error));
+                  return FALSE;
+                }
+            }
+          else
+            {
+              SKIP_UNKNOWN (parser,
+                            FALSE,
+                            "Unexpected key in root: %s",
+                            (const gchar *)event.data.scalar.value);
+            }
+          break;
+
+        default:
+          MMD_YAML_ERROR_EVENT_EXIT_BOOL (
+            error,
+            event,
+            "Unexpected YAML event in document root: %s",
+            mmd_yaml_get_event_name (event.type));
+          break;
+        }
+
+      yaml_event_delete (&event);
+    }
+}
+
+
 static const gchar *
 modulemd_yaml_get_doctype_string (ModulemdYamlDocumentTypeEnum doctype)
 {
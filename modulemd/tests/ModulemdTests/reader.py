@@ -0,0 +1,131 @@
+#!/usr/bin/python3
+
+# This file is part of libmodulemd
+# Copyright (C) 2020 Red Hat, Inc.
+#
+# Fedora-License-Identifier: MIT
+# SPDX-2.0-License-Identifier: MIT
+# SPDX-3.0-License-Identifier: MIT
+#
+# This program is free software.
+# For more information on the license, see COPYING.
+# For more information on free software, see
+# <https://www.gnu.org/philosophy/free-sw.en.html>.
+
+from os import path
+import sys
+
+try:
+    import unittest
+    import gi
+
+    gi.require_version("Modulemd", "2.0")
+    from gi.repository import Modulemd
+    from gi.repository import GLib
+except ImportError:
+    # Return error 77 to skip this test on platforms without the necessary
+    # python modules
+    sys.exit(77)
+
+from base import TestBase
+
+
+class TestReader(TestBase):
+    def test_iterate_file(self):
+        reader = Modulemd.Reader.new_for_file(
+            path.join(self.test_data_path, "long-valid.yaml"), True
+        )
+
+        docs = list(reader)
+        self.assertEqual(len(docs), 9)
+        self.assertEqual(
+            len([d for d in docs if isinstance(d, Modulemd.ModuleStream)]), 5
+        )
+        self.assertEqual(
+            len([d for d in docs if isinstance(d, Modulemd.Defaults)]), 3
+        )
+        self.assertEqual(
+            len([d for d in docs if isinstance(d, Modulemd.Translation)]), 1
+        )
+
+    def test_iterate_failure(self):
+        reader = Modulemd.Reader.new_for_string(
+            """---
+summary: An example module
+...
+---
+document: modulemd-defaults
+version: 1
+data:
+  module: foo
+...
+""",
+            True,
+        )
+
+        # Reading the broken subdocument directly reports it
+        with self.assertRaisesRegexp(GLib.GError, "No document type"):
+            reader.next_document()
+
+        # The reader carries on after a broken subdocument
+        docs = list(reader)
+        self.assertEqual(len(docs), 1)
+        self.assertEqual(docs[0].get_module_name(), "foo")
+        self.assertEqual(len(reader.failures), 0)
+
+    def test_iterate_skips_failures(self):
+        reader = Modulemd.Reader.new_for_string(
+            """---
+document: modulemd-defaults
+version: 1
+data:
+  module: foo
+...
+---
+summary: An example module
+...
+---
+document: modulemd-defaults
+version: 1
+data:
+  module: bar
+...
+""",
+            True,
+        )
+
+        # Iterating skips the broken subdocument instead of raising
+        docs = [d.get_module_name() for d in reader]
+        self.assertEqual(docs, ["foo", "bar"])
+
+        self.assertEqual(len(reader.failures), 1)
+        self.assertIn("No document type", reader.failures[0].message)
+
+    def test_iterate_raises_fatal_error(self):
+        reader = Modulemd.Reader.new_for_string(
+            """---
+document: modulemd-defaults
+version: 1
+data:
+  module: foo
+...
+---
+document: modulemd-defaults
+data: [unterminated
+""",
+            True,
+        )
+
+        # Invalid YAML ends the stream, so it is raised rather than skipped
+        docs = []
+        with self.assertRaises(GLib.Error):
+            for d in reader:
+                docs.append(d.get_module_name())
+
+        self.assertEqual(docs, ["foo"])
+        self.assertEqual(len(reader.failures), 0)
+        self.assertTrue(reader.is_finished())
+
+
+if __name__ == "__main__":
+    unittest.main()
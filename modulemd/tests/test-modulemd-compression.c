@@ -45,6 +45,14 @@ test_modulemd_compression_type (void)
                    ==,
                    MODULEMD_COMPRESSION_TYPE_XZ_COMPRESSION);
 
+  g_assert_cmpint (modulemd_compression_type ("zst"),
+                   ==,
+                   MODULEMD_COMPRESSION_TYPE_ZSTD_COMPRESSION);
+
+  g_assert_cmpint (modulemd_compression_type ("zstd"),
+                   ==,
+                   MODULEMD_COMPRESSION_TYPE_ZSTD_COMPRESSION);
+
   g_assert_cmpint (modulemd_compression_type ("garbage"),
                    ==,
                    MODULEMD_COMPRESSION_TYPE_UNKNOWN_COMPRESSION);
@@ -78,6 +86,8 @@ test_modulemd_detect_compression (void)
       .type = MODULEMD_COMPRESSION_TYPE_GZ_COMPRESSION },
     { .filename = "xzipped.yaml.xz",
       .type = MODULEMD_COMPRESSION_TYPE_XZ_COMPRESSION },
+    { .filename = "zstdipped.yaml.zst",
+      .type = MODULEMD_COMPRESSION_TYPE_ZSTD_COMPRESSION },
     { .filename = "uncompressed.yaml",
       .type = MODULEMD_COMPRESSION_TYPE_NO_COMPRESSION },
     { .filename = "empty",
@@ -104,8 +114,7 @@ test_modulemd_detect_compression (void)
     }
 
 
-    /* == Test detection by libmagic == */
-#ifdef HAVE_LIBMAGIC
+  /* == Detect by file contents == */
   struct expected_compression_t expected_magic[] = {
     { .filename = "bzipped",
       .type = MODULEMD_COMPRESSION_TYPE_BZ2_COMPRESSION },
@@ -113,27 +122,14 @@ test_modulemd_detect_compression (void)
       .type = MODULEMD_COMPRESSION_TYPE_GZ_COMPRESSION },
     { .filename = "xzipped",
       .type = MODULEMD_COMPRESSION_TYPE_XZ_COMPRESSION },
+    { .filename = "zstdipped",
+      .type = MODULEMD_COMPRESSION_TYPE_ZSTD_COMPRESSION },
     { .filename = "uncompressed",
       .type = MODULEMD_COMPRESSION_TYPE_NO_COMPRESSION },
     { .filename = "empty",
       .type = MODULEMD_COMPRESSION_TYPE_UNKNOWN_COMPRESSION },
     { .filename = NULL }
   };
-#else
-  struct expected_compression_t expected_magic[] = {
-    { .filename = "bzipped",
-      .type = MODULEMD_COMPRESSION_TYPE_UNKNOWN_COMPRESSION },
-    { .filename = "gzipped",
-      .type = MODULEMD_COMPRESSION_TYPE_UNKNOWN_COMPRESSION },
-    { .filename = "xzipped",
-      .type = MODULEMD_COMPRESSION_TYPE_UNKNOWN_COMPRESSION },
-    { .filename = "uncompressed",
-      .type = MODULEMD_COMPRESSION_TYPE_UNKNOWN_COMPRESSION },
-    { .filename = "empty",
-      .type = MODULEMD_COMPRESSION_TYPE_UNKNOWN_COMPRESSION },
-    { .filename = NULL }
-  };
-#endif
 
   for (size_t j = 0; expected_magic[j].filename; j++)
     {
@@ -170,6 +166,7 @@ test_modulemd_compression_suffix (void)
     { .type = MODULEMD_COMPRESSION_TYPE_GZ_COMPRESSION, .suffix = ".gz" },
     { .type = MODULEMD_COMPRESSION_TYPE_BZ2_COMPRESSION, .suffix = ".bz2" },
     { .type = MODULEMD_COMPRESSION_TYPE_XZ_COMPRESSION, .suffix = ".xz" },
+    { .type = MODULEMD_COMPRESSION_TYPE_ZSTD_COMPRESSION, .suffix = ".zst" },
     { .type = MODULEMD_COMPRESSION_TYPE_SENTINEL, .suffix = NULL }
   };
 
@@ -199,6 +196,7 @@ test_modulemd_get_rpmio_fmode (void)
     { .type = MODULEMD_COMPRESSION_TYPE_GZ_COMPRESSION, .suffix = "gzdio" },
     { .type = MODULEMD_COMPRESSION_TYPE_BZ2_COMPRESSION, .suffix = "bzdio" },
     { .type = MODULEMD_COMPRESSION_TYPE_XZ_COMPRESSION, .suffix = "xzdio" },
+    { .type = MODULEMD_COMPRESSION_TYPE_ZSTD_COMPRESSION, .suffix = "zstdio" },
     { .type = MODULEMD_COMPRESSION_TYPE_SENTINEL, .suffix = NULL }
   };
 
@@ -391,6 +391,74 @@ dependencies_test_copy (DependenciesFixture *fixture, gconstpointer user_data)
   g_clear_pointer (&list, g_strfreev);
 }
 
+static void
+dependencies_test_requires_module_and_stream (DependenciesFixture *fixture,
+                                              gconstpointer user_data)
+{
+  g_autoptr (ModulemdDependencies) d = NULL;
+  g_autoptr (ModulemdDependencies) d_copy = NULL;
+
+  d = modulemd_dependencies_new ();
+  modulemd_dependencies_add_runtime_stream (d, "platform", "f32");
+  modulemd_dependencies_add_runtime_stream (d, "platform", "f31");
+  modulemd_dependencies_add_runtime_stream (d, "nodejs", "-10");
+  modulemd_dependencies_add_runtime_stream (d, "nodejs", "-8");
+  modulemd_dependencies_set_empty_runtime_dependencies_for_module (d, "perl");
+  modulemd_dependencies_add_buildtime_stream (d, "platform", "f33");
+
+  /* Explicit streams */
+  g_assert_true (
+    modulemd_dependencies_requires_module_and_stream (d, "platform", "f31"));
+  g_assert_true (
+    modulemd_dependencies_requires_module_and_stream (d, "platform", "f32"));
+  g_assert_false (
+    modulemd_dependencies_requires_module_and_stream (d, "platform", "f33"));
+  g_assert_false (
+    modulemd_dependencies_requires_module_and_stream (d, "platform", "f3"));
+
+  /* Negated streams */
+  g_assert_true (
+    modulemd_dependencies_requires_module_and_stream (d, "nodejs", "12"));
+  g_assert_true (
+    modulemd_dependencies_requires_module_and_stream (d, "nodejs", "1"));
+  g_assert_false (
+    modulemd_dependencies_requires_module_and_stream (d, "nodejs", "10"));
+  g_assert_false (
+    modulemd_dependencies_requires_module_and_stream (d, "nodejs", "8"));
+
+  /* All streams */
+  g_assert_true (
+    modulemd_dependencies_requires_module_and_stream (d, "perl", "5.30"));
+
+  /* Modules that are not required at all */
+  g_assert_false (
+    modulemd_dependencies_requires_module_and_stream (d, "ruby", "2.7"));
+  g_assert_false (
+    modulemd_dependencies_buildrequires_module_and_stream (d, "perl", "5.30"));
+
+  g_assert_true (modulemd_dependencies_buildrequires_module_and_stream (
+    d, "platform", "f33"));
+  g_assert_false (modulemd_dependencies_buildrequires_module_and_stream (
+    d, "platform", "f32"));
+
+  /* Modifying the object or its copy is reflected only in the object
+   * modified.
+   */
+  d_copy = modulemd_dependencies_copy (d);
+  modulemd_dependencies_add_runtime_stream (d, "platform", "f33");
+  modulemd_dependencies_clear_buildtime_dependencies (d_copy);
+
+  g_assert_true (
+    modulemd_dependencies_requires_module_and_stream (d, "platform", "f33"));
+  g_assert_false (modulemd_dependencies_requires_module_and_stream (
+    d_copy, "platform", "f33"));
+  g_assert_true (modulemd_dependencies_buildrequires_module_and_stream (
+    d, "platform", "f33"));
+  g_assert_false (modulemd_dependencies_buildrequires_module_and_stream (
+    d_copy, "platform", "f33"));
+}
+
+
 static void
 dependencies_test_parse_yaml (DependenciesFixture *fixture,
                               gconstpointer user_data)
@@ -626,6 +694,13 @@ main (int argc, char *argv[])
               dependencies_test_copy,
               NULL);
 
+  g_test_add ("/modulemd/v2/dependencies/requires_module_and_stream",
+              DependenciesFixture,
+              NULL,
+              NULL,
+              dependencies_test_requires_module_and_stream,
+              NULL);
+
   g_test_add ("/modulemd/v2/dependencies/yaml/parse",
               DependenciesFixture,
               NULL,
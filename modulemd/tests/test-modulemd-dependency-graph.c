@@ -0,0 +1,285 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2020 Red Hat, Inc.
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#include <glib.h>
+#include <locale.h>
+
+#include "modulemd-dependencies.h"
+#include "modulemd-dependency-graph.h"
+#include "modulemd-errors.h"
+#include "modulemd-module-index.h"
+#include "modulemd-module-stream-v2.h"
+#include "modulemd-module.h"
+#include "private/glib-extensions.h"
+#include "private/test-utils.h"
+
+
+/*
+ * Adds module:stream to @index with a single #ModulemdDependencies object
+ * made of @runtime and @buildtime, each a NULL-terminated list of
+ * "module:stream" strings. A "module:" string stands for all streams.
+ */
+static void
+add_stream (ModulemdModuleIndex *index,
+            const gchar *module_name,
+            const gchar *stream_name,
+            const gchar **runtime,
+            const gchar **buildtime)
+{
+  g_autoptr (ModulemdModuleStream) stream = NULL;
+  g_autoptr (ModulemdDependencies) deps = NULL;
+  g_autoptr (GError) error = NULL;
+  g_auto (GStrv) split = NULL;
+
+  stream = modulemd_module_stream_new (
+    MD_MODULESTREAM_VERSION_TWO, module_name, stream_name);
+  modulemd_module_stream_set_version (stream, 1);
+  modulemd_module_stream_set_context (stream, "c0ffee42");
+
+  deps = modulemd_dependencies_new ();
+  for (guint i = 0; runtime && runtime[i]; i++)
+    {
+      split = g_strsplit (runtime[i], ":", 2);
+      if (split[1][0] == '\0')
+        {
+          modulemd_dependencies_set_empty_runtime_dependencies_for_module (
+            deps, split[0]);
+        }
+      else
+        {
+          modulemd_dependencies_add_runtime_stream (deps, split[0], split[1]);
+        }
+      g_clear_pointer (&split, g_strfreev);
+    }
+  for (guint i = 0; buildtime && buildtime[i]; i++)
+    {
+      split = g_strsplit (buildtime[i], ":", 2);
+      if (split[1][0] == '\0')
+        {
+          modulemd_dependencies_set_empty_buildtime_dependencies_for_module (
+            deps, split[0]);
+        }
+      else
+        {
+          modulemd_dependencies_add_buildtime_stream (
+            deps, split[0], split[1]);
+        }
+      g_clear_pointer (&split, g_strfreev);
+    }
+  modulemd_module_stream_v2_add_dependencies (
+    MODULEMD_MODULE_STREAM_V2 (stream), deps);
+
+  g_assert_true (
+    modulemd_module_index_add_module_stream (index, stream, &error));
+  g_assert_no_error (error);
+}
+
+
+static ModulemdModuleStream *
+get_stream (ModulemdModuleIndex *index,
+            const gchar *module_name,
+            const gchar *stream_name)
+{
+  g_autoptr (GError) error = NULL;
+  ModulemdModuleStream *stream = NULL;
+
+  stream = modulemd_module_get_stream_by_NSVCA (
+    modulemd_module_index_get_module (index, module_name),
+    stream_name,
+    1,
+    "c0ffee42",
+    NULL,
+    &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (stream);
+
+  return stream;
+}
+
+
+static void
+assert_nsvcas (GPtrArray *streams, const gchar **expected)
+{
+  g_autofree gchar *ns = NULL;
+  ModulemdModuleStream *stream = NULL;
+
+  g_assert_cmpuint (streams->len, ==, g_strv_length ((gchar **)expected));
+  for (guint i = 0; i < streams->len; i++)
+    {
+      stream = g_ptr_array_index (streams, i);
+      ns = g_strdup_printf ("%s:%s",
+                            modulemd_module_stream_get_module_name (stream),
+                            modulemd_module_stream_get_stream_name (stream));
+      g_assert_cmpstr (ns, ==, expected[i]);
+      g_clear_pointer (&ns, g_free);
+    }
+}
+
+
+static ModulemdModuleIndex *
+create_index (void)
+{
+  ModulemdModuleIndex *index = modulemd_module_index_new ();
+  const gchar *platform[] = { "platform:", NULL };
+  const gchar *f32[] = { "platform:f32", NULL };
+  const gchar *not_10[] = { "nodejs:-10", NULL };
+  const gchar *only_10[] = { "nodejs:10", NULL };
+
+  add_stream (index, "platform", "f32", NULL, NULL);
+  add_stream (index, "nodejs", "10", platform, platform);
+  add_stream (index, "nodejs", "12", f32, f32);
+  add_stream (index, "app", "1", not_10, only_10);
+
+  return index;
+}
+
+
+static void
+dependency_graph_test_requirements (void)
+{
+  g_autoptr (ModulemdModuleIndex) index = create_index ();
+  g_autoptr (ModulemdDependencyGraph) graph = NULL;
+  g_autoptr (GPtrArray) streams = NULL;
+  ModulemdModuleStream *app = NULL;
+  const gchar *all[] = {
+    "app:1", "nodejs:10", "nodejs:12", "platform:f32", NULL
+  };
+  const gchar *runtime[] = { "nodejs:12", NULL };
+  const gchar *buildtime[] = { "nodejs:10", NULL };
+  const gchar *both[] = { "nodejs:10", "nodejs:12", NULL };
+  const gchar *install[] = { "nodejs:12", "platform:f32", NULL };
+  const gchar *buildroot[] = { "nodejs:10", "platform:f32", NULL };
+  const gchar *none[] = { NULL };
+
+  graph = modulemd_dependency_graph_new (index);
+  assert_nsvcas (modulemd_dependency_graph_get_streams (graph), all);
+
+  app = get_stream (index, "app", "1");
+
+  /* Negated and empty stream sets are expanded */
+  streams = modulemd_dependency_graph_get_requirements (
+    graph, app, MODULEMD_DEPENDENCY_TYPE_RUNTIME);
+  assert_nsvcas (streams, runtime);
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  streams = modulemd_dependency_graph_get_requirements (
+    graph, app, MODULEMD_DEPENDENCY_TYPE_BUILDTIME);
+  assert_nsvcas (streams, buildtime);
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  streams = modulemd_dependency_graph_get_requirements (
+    graph, app, MODULEMD_DEPENDENCY_TYPE_ALL);
+  assert_nsvcas (streams, both);
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  streams = modulemd_dependency_graph_get_requirements (
+    graph,
+    get_stream (index, "platform", "f32"),
+    MODULEMD_DEPENDENCY_TYPE_ALL);
+  assert_nsvcas (streams, none);
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  /* The buildroot holds the run-time requirements of build requirements */
+  streams = modulemd_dependency_graph_get_transitive_requirements (
+    graph, app, MODULEMD_DEPENDENCY_TYPE_RUNTIME);
+  assert_nsvcas (streams, install);
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  streams = modulemd_dependency_graph_get_transitive_requirements (
+    graph, app, MODULEMD_DEPENDENCY_TYPE_BUILDTIME);
+  assert_nsvcas (streams, buildroot);
+  g_clear_pointer (&streams, g_ptr_array_unref);
+}
+
+
+static void
+dependency_graph_test_topological_order (void)
+{
+  g_autoptr (ModulemdModuleIndex) index = create_index ();
+  g_autoptr (ModulemdDependencyGraph) graph = NULL;
+  g_autoptr (GPtrArray) order = NULL;
+  g_autoptr (GPtrArray) cycles = NULL;
+  g_autoptr (GError) error = NULL;
+  const gchar *expected[] = {
+    "platform:f32", "nodejs:10", "nodejs:12", "app:1", NULL
+  };
+
+  graph = modulemd_dependency_graph_new (index);
+
+  order = modulemd_dependency_graph_get_topological_order (
+    graph, MODULEMD_DEPENDENCY_TYPE_ALL, &error);
+  g_assert_no_error (error);
+  assert_nsvcas (order, expected);
+
+  cycles =
+    modulemd_dependency_graph_get_cycles (graph, MODULEMD_DEPENDENCY_TYPE_ALL);
+  g_assert_cmpuint (cycles->len, ==, 0);
+}
+
+
+static void
+dependency_graph_test_cycles (void)
+{
+  g_autoptr (ModulemdModuleIndex) index = create_index ();
+  g_autoptr (ModulemdDependencyGraph) graph = NULL;
+  g_autoptr (GPtrArray) order = NULL;
+  g_autoptr (GPtrArray) cycles = NULL;
+  g_autoptr (GError) error = NULL;
+  const gchar *needs_y[] = { "y:1", NULL };
+  const gchar *needs_x[] = { "x:1", NULL };
+  const gchar *cycle[] = { "x:1", "y:1", NULL };
+
+  /* x and y only need each other to be built */
+  add_stream (index, "x", "1", NULL, needs_y);
+  add_stream (index, "y", "1", NULL, needs_x);
+  graph = modulemd_dependency_graph_new (index);
+
+  order = modulemd_dependency_graph_get_topological_order (
+    graph, MODULEMD_DEPENDENCY_TYPE_RUNTIME, &error);
+  g_assert_no_error (error);
+  g_assert_cmpuint (order->len, ==, 6);
+  g_clear_pointer (&order, g_ptr_array_unref);
+
+  order = modulemd_dependency_graph_get_topological_order (
+    graph, MODULEMD_DEPENDENCY_TYPE_BUILDTIME, &error);
+  g_assert_error (error, MODULEMD_ERROR, MODULEMD_ERROR_VALIDATE);
+  g_assert_null (order);
+
+  cycles = modulemd_dependency_graph_get_cycles (
+    graph, MODULEMD_DEPENDENCY_TYPE_BUILDTIME);
+  g_assert_cmpuint (cycles->len, ==, 1);
+  assert_nsvcas (g_ptr_array_index (cycles, 0), cycle);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  setlocale (LC_ALL, "");
+
+  g_test_init (&argc, &argv, NULL);
+  g_test_bug_base ("https://bugzilla.redhat.com/show_bug.cgi?id=");
+
+  // Define the tests.
+
+  g_test_add_func ("/modulemd/v2/dependency_graph/requirements",
+                   dependency_graph_test_requirements);
+
+  g_test_add_func ("/modulemd/v2/dependency_graph/topological_order",
+                   dependency_graph_test_topological_order);
+
+  g_test_add_func ("/modulemd/v2/dependency_graph/cycles",
+                   dependency_graph_test_cycles);
+
+  return g_test_run ();
+}
@@ -490,6 +490,74 @@ modulemd_test_remove_streams (void)
 }
 
 
+
+static void
+modulemd_test_stream_lookup (void)
+{
+  g_autoptr (ModulemdModule) m = NULL;
+  g_autoptr (ModulemdModuleStream) stream = NULL;
+  g_autoptr (GPtrArray) matches = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdModuleStream *found = NULL;
+  guint64 version;
+
+  m = modulemd_module_new ("testmodule");
+
+  for (version = 1; version <= 200; version++)
+    {
+      stream = modulemd_module_stream_new (2, "testmodule", "stream1");
+      modulemd_module_stream_set_version (stream, version);
+      modulemd_module_stream_set_context (stream, "c0ffee42");
+      modulemd_module_stream_set_arch (stream, "x86_64");
+      g_assert_cmpint (
+        modulemd_module_add_stream (
+          m, stream, MD_MODULESTREAM_VERSION_UNSET, &error),
+        ==,
+        MD_MODULESTREAM_VERSION_TWO);
+      g_assert_no_error (error);
+      g_clear_object (&stream);
+    }
+  g_assert_cmpuint (modulemd_module_get_all_streams (m)->len, ==, 200);
+
+  /* Exact lookups */
+  found = modulemd_module_get_stream_by_NSVCA (
+    m, "stream1", 150, "c0ffee42", "x86_64", &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (found);
+  g_assert_cmpuint (modulemd_module_stream_get_version (found), ==, 150);
+
+  found = modulemd_module_get_stream_by_NSVCA (
+    m, "stream1", 150, "c0ffee42", "aarch64", &error);
+  g_assert_error (error, MODULEMD_ERROR, MODULEMD_ERROR_NO_MATCHES);
+  g_assert_null (found);
+  g_clear_error (&error);
+
+  /* Lookups with wildcards still see every stream */
+  matches =
+    modulemd_module_search_streams (m, "stream1", 0, "c0ffee42", NULL);
+  g_assert_cmpuint (matches->len, ==, 200);
+  g_assert_cmpuint (
+    modulemd_module_stream_get_version (g_ptr_array_index (matches, 0)),
+    ==,
+    200);
+  g_clear_pointer (&matches, g_ptr_array_unref);
+
+  /* A stream that was changed after it was added can still be removed */
+  found = modulemd_module_get_stream_by_NSVCA (
+    m, "stream1", 7, "c0ffee42", "x86_64", &error);
+  g_assert_no_error (error);
+  modulemd_module_stream_set_arch (found, "s390x");
+  modulemd_module_remove_streams_by_NSVCA (
+    m, "stream1", 7, "c0ffee42", "s390x");
+  g_assert_cmpuint (modulemd_module_get_all_streams (m)->len, ==, 199);
+
+  modulemd_module_remove_streams_by_NSVCA (
+    m, "stream1", 8, "c0ffee42", "x86_64");
+  g_assert_cmpuint (modulemd_module_get_all_streams (m)->len, ==, 198);
+  g_assert_null (modulemd_module_get_stream_by_NSVCA (
+    m, "stream1", 8, "c0ffee42", "x86_64", NULL));
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -531,5 +599,8 @@ main (int argc, char *argv[])
   g_test_add_func ("/modulemd/v2/module/streams/remove",
                    modulemd_test_remove_streams);
 
+  g_test_add_func ("/modulemd/v2/module/streams/lookup",
+                   modulemd_test_stream_lookup);
+
   return g_test_run ();
 }
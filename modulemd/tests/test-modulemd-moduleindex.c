@@ -18,6 +18,7 @@
 #include <yaml.h>
 
 #include "config.h"
+#include "modulemd-defaults-v1.h"
 #include "modulemd-defaults.h"
 #include "modulemd-module-index.h"
 #include "modulemd-module-stream-v1.h"
@@ -332,6 +333,578 @@ module_index_test_read_unknown (ModuleIndexFixture *fixture,
 }
 
 
+static void
+module_index_test_read_out_of_order (ModuleIndexFixture *fixture,
+                                     gconstpointer user_data)
+{
+  g_autoptr (ModulemdModuleIndex) index = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdSubdocumentInfo *subdoc = NULL;
+  const gchar *yaml_string =
+    "---\n"
+    "data:\n"
+    "  module: foo\n"
+    "  stream: \"x\"\n"
+    "document: modulemd-defaults\n"
+    "version: 1\n"
+    "...\n"
+    "---\n"
+    "# Ünïcödé comment\n"
+    "document: modulemd\n"
+    "version: 2\n"
+    "data: foobar\n"
+    "...\n"
+    "---\n"
+    "document: modulemd-defaults\n"
+    "version: 1\n"
+    "data:\n"
+    "  module: bar\n"
+    "...\n";
+
+  index = modulemd_module_index_new ();
+
+  /* The first document puts its data section before the document type and
+   * the second one fails part-way through. Both must be handled without
+   * losing track of the documents that follow them.
+   */
+  g_assert_false (modulemd_module_index_update_from_string (
+    index, yaml_string, TRUE, &failures, &error));
+  g_assert_no_error (error);
+  g_assert_cmpint (failures->len, ==, 1);
+
+  subdoc = g_ptr_array_index (failures, 0);
+  g_assert_nonnull (modulemd_subdocument_info_get_gerror (subdoc));
+  g_assert_cmpstr (modulemd_subdocument_info_get_yaml (subdoc),
+                   ==,
+                   "---\n"
+                   "document: modulemd\n"
+                   "version: 2\n"
+                   "data: foobar\n"
+                   "...\n");
+
+  g_assert_nonnull (modulemd_module_index_get_module (index, "foo"));
+  g_assert_nonnull (modulemd_module_index_get_module (index, "bar"));
+}
+
+
+static void
+compare_parallel_read (const gchar *filename)
+{
+  g_autoptr (ModulemdModuleIndex) serial = NULL;
+  g_autoptr (ModulemdModuleIndex) parallel = NULL;
+  g_autoptr (GPtrArray) serial_failures = NULL;
+  g_autoptr (GPtrArray) parallel_failures = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *yaml_path = NULL;
+  g_autofree gchar *serial_output = NULL;
+  g_autofree gchar *parallel_output = NULL;
+  gboolean serial_passed;
+  gboolean parallel_passed;
+  ModulemdSubdocumentInfo *expected = NULL;
+  ModulemdSubdocumentInfo *actual = NULL;
+  guint i;
+
+  yaml_path =
+    g_strdup_printf ("%s/%s", g_getenv ("TEST_DATA_PATH"), filename);
+
+  serial = modulemd_module_index_new ();
+  g_assert_cmpuint (modulemd_module_index_get_parse_threads (serial), ==, 1);
+  serial_passed = modulemd_module_index_update_from_file (
+    serial, yaml_path, TRUE, &serial_failures, &error);
+  g_assert_no_error (error);
+
+  parallel = modulemd_module_index_new ();
+  modulemd_module_index_set_parse_threads (parallel, 4);
+  parallel_passed = modulemd_module_index_update_from_file (
+    parallel, yaml_path, TRUE, &parallel_failures, &error);
+  g_assert_no_error (error);
+
+  /* The results must not depend on how the file was parsed */
+  g_assert_cmpint (serial_passed, ==, parallel_passed);
+  g_assert_cmpuint (serial_failures->len, ==, parallel_failures->len);
+  for (i = 0; i < serial_failures->len; i++)
+    {
+      expected = g_ptr_array_index (serial_failures, i);
+      actual = g_ptr_array_index (parallel_failures, i);
+
+      g_assert_cmpstr (modulemd_subdocument_info_get_yaml (expected),
+                       ==,
+                       modulemd_subdocument_info_get_yaml (actual));
+      g_assert_cmpstr (
+        modulemd_subdocument_info_get_gerror (expected)->message,
+        ==,
+        modulemd_subdocument_info_get_gerror (actual)->message);
+    }
+
+  serial_output = modulemd_module_index_dump_to_string (serial, NULL);
+  parallel_output = modulemd_module_index_dump_to_string (parallel, NULL);
+  g_assert_cmpstr (serial_output, ==, parallel_output);
+}
+
+
+static void
+module_index_test_read_parallel (ModuleIndexFixture *fixture,
+                                 gconstpointer user_data)
+{
+  compare_parallel_read ("f29.yaml");
+  compare_parallel_read ("long-valid.yaml");
+  compare_parallel_read ("good-v2-extra-keys.yaml");
+}
+
+
+static const gchar *
+get_first_stream_arch (ModulemdModuleIndex *index, const gchar *module_name)
+{
+  ModulemdModule *module = NULL;
+
+  module = modulemd_module_index_get_module (index, module_name);
+  g_assert_nonnull (module);
+
+  return modulemd_module_stream_get_arch (
+    g_ptr_array_index (modulemd_module_get_all_streams (module), 0));
+}
+
+
+static void
+module_index_test_read_shared_strings (ModuleIndexFixture *fixture,
+                                       gconstpointer user_data)
+{
+  g_autoptr (ModulemdModuleIndex) index = NULL;
+  g_autoptr (ModulemdModuleIndex) other = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *yaml_path = NULL;
+  const gchar *arch = NULL;
+
+  yaml_path = g_strdup_printf ("%s/f29.yaml", g_getenv ("TEST_DATA_PATH"));
+
+  index = modulemd_module_index_new ();
+  g_assert_true (modulemd_module_index_update_from_file (
+    index, yaml_path, TRUE, &failures, &error));
+  g_assert_no_error (error);
+  g_clear_pointer (&failures, g_ptr_array_unref);
+
+  other = modulemd_module_index_new ();
+  g_assert_true (modulemd_module_index_update_from_file (
+    other, yaml_path, TRUE, &failures, &error));
+  g_assert_no_error (error);
+
+  /* The streams of an index share one copy of each string */
+  arch = get_first_stream_arch (index, "testmodule");
+  g_assert_cmpstr (arch, ==, "x86_64");
+  g_assert_true (arch == get_first_stream_arch (index, "stratis"));
+  g_assert_true (arch == get_first_stream_arch (index, "scala"));
+
+  /* But not with the streams of other indexes */
+  g_assert_cmpstr (get_first_stream_arch (other, "testmodule"), ==, arch);
+  g_assert_true (arch != get_first_stream_arch (other, "testmodule"));
+}
+
+
+static void
+compare_parallel_dump (const gchar *filename)
+{
+  g_autoptr (ModulemdModuleIndex) idx = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *yaml_path = NULL;
+  g_autofree gchar *serial_output = NULL;
+  g_autofree gchar *parallel_output = NULL;
+  g_autofree gchar *tmpdir = NULL;
+  g_autofree gchar *base_path = NULL;
+  g_autofree gchar *written_path = NULL;
+  g_autofree gchar *file_output = NULL;
+
+  yaml_path =
+    g_strdup_printf ("%s/%s", g_getenv ("TEST_DATA_PATH"), filename);
+
+  idx = modulemd_module_index_new ();
+  g_assert_true (modulemd_module_index_update_from_file (
+    idx, yaml_path, TRUE, &failures, &error));
+  g_assert_no_error (error);
+
+  g_assert_cmpuint (modulemd_module_index_get_emit_threads (idx), ==, 1);
+  serial_output = modulemd_module_index_dump_to_string (idx, &error);
+  g_assert_no_error (error);
+
+  /* The output must not depend on how it was emitted */
+  modulemd_module_index_set_emit_threads (idx, 4);
+  parallel_output = modulemd_module_index_dump_to_string (idx, &error);
+  g_assert_no_error (error);
+  g_assert_cmpstr (serial_output, ==, parallel_output);
+
+  tmpdir = g_dir_make_tmp ("modulemd-dump-XXXXXX", &error);
+  g_assert_no_error (error);
+  base_path = g_build_path ("/", tmpdir, "index.yaml", NULL);
+
+  written_path = modulemd_module_index_dump_to_file (
+    idx, base_path, MODULEMD_COMPRESSION_TYPE_NO_COMPRESSION, 0, &error);
+  g_assert_no_error (error);
+  g_assert_true (g_file_get_contents (written_path, &file_output, NULL, NULL));
+  g_assert_cmpstr (serial_output, ==, file_output);
+
+  g_assert_cmpint (g_unlink (written_path), ==, 0);
+  g_assert_cmpint (g_rmdir (tmpdir), ==, 0);
+}
+
+
+static void
+module_index_test_dump_parallel (ModuleIndexFixture *fixture,
+                                 gconstpointer user_data)
+{
+  compare_parallel_dump ("f29.yaml");
+  compare_parallel_dump ("long-valid.yaml");
+}
+
+
+static void
+compare_lazy_read (const gchar *filename)
+{
+  g_autoptr (ModulemdModuleIndex) eager = NULL;
+  g_autoptr (ModulemdModuleIndex) lazy = NULL;
+  g_autoptr (GPtrArray) eager_failures = NULL;
+  g_autoptr (GPtrArray) lazy_failures = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *yaml_path = NULL;
+  g_autofree gchar *eager_output = NULL;
+  g_autofree gchar *lazy_output = NULL;
+  g_auto (GStrv) module_names = NULL;
+  g_auto (GStrv) eager_streams = NULL;
+  g_auto (GStrv) lazy_streams = NULL;
+  g_autoptr (GPtrArray) eager_list = NULL;
+  g_autoptr (GPtrArray) lazy_list = NULL;
+  ModulemdModule *eager_module = NULL;
+  ModulemdModule *lazy_module = NULL;
+  gboolean eager_passed;
+  gboolean lazy_passed;
+  guint i;
+
+  yaml_path =
+    g_strdup_printf ("%s/%s", g_getenv ("TEST_DATA_PATH"), filename);
+
+  eager = modulemd_module_index_new ();
+  eager_passed = modulemd_module_index_update_from_file (
+    eager, yaml_path, TRUE, &eager_failures, &error);
+  g_assert_no_error (error);
+
+  lazy = modulemd_module_index_new ();
+  g_assert_false (modulemd_module_index_get_lazy_streams (lazy));
+  modulemd_module_index_set_lazy_streams (lazy, TRUE);
+  lazy_passed = modulemd_module_index_update_from_file (
+    lazy, yaml_path, TRUE, &lazy_failures, &error);
+  g_assert_no_error (error);
+  g_assert_cmpint (lazy_passed, ==, eager_passed);
+  g_assert_cmpuint (lazy_failures->len, ==, eager_failures->len);
+
+  /* Stream names are known without parsing the streams */
+  module_names = modulemd_module_index_get_module_names_as_strv (lazy);
+  for (i = 0; module_names[i] != NULL; i++)
+    {
+      eager_module =
+        modulemd_module_index_get_module (eager, module_names[i]);
+      lazy_module = modulemd_module_index_get_module (lazy, module_names[i]);
+      g_assert_nonnull (eager_module);
+
+      eager_streams = modulemd_module_get_stream_names_as_strv (eager_module);
+      lazy_streams = modulemd_module_get_stream_names_as_strv (lazy_module);
+      g_assert_cmpuint (
+        g_strv_length (eager_streams), ==, g_strv_length (lazy_streams));
+      if (eager_streams[0] != NULL)
+        {
+          g_assert_cmpstr (eager_streams[0], ==, lazy_streams[0]);
+          eager_list = modulemd_module_get_streams_by_stream_name_as_list (
+            eager_module, eager_streams[0]);
+          lazy_list = modulemd_module_get_streams_by_stream_name_as_list (
+            lazy_module, lazy_streams[0]);
+          g_assert_cmpuint (eager_list->len, ==, lazy_list->len);
+        }
+
+      g_clear_pointer (&eager_streams, g_strfreev);
+      g_clear_pointer (&lazy_streams, g_strfreev);
+      g_clear_pointer (&eager_list, g_ptr_array_unref);
+      g_clear_pointer (&lazy_list, g_ptr_array_unref);
+    }
+
+  eager_output = modulemd_module_index_dump_to_string (eager, &error);
+  g_assert_no_error (error);
+  lazy_output = modulemd_module_index_dump_to_string (lazy, &error);
+  g_assert_no_error (error);
+  g_assert_cmpstr (eager_output, ==, lazy_output);
+}
+
+
+static void
+module_index_test_read_lazy (ModuleIndexFixture *fixture,
+                             gconstpointer user_data)
+{
+  g_autoptr (ModulemdModuleIndex) index = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autoptr (GPtrArray) streams = NULL;
+  ModulemdModule *module = NULL;
+  const gchar *yaml_str = NULL;
+
+  compare_lazy_read ("f29.yaml");
+  compare_lazy_read ("long-valid.yaml");
+
+  /* A v1 stream read before a v2 one is upgraded once it is parsed, a
+   * stream that fails validation is dropped when it is first needed and
+   * reported later, and the streams keep the order of the document however
+   * they are parsed.
+   */
+  yaml_str = "---\n"
+             "document: modulemd\n"
+             "version: 1\n"
+             "data:\n"
+             "  name: foo\n"
+             "  stream: latest\n"
+             "  version: 1\n"
+             "  context: c0ffee42\n"
+             "  summary: A test module\n"
+             "  description: A test module in all its beauty.\n"
+             "  license:\n"
+             "    module: [MIT]\n"
+             "...\n"
+             "---\n"
+             "document: modulemd\n"
+             "version: 2\n"
+             "data:\n"
+             "  name: bar\n"
+             "  stream: latest\n"
+             "  version: 2\n"
+             "  context: c0ffee43\n"
+             "  summary: Another test module\n"
+             "  description: Another test module in all its beauty.\n"
+             "  license:\n"
+             "    module: [MIT]\n"
+             "...\n"
+             "---\n"
+             "document: modulemd\n"
+             "version: 2\n"
+             "data:\n"
+             "  name: bar\n"
+             "  stream: broken\n"
+             "  version: 3\n"
+             "...\n"
+             "---\n"
+             "document: modulemd\n"
+             "version: 2\n"
+             "data:\n"
+             "  name: bar\n"
+             "  stream: other\n"
+             "  version: 4\n"
+             "  context: c0ffee44\n"
+             "  summary: Yet another test module\n"
+             "  description: Yet another test module in all its beauty.\n"
+             "  license:\n"
+             "    module: [MIT]\n"
+             "...\n";
+
+  index = modulemd_module_index_new ();
+  modulemd_module_index_set_lazy_streams (index, TRUE);
+  g_assert_true (modulemd_module_index_update_from_string (
+    index, yaml_str, TRUE, &failures, &error));
+  g_assert_no_error (error);
+  g_assert_cmpuint (failures->len, ==, 0);
+  g_assert_cmpint (modulemd_module_index_get_stream_mdversion (index),
+                   ==,
+                   MD_MODULESTREAM_VERSION_TWO);
+
+  module = modulemd_module_index_get_module (index, "foo");
+  g_assert_nonnull (module);
+  g_assert_cmpuint (modulemd_module_get_all_streams (module)->len, ==, 1);
+  g_assert_cmpint (
+    modulemd_module_stream_get_mdversion (
+      g_ptr_array_index (modulemd_module_get_all_streams (module), 0)),
+    ==,
+    MD_MODULESTREAM_VERSION_TWO);
+
+  module = modulemd_module_index_get_module (index, "bar");
+  g_assert_nonnull (module);
+  streams = modulemd_module_search_streams (module, "other", 0, NULL, NULL);
+  g_assert_cmpuint (streams->len, ==, 1);
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  /* Lookups by part of the NSVCA only match streams of that name */
+  streams = modulemd_module_search_streams (module, "latest", 2, NULL, NULL);
+  g_assert_cmpuint (streams->len, ==, 1);
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  streams =
+    modulemd_module_search_streams (module, "latest", 0, "c0ffee44", NULL);
+  g_assert_cmpuint (streams->len, ==, 0);
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  streams = modulemd_module_search_streams (module, "missing", 0, NULL, NULL);
+  g_assert_cmpuint (streams->len, ==, 0);
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  streams = g_ptr_array_ref (modulemd_module_get_all_streams (module));
+  g_assert_cmpuint (streams->len, ==, 2);
+  g_assert_cmpstr (modulemd_module_stream_get_stream_name (
+                     g_ptr_array_index (streams, 0)),
+                   ==,
+                   "latest");
+  g_assert_cmpstr (modulemd_module_stream_get_stream_name (
+                     g_ptr_array_index (streams, 1)),
+                   ==,
+                   "other");
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  /* The stream that was dropped is reported, even though it was parsed
+   * before
+   */
+  g_clear_pointer (&failures, g_ptr_array_unref);
+  g_assert_false (modulemd_module_index_load_lazy_streams (index, &failures));
+  g_assert_cmpuint (failures->len, ==, 1);
+  g_assert_nonnull (modulemd_subdocument_info_get_gerror (
+    g_ptr_array_index (failures, 0)));
+}
+
+
+static void
+module_index_test_read_lazy_escaped (ModuleIndexFixture *fixture,
+                                     gconstpointer user_data)
+{
+  g_autoptr (ModulemdModuleIndex) index = NULL;
+  g_autoptr (ModulemdModule) module = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GPtrArray) streams = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdModuleStream *stream = NULL;
+  const gchar *yaml_str = NULL;
+
+  yaml_str = "---\n"
+             "document: modulemd\n"
+             "version: 2\n"
+             "data:\n"
+             "  name: foo\n"
+             "  stream: latest\n"
+             "  version: 1\n"
+             "  context: c0ffee42\n"
+             "  arch: x86_64\n"
+             "  summary: A test module\n"
+             "  description: A test module in all its beauty.\n"
+             "  license:\n"
+             "    module: [MIT]\n"
+             "...\n"
+             "---\n"
+             "document: modulemd\n"
+             "version: 2\n"
+             "data:\n"
+             "  name: foo\n"
+             "  stream: other\n"
+             "  version: 2\n"
+             "  context: c0ffee43\n"
+             "  arch: x86_64\n"
+             "  summary: Another test module\n"
+             "  description: Another test module in all its beauty.\n"
+             "  license:\n"
+             "    module: [MIT]\n"
+             "...\n";
+
+  index = modulemd_module_index_new ();
+  modulemd_module_index_set_lazy_streams (index, TRUE);
+  g_assert_true (modulemd_module_index_update_from_string (
+    index, yaml_str, TRUE, &failures, &error));
+  g_assert_no_error (error);
+
+  /* A module that outlives its index keeps its unparsed streams, even
+   * though their headers were allocated in the index
+   */
+  module = g_object_ref (modulemd_module_index_get_module (index, "foo"));
+  g_clear_object (&index);
+
+  stream = modulemd_module_get_stream_by_NSVCA (
+    module, "other", 2, "c0ffee43", "x86_64", &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (stream);
+  g_assert_cmpstr (modulemd_module_stream_v2_get_summary (
+                     MODULEMD_MODULE_STREAM_V2 (stream), "C"),
+                   ==,
+                   "Another test module");
+
+  streams = modulemd_module_search_streams (module, "latest", 0, NULL, NULL);
+  g_assert_cmpuint (streams->len, ==, 1);
+  g_clear_pointer (&streams, g_ptr_array_unref);
+
+  g_assert_cmpuint (modulemd_module_get_all_streams (module)->len, ==, 2);
+}
+
+
+static void
+assert_stream_names (ModulemdModule *module, const gchar **expected)
+{
+  GPtrArray *streams = modulemd_module_get_all_streams (module);
+
+  g_assert_cmpuint (streams->len, ==, g_strv_length ((gchar **)expected));
+  for (guint i = 0; i < streams->len; i++)
+    {
+      g_assert_cmpstr (modulemd_module_stream_get_stream_name (
+                         g_ptr_array_index (streams, i)),
+                       ==,
+                       expected[i]);
+    }
+}
+
+
+static void
+add_named_stream (ModulemdModuleIndex *index, const gchar *stream_name)
+{
+  g_autoptr (ModulemdModuleStreamV2) stream = NULL;
+  g_autoptr (GError) error = NULL;
+
+  stream = modulemd_module_stream_v2_new ("foo", stream_name);
+  modulemd_module_stream_set_version (MODULEMD_MODULE_STREAM (stream), 1);
+  modulemd_module_stream_set_context (MODULEMD_MODULE_STREAM (stream),
+                                      "c0ffee42");
+  modulemd_module_stream_v2_set_summary (stream, "A test stream");
+  modulemd_module_stream_v2_set_description (stream, "A test stream.");
+  modulemd_module_stream_v2_add_module_license (stream, "MIT");
+
+  g_assert_true (modulemd_module_index_add_module_stream (
+    index, MODULEMD_MODULE_STREAM (stream), &error));
+  g_assert_no_error (error);
+}
+
+
+static void
+module_index_test_dump_keeps_order (ModuleIndexFixture *fixture,
+                                    gconstpointer user_data)
+{
+  g_autoptr (ModulemdModuleIndex) index = NULL;
+  g_autoptr (GBytes) binary = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *yaml = NULL;
+  ModulemdModule *module = NULL;
+  const gchar *read_order[] = { "zeta", "alpha", NULL };
+  const gchar *added_order[] = { "zeta", "alpha", "mu", NULL };
+
+  index = modulemd_module_index_new ();
+  for (guint i = 0; read_order[i]; i++)
+    {
+      add_named_stream (index, read_order[i]);
+    }
+  module = modulemd_module_index_get_module (index, "foo");
+
+  /* Dumping sorts the output, but not the streams of the module */
+  yaml = modulemd_module_index_dump_to_string (index, &error);
+  g_assert_nonnull (yaml);
+  g_assert_no_error (error);
+  assert_stream_names (module, read_order);
+
+  binary = modulemd_module_index_dump_to_binary (index, &error);
+  g_assert_nonnull (binary);
+  g_assert_no_error (error);
+  assert_stream_names (module, read_order);
+
+  /* Streams added afterwards still go after the existing ones */
+  add_named_stream (index, "mu");
+  assert_stream_names (module, added_order);
+}
+
+
 static void
 module_index_test_stream_upgrade (ModuleIndexFixture *fixture,
                                   gconstpointer user_data)
@@ -691,50 +1264,550 @@ module_index_test_remove_module (ModuleIndexFixture *fixture,
 }
 
 
-struct custom_string
+static void
+module_index_test_adopt_stream (ModuleIndexFixture *fixture,
+                                gconstpointer user_data)
 {
-  gchar *string;
-  gchar *current;
-};
+  g_autoptr (ModulemdModuleIndex) index = NULL;
+  g_autoptr (ModulemdModuleStream) stream = NULL;
+  g_autoptr (ModulemdModuleStream) copy = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdModule *module = NULL;
+  GPtrArray *streams = NULL;
 
-static int
-custom_string_read_handler (void *data,
-                            unsigned char *buffer,
-                            size_t size,
-                            size_t *size_read)
-{
-  struct custom_string *custom = (struct custom_string *)data;
-  const gchar *end = custom->string + strlen (custom->string);
+  index = modulemd_module_index_new ();
 
-  if (custom->current == end)
-    {
-      *size_read = 0;
-      return 1;
-    }
+  stream =
+    modulemd_module_stream_new (MD_MODULESTREAM_VERSION_TWO, "foo", "bar");
+  modulemd_module_stream_set_version (stream, 42);
+  modulemd_module_stream_set_context (stream, "c0ffee42");
 
-  if (size > (size_t) (end - custom->current))
-    {
-      size = end - custom->current;
-    }
+  /* The index holds the stream itself rather than a copy */
+  g_assert_true (
+    modulemd_module_index_adopt_module_stream (index, stream, &error));
+  g_assert_no_error (error);
 
-  memcpy (buffer, custom->current, size);
-  custom->current += size;
-  *size_read = size;
-  return 1;
+  module = modulemd_module_index_get_module (index, "foo");
+  g_assert_nonnull (module);
+  streams = modulemd_module_get_all_streams (module);
+  g_assert_cmpuint (streams->len, ==, 1);
+  g_assert_true (g_ptr_array_index (streams, 0) == stream);
+
+  /* Adopting the same object again leaves it in place */
+  g_assert_true (
+    modulemd_module_index_adopt_module_stream (index, stream, &error));
+  g_assert_no_error (error);
+  streams = modulemd_module_get_all_streams (module);
+  g_assert_cmpuint (streams->len, ==, 1);
+  g_assert_true (g_ptr_array_index (streams, 0) == stream);
+
+  /* An equal stream added the usual way replaces it with a copy */
+  copy = modulemd_module_stream_copy (stream, NULL, NULL);
+  g_assert_true (
+    modulemd_module_index_add_module_stream (index, copy, &error));
+  g_assert_no_error (error);
+  streams = modulemd_module_get_all_streams (module);
+  g_assert_cmpuint (streams->len, ==, 1);
+  g_assert_true (g_ptr_array_index (streams, 0) != stream);
+  g_assert_true (g_ptr_array_index (streams, 0) != copy);
+  g_assert_true (
+    modulemd_module_stream_equals (g_ptr_array_index (streams, 0), stream));
 }
 
 
+
 static void
-module_index_test_custom_read (ModuleIndexFixture *fixture,
-                               gconstpointer user_data)
+add_search_stream (ModulemdModuleIndex *index,
+                   const gchar *module_name,
+                   const gchar *stream_name,
+                   guint64 version,
+                   const gchar *context,
+                   const gchar *arch)
 {
-  g_autoptr (ModulemdModuleIndex) index = NULL;
-  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (ModulemdModuleStream) stream = NULL;
   g_autoptr (GError) error = NULL;
 
+  stream = modulemd_module_stream_new (
+    MD_MODULESTREAM_VERSION_TWO, module_name, stream_name);
+  modulemd_module_stream_set_version (stream, version);
+  modulemd_module_stream_set_context (stream, context);
+  modulemd_module_stream_set_arch (stream, arch);
 
-  // clang-format off
-  g_autofree gchar *str = g_strdup(
+  g_assert_true (
+    modulemd_module_index_add_module_stream (index, stream, &error));
+  g_assert_no_error (error);
+}
+
+
+static void
+module_index_test_search_streams (ModuleIndexFixture *fixture,
+                                  gconstpointer user_data)
+{
+  g_autoptr (ModulemdModuleIndex) index = NULL;
+  g_autoptr (GPtrArray) matches = NULL;
+  ModulemdModuleStream *stream = NULL;
+
+  index = modulemd_module_index_new ();
+  add_search_stream (index, "foo", "1", 1, "c1", "x86_64");
+  add_search_stream (index, "foo", "1", 2, "c1", "x86_64");
+  add_search_stream (index, "foo", "1", 2, "c2", "aarch64");
+  add_search_stream (index, "foo", "2", 10, "c1", "x86_64");
+  add_search_stream (index, "foobar", "1", 1, "c1", "x86_64");
+  add_search_stream (index, "bar", "1", 1, "c3", "s390x");
+
+  /* No patterns at all returns every stream, ordered by module */
+  matches =
+    modulemd_module_index_search_streams (index, NULL, NULL, NULL, NULL, NULL);
+  g_assert_cmpuint (matches->len, ==, 6);
+  stream = g_ptr_array_index (matches, 0);
+  g_assert_cmpstr (modulemd_module_stream_get_module_name (stream), ==, "bar");
+  g_clear_pointer (&matches, g_ptr_array_unref);
+
+  /* Exact NSVCA */
+  matches = modulemd_module_index_search_streams (
+    index, "foo", "1", "2", "c2", "aarch64");
+  g_assert_cmpuint (matches->len, ==, 1);
+  stream = g_ptr_array_index (matches, 0);
+  g_assert_cmpstr (modulemd_module_stream_get_arch (stream), ==, "aarch64");
+  g_clear_pointer (&matches, g_ptr_array_unref);
+
+  /* Literal fields narrow down the search within a module */
+  matches = modulemd_module_index_search_streams (
+    index, "foo", "1", NULL, "c1", NULL);
+  g_assert_cmpuint (matches->len, ==, 2);
+  stream = g_ptr_array_index (matches, 0);
+  g_assert_cmpuint (modulemd_module_stream_get_version (stream), ==, 2);
+  g_clear_pointer (&matches, g_ptr_array_unref);
+
+  /* Globs on the module name and elsewhere */
+  matches = modulemd_module_index_search_streams (
+    index, "foo*", "1", NULL, NULL, "x86_64");
+  g_assert_cmpuint (matches->len, ==, 3);
+  stream = g_ptr_array_index (matches, 2);
+  g_assert_cmpstr (
+    modulemd_module_stream_get_module_name (stream), ==, "foobar");
+  g_clear_pointer (&matches, g_ptr_array_unref);
+
+  matches = modulemd_module_index_search_streams (
+    index, NULL, NULL, "1?", "c?", NULL);
+  g_assert_cmpuint (matches->len, ==, 1);
+  stream = g_ptr_array_index (matches, 0);
+  g_assert_cmpuint (modulemd_module_stream_get_version (stream), ==, 10);
+  g_clear_pointer (&matches, g_ptr_array_unref);
+
+  /* Nothing matches */
+  matches = modulemd_module_index_search_streams (
+    index, "nosuchmodule", NULL, NULL, NULL, NULL);
+  g_assert_cmpuint (matches->len, ==, 0);
+  g_clear_pointer (&matches, g_ptr_array_unref);
+
+  matches = modulemd_module_index_search_streams (
+    index, "foo", NULL, NULL, "nosuchcontext", NULL);
+  g_assert_cmpuint (matches->len, ==, 0);
+  g_clear_pointer (&matches, g_ptr_array_unref);
+
+  /* Removed streams are no longer found */
+  modulemd_module_remove_streams_by_NSVCA (
+    modulemd_module_index_get_module (index, "foo"), "1", 0, "c1", NULL);
+  matches = modulemd_module_index_search_streams (
+    index, "foo", NULL, NULL, "c1", NULL);
+  g_assert_cmpuint (matches->len, ==, 1);
+  g_clear_pointer (&matches, g_ptr_array_unref);
+}
+
+
+static void
+module_index_test_rpm_artifacts (ModuleIndexFixture *fixture,
+                                 gconstpointer user_data)
+{
+  g_autoptr (ModulemdModuleIndex) index = NULL;
+  g_autoptr (ModulemdModuleStream) stream = NULL;
+  g_autoptr (GPtrArray) owners = NULL;
+  g_autoptr (GHashTable) batch = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdModule *module = NULL;
+  ModulemdModuleStreamV2 *v2_stream = NULL;
+  const gchar *nevras[] = { "bar-1.0-1.x86_64",
+                            "baz-0:2.0-1.noarch",
+                            "nosuchrpm-1.0-1.x86_64",
+                            NULL };
+
+  index = modulemd_module_index_new ();
+
+  stream =
+    modulemd_module_stream_new (MD_MODULESTREAM_VERSION_TWO, "foo", "1");
+  v2_stream = MODULEMD_MODULE_STREAM_V2 (stream);
+  modulemd_module_stream_v2_add_rpm_artifact (v2_stream,
+                                              "bar-0:1.0-1.x86_64");
+  modulemd_module_stream_v2_add_rpm_artifact (v2_stream, "bar-0:1.0-1.i686");
+  modulemd_module_stream_v2_add_rpm_artifact (v2_stream, "baz-2.0-1.noarch");
+  g_assert_true (
+    modulemd_module_index_add_module_stream (index, stream, &error));
+  g_assert_no_error (error);
+  g_clear_object (&stream);
+
+  stream =
+    modulemd_module_stream_new (MD_MODULESTREAM_VERSION_TWO, "foo", "2");
+  modulemd_module_stream_v2_add_rpm_artifact (
+    MODULEMD_MODULE_STREAM_V2 (stream), "bar-0:2.0-1.x86_64");
+  g_assert_true (
+    modulemd_module_index_add_module_stream (index, stream, &error));
+  g_assert_no_error (error);
+  g_clear_object (&stream);
+
+  /* The epoch is optional on both sides */
+  owners = modulemd_module_index_get_streams_by_rpm_artifact (
+    index, "bar-1.0-1.x86_64");
+  g_assert_cmpuint (owners->len, ==, 1);
+  g_assert_cmpstr (modulemd_module_stream_get_stream_name (
+                     g_ptr_array_index (owners, 0)),
+                   ==,
+                   "1");
+  g_clear_pointer (&owners, g_ptr_array_unref);
+
+  owners = modulemd_module_index_get_streams_by_rpm_artifact (
+    index, "baz-0:2.0-1.noarch");
+  g_assert_cmpuint (owners->len, ==, 1);
+  g_clear_pointer (&owners, g_ptr_array_unref);
+
+  /* Lookups by name list each stream once */
+  owners = modulemd_module_index_get_streams_by_rpm_name (index, "bar", NULL);
+  g_assert_cmpuint (owners->len, ==, 2);
+  g_clear_pointer (&owners, g_ptr_array_unref);
+
+  owners =
+    modulemd_module_index_get_streams_by_rpm_name (index, "bar", "i686");
+  g_assert_cmpuint (owners->len, ==, 1);
+  g_clear_pointer (&owners, g_ptr_array_unref);
+
+  batch = modulemd_module_index_get_streams_by_rpm_artifacts (index, nevras);
+  g_assert_cmpuint (g_hash_table_size (batch), ==, 2);
+  g_assert_true (g_hash_table_contains (batch, "bar-1.0-1.x86_64"));
+  g_assert_false (g_hash_table_contains (batch, "nosuchrpm-1.0-1.x86_64"));
+  g_clear_pointer (&batch, g_hash_table_unref);
+
+  /* The tables follow the artifacts of a stream being edited in place */
+  module = modulemd_module_index_get_module (index, "foo");
+  v2_stream = MODULEMD_MODULE_STREAM_V2 (
+    modulemd_module_get_stream_by_NSVCA (module, "2", 0, NULL, NULL, &error));
+  g_assert_no_error (error);
+  modulemd_module_stream_v2_remove_rpm_artifact (v2_stream,
+                                                 "bar-0:2.0-1.x86_64");
+  modulemd_module_stream_v2_add_rpm_artifact (v2_stream, "qux-1.0-1.noarch");
+
+  owners = modulemd_module_index_get_streams_by_rpm_name (index, "bar", NULL);
+  g_assert_cmpuint (owners->len, ==, 1);
+  g_clear_pointer (&owners, g_ptr_array_unref);
+
+  owners = modulemd_module_index_get_streams_by_rpm_name (index, "qux", NULL);
+  g_assert_cmpuint (owners->len, ==, 1);
+  g_assert_cmpstr (modulemd_module_stream_get_stream_name (
+                     g_ptr_array_index (owners, 0)),
+                   ==,
+                   "2");
+  g_clear_pointer (&owners, g_ptr_array_unref);
+
+  /* The tables follow streams being removed from the index */
+  modulemd_module_remove_streams_by_NSVCA (
+    modulemd_module_index_get_module (index, "foo"), "1", 0, NULL, NULL);
+  owners = modulemd_module_index_get_streams_by_rpm_name (index, "bar", NULL);
+  g_assert_cmpuint (owners->len, ==, 0);
+  g_clear_pointer (&owners, g_ptr_array_unref);
+
+  owners = modulemd_module_index_get_streams_by_rpm_name (index, "qux", NULL);
+  g_assert_cmpuint (owners->len, ==, 1);
+  g_clear_pointer (&owners, g_ptr_array_unref);
+
+  g_assert_true (modulemd_module_index_remove_module (index, "foo"));
+  owners = modulemd_module_index_get_streams_by_rpm_name (index, "bar", NULL);
+  g_assert_cmpuint (owners->len, ==, 0);
+  g_clear_pointer (&owners, g_ptr_array_unref);
+}
+
+
+static void
+add_component_stream (ModulemdModuleIndex *index,
+                      const gchar *module_name,
+                      const gchar *stream_name,
+                      const gchar *component_name,
+                      const gchar *repository,
+                      const gchar *ref)
+{
+  g_autoptr (ModulemdModuleStream) stream = NULL;
+  g_autoptr (ModulemdComponentRpm) component = NULL;
+  g_autoptr (GError) error = NULL;
+
+  stream = modulemd_module_stream_new (
+    MD_MODULESTREAM_VERSION_TWO, module_name, stream_name);
+  component = modulemd_component_rpm_new (component_name);
+  modulemd_component_rpm_set_repository (component, repository);
+  modulemd_component_rpm_set_ref (component, ref);
+  modulemd_module_stream_v2_add_component (
+    MODULEMD_MODULE_STREAM_V2 (stream), MODULEMD_COMPONENT (component));
+
+  g_assert_true (
+    modulemd_module_index_add_module_stream (index, stream, &error));
+  g_assert_no_error (error);
+}
+
+
+static void
+module_index_test_rpm_components (ModuleIndexFixture *fixture,
+                                  gconstpointer user_data)
+{
+  g_autoptr (ModulemdModuleIndex) index = NULL;
+  g_autoptr (GPtrArray) owners = NULL;
+  g_autoptr (GHashTable) batch = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdModule *module = NULL;
+  ModulemdModuleStream *stream = NULL;
+  const gchar *names[] = { "openssl", "zlib", "nosuchpackage", NULL };
+  const gchar *repo = "https://src.example.com/rpms/openssl";
+
+  index = modulemd_module_index_new ();
+  add_component_stream (index, "foo", "1", "openssl", repo, "1.1");
+  add_component_stream (index, "bar", "1", "openssl", repo, "3.0");
+  add_component_stream (index, "bar", "2", "zlib", NULL, NULL);
+
+  /* Results are sorted by module name */
+  owners =
+    modulemd_module_index_get_streams_by_rpm_component (index, "openssl");
+  g_assert_cmpuint (owners->len, ==, 2);
+  g_assert_cmpstr (modulemd_module_stream_get_module_name (
+                     g_ptr_array_index (owners, 0)),
+                   ==,
+                   "bar");
+  g_clear_pointer (&owners, g_ptr_array_unref);
+
+  owners = modulemd_module_index_get_streams_by_rpm_component_source (
+    index, repo, NULL);
+  g_assert_cmpuint (owners->len, ==, 2);
+  g_clear_pointer (&owners, g_ptr_array_unref);
+
+  owners = modulemd_module_index_get_streams_by_rpm_component_source (
+    index, repo, "1.1");
+  g_assert_cmpuint (owners->len, ==, 1);
+  g_assert_cmpstr (modulemd_module_stream_get_module_name (
+                     g_ptr_array_index (owners, 0)),
+                   ==,
+                   "foo");
+  g_clear_pointer (&owners, g_ptr_array_unref);
+
+  batch = modulemd_module_index_get_streams_by_rpm_components (index, names);
+  g_assert_cmpuint (g_hash_table_size (batch), ==, 2);
+  g_assert_cmpuint (
+    ((GPtrArray *)g_hash_table_lookup (batch, "zlib"))->len, ==, 1);
+  g_clear_pointer (&batch, g_hash_table_unref);
+
+  /* Components edited in place after the first lookup are picked up */
+  module = modulemd_module_index_get_module (index, "foo");
+  stream =
+    modulemd_module_get_stream_by_NSVCA (module, "1", 0, NULL, NULL, &error);
+  g_assert_no_error (error);
+  modulemd_component_rpm_set_ref (
+    modulemd_module_stream_v2_get_rpm_component (
+      MODULEMD_MODULE_STREAM_V2 (stream), "openssl"),
+    "1.2");
+
+  owners = modulemd_module_index_get_streams_by_rpm_component_source (
+    index, repo, "1.1");
+  g_assert_cmpuint (owners->len, ==, 0);
+  g_clear_pointer (&owners, g_ptr_array_unref);
+
+  owners = modulemd_module_index_get_streams_by_rpm_component_source (
+    index, repo, "1.2");
+  g_assert_cmpuint (owners->len, ==, 1);
+  g_clear_pointer (&owners, g_ptr_array_unref);
+
+  /* Streams added and removed after the first lookup are picked up */
+  add_component_stream (index, "baz", "1", "zlib", NULL, NULL);
+  owners = modulemd_module_index_get_streams_by_rpm_component (index, "zlib");
+  g_assert_cmpuint (owners->len, ==, 2);
+  g_clear_pointer (&owners, g_ptr_array_unref);
+
+  modulemd_module_remove_streams_by_name (
+    modulemd_module_index_get_module (index, "bar"), "2");
+  owners = modulemd_module_index_get_streams_by_rpm_component (index, "zlib");
+  g_assert_cmpuint (owners->len, ==, 1);
+  g_assert_cmpstr (modulemd_module_stream_get_module_name (
+                     g_ptr_array_index (owners, 0)),
+                   ==,
+                   "baz");
+  g_clear_pointer (&owners, g_ptr_array_unref);
+
+  g_assert_true (modulemd_module_index_remove_module (index, "foo"));
+  owners =
+    modulemd_module_index_get_streams_by_rpm_component (index, "openssl");
+  g_assert_cmpuint (owners->len, ==, 1);
+  g_clear_pointer (&owners, g_ptr_array_unref);
+}
+
+
+static void
+add_requiring_stream (ModulemdModuleIndex *index,
+                      const gchar *module_name,
+                      const gchar *runtime_stream,
+                      const gchar *buildtime_stream)
+{
+  g_autoptr (ModulemdModuleStream) stream = NULL;
+  g_autoptr (ModulemdDependencies) deps = NULL;
+  g_autoptr (GError) error = NULL;
+
+  stream = modulemd_module_stream_new (
+    MD_MODULESTREAM_VERSION_TWO, module_name, "1");
+  deps = modulemd_dependencies_new ();
+  if (runtime_stream)
+    {
+      modulemd_dependencies_add_runtime_stream (
+        deps, "platform", runtime_stream);
+    }
+  else
+    {
+      modulemd_dependencies_set_empty_runtime_dependencies_for_module (
+        deps, "platform");
+    }
+  if (buildtime_stream)
+    {
+      modulemd_dependencies_add_buildtime_stream (
+        deps, "platform", buildtime_stream);
+    }
+  modulemd_module_stream_v2_add_dependencies (
+    MODULEMD_MODULE_STREAM_V2 (stream), deps);
+
+  g_assert_true (
+    modulemd_module_index_add_module_stream (index, stream, &error));
+  g_assert_no_error (error);
+}
+
+
+static void
+module_index_test_streams_requiring (ModuleIndexFixture *fixture,
+                                     gconstpointer user_data)
+{
+  g_autoptr (ModulemdModuleIndex) index = NULL;
+  g_autoptr (GPtrArray) requiring = NULL;
+  g_autoptr (GHashTable) batch = NULL;
+  g_autoptr (ModulemdDependencies) deps = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdModuleStream *stream = NULL;
+  const gchar *platforms[] = { "platform:f32", "platform:f31", NULL };
+
+  index = modulemd_module_index_new ();
+  add_requiring_stream (index, "a", NULL, NULL);
+  add_requiring_stream (index, "b", "f32", NULL);
+  add_requiring_stream (index, "c", "-f31", "-f32");
+  add_requiring_stream (index, "d", "-f32", NULL);
+
+  /* Empty, explicit and negated stream sets */
+  requiring = modulemd_module_index_get_streams_requiring_stream (
+    index, "platform", "f32", FALSE);
+  g_assert_cmpuint (requiring->len, ==, 3);
+  g_assert_cmpstr (modulemd_module_stream_get_module_name (
+                     g_ptr_array_index (requiring, 2)),
+                   ==,
+                   "c");
+  g_clear_pointer (&requiring, g_ptr_array_unref);
+
+  requiring = modulemd_module_index_get_streams_requiring_stream (
+    index, "platform", "f32", TRUE);
+  g_assert_cmpuint (requiring->len, ==, 0);
+  g_clear_pointer (&requiring, g_ptr_array_unref);
+
+  requiring = modulemd_module_index_get_streams_requiring_stream (
+    index, "platform", "f30", TRUE);
+  g_assert_cmpuint (requiring->len, ==, 1);
+  g_clear_pointer (&requiring, g_ptr_array_unref);
+
+  batch = modulemd_module_index_get_streams_requiring_streams (
+    index, platforms, FALSE);
+  g_assert_cmpuint (g_hash_table_size (batch), ==, 2);
+  g_assert_cmpuint (
+    ((GPtrArray *)g_hash_table_lookup (batch, "platform:f31"))->len, ==, 2);
+  g_clear_pointer (&batch, g_hash_table_unref);
+
+  /* Dependencies edited and then removed after the first lookup no longer
+   * count, even though the edit and the removal cancel each other out in
+   * the sum of the generations of the stream.
+   */
+  stream = modulemd_module_get_stream_by_NSVCA (
+    modulemd_module_index_get_module (index, "b"), "1", 0, NULL, NULL, &error);
+  g_assert_no_error (error);
+  deps = g_object_ref (g_ptr_array_index (
+    modulemd_module_stream_v2_get_dependencies (
+      MODULEMD_MODULE_STREAM_V2 (stream)),
+    0));
+  modulemd_dependencies_add_buildtime_stream (deps, "platform", "f33");
+  modulemd_module_stream_v2_remove_dependencies (
+    MODULEMD_MODULE_STREAM_V2 (stream), deps);
+
+  requiring = modulemd_module_index_get_streams_requiring_stream (
+    index, "platform", "f32", FALSE);
+  g_assert_cmpuint (requiring->len, ==, 2);
+  for (guint i = 0; i < requiring->len; i++)
+    {
+      g_assert_cmpstr (modulemd_module_stream_get_module_name (
+                         g_ptr_array_index (requiring, i)),
+                       !=,
+                       "b");
+    }
+  g_clear_pointer (&requiring, g_ptr_array_unref);
+
+  /* Removed modules no longer count */
+  g_assert_true (modulemd_module_index_remove_module (index, "d"));
+  requiring = modulemd_module_index_get_streams_requiring_stream (
+    index, "platform", "f31", FALSE);
+  g_assert_cmpuint (requiring->len, ==, 1);
+  g_assert_cmpstr (modulemd_module_stream_get_module_name (
+                     g_ptr_array_index (requiring, 0)),
+                   ==,
+                   "a");
+  g_clear_pointer (&requiring, g_ptr_array_unref);
+}
+
+struct custom_string
+{
+  gchar *string;
+  gchar *current;
+};
+
+static int
+custom_string_read_handler (void *data,
+                            unsigned char *buffer,
+                            size_t size,
+                            size_t *size_read)
+{
+  struct custom_string *custom = (struct custom_string *)data;
+  const gchar *end = custom->string + strlen (custom->string);
+
+  if (custom->current == end)
+    {
+      *size_read = 0;
+      return 1;
+    }
+
+  if (size > (size_t) (end - custom->current))
+    {
+      size = end - custom->current;
+    }
+
+  memcpy (buffer, custom->current, size);
+  custom->current += size;
+  *size_read = size;
+  return 1;
+}
+
+
+static void
+module_index_test_custom_read (ModuleIndexFixture *fixture,
+                               gconstpointer user_data)
+{
+  g_autoptr (ModulemdModuleIndex) index = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) error = NULL;
+
+
+  // clang-format off
+  g_autofree gchar *str = g_strdup(
 "---\n"
 "document: modulemd\n"
 "version: 2\n"
@@ -1031,6 +2104,24 @@ struct expected_compressed_read_t
   int error_code;
 };
 
+#if defined(HAVE_RPMIO) || defined(HAVE_ZLIB)
+#define CAN_READ_GZ TRUE
+#else
+#define CAN_READ_GZ FALSE
+#endif
+
+#if defined(HAVE_RPMIO) || defined(HAVE_BZIP2)
+#define CAN_READ_BZ2 TRUE
+#else
+#define CAN_READ_BZ2 FALSE
+#endif
+
+#if defined(HAVE_RPMIO) || defined(HAVE_LZMA)
+#define CAN_READ_XZ TRUE
+#else
+#define CAN_READ_XZ FALSE
+#endif
+
 static void
 test_module_index_read_compressed (void)
 {
@@ -1043,76 +2134,49 @@ test_module_index_read_compressed (void)
   g_autofree gchar *baseline_text = NULL;
   g_autofree gchar *compressed_text = NULL;
 
-#ifdef HAVE_RPMIO
-#ifdef HAVE_LIBMAGIC
-  struct expected_compressed_read_t expected[] = {
-    {
-      .filename = "bzipped",
-      .succeeds = TRUE,
-    },
-    {
-      .filename = "bzipped.yaml.bz2",
-      .succeeds = TRUE,
-    },
-    { .filename = "gzipped", .succeeds = TRUE },
-    { .filename = "gzipped.yaml.gz", .succeeds = TRUE },
-    { .filename = "xzipped", .succeeds = TRUE },
-    { .filename = "xzipped.yaml.xz", .succeeds = TRUE },
-    { .filename = NULL }
-  };
-#else /* HAVE_LIBMAGIC */
-  struct expected_compressed_read_t expected[] = {
-    { .filename = "bzipped",
-      .succeeds = FALSE,
-      .error_domain = MODULEMD_YAML_ERROR,
-      .error_code = MODULEMD_YAML_ERROR_UNPARSEABLE },
-    {
-      .filename = "bzipped.yaml.bz2",
-      .succeeds = TRUE,
-    },
-    { .filename = "gzipped",
-      .succeeds = FALSE,
-      .error_domain = MODULEMD_YAML_ERROR,
-      .error_code = MODULEMD_YAML_ERROR_UNPARSEABLE },
-    { .filename = "gzipped.yaml.gz", .succeeds = TRUE },
-    { .filename = "xzipped",
-      .succeeds = FALSE,
-      .error_domain = MODULEMD_YAML_ERROR,
-      .error_code = MODULEMD_YAML_ERROR_UNPARSEABLE },
-    { .filename = "xzipped.yaml.xz", .succeeds = TRUE },
-    { .filename = NULL }
-  };
-#endif /* HAVE_LIBMAGIC */
-
-#else /* HAVE_RPMIO */
+  /* Compressed files are detected by their contents when they have no
+   * suffix, and are read by a built-in decompressor or by rpmio.
+   */
   struct expected_compressed_read_t expected[] = {
     { .filename = "bzipped",
-      .succeeds = FALSE,
+      .succeeds = CAN_READ_BZ2,
       .error_domain = MODULEMD_ERROR,
       .error_code = MODULEMD_ERROR_NOT_IMPLEMENTED },
     { .filename = "bzipped.yaml.bz2",
-      .succeeds = FALSE,
+      .succeeds = CAN_READ_BZ2,
       .error_domain = MODULEMD_ERROR,
       .error_code = MODULEMD_ERROR_NOT_IMPLEMENTED },
     { .filename = "gzipped",
-      .succeeds = FALSE,
+      .succeeds = CAN_READ_GZ,
       .error_domain = MODULEMD_ERROR,
       .error_code = MODULEMD_ERROR_NOT_IMPLEMENTED },
     { .filename = "gzipped.yaml.gz",
-      .succeeds = FALSE,
+      .succeeds = CAN_READ_GZ,
+      .error_domain = MODULEMD_ERROR,
+      .error_code = MODULEMD_ERROR_NOT_IMPLEMENTED },
+    /* Zero padding and other data after the compressed data are ignored */
+    { .filename = "gzipped-padded.yaml.gz",
+      .succeeds = CAN_READ_GZ,
       .error_domain = MODULEMD_ERROR,
       .error_code = MODULEMD_ERROR_NOT_IMPLEMENTED },
     { .filename = "xzipped",
-      .succeeds = FALSE,
+      .succeeds = CAN_READ_XZ,
       .error_domain = MODULEMD_ERROR,
       .error_code = MODULEMD_ERROR_NOT_IMPLEMENTED },
     { .filename = "xzipped.yaml.xz",
-      .succeeds = FALSE,
+      .succeeds = CAN_READ_XZ,
       .error_domain = MODULEMD_ERROR,
       .error_code = MODULEMD_ERROR_NOT_IMPLEMENTED },
+    { .filename = "xzipped-padded.yaml.xz",
+      .succeeds = CAN_READ_XZ,
+      .error_domain = MODULEMD_ERROR,
+      .error_code = MODULEMD_ERROR_NOT_IMPLEMENTED },
+#ifdef HAVE_ZSTD
+    { .filename = "zstdipped", .succeeds = TRUE },
+    { .filename = "zstdipped.yaml.zst", .succeeds = TRUE },
+#endif /* HAVE_ZSTD */
     { .filename = NULL }
   };
-#endif /* HAVE_RPMIO */
 
   baseline_idx = modulemd_module_index_new ();
   g_assert_nonnull (baseline_idx);
@@ -1348,6 +2412,645 @@ test_module_index_read_def_dir (void)
 }
 
 
+static void
+test_module_index_dump_compressed (void)
+{
+  g_autoptr (ModulemdModuleIndex) idx = NULL;
+  g_autoptr (ModulemdModuleIndex) reread_idx = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *file_path = NULL;
+  g_autofree gchar *tmpdir = NULL;
+  g_autofree gchar *base_path = NULL;
+  g_autofree gchar *written_path = NULL;
+  g_autofree gchar *baseline_text = NULL;
+  g_autofree gchar *reread_text = NULL;
+  ModulemdCompressionTypeEnum comtypes[] = {
+    MODULEMD_COMPRESSION_TYPE_NO_COMPRESSION,
+    MODULEMD_COMPRESSION_TYPE_GZ_COMPRESSION,
+    MODULEMD_COMPRESSION_TYPE_BZ2_COMPRESSION,
+    MODULEMD_COMPRESSION_TYPE_XZ_COMPRESSION,
+  };
+  const gchar *suffixes[] = { ".yaml", ".yaml.gz", ".yaml.bz2", ".yaml.xz" };
+  guint i;
+
+  idx = modulemd_module_index_new ();
+  file_path = g_strdup_printf ("%s/compression/uncompressed.yaml",
+                               g_getenv ("TEST_DATA_PATH"));
+  g_assert_true (modulemd_module_index_update_from_file (
+    idx, file_path, TRUE, &failures, &error));
+  g_assert_no_error (error);
+
+  baseline_text = modulemd_module_index_dump_to_string (idx, &error);
+  g_assert_no_error (error);
+
+  tmpdir = g_dir_make_tmp ("modulemd-dump-XXXXXX", &error);
+  g_assert_no_error (error);
+  base_path = g_build_path ("/", tmpdir, "index.yaml", NULL);
+
+  for (i = 0; i < G_N_ELEMENTS (comtypes); i++)
+    {
+      written_path = modulemd_module_index_dump_to_file (
+        idx, base_path, comtypes[i], i % 2 ? 9 : 0, &error);
+
+#ifndef HAVE_RPMIO
+      if (comtypes[i] != MODULEMD_COMPRESSION_TYPE_NO_COMPRESSION)
+        {
+          g_assert_error (
+            error, MODULEMD_ERROR, MODULEMD_ERROR_NOT_IMPLEMENTED);
+          g_assert_null (written_path);
+          g_clear_error (&error);
+          continue;
+        }
+#endif /* HAVE_RPMIO */
+
+      g_assert_no_error (error);
+      g_assert_nonnull (written_path);
+      g_assert_true (g_str_has_suffix (written_path, suffixes[i]));
+
+      /* Reading it back must give the same index */
+      reread_idx = modulemd_module_index_new ();
+      g_clear_pointer (&failures, g_ptr_array_unref);
+      g_assert_true (modulemd_module_index_update_from_file (
+        reread_idx, written_path, TRUE, &failures, &error));
+      g_assert_no_error (error);
+
+      reread_text = modulemd_module_index_dump_to_string (reread_idx, &error);
+      g_assert_no_error (error);
+      g_assert_cmpstr (baseline_text, ==, reread_text);
+
+      g_assert_cmpint (g_unlink (written_path), ==, 0);
+      g_clear_pointer (&written_path, g_free);
+      g_clear_pointer (&reread_text, g_free);
+      g_clear_object (&reread_idx);
+    }
+
+  g_assert_cmpint (g_rmdir (tmpdir), ==, 0);
+}
+
+
+static void
+test_module_index_binary (void)
+{
+  g_autoptr (ModulemdModuleIndex) idx = NULL;
+  g_autoptr (ModulemdModuleIndex) loaded_idx = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autoptr (GBytes) garbage = NULL;
+  g_autofree gchar *file_path = NULL;
+  g_autofree gchar *tmpdir = NULL;
+  g_autofree gchar *binary_path = NULL;
+  g_autofree gchar *baseline_text = NULL;
+  g_autofree gchar *loaded_text = NULL;
+  const gchar garbage_data[] = "---\ndocument: modulemd\n";
+
+  idx = modulemd_module_index_new ();
+  file_path = g_strdup_printf ("%s/long-valid.yaml",
+                               g_getenv ("TEST_DATA_PATH"));
+  g_assert_true (modulemd_module_index_update_from_file (
+    idx, file_path, TRUE, &failures, &error));
+  g_assert_no_error (error);
+
+  baseline_text = modulemd_module_index_dump_to_string (idx, &error);
+  g_assert_no_error (error);
+
+  tmpdir = g_dir_make_tmp ("modulemd-binary-XXXXXX", &error);
+  g_assert_no_error (error);
+  binary_path = g_build_path ("/", tmpdir, "index.bin", NULL);
+
+  g_assert_true (
+    modulemd_module_index_dump_to_binary_file (idx, binary_path, &error));
+  g_assert_no_error (error);
+
+  /* Loading it must give back the same defaults, translations and streams */
+  loaded_idx = modulemd_module_index_new ();
+  g_clear_pointer (&failures, g_ptr_array_unref);
+  g_assert_true (modulemd_module_index_update_from_binary_file (
+    loaded_idx, binary_path, &failures, &error));
+  g_assert_no_error (error);
+  g_assert_cmpint (failures->len, ==, 0);
+  g_assert_cmpint (modulemd_module_index_get_stream_mdversion (loaded_idx),
+                   ==,
+                   MD_MODULESTREAM_VERSION_TWO);
+
+  loaded_text = modulemd_module_index_dump_to_string (loaded_idx, &error);
+  g_assert_no_error (error);
+  g_assert_cmpstr (baseline_text, ==, loaded_text);
+
+  g_assert_cmpint (g_unlink (binary_path), ==, 0);
+  g_assert_cmpint (g_rmdir (tmpdir), ==, 0);
+
+  /* Anything else is rejected */
+  g_clear_object (&loaded_idx);
+  g_clear_pointer (&failures, g_ptr_array_unref);
+  loaded_idx = modulemd_module_index_new ();
+  garbage = g_bytes_new_static (garbage_data, sizeof (garbage_data) - 1);
+  g_assert_false (modulemd_module_index_update_from_binary (
+    loaded_idx, garbage, &failures, &error));
+  g_assert_error (error, MODULEMD_ERROR, MODULEMD_ERROR_VALIDATE);
+
+}
+
+
+static GBytes *
+make_binary_index (const gchar *library_version, GVariantBuilder *streams)
+{
+  g_autoptr (GVariant) variant = NULL;
+
+  variant = g_variant_ref_sink (
+    g_variant_new ("(ssuv)",
+                   "libmodulemd-index",
+                   library_version,
+                   2,
+                   g_variant_new ("(sa(usstmsmsbs))", "", streams)));
+
+  return g_variant_get_data_as_bytes (variant);
+}
+
+
+static void
+add_binary_stream (GVariantBuilder *streams,
+                   const gchar *stream_name,
+                   gboolean validated,
+                   const gchar *yaml)
+{
+  g_variant_builder_add (streams,
+                         "(usstmsmsbs)",
+                         MD_MODULESTREAM_VERSION_TWO,
+                         "foo",
+                         stream_name,
+                         (guint64)1,
+                         "c0ffee42",
+                         NULL,
+                         validated,
+                         yaml);
+}
+
+
+static void
+test_module_index_binary_validate (void)
+{
+  g_autoptr (ModulemdModuleIndex) idx = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autoptr (GBytes) bytes = NULL;
+  g_auto (GStrv) stream_names = NULL;
+  GVariantBuilder streams;
+  const gchar *data = NULL;
+  const gchar *failed_yaml = NULL;
+  gsize size;
+  const gchar *good_yaml =
+    "---\n"
+    "document: modulemd\n"
+    "version: 2\n"
+    "data:\n"
+    "  name: foo\n"
+    "  stream: good\n"
+    "  version: 1\n"
+    "  context: c0ffee42\n"
+    "  summary: A good stream\n"
+    "  description: A good stream.\n"
+    "  license:\n"
+    "    module:\n"
+    "    - MIT\n"
+    "...\n";
+  const gchar *bad_yaml =
+    "---\n"
+    "document: modulemd\n"
+    "version: 2\n"
+    "data:\n"
+    "  name: foo\n"
+    "  stream: bad\n"
+    "  version: 1\n"
+    "  context: c0ffee42\n"
+    "...\n";
+  const gchar *trusted_yaml =
+    "---\n"
+    "document: modulemd\n"
+    "version: 2\n"
+    "data:\n"
+    "  name: foo\n"
+    "  stream: trusted\n"
+    "  version: 1\n"
+    "  context: c0ffee42\n"
+    "...\n";
+
+  /* An index written by another version of the library is rejected */
+  bytes = make_binary_index ("0.0.0", NULL);
+  idx = modulemd_module_index_new ();
+  g_assert_false (
+    modulemd_module_index_update_from_binary (idx, bytes, &failures, &error));
+  g_assert_error (error, MODULEMD_ERROR, MODULEMD_ERROR_NOT_IMPLEMENTED);
+  g_clear_error (&error);
+  g_clear_pointer (&failures, g_ptr_array_unref);
+  g_clear_pointer (&bytes, g_bytes_unref);
+  g_clear_object (&idx);
+
+  g_variant_builder_init (&streams, G_VARIANT_TYPE ("a(usstmsmsbs)"));
+  add_binary_stream (&streams, "good", FALSE, good_yaml);
+  add_binary_stream (&streams, "bad", FALSE, bad_yaml);
+  add_binary_stream (&streams, "trusted", TRUE, trusted_yaml);
+  bytes = make_binary_index (modulemd_get_version (), &streams);
+
+  /* The streams are not parsed as they are loaded, even without lazy streams
+   * enabled
+   */
+  idx = modulemd_module_index_new ();
+  g_assert_true (
+    modulemd_module_index_update_from_binary (idx, bytes, &failures, &error));
+  g_assert_no_error (error);
+  g_assert_cmpint (failures->len, ==, 0);
+
+  stream_names = modulemd_module_get_stream_names_as_strv (
+    modulemd_module_index_get_module (idx, "foo"));
+  g_assert_cmpint (g_strv_length (stream_names), ==, 3);
+  g_clear_pointer (&stream_names, g_strfreev);
+
+  /* Only the stream that was not validated when it was written is validated
+   * once it is parsed
+   */
+  g_assert_false (modulemd_module_index_load_lazy_streams (idx, &failures));
+  g_assert_cmpint (failures->len, ==, 1);
+  g_assert_nonnull (modulemd_subdocument_info_get_gerror (
+    g_ptr_array_index (failures, 0)));
+
+  stream_names = modulemd_module_get_stream_names_as_strv (
+    modulemd_module_index_get_module (idx, "foo"));
+  g_assert_cmpint (g_strv_length (stream_names), ==, 2);
+  g_assert_cmpstr (stream_names[0], ==, "good");
+  g_assert_cmpstr (stream_names[1], ==, "trusted");
+
+  /* The YAML of the failed stream was never copied out of the index */
+  data = g_bytes_get_data (bytes, &size);
+  failed_yaml =
+    modulemd_subdocument_info_get_yaml (g_ptr_array_index (failures, 0));
+  g_assert_true (failed_yaml >= data && failed_yaml < data + size);
+  g_assert_cmpstr (failed_yaml, ==, bad_yaml);
+}
+
+
+static ModulemdModuleIndex *
+read_through_cache (const gchar *path, const gchar *cache_dir)
+{
+  g_autoptr (ModulemdModuleIndex) idx = modulemd_module_index_new ();
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) error = NULL;
+
+  modulemd_module_index_set_cache_dir (idx, cache_dir);
+  g_assert_cmpstr (modulemd_module_index_get_cache_dir (idx), ==, cache_dir);
+  g_assert_true (modulemd_module_index_update_from_file (
+    idx, path, TRUE, &failures, &error));
+  g_assert_no_error (error);
+  g_assert_cmpint (failures->len, ==, 0);
+
+  return g_steal_pointer (&idx);
+}
+
+
+static gchar *
+only_cache_entry (const gchar *cache_dir)
+{
+  g_autoptr (GDir) dir = NULL;
+  g_autoptr (GError) error = NULL;
+  const gchar *name = NULL;
+
+  dir = g_dir_open (cache_dir, 0, &error);
+  g_assert_no_error (error);
+  name = g_dir_read_name (dir);
+  g_assert_nonnull (name);
+  g_assert_null (g_dir_read_name (dir));
+
+  return g_build_path ("/", cache_dir, name, NULL);
+}
+
+
+static void
+test_module_index_read_cached (void)
+{
+  g_autoptr (ModulemdModuleIndex) idx = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *tmpdir = NULL;
+  g_autofree gchar *cache_dir = NULL;
+  g_autofree gchar *yaml_path = NULL;
+  g_autofree gchar *source_path = NULL;
+  g_autofree gchar *entry_path = NULL;
+  g_autofree gchar *contents = NULL;
+  g_autofree gchar *baseline_text = NULL;
+  g_autofree gchar *cached_text = NULL;
+  GStatBuf first_entry;
+  GStatBuf entry;
+  const gchar *sources[] = { "long-valid.yaml", "compression/uncompressed" };
+  guint i;
+
+  tmpdir = g_dir_make_tmp ("modulemd-cache-XXXXXX", &error);
+  g_assert_no_error (error);
+  cache_dir = g_build_path ("/", tmpdir, "cache", NULL);
+  yaml_path = g_build_path ("/", tmpdir, "index.yaml", NULL);
+
+  for (i = 0; i < G_N_ELEMENTS (sources); i++)
+    {
+      /* Replacing the file must make the existing entry stale */
+      g_clear_pointer (&contents, g_free);
+      g_clear_pointer (&source_path, g_free);
+      source_path = g_strdup_printf (
+        "%s/%s", g_getenv ("TEST_DATA_PATH"), sources[i]);
+      g_assert_true (
+        g_file_get_contents (source_path, &contents, NULL, &error));
+      g_assert_no_error (error);
+      g_assert_true (
+        g_file_set_contents (yaml_path, contents, -1, &error));
+      g_assert_no_error (error);
+
+      /* The first read parses the file and creates the entry */
+      idx = read_through_cache (yaml_path, cache_dir);
+      baseline_text = modulemd_module_index_dump_to_string (idx, &error);
+      g_assert_no_error (error);
+      g_clear_object (&idx);
+
+      g_clear_pointer (&entry_path, g_free);
+      entry_path = only_cache_entry (cache_dir);
+      g_assert_cmpint (g_stat (entry_path, &first_entry), ==, 0);
+
+      /* The second one is read from the entry, which is left alone */
+      idx = read_through_cache (yaml_path, cache_dir);
+      cached_text = modulemd_module_index_dump_to_string (idx, &error);
+      g_assert_no_error (error);
+      g_assert_cmpstr (baseline_text, ==, cached_text);
+      g_clear_object (&idx);
+
+      g_assert_cmpint (g_stat (entry_path, &entry), ==, 0);
+      g_assert_cmpint (entry.st_ino, ==, first_entry.st_ino);
+
+      g_clear_pointer (&baseline_text, g_free);
+      g_clear_pointer (&cached_text, g_free);
+    }
+
+  g_assert_cmpint (g_unlink (entry_path), ==, 0);
+  g_assert_cmpint (g_rmdir (cache_dir), ==, 0);
+  g_assert_cmpint (g_unlink (yaml_path), ==, 0);
+  g_assert_cmpint (g_rmdir (tmpdir), ==, 0);
+}
+
+
+static void
+test_module_index_read_cached_validate (void)
+{
+  g_autoptr (ModulemdModuleIndex) idx = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *tmpdir = NULL;
+  g_autofree gchar *cache_dir = NULL;
+  g_autofree gchar *yaml_path = NULL;
+  g_autofree gchar *source_path = NULL;
+  g_autofree gchar *entry_path = NULL;
+  g_autofree gchar *contents = NULL;
+  const gchar *summary = "\n  summary: ";
+  gsize len;
+  guint broken = 0;
+
+  tmpdir = g_dir_make_tmp ("modulemd-cache-XXXXXX", &error);
+  g_assert_no_error (error);
+  cache_dir = g_build_path ("/", tmpdir, "cache", NULL);
+  yaml_path = g_build_path ("/", tmpdir, "index.yaml", NULL);
+
+  source_path = g_strdup_printf ("%s/compression/uncompressed",
+                                 g_getenv ("TEST_DATA_PATH"));
+  g_assert_true (g_file_get_contents (source_path, &contents, NULL, &error));
+  g_assert_no_error (error);
+  g_assert_true (g_file_set_contents (yaml_path, contents, -1, &error));
+  g_assert_no_error (error);
+  g_clear_pointer (&contents, g_free);
+
+  idx = read_through_cache (yaml_path, cache_dir);
+  g_clear_object (&idx);
+
+  /* Break the summary of every stream in the entry without changing its
+   * size, so that it still matches the file but no stream validates.
+   */
+  entry_path = only_cache_entry (cache_dir);
+  g_assert_true (g_file_get_contents (entry_path, &contents, &len, &error));
+  g_assert_no_error (error);
+  for (gsize i = 0; i + strlen (summary) <= len; i++)
+    {
+      if (memcmp (contents + i, summary, strlen (summary)) == 0)
+        {
+          contents[i + strlen ("\n  summar")] = 'x';
+          broken++;
+        }
+    }
+  g_assert_cmpuint (broken, >, 0);
+  g_assert_true (g_file_set_contents (entry_path, contents, len, &error));
+  g_assert_no_error (error);
+
+  /* With or without lazy streams, the streams of the entry are only parsed
+   * when they are loaded. They are parsed as strictly as the file was, so
+   * the unknown keys are reported then.
+   */
+  for (guint lazy = 0; lazy < 2; lazy++)
+    {
+      idx = modulemd_module_index_new ();
+      modulemd_module_index_set_cache_dir (idx, cache_dir);
+      modulemd_module_index_set_lazy_streams (idx, lazy);
+      g_assert_true (modulemd_module_index_update_from_file (
+        idx, yaml_path, TRUE, &failures, &error));
+      g_assert_no_error (error);
+      g_assert_cmpuint (failures->len, ==, 0);
+      g_assert_false (
+        modulemd_module_index_load_lazy_streams (idx, &failures));
+      g_assert_cmpuint (failures->len, ==, broken);
+      g_clear_pointer (&failures, g_ptr_array_unref);
+      g_clear_object (&idx);
+    }
+
+  g_assert_cmpint (g_unlink (entry_path), ==, 0);
+  g_assert_cmpint (g_rmdir (cache_dir), ==, 0);
+  g_assert_cmpint (g_unlink (yaml_path), ==, 0);
+  g_assert_cmpint (g_rmdir (tmpdir), ==, 0);
+}
+
+
+static void
+test_module_index_read_cached_lazy (void)
+{
+  g_autoptr (ModulemdModuleIndex) idx = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *tmpdir = NULL;
+  g_autofree gchar *cache_dir = NULL;
+  g_autofree gchar *yaml_path = NULL;
+  g_autofree gchar *entry_path = NULL;
+  g_auto (GStrv) stream_names = NULL;
+  const gchar *yaml_str = "---\n"
+                          "document: modulemd\n"
+                          "version: 2\n"
+                          "data:\n"
+                          "  name: foo\n"
+                          "  stream: good\n"
+                          "  version: 1\n"
+                          "  context: c0ffee42\n"
+                          "  summary: A good stream\n"
+                          "  description: A good stream.\n"
+                          "  license:\n"
+                          "    module: [MIT]\n"
+                          "...\n"
+                          "---\n"
+                          "document: modulemd\n"
+                          "version: 2\n"
+                          "data:\n"
+                          "  name: foo\n"
+                          "  stream: bad\n"
+                          "  version: 1\n"
+                          "  context: c0ffee42\n"
+                          "...\n";
+
+  tmpdir = g_dir_make_tmp ("modulemd-cache-XXXXXX", &error);
+  g_assert_no_error (error);
+  cache_dir = g_build_path ("/", tmpdir, "cache", NULL);
+  yaml_path = g_build_path ("/", tmpdir, "index.yaml", NULL);
+  g_assert_true (g_file_set_contents (yaml_path, yaml_str, -1, &error));
+  g_assert_no_error (error);
+
+  /* The entry is written without parsing the streams, so the invalid one is
+   * stored as it was read and reported the same way from the entry as from
+   * the file.
+   */
+  for (guint i = 0; i < 2; i++)
+    {
+      idx = modulemd_module_index_new ();
+      modulemd_module_index_set_cache_dir (idx, cache_dir);
+      modulemd_module_index_set_lazy_streams (idx, TRUE);
+      g_assert_true (modulemd_module_index_update_from_file (
+        idx, yaml_path, TRUE, &failures, &error));
+      g_assert_no_error (error);
+      g_assert_cmpuint (failures->len, ==, 0);
+
+      stream_names = modulemd_module_get_stream_names_as_strv (
+        modulemd_module_index_get_module (idx, "foo"));
+      g_assert_cmpint (g_strv_length (stream_names), ==, 2);
+      g_clear_pointer (&stream_names, g_strfreev);
+
+      g_assert_false (
+        modulemd_module_index_load_lazy_streams (idx, &failures));
+      g_assert_cmpuint (failures->len, ==, 1);
+      g_clear_pointer (&failures, g_ptr_array_unref);
+      g_clear_object (&idx);
+    }
+
+  entry_path = only_cache_entry (cache_dir);
+  g_assert_cmpint (g_unlink (entry_path), ==, 0);
+  g_assert_cmpint (g_rmdir (cache_dir), ==, 0);
+  g_assert_cmpint (g_unlink (yaml_path), ==, 0);
+  g_assert_cmpint (g_rmdir (tmpdir), ==, 0);
+}
+
+
+static void
+test_module_index_read_def_dir_broken_file (void)
+{
+  g_autoptr (ModulemdModuleIndex) idx = modulemd_module_index_new ();
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *tmpdir = NULL;
+  g_autofree gchar *good_path = NULL;
+  g_autofree gchar *broken_path = NULL;
+
+  tmpdir = g_dir_make_tmp ("modulemd-defaults-XXXXXX", &error);
+  g_assert_no_error (error);
+
+  good_path = g_build_path ("/", tmpdir, "good.yaml", NULL);
+  g_assert_true (g_file_set_contents (good_path,
+                                      "---\n"
+                                      "document: modulemd-defaults\n"
+                                      "version: 1\n"
+                                      "data:\n"
+                                      "  module: good\n"
+                                      "...\n",
+                                      -1,
+                                      &error));
+
+  broken_path = g_build_path ("/", tmpdir, "broken.yaml", NULL);
+  g_assert_true (g_file_set_contents (broken_path,
+                                      "---\n"
+                                      "document: modulemd-defaults\n"
+                                      "version: 1\n"
+                                      "data: foobar\n"
+                                      "...\n",
+                                      -1,
+                                      &error));
+
+  /* The error must say which file could not be read */
+  g_assert_false (modulemd_module_index_update_from_defaults_directory (
+    idx, tmpdir, TRUE, NULL, &error));
+  g_assert_nonnull (error);
+  g_assert_true (g_str_has_prefix (error->message, broken_path));
+
+  g_assert_cmpint (g_unlink (good_path), ==, 0);
+  g_assert_cmpint (g_unlink (broken_path), ==, 0);
+  g_assert_cmpint (g_rmdir (tmpdir), ==, 0);
+}
+
+
+static void
+test_module_index_read_def_dir_merge_order (void)
+{
+  g_autoptr (ModulemdModuleIndex) idx = modulemd_module_index_new ();
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *tmpdir = NULL;
+  g_autofree gchar *path = NULL;
+  g_autofree gchar *yaml = NULL;
+  ModulemdModule *module = NULL;
+  ModulemdDefaults *defaults = NULL;
+  const gchar *files[] = { "a.yaml", "c.yaml", "d.yaml", NULL };
+  const gchar *streams[] = { "y", "z", "w", NULL };
+  guint64 modified[] = { 2, 1, 1 };
+
+  tmpdir = g_dir_make_tmp ("modulemd-defaults-XXXXXX", &error);
+  g_assert_no_error (error);
+
+  for (guint i = 0; files[i]; i++)
+    {
+      path = g_build_path ("/", tmpdir, files[i], NULL);
+      yaml = g_strdup_printf ("---\n"
+                              "document: modulemd-defaults\n"
+                              "version: 1\n"
+                              "data:\n"
+                              "  module: foo\n"
+                              "  modified: %" G_GUINT64_FORMAT "\n"
+                              "  stream: %s\n"
+                              "...\n",
+                              modified[i],
+                              streams[i]);
+      g_assert_true (g_file_set_contents (path, yaml, -1, &error));
+      g_assert_no_error (error);
+      g_clear_pointer (&path, g_free);
+      g_clear_pointer (&yaml, g_free);
+    }
+
+  /* The files are merged in order, so a.yaml takes precedence over both of
+   * the others before they can conflict with each other.
+   */
+  g_assert_true (modulemd_module_index_update_from_defaults_directory (
+    idx, tmpdir, TRUE, NULL, &error));
+  g_assert_no_error (error);
+
+  module = modulemd_module_index_get_module (idx, "foo");
+  g_assert_nonnull (module);
+  defaults = modulemd_module_get_defaults (module);
+  g_assert_nonnull (defaults);
+  g_assert_cmpstr (modulemd_defaults_v1_get_default_stream (
+                     MODULEMD_DEFAULTS_V1 (defaults), NULL),
+                   ==,
+                   "y");
+
+  for (guint i = 0; files[i]; i++)
+    {
+      path = g_build_path ("/", tmpdir, files[i], NULL);
+      g_assert_cmpint (g_unlink (path), ==, 0);
+      g_clear_pointer (&path, g_free);
+    }
+  g_assert_cmpint (g_rmdir (tmpdir), ==, 0);
+}
+
+
 int
 main (int argc, char *argv[])
 {
@@ -1386,6 +3089,55 @@ main (int argc, char *argv[])
               module_index_test_read_unknown,
               NULL);
 
+  g_test_add ("/modulemd/v2/module/index/read/out_of_order",
+              ModuleIndexFixture,
+              NULL,
+              NULL,
+              module_index_test_read_out_of_order,
+              NULL);
+
+  g_test_add ("/modulemd/v2/module/index/read/parallel",
+              ModuleIndexFixture,
+              NULL,
+              NULL,
+              module_index_test_read_parallel,
+              NULL);
+
+  g_test_add ("/modulemd/v2/module/index/read/shared_strings",
+              ModuleIndexFixture,
+              NULL,
+              NULL,
+              module_index_test_read_shared_strings,
+              NULL);
+
+  g_test_add ("/modulemd/v2/module/index/dump/parallel",
+              ModuleIndexFixture,
+              NULL,
+              NULL,
+              module_index_test_dump_parallel,
+              NULL);
+
+  g_test_add ("/modulemd/v2/module/index/read/lazy",
+              ModuleIndexFixture,
+              NULL,
+              NULL,
+              module_index_test_read_lazy,
+              NULL);
+
+  g_test_add ("/modulemd/v2/module/index/read/lazy/escaped",
+              ModuleIndexFixture,
+              NULL,
+              NULL,
+              module_index_test_read_lazy_escaped,
+              NULL);
+
+  g_test_add ("/modulemd/v2/module/index/dump/keeps_order",
+              ModuleIndexFixture,
+              NULL,
+              NULL,
+              module_index_test_dump_keeps_order,
+              NULL);
+
   g_test_add ("/modulemd/v2/module/index/upgrade/stream",
               ModuleIndexFixture,
               NULL,
@@ -1407,6 +3159,41 @@ main (int argc, char *argv[])
               module_index_test_remove_module,
               NULL);
 
+  g_test_add ("/modulemd/v2/module/index/adopt_stream",
+              ModuleIndexFixture,
+              NULL,
+              NULL,
+              module_index_test_adopt_stream,
+              NULL);
+
+  g_test_add ("/modulemd/v2/module/index/search_streams",
+              ModuleIndexFixture,
+              NULL,
+              NULL,
+              module_index_test_search_streams,
+              NULL);
+
+  g_test_add ("/modulemd/v2/module/index/rpm_artifacts",
+              ModuleIndexFixture,
+              NULL,
+              NULL,
+              module_index_test_rpm_artifacts,
+              NULL);
+
+  g_test_add ("/modulemd/v2/module/index/rpm_components",
+              ModuleIndexFixture,
+              NULL,
+              NULL,
+              module_index_test_rpm_components,
+              NULL);
+
+  g_test_add ("/modulemd/v2/module/index/streams_requiring",
+              ModuleIndexFixture,
+              NULL,
+              NULL,
+              module_index_test_streams_requiring,
+              NULL);
+
   g_test_add ("/modulemd/v2/module/index/custom_read",
               ModuleIndexFixture,
               NULL,
@@ -1430,8 +3217,32 @@ main (int argc, char *argv[])
   g_test_add_func ("/modulemd/v2/module/index/compressed",
                    test_module_index_read_compressed);
 
+  g_test_add_func ("/modulemd/v2/module/index/dump/compressed",
+                   test_module_index_dump_compressed);
+
+  g_test_add_func ("/modulemd/v2/module/index/binary",
+                   test_module_index_binary);
+
+  g_test_add_func ("/modulemd/v2/module/index/binary/validate",
+                   test_module_index_binary_validate);
+
+  g_test_add_func ("/modulemd/v2/module/index/read/cached",
+                   test_module_index_read_cached);
+
+  g_test_add_func ("/modulemd/v2/module/index/read/cached/validate",
+                   test_module_index_read_cached_validate);
+
+  g_test_add_func ("/modulemd/v2/module/index/read/cached/lazy",
+                   test_module_index_read_cached_lazy);
+
   g_test_add_func ("/modulemd/v2/module/index/defaultdir",
                    test_module_index_read_def_dir);
 
+  g_test_add_func ("/modulemd/v2/module/index/defaultdir/broken_file",
+                   test_module_index_read_def_dir_broken_file);
+
+  g_test_add_func ("/modulemd/v2/module/index/defaultdir/merge_order",
+                   test_module_index_read_def_dir_merge_order);
+
   return g_test_run ();
 }
@@ -2190,6 +2190,127 @@ module_stream_v2_test_validate_buildafter (ModuleStreamFixture *fixture,
 }
 
 
+static void
+add_rpm_component (ModulemdModuleStreamV2 *stream,
+                   const gchar *name,
+                   gint64 buildorder,
+                   const gchar **buildafter)
+{
+  g_autoptr (ModulemdComponentRpm) component = NULL;
+
+  component = modulemd_component_rpm_new (name);
+  modulemd_component_set_buildorder (MODULEMD_COMPONENT (component),
+                                     buildorder);
+  for (guint i = 0; buildafter && buildafter[i]; i++)
+    {
+      modulemd_component_add_buildafter (MODULEMD_COMPONENT (component),
+                                         buildafter[i]);
+    }
+  modulemd_module_stream_v2_add_component (stream,
+                                           MODULEMD_COMPONENT (component));
+}
+
+
+static void
+assert_build_batches (ModulemdModuleStreamV2 *stream,
+                      const gchar **expected_batches,
+                      const gchar **expected_critical_path)
+{
+  g_autoptr (GPtrArray) batches = NULL;
+  g_auto (GStrv) critical_path = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *batch = NULL;
+
+  batches =
+    modulemd_module_stream_v2_get_rpm_component_build_batches (stream, &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (batches);
+  g_assert_cmpuint (
+    batches->len, ==, g_strv_length ((gchar **)expected_batches));
+  for (guint i = 0; i < batches->len; i++)
+    {
+      batch = g_strjoinv (" ", g_ptr_array_index (batches, i));
+      g_assert_cmpstr (batch, ==, expected_batches[i]);
+      g_clear_pointer (&batch, g_free);
+    }
+
+  critical_path =
+    modulemd_module_stream_v2_get_rpm_component_critical_path (stream, &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (critical_path);
+  g_assert_cmpuint (g_strv_length (critical_path), ==, batches->len);
+  for (guint i = 0; expected_critical_path[i]; i++)
+    {
+      g_assert_cmpstr (critical_path[i], ==, expected_critical_path[i]);
+    }
+}
+
+
+static void
+module_stream_v2_test_rpm_component_build_batches (
+  ModuleStreamFixture *fixture, gconstpointer user_data)
+{
+  g_autoptr (ModulemdModuleStreamV2) stream = NULL;
+  g_autoptr (GPtrArray) batches = NULL;
+  g_auto (GStrv) critical_path = NULL;
+  g_autoptr (GError) error = NULL;
+  const gchar *after_a[] = { "a", NULL };
+  const gchar *after_a_b[] = { "a", "b", NULL };
+  const gchar *after_c_d[] = { "c", "d", NULL };
+  const gchar *after_x[] = { "x", NULL };
+  const gchar *after_y[] = { "y", NULL };
+  const gchar *none[] = { NULL };
+  const gchar *single[] = { "a b c", NULL };
+  const gchar *buildafter_batches[] = { "a b", "c d", "e", NULL };
+  const gchar *buildafter_path[] = { "a", "c", "e", NULL };
+  const gchar *buildorder_batches[] = { "r", "s", "p q", NULL };
+  const gchar *buildorder_path[] = { "r", "s", "p", NULL };
+
+  stream = modulemd_module_stream_v2_new ("foo", "bar");
+
+  /* No components at all */
+  assert_build_batches (stream, none, none);
+
+  /* Neither buildorder nor buildafter */
+  add_rpm_component (stream, "c", 0, NULL);
+  add_rpm_component (stream, "b", 0, NULL);
+  add_rpm_component (stream, "a", 0, NULL);
+  assert_build_batches (stream, single, after_a);
+
+  /* Buildafter */
+  add_rpm_component (stream, "c", 0, after_a);
+  add_rpm_component (stream, "d", 0, after_a_b);
+  add_rpm_component (stream, "e", 0, after_c_d);
+  assert_build_batches (stream, buildafter_batches, buildafter_path);
+
+  /* Buildafter cycles are reported */
+  add_rpm_component (stream, "x", 0, after_y);
+  add_rpm_component (stream, "y", 0, after_x);
+  add_rpm_component (stream, "z", 0, after_x);
+
+  batches =
+    modulemd_module_stream_v2_get_rpm_component_build_batches (stream, &error);
+  g_assert_error (error, MODULEMD_ERROR, MODULEMD_ERROR_VALIDATE);
+  g_assert_cmpstr (
+    error->message, ==, "Buildafter cycle between components 'x', 'y'");
+  g_assert_null (batches);
+  g_clear_error (&error);
+
+  critical_path =
+    modulemd_module_stream_v2_get_rpm_component_critical_path (stream, &error);
+  g_assert_error (error, MODULEMD_ERROR, MODULEMD_ERROR_VALIDATE);
+  g_assert_null (critical_path);
+  g_clear_error (&error);
+
+  /* Buildorder */
+  modulemd_module_stream_v2_clear_rpm_components (stream);
+  add_rpm_component (stream, "p", 10, NULL);
+  add_rpm_component (stream, "q", 10, NULL);
+  add_rpm_component (stream, "r", -1, NULL);
+  add_rpm_component (stream, "s", 0, NULL);
+  assert_build_batches (stream, buildorder_batches, buildorder_path);
+}
+
 static void
 module_stream_v2_test_validate_buildarches (ModuleStreamFixture *fixture,
                                             gconstpointer user_data)
@@ -2260,6 +2381,82 @@ module_stream_v2_test_validate_buildarches (ModuleStreamFixture *fixture,
 }
 
 
+static void
+module_stream_v2_test_validate_cached (ModuleStreamFixture *fixture,
+                                       gconstpointer user_data)
+{
+  g_autoptr (ModulemdModuleStream) stream = NULL;
+  g_autoptr (ModulemdModuleStream) copy = NULL;
+  g_autofree gchar *path = NULL;
+  g_autoptr (GError) error = NULL;
+  ModulemdModuleStreamV2 *v2_stream = NULL;
+  ModulemdComponentRpm *component = NULL;
+  ModulemdBuildopts *buildopts = NULL;
+
+  path = g_strdup_printf ("%s/buildarches/good_combo_arches.yaml",
+                          g_getenv ("TEST_DATA_PATH"));
+  g_assert_nonnull (path);
+  stream = modulemd_module_stream_read_file (path, TRUE, NULL, NULL, &error);
+  g_assert_nonnull (stream);
+  g_assert_no_error (error);
+  v2_stream = MODULEMD_MODULE_STREAM_V2 (stream);
+
+  g_assert_true (modulemd_module_stream_validate (stream, &error));
+  g_assert_no_error (error);
+
+  /* Changing the stream itself must cause it to be validated again */
+  modulemd_module_stream_v2_add_rpm_artifact (v2_stream, "not-a-nevra");
+  g_assert_false (modulemd_module_stream_validate (stream, &error));
+  g_assert_error (error, MODULEMD_ERROR, MODULEMD_ERROR_VALIDATE);
+  g_clear_error (&error);
+
+  modulemd_module_stream_v2_remove_rpm_artifact (v2_stream, "not-a-nevra");
+  g_assert_true (modulemd_module_stream_validate (stream, &error));
+  g_assert_no_error (error);
+
+  /* So must changing a component owned by the stream */
+  component =
+    modulemd_module_stream_v2_get_rpm_component (v2_stream, "http-parser");
+  g_assert_nonnull (component);
+  modulemd_component_rpm_add_restricted_arch (component, "i686");
+  g_assert_false (modulemd_module_stream_validate (stream, &error));
+  g_assert_error (error, MODULEMD_ERROR, MODULEMD_ERROR_VALIDATE);
+  g_clear_error (&error);
+
+  modulemd_component_rpm_reset_arches (component);
+  modulemd_component_rpm_add_restricted_arch (component, "x86_64");
+  g_assert_true (modulemd_module_stream_validate (stream, &error));
+  g_assert_no_error (error);
+
+  /* And changing its buildopts */
+  buildopts = modulemd_module_stream_v2_get_buildopts (v2_stream);
+  g_assert_nonnull (buildopts);
+  modulemd_buildopts_remove_arch (buildopts, "x86_64");
+  g_assert_false (modulemd_module_stream_validate (stream, &error));
+  g_assert_error (error, MODULEMD_ERROR, MODULEMD_ERROR_VALIDATE);
+  g_clear_error (&error);
+
+  modulemd_buildopts_add_arch (buildopts, "x86_64");
+  g_assert_true (modulemd_module_stream_validate (stream, &error));
+  g_assert_no_error (error);
+
+  /* A copy of a valid stream is valid, and tracks its own changes */
+  copy = modulemd_module_stream_copy (stream, NULL, NULL);
+  g_assert_nonnull (copy);
+  g_assert_true (modulemd_module_stream_validate (copy, &error));
+  g_assert_no_error (error);
+
+  modulemd_module_stream_v2_add_rpm_artifact (
+    MODULEMD_MODULE_STREAM_V2 (copy), "not-a-nevra");
+  g_assert_false (modulemd_module_stream_validate (copy, &error));
+  g_assert_error (error, MODULEMD_ERROR, MODULEMD_ERROR_VALIDATE);
+  g_clear_error (&error);
+
+  g_assert_true (modulemd_module_stream_validate (stream, &error));
+  g_assert_no_error (error);
+}
+
+
 static void
 module_stream_v2_test_rpm_map (ModuleStreamFixture *fixture,
                                gconstpointer user_data)
@@ -2758,6 +2955,13 @@ main (int argc, char *argv[])
               module_stream_v2_test_validate_buildafter,
               NULL);
 
+  g_test_add ("/modulemd/v2/modulestream/v2/rpm_component_build_batches",
+              ModuleStreamFixture,
+              NULL,
+              NULL,
+              module_stream_v2_test_rpm_component_build_batches,
+              NULL);
+
   g_test_add ("/modulemd/v2/modulestream/v2/validate/buildarches",
               ModuleStreamFixture,
               NULL,
@@ -2765,6 +2969,13 @@ main (int argc, char *argv[])
               module_stream_v2_test_validate_buildarches,
               NULL);
 
+  g_test_add ("/modulemd/v2/modulestream/v2/validate/cached",
+              ModuleStreamFixture,
+              NULL,
+              NULL,
+              module_stream_v2_test_validate_cached,
+              NULL);
+
   g_test_add ("/modulemd/v2/modulestream/v2/rpm_map",
               ModuleStreamFixture,
               NULL,
@@ -0,0 +1,181 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2020 Red Hat, Inc.
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#include <glib.h>
+#include <locale.h>
+
+#include "modulemd-defaults.h"
+#include "modulemd-errors.h"
+#include "modulemd-module-index.h"
+#include "modulemd-module-stream.h"
+#include "modulemd-module.h"
+#include "modulemd-reader.h"
+#include "modulemd-translation.h"
+#include "private/glib-extensions.h"
+#include "private/test-utils.h"
+
+
+static void
+reader_test_read_file (void)
+{
+  g_autoptr (ModulemdReader) reader = NULL;
+  g_autoptr (ModulemdModuleIndex) idx = NULL;
+  g_autoptr (GPtrArray) failures = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *yaml_path = NULL;
+  GObject *object = NULL;
+  ModulemdModuleStream *stream = NULL;
+  guint n_streams = 0;
+  guint n_defaults = 0;
+  guint n_translations = 0;
+
+  yaml_path =
+    g_strdup_printf ("%s/long-valid.yaml", g_getenv ("TEST_DATA_PATH"));
+
+  reader = modulemd_reader_new_for_file (yaml_path, TRUE, &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (reader);
+
+  /* Every object must match the one read into an index */
+  idx = modulemd_module_index_new ();
+  g_assert_true (modulemd_module_index_update_from_file (
+    idx, yaml_path, TRUE, &failures, &error));
+  g_assert_no_error (error);
+
+  while ((object = modulemd_reader_next_document (reader, &error)) != NULL)
+    {
+      g_assert_no_error (error);
+
+      if (MODULEMD_IS_MODULE_STREAM (object))
+        {
+          stream = MODULEMD_MODULE_STREAM (object);
+          g_assert_nonnull (modulemd_module_get_stream_by_NSVCA (
+            modulemd_module_index_get_module (
+              idx, modulemd_module_stream_get_module_name (stream)),
+            modulemd_module_stream_get_stream_name (stream),
+            modulemd_module_stream_get_version (stream),
+            modulemd_module_stream_get_context (stream),
+            modulemd_module_stream_get_arch (stream),
+            &error));
+          g_assert_no_error (error);
+          n_streams++;
+        }
+      else if (MODULEMD_IS_DEFAULTS (object))
+        {
+          n_defaults++;
+        }
+      else
+        {
+          g_assert_true (MODULEMD_IS_TRANSLATION (object));
+          n_translations++;
+        }
+
+      g_clear_object (&object);
+    }
+  g_assert_no_error (error);
+
+  g_assert_cmpuint (n_streams, ==, 5);
+  g_assert_cmpuint (n_defaults, ==, 3);
+  g_assert_cmpuint (n_translations, ==, 1);
+
+  /* It stays at the end of the stream */
+  g_assert_null (modulemd_reader_next_document (reader, &error));
+  g_assert_no_error (error);
+}
+
+
+static void
+reader_test_read_string (void)
+{
+  g_autoptr (ModulemdReader) reader = NULL;
+  g_autoptr (GObject) object = NULL;
+  g_autoptr (GError) error = NULL;
+  const gchar *yaml_string =
+    "---\n"
+    "document: modulemd-defaults\n"
+    "version: 1\n"
+    "data:\n"
+    "  module: foo\n"
+    "...\n"
+    "---\n"
+    "summary: An example module\n"
+    "...\n"
+    "---\n"
+    "document: modulemd-defaults\n"
+    "version: 1\n"
+    "data:\n"
+    "  module: bar\n"
+    "...\n";
+
+  reader = modulemd_reader_new_for_string (yaml_string, TRUE);
+  g_assert_nonnull (reader);
+
+  object = modulemd_reader_next_document (reader, &error);
+  g_assert_no_error (error);
+  g_assert_true (MODULEMD_IS_DEFAULTS (object));
+  g_assert_cmpstr (
+    modulemd_defaults_get_module_name (MODULEMD_DEFAULTS (object)), ==, "foo");
+  g_clear_object (&object);
+
+  /* A broken subdocument is reported without ending the stream */
+  object = modulemd_reader_next_document (reader, &error);
+  g_assert_null (object);
+  g_assert_error (
+    error, MODULEMD_YAML_ERROR, MODULEMD_YAML_ERROR_MISSING_REQUIRED);
+  g_clear_error (&error);
+  g_assert_false (modulemd_reader_is_finished (reader));
+
+  object = modulemd_reader_next_document (reader, &error);
+  g_assert_no_error (error);
+  g_assert_true (MODULEMD_IS_DEFAULTS (object));
+  g_assert_cmpstr (
+    modulemd_defaults_get_module_name (MODULEMD_DEFAULTS (object)), ==, "bar");
+  g_clear_object (&object);
+
+  g_assert_null (modulemd_reader_next_document (reader, &error));
+  g_assert_no_error (error);
+  g_assert_true (modulemd_reader_is_finished (reader));
+}
+
+
+static void
+reader_test_missing_file (void)
+{
+  g_autoptr (ModulemdReader) reader = NULL;
+  g_autoptr (GError) error = NULL;
+
+  reader = modulemd_reader_new_for_file ("/nonexistent.yaml", TRUE, &error);
+  g_assert_null (reader);
+  g_assert_error (error, MODULEMD_ERROR, MODULEMD_YAML_ERROR_OPEN);
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  setlocale (LC_ALL, "");
+
+  g_test_init (&argc, &argv, NULL);
+  g_test_bug_base ("https://bugzilla.redhat.com/show_bug.cgi?id=");
+
+  // Define the tests.
+
+  g_test_add_func ("/modulemd/v2/reader/file", reader_test_read_file);
+
+  g_test_add_func ("/modulemd/v2/reader/string", reader_test_read_string);
+
+  g_test_add_func ("/modulemd/v2/reader/missing_file",
+                   reader_test_missing_file);
+
+  return g_test_run ();
+}
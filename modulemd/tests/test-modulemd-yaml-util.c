@@ -0,0 +1,149 @@
+/*
+ * This file is part of libmodulemd
+ * Copyright (C) 2020 Red Hat, Inc.
+ *
+ * Fedora-License-Identifier: MIT
+ * SPDX-2.0-License-Identifier: MIT
+ * SPDX-3.0-License-Identifier: MIT
+ *
+ * This program is free software.
+ * For more information on the license, see COPYING.
+ * For more information on free software, see <https://www.gnu.org/philosophy/free-sw.en.html>.
+ */
+
+#include <glib.h>
+#include <locale.h>
+#include <string.h>
+#include <yaml.h>
+
+#include "private/modulemd-yaml.h"
+#include "private/test-utils.h"
+
+/* Enough items for the output to outgrow the smallest string buffer */
+#define TEST_ITEM_COUNT 5000
+
+
+static void
+emit_items (yaml_emitter_t *emitter)
+{
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *item = NULL;
+
+  g_assert_true (mmd_emitter_start_stream (emitter, &error));
+  g_assert_true (mmd_emitter_start_document (emitter, &error));
+  g_assert_true (
+    mmd_emitter_start_sequence (emitter, YAML_BLOCK_SEQUENCE_STYLE, &error));
+
+  for (guint i = 0; i < TEST_ITEM_COUNT; i++)
+    {
+      item = g_strdup_printf ("item-%u", i);
+      g_assert_true (
+        mmd_emitter_scalar (emitter, item, YAML_PLAIN_SCALAR_STYLE, &error));
+      g_clear_pointer (&item, g_free);
+    }
+
+  g_assert_true (mmd_emitter_end_sequence (emitter, &error));
+  g_assert_true (mmd_emitter_end_document (emitter, &error));
+  g_assert_true (mmd_emitter_end_stream (emitter, &error));
+  g_assert_no_error (error);
+}
+
+
+static gchar *
+emit_items_to_string (void)
+{
+  MMD_INIT_YAML_EMITTER (emitter);
+  MMD_INIT_YAML_STRING (&emitter, yaml_string);
+
+  emit_items (&emitter);
+
+  return g_steal_pointer (&yaml_string->str);
+}
+
+
+static GBytes *
+emit_items_to_bytes (gsize size_hint)
+{
+  MMD_INIT_YAML_EMITTER (emitter);
+  MMD_INIT_YAML_STRING_SIZED (&emitter, yaml_string, size_hint);
+
+  emit_items (&emitter);
+
+  return modulemd_yaml_string_free_to_bytes (g_steal_pointer (&yaml_string));
+}
+
+
+static void
+test_yaml_string_size_hint (void)
+{
+  g_autofree gchar *expected = NULL;
+  g_autoptr (GBytes) bytes = NULL;
+  const gchar *data = NULL;
+  gsize expected_len;
+  gsize size;
+
+  expected = emit_items_to_string ();
+  expected_len = strlen (expected);
+  g_assert_cmpuint (expected_len, >, 16384); /* MMD_YAML_STRING_MIN_ALLOC */
+
+  /* Hints smaller than, equal to and larger than the output all give the
+   * same bytes as the unsized string.
+   */
+  gsize hints[] = { 0, 1, expected_len / 2, expected_len, expected_len * 4 };
+
+  for (guint i = 0; i < G_N_ELEMENTS (hints); i++)
+    {
+      g_test_message ("Size hint %" G_GSIZE_FORMAT, hints[i]);
+
+      bytes = emit_items_to_bytes (hints[i]);
+      data = g_bytes_get_data (bytes, &size);
+      g_assert_cmpuint (size, ==, expected_len);
+      g_assert_cmpmem (data, size, expected, expected_len);
+
+      /* The data can also be read as a string */
+      g_assert_cmpint (data[size], ==, '\0');
+
+      g_clear_pointer (&bytes, g_bytes_unref);
+    }
+}
+
+
+static void
+test_yaml_string_free_to_bytes_empty (void)
+{
+  g_autoptr (GBytes) bytes = NULL;
+  const gchar *data = NULL;
+  gsize size;
+
+  /* A string that was never written to becomes an empty string */
+  bytes = modulemd_yaml_string_free_to_bytes (modulemd_yaml_string_new (0));
+  data = g_bytes_get_data (bytes, &size);
+  g_assert_cmpuint (size, ==, 0);
+  g_assert_nonnull (data);
+  g_assert_cmpint (data[0], ==, '\0');
+  g_clear_pointer (&bytes, g_bytes_unref);
+
+  bytes = modulemd_yaml_string_free_to_bytes (modulemd_yaml_string_new (64));
+  data = g_bytes_get_data (bytes, &size);
+  g_assert_cmpuint (size, ==, 0);
+  g_assert_nonnull (data);
+  g_assert_cmpint (data[0], ==, '\0');
+}
+
+
+int
+main (int argc, char *argv[])
+{
+  setlocale (LC_ALL, "");
+
+  g_test_init (&argc, &argv, NULL);
+  g_test_bug_base ("https://bugzilla.redhat.com/show_bug.cgi?id=");
+
+  g_test_add_func ("/modulemd/yaml/string/size_hint",
+                   test_yaml_string_size_hint);
+
+  g_test_add_func ("/modulemd/yaml/string/free_to_bytes/empty",
+                   test_yaml_string_free_to_bytes_empty);
+
+  return g_test_run ();
+}